@@ -0,0 +1,31 @@
+import { BenchmarkConfig, BenchmarkRun } from "@/lib/types/benchmark"
+
+import { apiClient } from "./client"
+
+export const benchmark = {
+    async start(config: BenchmarkConfig): Promise<BenchmarkRun> {
+        const response = await apiClient.post<BenchmarkRun, BenchmarkConfig>("/api/benchmark", config)
+        if (!response.result) {
+            throw new Error(response.error || "Failed to start benchmark")
+        }
+        return response.result
+    },
+
+    async getRun(runId: string): Promise<BenchmarkRun | null> {
+        const response = await apiClient.get<BenchmarkRun>(
+            `/api/benchmark?runId=${encodeURIComponent(runId)}`
+        )
+        return response.result || null
+    },
+
+    async listRuns(vectorSetName: string): Promise<BenchmarkRun[]> {
+        const response = await apiClient.get<BenchmarkRun[]>(
+            `/api/benchmark?vectorSetName=${encodeURIComponent(vectorSetName)}`
+        )
+        return response.result || []
+    },
+
+    async clearRuns(vectorSetName: string): Promise<void> {
+        await apiClient.delete(`/api/benchmark?vectorSetName=${encodeURIComponent(vectorSetName)}`)
+    },
+}
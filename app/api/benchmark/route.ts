@@ -0,0 +1,100 @@
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import {
+    clearBenchmarkRuns,
+    getBenchmarkRun,
+    listBenchmarkRuns,
+    startBenchmark,
+    validateBenchmarkConfig,
+} from "@/lib/server/benchmark"
+
+// GET /api/benchmark?runId=... - State of one run
+// GET /api/benchmark?vectorSetName=... - Finished runs for a vector set, newest first
+export async function GET(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    const runId = req.nextUrl.searchParams.get("runId")
+    const vectorSetName = req.nextUrl.searchParams.get("vectorSetName")
+    try {
+        if (runId) {
+            const run = await getBenchmarkRun(redisUrl, runId)
+            if (!run) {
+                return NextResponse.json(
+                    { success: false, error: "Benchmark run not found" },
+                    { status: 404 }
+                )
+            }
+            return NextResponse.json({ success: true, result: run })
+        }
+        if (vectorSetName) {
+            return NextResponse.json({
+                success: true,
+                result: await listBenchmarkRuns(redisUrl, vectorSetName),
+            })
+        }
+        return NextResponse.json(
+            { success: false, error: "runId or vectorSetName is required" },
+            { status: 400 }
+        )
+    } catch (error) {
+        console.error("[Benchmark] Failed to read runs:", error)
+        return NextResponse.json({ success: false, error: String(error) }, { status: 500 })
+    }
+}
+
+// POST /api/benchmark - Start a run in the background
+export async function POST(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    const validation = validateBenchmarkConfig(await req.json().catch(() => null))
+    if (!validation.isValid || !validation.value) {
+        return NextResponse.json({ success: false, error: validation.error }, { status: 400 })
+    }
+
+    try {
+        const run = await startBenchmark(redisUrl, validation.value)
+        return NextResponse.json({ success: true, result: run })
+    } catch (error) {
+        console.error("[Benchmark] Failed to start run:", error)
+        return NextResponse.json({ success: false, error: String(error) }, { status: 500 })
+    }
+}
+
+// DELETE /api/benchmark?vectorSetName=... - Forget a vector set's runs
+export async function DELETE(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    const vectorSetName = req.nextUrl.searchParams.get("vectorSetName")
+    if (!vectorSetName) {
+        return NextResponse.json(
+            { success: false, error: "vectorSetName is required" },
+            { status: 400 }
+        )
+    }
+
+    try {
+        await clearBenchmarkRuns(redisUrl, vectorSetName)
+        return NextResponse.json({ success: true })
+    } catch (error) {
+        console.error("[Benchmark] Failed to clear runs:", error)
+        return NextResponse.json({ success: false, error: String(error) }, { status: 500 })
+    }
+}
@@ -2,6 +2,8 @@
  * Wrappers for calling our local REST APIs 
  */
 
+import { decodeVectorFrame, VECTOR_FRAME_CONTENT_TYPE } from "@/lib/redis-server/vectorFrame";
+
 export interface ApiResponse<T = unknown> {
     success: boolean
     result?: T
@@ -95,6 +97,45 @@ export const apiClient = {
         }
     },
 
+    // POST expecting a vector frame (see lib/redis-server/vectorFrame.ts); falls back to JSON error bodies
+    async postVectorFrame<TResponse, TRequest>(
+        url: string,
+        data: TRequest
+    ): Promise<ApiResponse<TResponse> & { vectors: (Float32Array | null)[] }> {
+        try {
+            const resolvedUrl = typeof window !== 'undefined'
+                ? new URL(url, window.location.origin)
+                : new URL(url, 'http://localhost:3000');
+
+            const response = await fetch(resolvedUrl.toString(), {
+                method: 'POST',
+                headers: { 'Content-Type': 'application/json' },
+                body: JSON.stringify(data),
+            });
+
+            if (response.headers.get('Content-Type') !== VECTOR_FRAME_CONTENT_TYPE) {
+                // Errors are still reported as JSON
+                const responseData = await response.json().catch(() => ({})) as ApiResponse<TResponse>;
+                throw new ApiError(
+                    responseData.error || `HTTP error ${response.status}`,
+                    response.status,
+                    responseData
+                );
+            }
+
+            const { header, vectors } = decodeVectorFrame<ApiResponse<TResponse>>(
+                await response.arrayBuffer()
+            );
+
+            return { ...header, vectors };
+        } catch (error) {
+            if (error instanceof ApiError) {
+                throw error;
+            }
+            throw new ApiError(error instanceof Error ? error.message : 'Unknown error');
+        }
+    },
+
     // Convenience methods
     async get<TResponse>(url: string, headers?: Record<string, string>) {
         return this.request<TResponse>(url, { headers });
@@ -1,5 +1,5 @@
 import { NextRequest, NextResponse } from "next/server"
-import { EmbeddingService } from "@/lib/embeddings/service"
+import { getEmbeddingService } from "@/lib/embeddings/service"
 import { EmbeddingConfig } from "@/lib/embeddings/types/embeddingModels"
 
 interface BatchEmbeddingRequestBody {
@@ -7,7 +7,7 @@ interface BatchEmbeddingRequestBody {
     config: EmbeddingConfig
 }
 
-const embeddingService = new EmbeddingService()
+const embeddingService = getEmbeddingService()
 
 export async function POST(request: NextRequest) {
     try {
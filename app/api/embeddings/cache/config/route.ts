@@ -2,11 +2,11 @@ import { RedisConnection, getRedisUrl } from "@/lib/redis-server/RedisConnection
 import { NextResponse } from "next/server"
 import { EmbeddingConfig } from "@/lib/embeddings/types/embeddingModels"
 import { DEFAULT_EMBEDDING_CONFIG } from "@/app/vectorset/utils/constants"
-
-// Redis key for storing cache configuration
-const CONFIG_KEY = "vector-set-browser:config"
-
-const EMBEDDING_CACHE_CONFIG_KEY = "embedding_cache_config"
+import {
+    EMBEDDING_CACHE_CONFIG_FIELD,
+    EMBEDDING_CACHE_CONFIG_HASH,
+    invalidateEmbeddingCacheSettings,
+} from "@/lib/embeddings/cache/redis-cache"
 
 // Default cache configuration
 const DEFAULT_CACHE_CONFIG = {
@@ -37,8 +37,8 @@ export async function GET() {
             redisUrl,
             async (client) => {
                 const configJson = await client.hGet(
-                    CONFIG_KEY,
-                    EMBEDDING_CACHE_CONFIG_KEY
+                    EMBEDDING_CACHE_CONFIG_HASH,
+                    EMBEDDING_CACHE_CONFIG_FIELD
                 )
 
                 // If no configuration exists, return the default
@@ -114,10 +114,11 @@ export async function POST(request: Request) {
             async (client) => {
                 // Store the configuration as JSON
                 await client.hSet(
-                    CONFIG_KEY,
-                    EMBEDDING_CACHE_CONFIG_KEY,
+                    EMBEDDING_CACHE_CONFIG_HASH,
+                    EMBEDDING_CACHE_CONFIG_FIELD,
                     JSON.stringify(config)
                 )
+                invalidateEmbeddingCacheSettings()
                 return true
             }
         )
@@ -1,6 +1,10 @@
 import { RedisConnection, getRedisUrl } from "@/lib/redis-server/RedisConnection"
 import { NextResponse } from "next/server"
-import { EMBEDDING_CACHE_KEY, EMBEDDING_CACHE_LOG_KEY } from "@/lib/embeddings/cache/redis-cache"
+import {
+    EMBEDDING_CACHE_KEY,
+    EMBEDDING_CACHE_LOG_KEY,
+    clearMemoryEmbeddingCache,
+} from "@/lib/embeddings/cache/redis-cache"
 
 export async function GET() {
     try {
@@ -57,6 +61,7 @@ export async function DELETE() {
                 // Delete both the cache and the log
                 await client.del(EMBEDDING_CACHE_KEY)
                 await client.del(EMBEDDING_CACHE_LOG_KEY)
+                clearMemoryEmbeddingCache()
                 return true
             }
         )
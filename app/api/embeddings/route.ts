@@ -1,8 +1,8 @@
 import { NextRequest, NextResponse } from "next/server"
-import { EmbeddingService } from "@/lib/embeddings/service"
+import { getEmbeddingService } from "@/lib/embeddings/service"
 import { EmbeddingRequestBody } from "@/lib/embeddings/types/response"
 
-const embeddingService = new EmbeddingService()
+const embeddingService = getEmbeddingService()
 
 export async function POST(request: NextRequest) {
     try {
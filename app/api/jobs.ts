@@ -1,5 +1,6 @@
-import { CSVJobMetadata } from "@/lib/types/jobs"
+import { BulkEditSpec, CSVJobMetadata, JobCheckpoint } from "@/lib/types/jobs"
 import { VectorSetMetadata } from "@/lib/types/vectors"
+import type { VectorExportFormat } from "@/lib/imports/vectorExport"
 
 import { apiClient } from "./client"
 
@@ -17,8 +18,12 @@ export interface Job {
         total: number
         message?: string
         error?: string
+        rowsPerSecond?: number
+        etaSeconds?: number
+        timestamp?: number
     }
     metadata: CSVJobMetadata
+    checkpoint?: JobCheckpoint | null
 }
 
 export interface ImportLogEntry {
@@ -39,6 +44,19 @@ export interface CreateImportJobRequestBody {
     config: ImportJobConfig
 }
 
+// Creates a job whose file is then sent with PUT /api/jobs?jobId=<id>
+export interface CreateStreamingJobRequestBody {
+    vectorSetName: string
+    fileName: string
+    config: ImportJobConfig
+    upload: "stream"
+}
+
+export interface CreateBulkEditJobRequestBody {
+    vectorSetName: string
+    bulkEdit: BulkEditSpec
+}
+
 export interface ImportJobConfig {
     delimiter?: string
     hasHeader?: boolean
@@ -53,6 +71,11 @@ export interface ImportJobConfig {
     fileType?: 'csv' | 'image' | 'images' | 'json'
     exportType?: 'redis' | 'json'
     outputFilename?: string
+    exportFormat?: VectorExportFormat
+    streaming?: boolean // Upload the raw file and parse it incrementally on the server (CSV/JSON)
+    batchSize?: number
+    batchTimeBudgetMs?: number
+    concurrency?: number
 }
 
 export const jobs = {
@@ -107,6 +130,13 @@ export const jobs = {
         file: File,
         config: ImportJobConfig
     ): Promise<{ jobId: string }> {
+        const fileType = config.fileType || "csv"
+        const canStream =
+            (fileType === "csv" || fileType === "json") && !config.rawVectors
+        if (canStream && config.streaming !== false) {
+            return this.createStreamingImportJob(vectorSetName, file, config)
+        }
+
         // Convert file to base64 for JSON transport
         const fileContent = await file.text();
 
@@ -124,4 +154,57 @@ export const jobs = {
         >(`/api/jobs`, requestBody)
         return response?.result || { jobId: "" }
     },
+
+    // Deletes or edits every element matching spec.filter, as a background job
+    async createBulkEditJob(
+        vectorSetName: string,
+        bulkEdit: BulkEditSpec
+    ): Promise<{ jobId: string }> {
+        const response = await apiClient.post<
+            { jobId: string },
+            CreateBulkEditJobRequestBody
+        >(`/api/jobs`, { vectorSetName, bulkEdit })
+        return response?.result || { jobId: "" }
+    },
+
+    /**
+     * Creates the job first and resolves with its ID, then sends the file as
+     * the raw request body so neither side holds it as a string. The upload
+     * keeps running in the background; the server writes failures to the
+     * job's status.
+     */
+    async createStreamingImportJob(
+        vectorSetName: string,
+        file: File,
+        config: ImportJobConfig
+    ): Promise<{ jobId: string }> {
+        const response = await apiClient.post<
+            { jobId: string },
+            CreateStreamingJobRequestBody
+        >(`/api/jobs`, { vectorSetName, fileName: file.name, config, upload: "stream" })
+        const jobId = response?.result?.jobId
+        if (!jobId) {
+            return { jobId: "" }
+        }
+
+        fetch(`/api/jobs?jobId=${encodeURIComponent(jobId)}`, {
+            method: "PUT",
+            // Never application/json, which the route treats as a JSON envelope
+            headers: { "Content-Type": "application/octet-stream" },
+            body: file,
+        })
+            .then(async (upload) => {
+                if (!upload.ok) {
+                    const data = await upload.json().catch(() => null)
+                    console.error(`Upload for job ${jobId} failed:`, data?.error || upload.status)
+                }
+            })
+            .catch((error) => {
+                // The request never reached the server, so nothing marked the job failed
+                console.error(`Upload for job ${jobId} failed:`, error)
+                this.cancelJob(jobId).catch(() => {})
+            })
+
+        return { jobId }
+    },
 }
@@ -0,0 +1,88 @@
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import { subscribeJobEvents } from "@/lib/server/job-events"
+import { JobProgressEvent } from "@/lib/types/jobs"
+
+export const dynamic = "force-dynamic"
+
+// Comment lines sent while idle, so proxies keep the stream open
+const HEARTBEAT_INTERVAL_MS = 15000
+// How long the browser waits before reconnecting a dropped stream
+const RETRY_MS = 3000
+
+// Server-Sent Events stream of job progress, optionally for one vector set
+export async function GET(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    const vectorSetName = req.nextUrl.searchParams.get("vectorSetName")
+    const encoder = new TextEncoder()
+    let cleanup = () => {}
+
+    const stream = new ReadableStream<Uint8Array>({
+        async start(controller) {
+            let closed = false
+            const send = (chunk: string) => {
+                if (closed) return
+                try {
+                    controller.enqueue(encoder.encode(chunk))
+                } catch {
+                    cleanup()
+                }
+            }
+
+            let unsubscribe: (() => void) | null = null
+            const heartbeat = setInterval(() => send(": heartbeat\n\n"), HEARTBEAT_INTERVAL_MS)
+            cleanup = () => {
+                if (closed) return
+                closed = true
+                clearInterval(heartbeat)
+                unsubscribe?.()
+                req.signal.removeEventListener("abort", cleanup)
+                try {
+                    controller.close()
+                } catch {
+                    // Already closed by the client
+                }
+            }
+            req.signal.addEventListener("abort", cleanup)
+
+            send(`retry: ${RETRY_MS}\n\n`)
+            try {
+                const remove = await subscribeJobEvents(redisUrl, (event: JobProgressEvent) => {
+                    if (vectorSetName && event.vectorSetName !== vectorSetName) return
+                    send(`event: progress\ndata: ${JSON.stringify(event)}\n\n`)
+                })
+                if (closed) {
+                    remove()
+                    return
+                }
+                unsubscribe = remove
+                send("event: ready\ndata: {}\n\n")
+            } catch (error) {
+                console.error("[JobEvents] Failed to subscribe:", error)
+                send(`event: unavailable\ndata: ${JSON.stringify({
+                    error: error instanceof Error ? error.message : String(error),
+                })}\n\n`)
+                cleanup()
+            }
+        },
+        cancel() {
+            cleanup()
+        },
+    })
+
+    return new Response(stream, {
+        headers: {
+            "Content-Type": "text/event-stream",
+            "Cache-Control": "no-cache, no-transform",
+            Connection: "keep-alive",
+            "X-Accel-Buffering": "no",
+        },
+    })
+}
@@ -1,7 +1,7 @@
-import { JobProcessor } from "@/lib/server/job-processor"
+import { JobProcessor, JobProcessorOptions, jobConsumerName } from "@/lib/server/job-processor"
 import { JobQueueService } from "@/lib/server/job-queue"
 import { NextRequest, NextResponse } from "next/server"
-import { CreateImportJobRequestBody } from "../jobs"
+import { CreateBulkEditJobRequestBody, CreateImportJobRequestBody, CreateStreamingJobRequestBody } from "../jobs"
 import { RedisConnection, getRedisUrl } from "@/lib/redis-server/RedisConnection"
 import { VectorSetMetadata } from "@/lib/types/vectors"
 
@@ -57,45 +57,14 @@ export async function GET(req: NextRequest) {
             })
         }
 
-        // Otherwise, list all jobs
+        // Otherwise, list all jobs. The key listing gets a lease of its own;
+        // the per-job reads below lease their own connections, so they must
+        // not run while it is held
         const result = await RedisConnection.withClient(
             redisUrl,
             async (client) => {
                 console.log("Listing jobs from Redis")
-                const keys = await client.keys("job:*:status")
-                console.log("Found job status keys:", keys)
-                const jobs = []
-                
-                for (const key of keys) {
-                    const jobId = key.split(":")[1]
-                    
-                    // Skip if the key format is invalid
-                    if (!jobId) continue;
-                    
-                    const [status, metadata] = await Promise.all([
-                        JobQueueService.getJobProgress(redisUrl, jobId),
-                        JobQueueService.getJobMetadata(redisUrl, jobId),
-                    ])
-                    
-                    if (status && metadata) {
-                        // If vectorSetName is provided, only include jobs for that vector set
-                        if (
-                            vectorSetName &&
-                            metadata.vectorSetName !== vectorSetName
-                        ) {
-                            continue
-                        }
-                        
-                        // Add the job with proper structure
-                        jobs.push({ 
-                            jobId, 
-                            status, 
-                            metadata 
-                        })
-                    }
-                }
-                
-                return jobs
+                return client.keys("job:*:status")
             }
         )
 
@@ -103,9 +72,44 @@ export async function GET(req: NextRequest) {
             return NextResponse.json({ success: false, error: result.error }, { status: 500 })
         }
 
+        const keys = result.result || []
+        console.log("Found job status keys:", keys)
+        const jobs = []
+
+        for (const key of keys) {
+            const jobId = key.split(":")[1]
+
+            // Skip if the key format is invalid
+            if (!jobId) continue;
+
+            const [status, metadata, checkpoint] = await Promise.all([
+                JobQueueService.getJobProgress(redisUrl, jobId),
+                JobQueueService.getJobMetadata(redisUrl, jobId),
+                JobQueueService.getJobCheckpoint(redisUrl, jobId),
+            ])
+
+            if (status && metadata) {
+                // If vectorSetName is provided, only include jobs for that vector set
+                if (
+                    vectorSetName &&
+                    metadata.vectorSetName !== vectorSetName
+                ) {
+                    continue
+                }
+
+                // Add the job with proper structure
+                jobs.push({
+                    jobId,
+                    status,
+                    metadata,
+                    checkpoint,
+                })
+            }
+        }
+
         return NextResponse.json({
             success: true,
-            result: result.result
+            result: jobs
         })
     } catch (error) {
         console.error("Error getting job(s):", error)
@@ -118,6 +122,137 @@ export async function GET(req: NextRequest) {
 // Redis key for storing cache configuration
 const CONFIG_KEY = "vector-set-browser:config"
 
+async function getVectorSetMetadata(
+    redisUrl: string,
+    vectorSetName: string
+): Promise<VectorSetMetadata | null> {
+    const response = await RedisConnection.withClient(
+        redisUrl,
+        async (client) => {
+            const metadata = await client.hGet(CONFIG_KEY, `vset:${vectorSetName}:metadata`)
+            if (!metadata) {
+                return null
+            }
+            return JSON.parse(metadata) as VectorSetMetadata
+        }
+    )
+    return response.success ? response.result || null : null
+}
+
+// With JOB_WORKERS=external, jobs are only run by `npm run worker` processes
+const externalWorkers = process.env.JOB_WORKERS === "external"
+
+function startProcessor(redisUrl: string, jobId: string, options: JobProcessorOptions = {}) {
+    if (externalWorkers) return
+    const existing = activeProcessors.get(jobId)
+    if (existing?.active) return
+
+    const processor = new JobProcessor(redisUrl, jobId, { consumer: jobConsumerName(), ...options })
+    activeProcessors.set(jobId, processor)
+
+    // Start processing in the background
+    processor
+        .start()
+        .catch((error) => console.error("Job processing error:", error))
+        .finally(() => {
+            if (activeProcessors.get(jobId) === processor) activeProcessors.delete(jobId)
+        })
+}
+
+// Create a job whose file is uploaded afterwards with PUT, so the client has
+// the job ID while the upload is still running
+async function createStreamingJob(body: CreateStreamingJobRequestBody, redisUrl: string) {
+    const { vectorSetName, fileName, config } = body
+    if (!vectorSetName) {
+        return NextResponse.json(
+            { success: false, error: "vectorSetName is required" },
+            { status: 400 }
+        )
+    }
+
+    const metadata = await getVectorSetMetadata(redisUrl, vectorSetName)
+    if (!metadata || !metadata.embedding) {
+        return NextResponse.json(
+            { success: false, error: "Vector set not found or has no embedding configuration" },
+            { status: 404 }
+        )
+    }
+
+    try {
+        const jobId = await JobQueueService.createStreamingJob(
+            redisUrl,
+            fileName || "upload",
+            vectorSetName,
+            metadata.embedding,
+            config || {}
+        )
+        return NextResponse.json({ success: true, result: { jobId } })
+    } catch (error) {
+        console.error("[Jobs API] Error creating streaming job:", error)
+        return NextResponse.json(
+            { success: false, error: "Failed to create job: " + (error instanceof Error ? error.message : String(error)) },
+            { status: 500 }
+        )
+    }
+}
+
+// Upload the file of a streaming job as the raw request body. It is parsed as
+// it arrives and processing starts before it has been fully received; errors
+// are also written to the job's status.
+export async function PUT(req: NextRequest) {
+    const jobId = new URL(req.url).searchParams.get("jobId")
+    if (!jobId || !req.body) {
+        return NextResponse.json(
+            { success: false, error: "jobId and a file body are required" },
+            { status: 400 }
+        )
+    }
+
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json({ success: false, error: "No Redis URL configured" }, { status: 400 })
+    }
+
+    try {
+        const rows = await JobQueueService.ingestStreamingJob(
+            redisUrl,
+            jobId,
+            req.body,
+            (jobId) => startProcessor(redisUrl, jobId)
+        )
+        return NextResponse.json({ success: true, result: { jobId, rows } })
+    } catch (error) {
+        console.error(`[Jobs API] Upload for job ${jobId} failed:`, error)
+        return NextResponse.json(
+            { success: false, error: "Upload failed: " + (error instanceof Error ? error.message : String(error)) },
+            { status: 500 }
+        )
+    }
+}
+
+// Create a job that deletes or edits every element matching a filter
+async function createBulkEditJob(body: CreateBulkEditJobRequestBody, redisUrl: string) {
+    const { vectorSetName, bulkEdit } = body
+    if (!vectorSetName || !bulkEdit?.action || !["delete", "setattr"].includes(bulkEdit.action.type)) {
+        return NextResponse.json(
+            { success: false, error: "vectorSetName and a delete or setattr action are required" },
+            { status: 400 }
+        )
+    }
+
+    try {
+        const jobId = await JobQueueService.createBulkEditJob(redisUrl, vectorSetName, bulkEdit)
+        startProcessor(redisUrl, jobId)
+        return NextResponse.json({ success: true, result: { jobId } })
+    } catch (error) {
+        console.error("[Jobs API] Error creating bulk edit job:", error)
+        return NextResponse.json(
+            { success: false, error: "Failed to create job: " + (error instanceof Error ? error.message : String(error)) },
+            { status: 400 }
+        )
+    }
+}
+
 // Create a new job
 export async function POST(req: NextRequest) {
     const redisUrl = await getRedisUrl()
@@ -125,8 +260,25 @@ export async function POST(req: NextRequest) {
         return NextResponse.json({ success: false, error: "No Redis URL configured" }, { status: 400 })
     }
 
+    // Files are uploaded with PUT once their job exists
+    if (!req.headers.get("content-type")?.startsWith("application/json")) {
+        return NextResponse.json(
+            { success: false, error: "Create the job with a JSON body, then PUT the file to /api/jobs?jobId=<id>" },
+            { status: 415 }
+        )
+    }
+
     try {
-        const body = await req.json() as CreateImportJobRequestBody;
+        const body = await req.json() as
+            | CreateImportJobRequestBody
+            | CreateBulkEditJobRequestBody
+            | CreateStreamingJobRequestBody;
+        if ("bulkEdit" in body) {
+            return createBulkEditJob(body, redisUrl)
+        }
+        if ("upload" in body) {
+            return createStreamingJob(body, redisUrl)
+        }
         const { vectorSetName, fileContent, fileName, config } = body;
 
         // Create a File object from the content
@@ -134,30 +286,12 @@ export async function POST(req: NextRequest) {
             type: 'application/octet-stream'
         });
 
-        const response = await RedisConnection.withClient(
-            redisUrl,
-            async (client) => {
-                const metadata = await client.hGet(CONFIG_KEY, `vset:${vectorSetName}:metadata`)
-                if (!metadata) {
-                    return null
-                }
-                return JSON.parse(metadata) as VectorSetMetadata
-            }
-        )
-        
-        if (!response ||!response.success) {
-            return NextResponse.json(
-                { success: false, error: "Vector set not found" },
-                { status: 404 }
-            )
-        }
+        const metadata = await getVectorSetMetadata(redisUrl, vectorSetName)
 
-        const metadata = response.result
-        
         if (!metadata || !metadata.embedding) {
             return NextResponse.json(
-                { success: false, error: "Vector set has no embedding configuration" },
-                { status: 400 }
+                { success: false, error: "Vector set not found or has no embedding configuration" },
+                { status: 404 }
             )
         }
         
@@ -165,14 +299,7 @@ export async function POST(req: NextRequest) {
             const jobId = await JobQueueService.createJob(redisUrl, file, vectorSetName, metadata.embedding, config)
 
             // Start processing the job
-            const processor = new JobProcessor(redisUrl, jobId)
-            activeProcessors.set(jobId, processor)
-
-            // Start processing in the background
-            processor.start().catch((error) => {
-                console.error("Job processing error:", error)
-                activeProcessors.delete(jobId)
-            })
+            startProcessor(redisUrl, jobId)
 
             return NextResponse.json({ success: true, result: { jobId } })
         } catch (error) {
@@ -237,19 +364,21 @@ export async function PATCH(req: NextRequest) {
                 await processor.pause()
             }
             await JobQueueService.pauseJob(redisUrl, jobId)
+        } else if (processor?.active) {
+            await processor.resume()
+            await JobQueueService.resumeJob(redisUrl, jobId)
         } else {
-            if (processor) {
-                await processor.resume()
-            } else {
+            const progress = await JobQueueService.getJobProgress(redisUrl, jobId)
+            if (progress?.status === "paused") {
                 // If no active processor, create a new one and start it
-                const newProcessor = new JobProcessor(redisUrl, jobId)
-                activeProcessors.set(jobId, newProcessor)
-                newProcessor.start().catch((error) => {
-                    console.error("Job processing error:", error)
-                    activeProcessors.delete(jobId)
-                })
+                startProcessor(redisUrl, jobId)
+                await JobQueueService.resumeJob(redisUrl, jobId)
+            } else {
+                // Failed, or left processing by a server that went away:
+                // continue from the checkpoint, taking over the rows it held
+                await JobQueueService.resumeInterruptedJob(redisUrl, jobId)
+                startProcessor(redisUrl, jobId, { takeOver: true })
             }
-            await JobQueueService.resumeJob(redisUrl, jobId)
         }
 
         return NextResponse.json({ success: true })
@@ -0,0 +1,72 @@
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import {
+    getWhatIfRun,
+    listWhatIfRuns,
+    startWhatIf,
+    validateWhatIfConfig,
+} from "@/lib/server/memory-profile"
+
+// GET /api/memory-whatif?runId=... - State of one run
+// GET /api/memory-whatif?vectorSetName=... - Finished runs for a vector set, newest first
+export async function GET(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    const runId = req.nextUrl.searchParams.get("runId")
+    const vectorSetName = req.nextUrl.searchParams.get("vectorSetName")
+    try {
+        if (runId) {
+            const run = await getWhatIfRun(redisUrl, runId)
+            if (!run) {
+                return NextResponse.json(
+                    { success: false, error: "What-if run not found" },
+                    { status: 404 }
+                )
+            }
+            return NextResponse.json({ success: true, result: run })
+        }
+        if (vectorSetName) {
+            return NextResponse.json({
+                success: true,
+                result: await listWhatIfRuns(redisUrl, vectorSetName),
+            })
+        }
+        return NextResponse.json(
+            { success: false, error: "runId or vectorSetName is required" },
+            { status: 400 }
+        )
+    } catch (error) {
+        console.error("[MemoryProfile] Failed to read runs:", error)
+        return NextResponse.json({ success: false, error: String(error) }, { status: 500 })
+    }
+}
+
+// POST /api/memory-whatif - Build and measure shadow sets in the background
+export async function POST(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    const validation = validateWhatIfConfig(await req.json().catch(() => null))
+    if (!validation.isValid || !validation.value) {
+        return NextResponse.json({ success: false, error: validation.error }, { status: 400 })
+    }
+
+    try {
+        const run = await startWhatIf(redisUrl, validation.value)
+        return NextResponse.json({ success: true, result: run })
+    } catch (error) {
+        console.error("[MemoryProfile] Failed to start run:", error)
+        return NextResponse.json({ success: false, error: String(error) }, { status: 500 })
+    }
+}
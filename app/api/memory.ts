@@ -0,0 +1,34 @@
+import { MemoryMeasurement, WhatIfConfig, WhatIfRun } from "@/lib/types/memory"
+
+import { apiClient } from "./client"
+
+export const memory = {
+    async measure(vectorSetName: string): Promise<MemoryMeasurement | null> {
+        const response = await apiClient.get<MemoryMeasurement>(
+            `/api/vectorset/${encodeURIComponent(vectorSetName)}/memory`
+        )
+        return response.result || null
+    },
+
+    async startWhatIf(config: WhatIfConfig): Promise<WhatIfRun> {
+        const response = await apiClient.post<WhatIfRun, WhatIfConfig>("/api/memory-whatif", config)
+        if (!response.result) {
+            throw new Error(response.error || "Failed to start what-if run")
+        }
+        return response.result
+    },
+
+    async getWhatIfRun(runId: string): Promise<WhatIfRun | null> {
+        const response = await apiClient.get<WhatIfRun>(
+            `/api/memory-whatif?runId=${encodeURIComponent(runId)}`
+        )
+        return response.result || null
+    },
+
+    async listWhatIfRuns(vectorSetName: string): Promise<WhatIfRun[]> {
+        const response = await apiClient.get<WhatIfRun[]>(
+            `/api/memory-whatif?vectorSetName=${encodeURIComponent(vectorSetName)}`
+        )
+        return response.result || []
+    },
+}
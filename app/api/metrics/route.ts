@@ -0,0 +1,11 @@
+import { renderMetrics } from "@/lib/server/metrics"
+
+// GET /api/metrics - Prometheus text exposition of server-side timings
+export async function GET() {
+    return new Response(renderMetrics(), {
+        headers: {
+            "Content-Type": "text/plain; version=0.0.4; charset=utf-8",
+            "Cache-Control": "no-store",
+        },
+    })
+}
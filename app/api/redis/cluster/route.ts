@@ -0,0 +1,37 @@
+import { NextResponse } from "next/server"
+import { RedisConnection, getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import { nodeLabel } from "@/lib/redis-server/cluster"
+
+// GET /api/redis/cluster - Whether the connection is a cluster, and its primaries
+export async function GET() {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    try {
+        const topology = await RedisConnection.getTopology(redisUrl)
+        return NextResponse.json({
+            success: true,
+            result: topology
+                ? {
+                      mode: "cluster",
+                      primaries: topology.primaries.map((node) => ({
+                          id: node.id,
+                          node: nodeLabel(node.url),
+                          slots: node.slots,
+                      })),
+                  }
+                : { mode: "standalone", primaries: [{ id: null, node: nodeLabel(redisUrl), slots: [] }] },
+        })
+    } catch (error) {
+        console.error("Error reading cluster topology:", error)
+        return NextResponse.json(
+            { success: false, error: error instanceof Error ? error.message : String(error) },
+            { status: 500 }
+        )
+    }
+}
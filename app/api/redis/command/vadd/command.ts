@@ -1,5 +1,6 @@
-import { validateElement, validateKeyName, validateVector } from '@/lib/redis-server/utils'
+import { validateElement, validateKeyName, validateVector, vectorToFp32Buffer } from '@/lib/redis-server/utils'
 import { VaddRequestBody } from '@/lib/redis-server/api'
+import type { RedisCapabilities } from '@/lib/redis-server/capabilities'
 
 export function validateVaddRequest(body: any): { isValid: boolean; error?: string; value?: VaddRequestBody } {
     if (!validateKeyName(body.keyName)) {
@@ -26,24 +27,30 @@ export function validateVaddRequest(body: any): { isValid: boolean; error?: stri
             useCAS: typeof body.useCAS === 'boolean' ? body.useCAS : undefined,
             ef: typeof body.ef === 'number' ? body.ef : undefined,
             quantization: typeof body.quantization === 'string' ? body.quantization : undefined,
+            vectorFormat: body.vectorFormat === 'VALUES' ? 'VALUES' : 'FP32',
             returnCommandOnly: body.returnCommandOnly === true
         }
     }
 }
 
-export function buildVaddCommand(request: VaddRequestBody): string[] {
-    const command = ['VADD', request.keyName]
+export function buildVaddCommand(request: VaddRequestBody, capabilities?: RedisCapabilities): (string | Buffer)[] {
+    const command: (string | Buffer)[] = ['VADD', request.keyName]
 
     if (request.reduceDimensions) {
         command.push('REDUCE', request.reduceDimensions.toString())
     }
 
-    command.push(
-        'VALUES',
-        request.vector.length.toString(),
-        ...request.vector.map(v => v.toString()),
-        request.element
-    )
+    // FP32 blobs avoid stringifying and re-parsing every component
+    if (request.vectorFormat === 'VALUES' || capabilities?.fp32 === false) {
+        command.push(
+            'VALUES',
+            request.vector.length.toString(),
+            ...request.vector.map(v => v.toString())
+        )
+    } else {
+        command.push('FP32', vectorToFp32Buffer(request.vector))
+    }
+    command.push(request.element)
 
     if (request.attributes) {
         command.push('SETATTR', request.attributes)
@@ -2,9 +2,13 @@ import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection
 import { validateRequest, formatResponse, handleError } from '@/lib/redis-server/utils'
 import { validateVaddRequest, buildVaddCommand } from './command'
 import { NextResponse } from 'next/server'
+import { invalidateVectorSet } from '@/lib/server/vsim-cache'
+import { CommandTimer } from '@/lib/server/metrics'
 
 export async function POST(request: Request) {
     try {
+        const timer = new CommandTimer('VADD')
+
         // Validate request
         const validatedRequest = await validateRequest(request, validateVaddRequest)
         console.log("Received VADD request")
@@ -18,22 +22,27 @@ export async function POST(request: Request) {
             )
         }
 
-        // Build command
-        const command = buildVaddCommand(validatedRequest)
-        const commandStr = command.join(' ')
-
-        // If returnCommandOnly is true, return just the command
+        // If returnCommandOnly is true, return just the command in its readable VALUES form
         if (validatedRequest.returnCommandOnly) {
             return NextResponse.json({
                 success: true,
-                executedCommand: commandStr
+                executedCommand: buildVaddCommand({ ...validatedRequest, vectorFormat: 'VALUES' }).join(' ')
             })
         }
 
+        // Build command in the cheapest form the server accepts
+        const capabilities = await RedisConnection.getCapabilities(redisUrl, validatedRequest.keyName, { probe: true })
+        const command = buildVaddCommand(validatedRequest, capabilities)
+        const commandStr = command
+            .map((arg) => (arg instanceof Buffer ? '<binary>' : arg))
+            .join(' ')
+
         // Execute command
         const redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
             return await client.sendCommand(command)
-        })
+        }, { key: validatedRequest.keyName })
+        invalidateVectorSet(redisUrl, validatedRequest.keyName)
+        timer.recordRedis(redisResult)
 
         // Check if the Redis operation itself failed
         if (!redisResult.success) {
@@ -43,12 +52,14 @@ export async function POST(request: Request) {
         // Redis VADD returns 1 for success, 0 for failure (element exists)
         const success = redisResult.result === 1
         console.log("Redis VADD result", redisResult.result)
-        return formatResponse({
+        timer.mark('parse')
+
+        return timer.serialize(() => formatResponse({
             success,
             result: redisResult.result,
             executedCommand: commandStr,
             error: !success ? 'Element already exists' : undefined
-        })
+        }))
     } catch (error) {
         return handleError(error)
     }
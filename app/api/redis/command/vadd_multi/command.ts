@@ -1,7 +1,13 @@
-import { validateKeyName, validateElement, validateVector } from '@/lib/redis-server/utils'
+import { validateKeyName, validateElement, validateVector, vectorToFp32Buffer, fp32Base64ToBuffers } from '@/lib/redis-server/utils'
 import { VaddMultiRequestBody } from '@/lib/redis-server/api'
+import type { RedisCapabilities } from '@/lib/redis-server/capabilities'
 
-export function validateVaddMultiRequest(body: any): { isValid: boolean; error?: string; value?: VaddMultiRequestBody } {
+// Server-side form of the request: vectors sent as vectorsFp32 arrive here as ready-made blobs
+export interface VaddMultiCommandRequest extends VaddMultiRequestBody {
+    vectorBlobs?: Buffer[]
+}
+
+export function validateVaddMultiRequest(body: any): { isValid: boolean; error?: string; value?: VaddMultiCommandRequest } {
     if (!validateKeyName(body.keyName)) {
         return { isValid: false, error: 'Key name is required' }
     }
@@ -10,14 +16,6 @@ export function validateVaddMultiRequest(body: any): { isValid: boolean; error?:
         return { isValid: false, error: 'Elements array is required and must not be empty' }
     }
 
-    if (!Array.isArray(body.vectors) || body.vectors.length === 0) {
-        return { isValid: false, error: 'Vectors array is required and must not be empty' }
-    }
-
-    if (body.elements.length !== body.vectors.length) {
-        return { isValid: false, error: `Mismatch between elements (${body.elements.length}) and vectors (${body.vectors.length})` }
-    }
-
     // Validate each element
     for (const element of body.elements) {
         if (!validateElement(element)) {
@@ -25,11 +23,30 @@ export function validateVaddMultiRequest(body: any): { isValid: boolean; error?:
         }
     }
 
-    // Validate each vector
-    for (const vector of body.vectors) {
-        const vectorValidation = validateVector(vector)
-        if (!vectorValidation.isValid) {
-            return { isValid: false, error: vectorValidation.error }
+    let vectorBlobs: Buffer[] | undefined
+
+    if (typeof body.vectorsFp32 === 'string') {
+        // Binary form: one base64 blob of concatenated FP32 vectors
+        const decoded = fp32Base64ToBuffers(body.vectorsFp32, Number(body.dimensions), body.elements.length)
+        if (!decoded.isValid) {
+            return { isValid: false, error: decoded.error }
+        }
+        vectorBlobs = decoded.buffers
+    } else {
+        if (!Array.isArray(body.vectors) || body.vectors.length === 0) {
+            return { isValid: false, error: 'Vectors array is required and must not be empty' }
+        }
+
+        if (body.elements.length !== body.vectors.length) {
+            return { isValid: false, error: `Mismatch between elements (${body.elements.length}) and vectors (${body.vectors.length})` }
+        }
+
+        // Validate each vector
+        for (const vector of body.vectors) {
+            const vectorValidation = validateVector(vector)
+            if (!vectorValidation.isValid) {
+                return { isValid: false, error: vectorValidation.error }
+            }
         }
     }
 
@@ -38,7 +55,9 @@ export function validateVaddMultiRequest(body: any): { isValid: boolean; error?:
         value: {
             keyName: body.keyName,
             elements: body.elements,
-            vectors: body.vectors,
+            vectors: vectorBlobs ? [] : body.vectors,
+            vectorBlobs,
+            vectorFormat: body.vectorFormat === 'VALUES' && !vectorBlobs ? 'VALUES' : 'FP32',
             attributes: body.attributes,
             reduceDimensions: typeof body.reduceDimensions === 'number' ? body.reduceDimensions : undefined,
             useCAS: typeof body.useCAS === 'boolean' ? body.useCAS : undefined,
@@ -48,21 +67,37 @@ export function validateVaddMultiRequest(body: any): { isValid: boolean; error?:
     }
 }
 
-export function buildVaddMultiCommand(request: VaddMultiRequestBody): string[][] {
+export function buildVaddMultiCommand(request: VaddMultiCommandRequest, capabilities?: RedisCapabilities): (string | Buffer)[][] {
+    const fp32 = capabilities?.fp32 !== false
+
     // Return an array of VADD commands, one for each element-vector pair
     return request.elements.map((element, index) => {
-        const command = ['VADD', request.keyName]
+        const command: (string | Buffer)[] = ['VADD', request.keyName]
 
         if (request.reduceDimensions) {
             command.push('REDUCE', request.reduceDimensions.toString())
         }
 
-        command.push(
-            'VALUES',
-            request.vectors[index].length.toString(),
-            ...request.vectors[index].map(v => v.toString()),
-            element
-        )
+        if (request.vectorBlobs && fp32) {
+            command.push('FP32', request.vectorBlobs[index])
+        } else if (request.vectorBlobs) {
+            // A server without FP32 gets the blob's components as VALUES
+            const blob = request.vectorBlobs[index]
+            const values: string[] = []
+            for (let offset = 0; offset < blob.length; offset += 4) {
+                values.push(blob.readFloatLE(offset).toString())
+            }
+            command.push('VALUES', values.length.toString(), ...values)
+        } else if (request.vectorFormat === 'VALUES' || !fp32) {
+            command.push(
+                'VALUES',
+                request.vectors[index].length.toString(),
+                ...request.vectors[index].map(v => v.toString())
+            )
+        } else {
+            command.push('FP32', vectorToFp32Buffer(request.vectors[index]))
+        }
+        command.push(element)
 
         // Handle attributes if provided
         if (request.attributes && request.attributes[index]) {
@@ -2,6 +2,7 @@ import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection
 import { validateRequest, handleError } from '@/lib/redis-server/utils'
 import { validateVaddMultiRequest, buildVaddMultiCommand } from './command'
 import { NextResponse } from 'next/server'
+import { invalidateVectorSet } from '@/lib/server/vsim-cache'
 
 export async function POST(request: Request) {
     try {
@@ -18,9 +19,12 @@ export async function POST(request: Request) {
             )
         }
 
-        // Build commands
-        const commands = buildVaddMultiCommand(validatedRequest)
-        const commandStrs = commands.map(cmd => cmd.join(' '))
+        // Build commands in the cheapest form the server accepts
+        const capabilities = await RedisConnection.getCapabilities(redisUrl, validatedRequest.keyName, { probe: true })
+        const commands = buildVaddMultiCommand(validatedRequest, capabilities)
+        const commandStrs = commands.map(cmd =>
+            cmd.map((arg) => (arg instanceof Buffer ? '<binary>' : arg)).join(' ')
+        )
 
         // If returnCommandOnly is true, return just the commands
         if (validatedRequest.returnCommandOnly) {
@@ -39,7 +43,8 @@ export async function POST(request: Request) {
             })
 
             return await multi.exec()
-        })
+        }, { key: validatedRequest.keyName })
+        invalidateVectorSet(redisUrl, validatedRequest.keyName)
 
         if (!response.success || !response.result) {
             return NextResponse.json({
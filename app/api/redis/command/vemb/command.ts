@@ -15,6 +15,7 @@ export function validateVembRequest(body: any): {
         value: {
             keyName: body.keyName,
             element: body.element,
+            vectorEncoding: body.vectorEncoding === "binary" ? "binary" : "json",
             returnCommandOnly: body.returnCommandOnly === true,
         },
     }
@@ -1,10 +1,13 @@
 import { NextResponse } from "next/server"
 import { RedisConnection, getRedisUrl } from "@/lib/redis-server/RedisConnection"
-import { validateRequest } from '@/lib/redis-server/utils'
+import { formatVectorFrameResponse, validateRequest } from '@/lib/redis-server/utils'
 import { validateVembRequest, buildVembCommand } from "./command"
+import { fetchEmbeddingsBatchRaw } from "@/app/api/redis/command/vemb_multi/command"
+import { CommandTimer } from "@/lib/server/metrics"
 
 export async function POST(request: Request) {
     try {
+        const timer = new CommandTimer("VEMB")
         const validatedRequest = await validateRequest(
             request,
             validateVembRequest
@@ -29,9 +32,31 @@ export async function POST(request: Request) {
             })
         }
 
+        if (validatedRequest.vectorEncoding === "binary") {
+            const rawResult = await fetchEmbeddingsBatchRaw(
+                redisUrl,
+                validatedRequest.keyName,
+                [validatedRequest.element]
+            )
+            timer.recordRedis(rawResult)
+
+            if (!rawResult.success || !rawResult.result || !rawResult.result[0]) {
+                return NextResponse.json(
+                    { success: false, error: rawResult.error || "Invalid response format" },
+                    { status: 500 }
+                )
+            }
+
+            return timer.serialize(() => formatVectorFrameResponse(
+                { success: true, result: null, executedCommand: `${commandStr} RAW` },
+                rawResult.result!
+            ))
+        }
+
         const response = await RedisConnection.withClient(redisUrl, async (client) => {
             return await client.sendCommand(command)
-        })
+        }, { key: validatedRequest.keyName })
+        timer.recordRedis(response)
 
         if (!response.success || !response.result || !Array.isArray(response.result)) {
             return NextResponse.json(
@@ -42,11 +67,12 @@ export async function POST(request: Request) {
 
         // Convert vector values to floats
         const vector = (response.result as (string | number)[]).map((val: string | number) => parseFloat(String(val)))
+        timer.mark("parse")
 
-        return NextResponse.json({
+        return timer.serialize(() => NextResponse.json({
             success: true,
             result: vector
-        })
+        }))
     } catch (error) {
         console.error("Error in VEMB route:", error)
         return NextResponse.json(
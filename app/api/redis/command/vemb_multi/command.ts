@@ -1,6 +1,7 @@
 import { validateKeyName, validateElement } from '@/lib/redis-server/utils'
 import { VembMultiRequestBody } from '@/lib/redis-server/api'
-import { RedisConnection, RedisOperationResult } from "@/lib/redis-server/RedisConnection"
+import { RedisClient, RedisConnection, RedisOperationResult } from "@/lib/redis-server/RedisConnection"
+import type { RedisCapabilities } from "@/lib/redis-server/capabilities"
 
 export function validateVembMultiRequest(body: any): { isValid: boolean; error?: string; value?: VembMultiRequestBody } {
     if (!validateKeyName(body.keyName)) {
@@ -27,6 +28,7 @@ export function validateVembMultiRequest(body: any): { isValid: boolean; error?:
         value: {
             keyName: body.keyName,
             elements: body.elements,
+            vectorEncoding: body.vectorEncoding === 'binary' ? 'binary' : 'json',
             returnCommandOnly: body.returnCommandOnly === true
         }
     }
@@ -49,6 +51,15 @@ export async function fetchEmbeddingsBatch(
     keyName: string,
     elements: string[]
 ): Promise<RedisOperationResult<(number[] | null)[]>> {
+    // Binary RAW replies are cheaper to read than text, even for JSON callers
+    const capabilities = await RedisConnection.getCapabilities(redisUrl, keyName)
+    if (capabilities.vembRaw) {
+        const raw = await fetchEmbeddingsBatchRaw(redisUrl, keyName, elements)
+        return raw.success && raw.result
+            ? { ...raw, result: raw.result.map((vector) => (vector ? Array.from(vector) : null)) }
+            : { ...raw, result: undefined }
+    }
+
     return RedisConnection.withClient(redisUrl, async (client) => {
         const multi = client.multi()
 
@@ -68,5 +79,121 @@ export async function fetchEmbeddingsBatch(
                 ? item.map((val) => parseFloat(String(val)))
                 : null
         )
+    }, { key: keyName })
+} 
+
+/**
+ * Rebuilds an embedding from a VEMB ... RAW reply:
+ * [quantization type, raw blob, L2 norm, quantization range (int8 only)].
+ * Mirrors how Redis itself dequantizes and de-normalizes for plain VEMB.
+ */
+export function decodeRawEmbedding(reply: unknown): Float32Array | null {
+    if (!Array.isArray(reply) || reply.length < 3) {
+        return null
+    }
+
+    const quantType = String(reply[0])
+    const blob = reply[1] as Buffer
+    const norm = parseFloat(String(reply[2]))
+
+    if (quantType === 'f32') {
+        const vector = new Float32Array(blob.length / 4)
+        for (let i = 0; i < vector.length; i++) {
+            vector[i] = blob.readFloatLE(i * 4) * norm
+        }
+        return vector
+    }
+
+    if (quantType === 'int8') {
+        const scale = (parseFloat(String(reply[3])) / 127) * norm
+        const vector = new Float32Array(blob.length)
+        for (let i = 0; i < vector.length; i++) {
+            vector[i] = blob.readInt8(i) * scale
+        }
+        return vector
+    }
+
+    if (quantType === 'bin') {
+        // Binary vectors are returned as +1/-1 per dimension, without de-normalization.
+        // The blob is padded to whole 64-bit words, so its length only bounds the dimension count
+        const vector = new Float32Array(blob.length * 8)
+        for (let i = 0; i < vector.length; i++) {
+            vector[i] = blob[i >> 3] & (1 << (i & 7)) ? 1 : -1
+        }
+        return vector
+    }
+
+    throw new Error(`Unsupported VEMB RAW quantization type: ${quantType}`)
+}
+
+/**
+ * Reads embeddings with VEMB ... RAW on an already acquired client. Replies
+ * come back as buffers and are decoded straight into Float32Arrays instead
+ * of parsing text per component.
+ */
+export async function readEmbeddingsRaw(
+    client: RedisClient,
+    keyName: string,
+    elements: string[]
+): Promise<(Float32Array | null)[]> {
+    // Commands issued in the same tick are pipelined by the client
+    const replies = await Promise.all(
+        elements.map((id) =>
+            client.sendCommand(["VEMB", keyName, id, "RAW"], {
+                returnBuffers: true,
+            })
+        )
+    )
+
+    // Binary blobs are padded to 64 bits, so trim them to the set's dimension
+    let dimensions: number | undefined
+    if (replies.some((reply) => Array.isArray(reply) && String(reply[0]) === "bin")) {
+        dimensions = Number(await client.sendCommand(["VDIM", keyName]))
+    }
+
+    return replies.map((reply) => {
+        const vector = decodeRawEmbedding(reply)
+        return vector && dimensions && vector.length > dimensions
+            ? vector.subarray(0, dimensions)
+            : vector
     })
-} 
\ No newline at end of file
+}
+
+/**
+ * Reads embeddings as Float32Arrays on an already acquired client: from
+ * VEMB ... RAW when the server has it, else from plain VEMB text
+ */
+export async function readEmbeddings(
+    client: RedisClient,
+    keyName: string,
+    elements: string[],
+    capabilities?: RedisCapabilities
+): Promise<(Float32Array | null)[]> {
+    if (capabilities?.vembRaw !== false) {
+        return readEmbeddingsRaw(client, keyName, elements)
+    }
+    const replies = await Promise.all(
+        elements.map((id) => client.sendCommand(["VEMB", keyName, id]))
+    )
+    return replies.map((reply) =>
+        Array.isArray(reply)
+            ? Float32Array.from(reply, (value) => parseFloat(String(value)))
+            : null
+    )
+}
+
+/**
+ * Same as fetchEmbeddingsBatch, but decodes VEMB ... RAW replies into Float32Arrays
+ */
+export async function fetchEmbeddingsBatchRaw(
+    redisUrl: string,
+    keyName: string,
+    elements: string[]
+): Promise<RedisOperationResult<(Float32Array | null)[]>> {
+    const capabilities = await RedisConnection.getCapabilities(redisUrl, keyName)
+    return RedisConnection.withClient(
+        redisUrl,
+        (client) => readEmbeddings(client, keyName, elements, capabilities),
+        { key: keyName }
+    )
+}
@@ -1,6 +1,6 @@
 import { getRedisUrl } from '@/lib/redis-server/RedisConnection'
-import { validateRequest } from '@/lib/redis-server/utils'
-import { validateVembMultiRequest, buildVembMultiCommand, fetchEmbeddingsBatch } from './command'
+import { formatVectorFrameResponse, validateRequest } from '@/lib/redis-server/utils'
+import { validateVembMultiRequest, buildVembMultiCommand, fetchEmbeddingsBatch, fetchEmbeddingsBatchRaw } from './command'
 import { NextResponse } from 'next/server'
 
 export async function POST(request: Request) {
@@ -29,6 +29,27 @@ export async function POST(request: Request) {
             })
         }
 
+        // Binary clients get FP32 vectors decoded from VEMB RAW, with no text round trip
+        if (validatedRequest.vectorEncoding === 'binary') {
+            const rawResult = await fetchEmbeddingsBatchRaw(
+                redisUrl,
+                validatedRequest.keyName,
+                validatedRequest.elements
+            )
+
+            if (!rawResult.success || !rawResult.result) {
+                return NextResponse.json({
+                    success: false,
+                    error: rawResult.error
+                })
+            }
+
+            return formatVectorFrameResponse(
+                { success: true, result: rawResult.result.map(() => null) },
+                rawResult.result
+            )
+        }
+
         // Use fetchEmbeddingsBatch to get the embeddings
         const embeddingsResult = await fetchEmbeddingsBatch(
             redisUrl,
@@ -33,7 +33,7 @@ export async function POST(request: Request) {
         // Execute command
         const redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
             return await client.sendCommand(commands[0])
-        })
+        }, { key: validatedRequest.keyName })
 
         // Check if the Redis operation itself failed
         if (!redisResult.success) {
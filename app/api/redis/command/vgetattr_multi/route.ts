@@ -36,7 +36,7 @@ export async function POST(request: Request) {
                 multi.addCommand(command)
             }
             return await multi.exec()
-        })
+        }, { key: validatedRequest.keyName })
 
         // Check if the Redis operation itself failed
         if (!redisResult.success) {
@@ -2,9 +2,12 @@ import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection
 import { validateRequest, formatResponse, handleError } from '@/lib/redis-server/utils'
 import { validateVinfoRequest, buildVinfoCommand } from './command'
 import { NextResponse } from 'next/server'
+import { CommandTimer } from '@/lib/server/metrics'
 
 export async function POST(request: Request) {
     try {
+        const timer = new CommandTimer('VINFO')
+
         // Validate request
         const validatedRequest = await validateRequest(request, validateVinfoRequest)
         console.log("Received VINFO request")
@@ -33,7 +36,8 @@ export async function POST(request: Request) {
         // Execute command
         const redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
             return await client.sendCommand(commands[0])
-        })
+        }, { key: validatedRequest.keyName })
+        timer.recordRedis(redisResult)
 
         // Check if the Redis operation itself failed
         if (!redisResult.success) {
@@ -59,11 +63,13 @@ export async function POST(request: Request) {
             }
         }
 
-        return formatResponse({
+        timer.mark('parse')
+
+        return timer.serialize(() => formatResponse({
             success: true,
             result: info,
             executedCommand: commandStr
-        })
+        }))
     } catch (error) {
         return handleError(error)
     }
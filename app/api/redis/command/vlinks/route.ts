@@ -6,6 +6,7 @@ import {
 import { buildVlinksCommand, validateVlinksRequest } from "./command"
 import { validateRequest } from "@/lib/redis-server/utils"
 import { fetchEmbeddingsBatch } from "@/app/api/redis/command/vemb_multi/command"
+import { CommandTimer } from "@/lib/server/metrics"
 
 // Define the types for our links
 type LinkTuple = [string, number];
@@ -15,6 +16,7 @@ type ProcessedResultWithEmb = LinkTupleWithEmb[][];
 
 export async function POST(request: Request) {
     try {
+        const timer = new CommandTimer("VLINKS")
         const validatedRequest = await validateRequest(
             request,
             validateVlinksRequest
@@ -109,9 +111,13 @@ export async function POST(request: Request) {
                         `Failed to get links for element ${element}: ${error}`
                     )
                 }
-            }
+            },
+            { key: keyName }
         )
 
+        // The reply is parsed inside the operation, so it is counted as Redis time
+        timer.recordRedis(response)
+
         if (!response.success || !response.result) {
             return NextResponse.json(
                 { success: false, error: response.error || "No result returned" },
@@ -144,10 +150,13 @@ export async function POST(request: Request) {
             }
         }
 
-        return NextResponse.json({
+        // Parse covers the embedding lookup and merge
+        timer.mark("parse")
+
+        return timer.serialize(() => NextResponse.json({
             success: true,
             result: links,
-        })
+        }))
     } catch (error) {
         console.error("Error in VLINKS API:", error)
         return NextResponse.json(
@@ -0,0 +1,153 @@
+import { validateKeyName, validateElement } from "@/lib/redis-server/utils"
+import { VlinksMultiRequestBody } from "@/lib/redis-server/api"
+import { RedisClient } from "@/lib/redis-server/RedisConnection"
+import type { RedisCapabilities } from "@/lib/redis-server/capabilities"
+import { readEmbeddings } from "@/app/api/redis/command/vemb_multi/command"
+
+export const VLINKS_MULTI_MAX_DEPTH = 3
+// Upper bound on elements expanded per request, so a deep walk cannot fan out unbounded
+export const VLINKS_MULTI_MAX_EXPANDED = 2000
+
+export function validateVlinksMultiRequest(body: any): {
+    isValid: boolean
+    error?: string
+    value?: VlinksMultiRequestBody
+} {
+    if (!validateKeyName(body.keyName)) {
+        return { isValid: false, error: "Key name is required" }
+    }
+
+    if (!Array.isArray(body.elements) || body.elements.length === 0) {
+        return { isValid: false, error: "Elements must be a non-empty array" }
+    }
+
+    for (const element of body.elements) {
+        if (!validateElement(element)) {
+            return { isValid: false, error: `Invalid element in array: ${element}` }
+        }
+    }
+
+    const depth = body.depth === undefined ? 1 : Number(body.depth)
+    if (!Number.isInteger(depth) || depth < 1 || depth > VLINKS_MULTI_MAX_DEPTH) {
+        return {
+            isValid: false,
+            error: `Depth must be an integer between 1 and ${VLINKS_MULTI_MAX_DEPTH}`,
+        }
+    }
+
+    if (body.count !== undefined && (!Number.isInteger(body.count) || body.count < 1)) {
+        return { isValid: false, error: "Count must be a positive integer" }
+    }
+
+    return {
+        isValid: true,
+        value: {
+            keyName: body.keyName,
+            elements: Array.from(new Set<string>(body.elements)),
+            depth,
+            count: body.count,
+            withEmbeddings: body.withEmbeddings === true,
+            knownElements: Array.isArray(body.knownElements)
+                ? body.knownElements.filter(validateElement)
+                : [],
+            vectorEncoding: body.vectorEncoding === "binary" ? "binary" : "json",
+            returnCommandOnly: body.returnCommandOnly === true,
+        },
+    }
+}
+
+// Commands for the first ring; later rings depend on what the first returns
+export function buildVlinksMultiCommands(request: VlinksMultiRequestBody): string[][] {
+    return request.elements.map((element) => [
+        "VLINKS",
+        request.keyName,
+        element,
+        "WITHSCORES",
+    ])
+}
+
+/**
+ * Flattens a VLINKS ... WITHSCORES reply (one element/score list per HNSW
+ * level) into one list with each neighbour once, at its best score, highest
+ * score first. A missing element yields an empty list.
+ */
+export function parseVlinksReply(reply: unknown): [string, number][] {
+    if (!Array.isArray(reply)) return []
+
+    const best = new Map<string, number>()
+    for (const level of reply) {
+        if (!Array.isArray(level)) continue
+        for (let j = 0; j + 1 < level.length; j += 2) {
+            const neighbor = String(level[j])
+            const score = parseFloat(String(level[j + 1]))
+            if (!neighbor || isNaN(score)) continue
+            const current = best.get(neighbor)
+            if (current === undefined || score > current) {
+                best.set(neighbor, score)
+            }
+        }
+    }
+
+    return Array.from(best.entries()).sort((a, b) => b[1] - a[1])
+}
+
+export interface NeighborRings {
+    links: Record<string, [string, number][]>
+    embeddings: [string, Float32Array | null][]
+}
+
+/**
+ * Walks `depth` rings out from the frontier. Each ring is one pipelined
+ * batch of VLINKS (commands issued in the same tick share a round trip),
+ * and the embeddings of everything discovered come back in one more batch.
+ */
+export async function fetchNeighborRings(
+    client: RedisClient,
+    request: VlinksMultiRequestBody,
+    capabilities?: RedisCapabilities
+): Promise<NeighborRings> {
+    const { keyName, count } = request
+    const depth = request.depth ?? 1
+    const links: Record<string, [string, number][]> = {}
+    const seen = new Set<string>(request.elements)
+    let frontier = request.elements
+    let expanded = 0
+
+    for (let ring = 0; ring < depth && frontier.length > 0; ring++) {
+        frontier = frontier.slice(0, VLINKS_MULTI_MAX_EXPANDED - expanded)
+        const replies = await Promise.all(
+            frontier.map((element) =>
+                client.sendCommand(["VLINKS", keyName, element, "WITHSCORES"])
+            )
+        )
+        expanded += frontier.length
+
+        const next: string[] = []
+        frontier.forEach((element, i) => {
+            const neighbors = parseVlinksReply(replies[i])
+            links[element] = count ? neighbors.slice(0, count) : neighbors
+            for (const [neighbor] of links[element]) {
+                if (!seen.has(neighbor)) {
+                    seen.add(neighbor)
+                    next.push(neighbor)
+                }
+            }
+        })
+        frontier = next
+    }
+
+    if (!request.withEmbeddings) {
+        return { links, embeddings: [] }
+    }
+
+    const known = new Set(request.knownElements ?? [])
+    const wanted = Array.from(seen).filter((element) => !known.has(element))
+    const vectors = wanted.length > 0
+        ? await readEmbeddings(client, keyName, wanted, capabilities)
+        : []
+
+    return {
+        links,
+        embeddings: wanted.map((element, i) => [element, vectors[i]]),
+    }
+}
@@ -0,0 +1,92 @@
+import { NextResponse } from "next/server"
+import {
+    RedisConnection,
+    getRedisUrl,
+} from "@/lib/redis-server/RedisConnection"
+import { formatVectorFrameResponse, validateRequest } from "@/lib/redis-server/utils"
+import { VlinksMultiResult } from "@/lib/redis-server/api"
+import { CommandTimer } from "@/lib/server/metrics"
+import {
+    buildVlinksMultiCommands,
+    fetchNeighborRings,
+    validateVlinksMultiRequest,
+} from "./command"
+
+export async function POST(request: Request) {
+    try {
+        const timer = new CommandTimer("VLINKS_MULTI")
+        const validatedRequest = await validateRequest(
+            request,
+            validateVlinksMultiRequest
+        )
+
+        const redisUrl = await getRedisUrl()
+        if (!redisUrl) {
+            return NextResponse.json(
+                { success: false, error: "No Redis connection available" },
+                { status: 401 }
+            )
+        }
+
+        if (validatedRequest.returnCommandOnly) {
+            return NextResponse.json({
+                success: true,
+                executedCommands: buildVlinksMultiCommands(validatedRequest).map(
+                    (command) => command.join(" ")
+                ),
+            })
+        }
+
+        const capabilities = await RedisConnection.getCapabilities(redisUrl, validatedRequest.keyName)
+        const response = await RedisConnection.withClient(redisUrl, (client) =>
+            fetchNeighborRings(client, validatedRequest, capabilities),
+            { key: validatedRequest.keyName }
+        )
+
+        // Reply parsing happens inside the operation, so it is counted as Redis time
+        timer.recordRedis(response)
+
+        if (!response.success || !response.result) {
+            return NextResponse.json(
+                { success: false, error: response.error || "No result returned" },
+                { status: 500 }
+            )
+        }
+
+        const { links, embeddings } = response.result
+
+        if (validatedRequest.vectorEncoding === "binary" && validatedRequest.withEmbeddings) {
+            const header: VlinksMultiResult = {
+                links,
+                embeddings: embeddings.map(([element]) => [element, null]),
+            }
+            return timer.serialize(() => formatVectorFrameResponse(
+                { success: true, result: header },
+                embeddings.map(([, vector]) => vector)
+            ))
+        }
+
+        const result: VlinksMultiResult = {
+            links,
+            embeddings: embeddings.map(([element, vector]) => [
+                element,
+                vector ? Array.from(vector) : null,
+            ]),
+        }
+        timer.mark("parse")
+
+        return timer.serialize(() => NextResponse.json({
+            success: true,
+            result,
+        }))
+    } catch (error) {
+        console.error("Error in VLINKS_MULTI API:", error)
+        return NextResponse.json(
+            {
+                success: false,
+                error: error instanceof Error ? error.message : String(error),
+            },
+            { status: 500 }
+        )
+    }
+}
@@ -36,7 +36,8 @@ export async function POST(request: Request) {
             redisUrl,
             async (client) => {
                 return await client.sendCommand(command)
-            }
+            },
+            { key: validatedRequest.keyName }
         )
 
         if (
@@ -2,6 +2,7 @@ import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection
 import { validateRequest, formatResponse, handleError } from '@/lib/redis-server/utils'
 import { validateVremRequest, buildVremCommand } from './command'
 import { NextResponse } from 'next/server'
+import { invalidateVectorSet } from '@/lib/server/vsim-cache'
 
 export async function POST(request: Request) {
     try {
@@ -46,7 +47,8 @@ export async function POST(request: Request) {
                 // Single element removal
                 return await client.sendCommand(commands[0])
             }
-        })
+        }, { key: validatedRequest.keyName })
+        invalidateVectorSet(redisUrl, validatedRequest.keyName)
 
         // Check if the Redis operation itself failed
         if (!redisResult.success) {
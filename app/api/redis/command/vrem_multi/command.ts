@@ -0,0 +1,33 @@
+import { validateKeyName, validateElement } from '@/lib/redis-server/utils'
+import { VremMultiRequestBody, MULTI_ELEMENT_LIMIT } from '@/lib/redis-server/api'
+
+export function validateVremMultiRequest(body: any): { isValid: boolean; error?: string; value?: VremMultiRequestBody } {
+    if (!validateKeyName(body.keyName)) {
+        return { isValid: false, error: 'Key name is required' }
+    }
+
+    if (!Array.isArray(body.elements) || body.elements.length === 0) {
+        return { isValid: false, error: 'Elements must be a non-empty array' }
+    }
+    if (body.elements.length > MULTI_ELEMENT_LIMIT) {
+        return { isValid: false, error: `At most ${MULTI_ELEMENT_LIMIT} elements per request; use a bulk edit job for more` }
+    }
+    for (const element of body.elements) {
+        if (!validateElement(element)) {
+            return { isValid: false, error: `Invalid element in array: ${element}` }
+        }
+    }
+
+    return {
+        isValid: true,
+        value: {
+            keyName: body.keyName,
+            elements: body.elements,
+            returnCommandOnly: body.returnCommandOnly === true
+        }
+    }
+}
+
+export function buildVremMultiCommand(request: VremMultiRequestBody): string[][] {
+    return request.elements.map(element => ['VREM', request.keyName, element])
+}
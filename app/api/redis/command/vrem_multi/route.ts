@@ -0,0 +1,68 @@
+import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection'
+import { validateRequest, formatResponse, handleError, sendPipelined } from '@/lib/redis-server/utils'
+import { validateVremMultiRequest, buildVremMultiCommand } from './command'
+import { NextResponse } from 'next/server'
+import { invalidateVectorSet } from '@/lib/server/vsim-cache'
+
+// Removes many elements in pipelined chunks rather than one MULTI, so a large
+// selection neither blocks the server nor fails as a whole on one bad element
+export async function POST(request: Request) {
+    try {
+        // Validate request
+        const validatedRequest = await validateRequest(request, validateVremMultiRequest)
+        console.log("Received VREM_MULTI request", validatedRequest.elements.length)
+
+        // Get Redis URL
+        const redisUrl = await getRedisUrl()
+        if (!redisUrl) {
+            return NextResponse.json(
+                { success: false, error: 'No Redis connection available' },
+                { status: 401 }
+            )
+        }
+
+        const commands = buildVremMultiCommand(validatedRequest)
+        const commandStr = commands.map(cmd => cmd.join(' ')).join('\n')
+
+        // If returnCommandOnly is true, return just the commands
+        if (validatedRequest.returnCommandOnly) {
+            return NextResponse.json({
+                success: true,
+                executedCommand: commandStr
+            })
+        }
+
+        // Execute commands
+        const redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
+            return await sendPipelined(client, commands)
+        }, { key: validatedRequest.keyName, lane: 'bulk' })
+        invalidateVectorSet(redisUrl, validatedRequest.keyName)
+
+        // Check if the Redis operation itself failed
+        if (!redisResult.success) {
+            return formatResponse(redisResult)
+        }
+
+        // Each reply is 1 if the element was removed, 0 if it did not exist, or an Error
+        const replies = redisResult.result as unknown[]
+        const results = replies.map((reply, index) => ({
+            element: validatedRequest.elements[index],
+            removed: reply === 1,
+            error: reply instanceof Error ? reply.message : undefined
+        }))
+        const successCount = results.filter(result => result.removed).length
+
+        return formatResponse({
+            success: successCount > 0, // Consider partial success as success
+            result: {
+                totalElements: validatedRequest.elements.length,
+                successfulRemovals: successCount,
+                results
+            },
+            executedCommand: commandStr,
+            error: successCount === 0 ? 'No elements were removed' : undefined
+        })
+    } catch (error) {
+        return handleError(error)
+    }
+}
@@ -2,6 +2,7 @@ import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection
 import { validateRequest, formatResponse, handleError } from '@/lib/redis-server/utils'
 import { validateVsetattrRequest, buildVsetattrCommand } from './command'
 import { NextResponse } from 'next/server'
+import { invalidateVectorSet } from '@/lib/server/vsim-cache'
 
 export async function POST(request: Request) {
     try {
@@ -34,7 +35,8 @@ export async function POST(request: Request) {
         // Execute command
         const redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
             return await client.sendCommand(command)
-        })
+        }, { key: validatedRequest.keyName })
+        invalidateVectorSet(redisUrl, validatedRequest.keyName)
 
         // Check if the Redis operation itself failed
         if (!redisResult.success) {
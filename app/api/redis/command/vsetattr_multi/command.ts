@@ -0,0 +1,48 @@
+import { validateKeyName, validateElement } from '@/lib/redis-server/utils'
+import { VsetAttrMultiRequestBody, MULTI_ELEMENT_LIMIT } from '@/lib/redis-server/api'
+
+export function validateVsetattrMultiRequest(body: any): { isValid: boolean; error?: string; value?: VsetAttrMultiRequestBody } {
+    if (!validateKeyName(body.keyName)) {
+        return { isValid: false, error: 'Key name is required' }
+    }
+
+    if (!Array.isArray(body.updates) || body.updates.length === 0) {
+        return { isValid: false, error: 'Updates must be a non-empty array' }
+    }
+    if (body.updates.length > MULTI_ELEMENT_LIMIT) {
+        return { isValid: false, error: `At most ${MULTI_ELEMENT_LIMIT} updates per request; use a bulk edit job for more` }
+    }
+
+    for (const update of body.updates) {
+        if (!update || !validateElement(update.element)) {
+            return { isValid: false, error: 'Every update needs an element' }
+        }
+        // Attributes must be a JSON string; an empty string clears them
+        if (typeof update.attributes !== 'string') {
+            return { isValid: false, error: `Attributes for ${update.element} must be a JSON string` }
+        }
+        if (update.attributes !== '') {
+            try {
+                JSON.parse(update.attributes)
+            } catch (_e) {
+                return { isValid: false, error: `Attributes for ${update.element} must be a valid JSON string` }
+            }
+        }
+    }
+
+    return {
+        isValid: true,
+        value: {
+            keyName: body.keyName,
+            updates: body.updates.map((update: any) => ({
+                element: update.element,
+                attributes: update.attributes
+            })),
+            returnCommandOnly: body.returnCommandOnly === true
+        }
+    }
+}
+
+export function buildVsetattrMultiCommand(request: VsetAttrMultiRequestBody): string[][] {
+    return request.updates.map(update => ['VSETATTR', request.keyName, update.element, update.attributes])
+}
@@ -0,0 +1,66 @@
+import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection'
+import { validateRequest, formatResponse, handleError, sendPipelined } from '@/lib/redis-server/utils'
+import { validateVsetattrMultiRequest, buildVsetattrMultiCommand } from './command'
+import { NextResponse } from 'next/server'
+import { invalidateVectorSet } from '@/lib/server/vsim-cache'
+
+export async function POST(request: Request) {
+    try {
+        // Validate request
+        const validatedRequest = await validateRequest(request, validateVsetattrMultiRequest)
+        console.log("Received VSETATTR_MULTI request", validatedRequest.updates.length)
+
+        // Get Redis URL
+        const redisUrl = await getRedisUrl()
+        if (!redisUrl) {
+            return NextResponse.json(
+                { success: false, error: 'No Redis connection available' },
+                { status: 401 }
+            )
+        }
+
+        const commands = buildVsetattrMultiCommand(validatedRequest)
+        const commandStr = commands.map(cmd => cmd.join(' ')).join('\n')
+
+        // If returnCommandOnly is true, return just the commands
+        if (validatedRequest.returnCommandOnly) {
+            return NextResponse.json({
+                success: true,
+                executedCommand: commandStr
+            })
+        }
+
+        // Execute commands in pipelined chunks
+        const redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
+            return await sendPipelined(client, commands)
+        }, { key: validatedRequest.keyName, lane: 'bulk' })
+        invalidateVectorSet(redisUrl, validatedRequest.keyName)
+
+        // Check if the Redis operation itself failed
+        if (!redisResult.success) {
+            return formatResponse(redisResult)
+        }
+
+        // VSETATTR returns 1 if the attributes were set, 0 if the element doesn't exist
+        const replies = redisResult.result as unknown[]
+        const results = replies.map((reply, index) => ({
+            element: validatedRequest.updates[index].element,
+            updated: reply === 1,
+            error: reply instanceof Error ? reply.message : undefined
+        }))
+        const successCount = results.filter(result => result.updated).length
+
+        return formatResponse({
+            success: successCount > 0, // Consider partial success as success
+            result: {
+                totalElements: validatedRequest.updates.length,
+                successfulUpdates: successCount,
+                results
+            },
+            executedCommand: commandStr,
+            error: successCount === 0 ? 'No attributes were updated' : undefined
+        })
+    } catch (error) {
+        return handleError(error)
+    }
+}
@@ -1,5 +1,6 @@
 import { validateKeyName, vectorToFp32Buffer } from '@/lib/redis-server/utils'
 import { VsimRequestBody } from '@/lib/redis-server/api'
+import type { RedisCapabilities } from '@/lib/redis-server/capabilities'
 
 export function validateVsimRequest(body: any): { isValid: boolean; error?: string; value?: VsimRequestBody } {
     if (!validateKeyName(body.keyName)) {
@@ -63,17 +64,20 @@ export function validateVsimRequest(body: any): { isValid: boolean; error?: stri
             withAttribs: body.withAttribs === true,
             forceLinearScan: body.forceLinearScan === true,
             noThread: body.noThread === true,
-            vectorFormat: body.vectorFormat || 'FP32' // Default to FP32 for backward compatibility
+            vectorFormat: body.vectorFormat || 'FP32', // Default to FP32 for backward compatibility
+            vectorEncoding: body.vectorEncoding === 'binary' ? 'binary' : 'json'
         }
     }
 }
 
-export function buildVsimCommand(request: VsimRequestBody): (string | Buffer)[][] {
+// With capabilities, options the server lacks are left out (or swapped for
+// their older form) rather than sent and rejected
+export function buildVsimCommand(request: VsimRequestBody, capabilities?: RedisCapabilities): (string | Buffer)[][] {
     const baseCommand: (string | Buffer)[] = ["VSIM", request.keyName]
 
     if (request.searchVector) {
         // Support both FP32 and VALUES formats
-        if (request.vectorFormat === 'VALUES') {
+        if (request.vectorFormat === 'VALUES' || capabilities?.fp32 === false) {
             baseCommand.push(
                 "VALUES",
                 request.searchVector.length.toString(),
@@ -95,8 +99,8 @@ export function buildVsimCommand(request: VsimRequestBody): (string | Buffer)[][
     // Always add WITHSCORES for consistent result format
     baseCommand.push("WITHSCORES")
 
-    // Add WITHATTRIBS if requested
-    if (request.withAttribs) {
+    // Add WITHATTRIBS if requested; without it the route reads attributes with VGETATTR
+    if (request.withAttribs && capabilities?.withAttribs !== false) {
         baseCommand.push("WITHATTRIBS")
     }
 
@@ -109,8 +113,7 @@ export function buildVsimCommand(request: VsimRequestBody): (string | Buffer)[][
     }
     
     // Add filterExplorationFactor if provided
-    if (request.filterExplorationFactor && request.filterExplorationFactor > 0) {
-        console.log("FILTER-EF", String(request.filterExplorationFactor))
+    if (request.filterExplorationFactor && request.filterExplorationFactor > 0 && capabilities?.filterEf !== false) {
         baseCommand.push("FILTER-EF", String(request.filterExplorationFactor))
     }
 
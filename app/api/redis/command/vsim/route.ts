@@ -1,16 +1,30 @@
 import { NextResponse } from 'next/server'
-import { RedisConnection, getRedisUrl } from '@/lib/redis-server/RedisConnection'
+import { RedisConnection, RedisOperationResult, getRedisUrl } from '@/lib/redis-server/RedisConnection'
 import { validateVsimRequest, buildVsimCommand } from './command'
-import { formatResponse } from '@/lib/redis-server/utils'
-import { fetchEmbeddingsBatch } from '@/app/api/redis/command/vemb_multi/command'
+import { formatResponse, formatVectorFrameResponse, sendPipelined } from '@/lib/redis-server/utils'
+import { isUnsupportedError } from '@/lib/redis-server/capabilities'
+import { fetchEmbeddingsBatch, fetchEmbeddingsBatchRaw } from '@/app/api/redis/command/vemb_multi/command'
+import { EmbeddingVector } from '@/lib/redis-server/api'
+import { CommandTimer } from '@/lib/server/metrics'
+import { dropCachedVsim, getCachedVsim, runVsimOnce, vsimRequestKey } from '@/lib/server/vsim-cache'
 
 type SimPair = [string, number];
-type SimPairWithEmb = [string, number, number[] | null];
-type SimPairWithAttribs = [string, number, number[] | null, string | null];
-
-export async function POST(request: Request) {
+type SimPairWithEmb = [string, number, EmbeddingVector | null];
+type SimPairWithAttribs = [string, number, EmbeddingVector | null, string | null];
+
+type VsimOutcome =
+    | { success: false; redisResult: RedisOperationResult<unknown> }
+    | {
+          success: true
+          finalResult: SimPair[] | SimPairWithEmb[] | SimPairWithAttribs[]
+          fallbackUsed: boolean
+          executionTimeMs?: number
+      }
+
+export async function POST(req: Request) {
     try {
-        const body = await request.json()
+        const timer = new CommandTimer('VSIM')
+        const body = await req.json()
 
         const validationResult = validateVsimRequest(body)
         if (!validationResult.isValid || !validationResult.value) {
@@ -29,9 +43,20 @@ export async function POST(request: Request) {
             )
         }
 
-        const command = buildVsimCommand(validationResult.value)
+        const request = validationResult.value
+
+        // Options the server lacks are left out up front, so a search costs one VSIM
+        const capabilities = await RedisConnection.getCapabilities(redisUrl, request.keyName)
+        const command = buildVsimCommand(request, capabilities)
 
-        if (validationResult.value.returnCommandOnly) {
+        // Binary clients get embeddings decoded from VEMB RAW and sent as FP32
+        const binaryVectors = request.vectorEncoding === 'binary'
+        const fetchEmbeddings = (elements: string[]): Promise<RedisOperationResult<(EmbeddingVector | null)[]>> =>
+            binaryVectors
+                ? fetchEmbeddingsBatchRaw(redisUrl, request.keyName, elements)
+                : fetchEmbeddingsBatch(redisUrl, request.keyName, elements)
+
+        if (request.returnCommandOnly) {
             return NextResponse.json({ command })
         }
 
@@ -39,156 +64,154 @@ export async function POST(request: Request) {
             .map((arg) => (arg instanceof Buffer ? '<binary>' : String(arg)))
             .join(' ')
 
-        let redisResult: any
-        let useWithAttribs = validationResult.value.withAttribs
-        let fallbackUsed = false
-
-        // Try VSIM with WITHATTRIBS if requested
-        if (useWithAttribs) {
-            try {
-                redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
-                    return await client.sendCommand(command[0])
-                })
-
-                // If WITHATTRIBS failed, we'll fallback to the original method
-                if (!redisResult.success) {
-                    console.log('VSIM with WITHATTRIBS failed, falling back to original method')
-                    useWithAttribs = false
-                    fallbackUsed = true
-                }
-            } catch (error) {
-                console.log('VSIM with WITHATTRIBS threw error, falling back to original method:', error)
-                useWithAttribs = false
-                fallbackUsed = true
-            }
-        }
+        const requestKey = vsimRequestKey(redisUrl, request.keyName, command[0], {
+            withEmbeddings: request.withEmbeddings,
+            withAttribs: request.withAttribs,
+            vectorEncoding: request.vectorEncoding,
+        })
 
-        // If not using WITHATTRIBS or fallback is needed, use original command
-        if (!useWithAttribs) {
-            console.log('VSIM: Using fallback method (no WITHATTRIBS)' + (fallbackUsed ? ' - WITHATTRIBS failed' : ''))
-            // Build command without WITHATTRIBS
-            const fallbackRequest = { ...validationResult.value, withAttribs: false }
-            const fallbackCommand = buildVsimCommand(fallbackRequest)
-            
-            redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
-                return await client.sendCommand(fallbackCommand[0])
-            })
+        // VCARD is sent alongside the search (same round trip) so a cached result can be validated later
+        let card: number | null = null
+        const sendWithCard = async (client: any, args: (string | Buffer)[]) => {
+            const [reply, vcard] = await Promise.all([
+                client.sendCommand(args),
+                client.sendCommand(['VCARD', request.keyName]),
+            ])
+            card = Number(vcard)
+            return reply
         }
 
-        // Check if the Redis operation failed
-        if (!redisResult.success) {
-            return formatResponse(redisResult)
-        }
+        const search = async (): Promise<{ value: VsimOutcome; card: number | null }> => {
+            let nativeAttribs = request.withAttribs && capabilities.withAttribs
+            let fallbackUsed = request.withAttribs && !nativeAttribs
 
-        // Process the result based on whether WITHATTRIBS was used
-        let finalResult: SimPair[] | SimPairWithEmb[] | SimPairWithAttribs[]
+            let redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
+                return await sendWithCard(client, command[0])
+            }, { key: request.keyName })
 
-        if (useWithAttribs) {
-            // WITHATTRIBS returns: element, score, attributes, element, score, attributes, ...
-            // The format is: [elem1, score1, attr1, elem2, score2, attr2, ...]
-            const resultArray = redisResult.result as any[]
-            const pairsWithAttribs: SimPairWithAttribs[] = []
-            
-            // Parse every 3 items: element, score, attributes
-            for (let i = 0; i < resultArray.length; i += 3) {
-                if (i + 2 < resultArray.length) {
-                    const element = resultArray[i] as string
-                    const score = parseFloat(resultArray[i + 1] as string)
-                    const attributes = resultArray[i + 2] // Can be null or string
-                    
-                    pairsWithAttribs.push([
-                        element, 
-                        score, 
-                        null, // embedding will be filled later if needed
-                        attributes
-                    ])
-                }
+            // Capabilities that were assumed rather than probed can be wrong once;
+            // remember the rejection so later searches build the right command
+            if (!redisResult.success && nativeAttribs && isUnsupportedError(redisResult.error)) {
+                console.log('VSIM: server rejected WITHATTRIBS, reading attributes with VGETATTR from now on')
+                await RedisConnection.markUnsupported(redisUrl, request.keyName, 'withAttribs')
+                nativeAttribs = false
+                fallbackUsed = true
+                const fallbackCommand = buildVsimCommand({ ...request, withAttribs: false }, capabilities)
+                redisResult = await RedisConnection.withClient(redisUrl, async (client) => {
+                    return await sendWithCard(client, fallbackCommand[0])
+                }, { key: request.keyName })
             }
 
-            finalResult = pairsWithAttribs
+            timer.recordRedis(redisResult)
 
-            // If withEmbeddings is also requested, fetch them
-            if (validationResult.value.withEmbeddings) {
-                const elements = pairsWithAttribs.map(([element]) => element)
-                const embResults = await fetchEmbeddingsBatch(redisUrl, validationResult.value.keyName, elements)
+            // Check if the Redis operation failed
+            if (!redisResult.success) {
+                return { value: { success: false, redisResult }, card: null }
+            }
 
-                if (embResults.success && embResults.result) {
-                    finalResult = finalResult.map(([element, score, , attributes], index): SimPairWithAttribs => 
-                        [element, score, embResults.result![index], attributes]
-                    )
-                }
+            // WITHATTRIBS replies element, score, attributes, ...; otherwise element, score, ...
+            const resultArray = redisResult.result as any[]
+            const stride = nativeAttribs ? 3 : 2
+            const elements: string[] = []
+            const scores: number[] = []
+            let attributes: (string | null)[] | null = nativeAttribs ? [] : null
+            for (let i = 0; i + stride - 1 < resultArray.length; i += stride) {
+                elements.push(String(resultArray[i]))
+                scores.push(parseFloat(String(resultArray[i + 1])))
+                attributes?.push(resultArray[i + 2] ?? null)
             }
-        } else {
-            // Original method: pairs of [element, score]
-            const pairs: SimPair[] = []
-            const resultArray = redisResult.result as string[]
-            for (let i = 0; i < resultArray.length; i += 2) {
-                pairs.push([resultArray[i], parseFloat(resultArray[i + 1])])
+
+            // Attributes the server could not return inline, and embeddings, are read in parallel
+            const [attributeResult, embResults] = await Promise.all([
+                request.withAttribs && !nativeAttribs && elements.length > 0
+                    ? RedisConnection.withClient(redisUrl, async (client) => {
+                        const replies = await sendPipelined(
+                            client,
+                            elements.map((element) => ['VGETATTR', request.keyName, element])
+                        )
+                        return replies.map((reply) => (typeof reply === 'string' ? reply : null))
+                    }, { key: request.keyName })
+                    : null,
+                request.withEmbeddings && elements.length > 0 ? fetchEmbeddings(elements) : null,
+            ])
+            if (attributeResult?.success && attributeResult.result) {
+                attributes = attributeResult.result
             }
+            const embeddings = embResults?.success && embResults.result ? embResults.result : null
 
-            // If attributes are requested but WITHATTRIBS wasn't used, fetch them separately
-            if (validationResult.value.withAttribs || validationResult.value.withEmbeddings) {
-                const elements = pairs.map(([element]) => element)
-                
-                // Fetch attributes if requested (or if fallback was used)
-                let attributes: (string | null)[] | null = null
-                if (validationResult.value.withAttribs || fallbackUsed) {
-                    console.log("VSIM fallback: fetching attributes with VGETATTR_MULTI")
-                    const { vgetattr_multi } = await import('@/lib/redis-server/api')
-                    const attrResponse = await vgetattr_multi({
-                        keyName: validationResult.value.keyName,
-                        elements,
-                        returnCommandOnly: false,
-                    })
-                    
-                    if (attrResponse.success && attrResponse.result) {
-                        attributes = attrResponse.result
-                    }
-                }
-
-                // Fetch embeddings if requested
-                let embeddings: (number[] | null)[] | null = null
-                if (validationResult.value.withEmbeddings) {
-                    console.log("VSIM fallback: GET embeddings")
-                    const embResults = await fetchEmbeddingsBatch(redisUrl, validationResult.value.keyName, elements)
-                    if (embResults.success && embResults.result) {
-                        embeddings = embResults.result
-                    }
-                }
-
-                // Build final result with both attributes and embeddings as needed
-                finalResult = pairs.map(([element, score], index): SimPairWithAttribs => [
-                    element, 
-                    score, 
+            let finalResult: SimPair[] | SimPairWithEmb[] | SimPairWithAttribs[]
+            if (request.withAttribs) {
+                finalResult = elements.map((element, index): SimPairWithAttribs => [
+                    element,
+                    scores[index],
                     embeddings ? embeddings[index] : null,
-                    attributes ? attributes[index] : null
+                    attributes ? attributes[index] : null,
+                ])
+            } else if (embeddings) {
+                finalResult = elements.map((element, index): SimPairWithEmb => [
+                    element,
+                    scores[index],
+                    embeddings[index],
                 ])
             } else {
-                // Just embeddings requested
-                if (validationResult.value.withEmbeddings) {
-                    console.log("VSIM GET embeddings")
-                    const elements = pairs.map(([element]) => element)
-                    const embResults = await fetchEmbeddingsBatch(redisUrl, validationResult.value.keyName, elements)
-
-                    if (embResults.success && embResults.result) {
-                        finalResult = pairs.map(([element, score], index): SimPairWithEmb => 
-                            [element, score, embResults.result![index]]
-                        )
-                    } else {
-                        finalResult = pairs
-                    }
-                } else {
-                    finalResult = pairs
-                }
+                finalResult = elements.map((element, index): SimPair => [element, scores[index]])
+            }
+
+            timer.mark('parse')
+            return {
+                value: { success: true, finalResult, fallbackUsed, executionTimeMs: redisResult.executionTimeMs },
+                card,
+            }
+        }
+
+        let outcome: VsimOutcome | null = null
+
+        // A recent identical search is reused if the set's size has not changed since
+        const cached = getCachedVsim<VsimOutcome>(redisUrl, request.keyName, requestKey)
+        if (cached) {
+            const cardResult = await RedisConnection.withClient(redisUrl, async (client) => {
+                return Number(await client.sendCommand(['VCARD', request.keyName]))
+            }, { key: request.keyName })
+            timer.recordRedis(cardResult)
+            if (cardResult.success && cardResult.result === cached.card) {
+                outcome = cached.value
+            } else {
+                dropCachedVsim(requestKey)
             }
         }
 
-        return formatResponse({
+        // Concurrent identical searches share one execution
+        if (!outcome) {
+            outcome = await runVsimOnce(redisUrl, request.keyName, requestKey, search)
+        }
+
+        if (!outcome.success) {
+            return formatResponse(outcome.redisResult)
+        }
+
+        const { finalResult, fallbackUsed, executionTimeMs } = outcome
+
+        if (binaryVectors && request.withEmbeddings) {
+            // Embeddings were requested, so every tuple carries a vector slot
+            const tuples = finalResult as (SimPairWithEmb | SimPairWithAttribs)[]
+            const vectors = tuples.map((pair) => (pair[2] ?? null) as Float32Array | null)
+            return timer.serialize(() => formatVectorFrameResponse(
+                {
+                    success: true,
+                    result: tuples.map(([element, score, , ...rest]) => [element, score, null, ...rest]),
+                    executedCommand: commandStr + (fallbackUsed ? ' (fallback used)' : ''),
+                    executionTimeMs
+                },
+                vectors
+            ))
+        }
+
+        return timer.serialize(() => formatResponse({
             success: true,
             result: finalResult,
             executedCommand: commandStr + (fallbackUsed ? ' (fallback used)' : ''),
-            executionTimeMs: redisResult.executionTimeMs
-        })
+            executionTimeMs
+        }))
 
     } catch (error) {
         console.error('Error in VSIM route:', error)
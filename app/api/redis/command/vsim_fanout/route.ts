@@ -0,0 +1,70 @@
+import { NextResponse } from 'next/server'
+import { getRedisUrl } from '@/lib/redis-server/RedisConnection'
+import { fanoutVsim, resolveShardKeys } from '@/lib/server/shards'
+import { validateVsimRequest } from '../vsim/command'
+
+// POST /api/redis/command/vsim_fanout - VSIM over every shard of a logical set,
+// merged into one top-k. Shards are given as `keys`, or found from `keyName`
+export async function POST(request: Request) {
+    try {
+        const body = await request.json()
+
+        const redisUrl = await getRedisUrl()
+        if (!redisUrl) {
+            return NextResponse.json(
+                { success: false, error: 'Redis connection not available' },
+                { status: 401 }
+            )
+        }
+
+        let keys: string[] | undefined = body.keys
+        if (keys !== undefined && (!Array.isArray(keys) || keys.some((key) => typeof key !== 'string' || !key))) {
+            return NextResponse.json(
+                { success: false, error: 'keys must be a list of key names' },
+                { status: 400 }
+            )
+        }
+        if (!keys || keys.length === 0) {
+            if (typeof body.keyName !== 'string' || !body.keyName) {
+                return NextResponse.json(
+                    { success: false, error: 'Either keys or keyName is required' },
+                    { status: 400 }
+                )
+            }
+            keys = await resolveShardKeys(redisUrl, body.keyName)
+            if (keys.length === 0) {
+                return NextResponse.json(
+                    { success: false, error: `No shards found for ${body.keyName}` },
+                    { status: 404 }
+                )
+            }
+        }
+
+        const validationResult = validateVsimRequest({ ...body, keyName: keys[0] })
+        if (!validationResult.isValid || !validationResult.value) {
+            return NextResponse.json(
+                { success: false, error: validationResult.error },
+                { status: 400 }
+            )
+        }
+
+        const { keyName: _keyName, returnCommandOnly: _commandOnly, withEmbeddings: _withEmbeddings, ...search } =
+            validationResult.value
+        const startTime = performance.now()
+        const result = await fanoutVsim(redisUrl, { ...search, keys })
+        const failed = result.shards.every((shard) => shard.error)
+
+        return NextResponse.json({
+            success: !failed,
+            result,
+            error: failed ? result.shards[0]?.error : undefined,
+            executionTimeMs: performance.now() - startTime,
+        })
+    } catch (error) {
+        console.error('[vsim_fanout] Error:', error)
+        return NextResponse.json(
+            { success: false, error: error instanceof Error ? error.message : String(error) },
+            { status: 500 }
+        )
+    }
+}
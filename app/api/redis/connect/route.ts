@@ -39,13 +39,18 @@ export async function POST(request: Request) {
             );
         }
 
+        // What is known of the server's vector set commands. The probe itself
+        // writes a short-lived set, so it runs with the first write instead
+        const capabilities = await RedisConnection.getCapabilities(url);
+
         // Set the cookie with the Redis URL
         (await cookies()).set(REDIS_URL_COOKIE, url, COOKIE_OPTIONS);
         
         return NextResponse.json({ 
             success: true,
             message: "Connected successfully",
-            url 
+            url,
+            capabilities
         });
     } catch (error) {
         console.error("Redis connection error:", error);
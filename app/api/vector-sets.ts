@@ -1,4 +1,4 @@
-import { VectorSetMetadata } from '@/lib/types/vectors';
+import { VectorSetCatalogEntry, VectorSetMetadata } from '@/lib/types/vectors';
 import { apiClient } from './client';
 
 // Vector set management types
@@ -28,6 +28,22 @@ export const vectorSets = {
         return response.result || null
     },
 
+    // Every vector set with its info and metadata, in one request
+    async catalog(refresh = false): Promise<VectorSetCatalogEntry[]> {
+        const response = await apiClient.get<VectorSetCatalogEntry[]>(
+            `/api/vectorset/catalog${refresh ? "?refresh=1" : ""}`
+        );
+        return response.result || []
+    },
+
+    // Info and metadata of one set, or null if it does not exist
+    async getInfo(name: string): Promise<VectorSetCatalogEntry | null> {
+        const response = await apiClient.get<(VectorSetCatalogEntry | null)[]>(
+            `/api/vectorset/catalog?name=${encodeURIComponent(name)}`
+        );
+        return response.result?.[0] ?? null
+    },
+
     async create(request: VectorSetCreateRequestBody
     ): Promise<void> {
         const encodedName = encodeURIComponent(request.name)
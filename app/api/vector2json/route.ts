@@ -30,8 +30,8 @@ export async function POST(request: Request) {
             await mkdir(publicDir, { recursive: true })
         }
         
-        // Save the file
-        await writeFile(filePath, JSON.stringify(data, null, 2))
+        // Save the file (compact; pretty-printing roughly doubles the size of vector data)
+        await writeFile(filePath, JSON.stringify(data))
         console.log(`[vector2json] Successfully saved file to: ${filePath}`)
         
         // Return the public URL path
@@ -0,0 +1,36 @@
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import { measureVectorSet } from "@/lib/server/memory-profile"
+
+// GET /api/vectorset/[setname]/memory - MEMORY USAGE and VINFO of a set,
+// compared with the memory model's estimate
+export async function GET(
+    _req: NextRequest,
+    { params }: any //{ params: { setname: string } }
+) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    try {
+        const { setname } = await params
+        const measurement = await measureVectorSet(redisUrl, setname)
+        if (!measurement) {
+            return NextResponse.json(
+                { success: false, error: `Vector set ${setname} not found` },
+                { status: 404 }
+            )
+        }
+        return NextResponse.json({ success: true, result: measurement })
+    } catch (error) {
+        console.error("Error measuring vector set memory:", error)
+        return NextResponse.json(
+            { success: false, error: error instanceof Error ? error.message : String(error) },
+            { status: 500 }
+        )
+    }
+}
@@ -3,6 +3,7 @@ import {
     RedisConnection,
     getRedisUrl,
 } from "@/lib/redis-server/RedisConnection"
+import { setCatalogMetadata } from "@/lib/server/vectorset-catalog"
 import { NextRequest, NextResponse } from "next/server"
 
 // type Params = { params: { setname: string } }
@@ -65,7 +66,8 @@ export async function GET(
                     )
                     throw error
                 }
-            }
+            },
+            { key: "vector-set-browser:config" }
         )
 
         if (!response || !response.success) {
@@ -135,7 +137,8 @@ export async function PUT(
                     [hashKey]: JSON.stringify(metadata),
                 })
                 return true
-            }
+            },
+            { key: "vector-set-browser:config" }
         )
 
         if (!response.success) {
@@ -144,6 +147,7 @@ export async function PUT(
                 { status: 500 }
             )
         }
+        setCatalogMetadata(redisUrl, keyName, metadata)
 
         return NextResponse.json({
             success: true,
@@ -1,10 +1,12 @@
 import { VectorSetCreateRequestBody } from "@/app/api/vector-sets"
-import { EmbeddingService } from "@/lib/embeddings/service"
+import { getEmbeddingService } from "@/lib/embeddings/service"
 import { getExpectedDimensions } from "@/lib/embeddings/types/embeddingModels"
 import {
     RedisConnection,
     getRedisUrl,
 } from "@/lib/redis-server/RedisConnection"
+import { vectorToFp32Buffer } from "@/lib/redis-server/utils"
+import { invalidateVectorSet } from "@/lib/server/vsim-cache"
 import { NextRequest, NextResponse } from "next/server"
 
 // POST /api/vectorset/[setname] - Create a new vector set
@@ -45,6 +47,68 @@ export async function POST(
             )
         }
 
+        // Resolved before leasing a connection: a test embedding reads the
+        // embedding cache through the same pool
+        let effectiveDimensions = dimensions
+
+        // If dimensions is not specified or zero, try to determine from metadata and/or embedding service
+        if (!dimensions || dimensions < 2) {
+            // First, try to get dimensions from metadata directly
+            if (metadata?.dimensions && metadata.dimensions >= 2) {
+                effectiveDimensions = metadata.dimensions
+                console.log(
+                    `Using dimensions from metadata: ${effectiveDimensions}`
+                )
+            }
+            // If not available in metadata, try to determine from embedding configuration
+            else if (metadata?.embedding) {
+                try {
+                    // Try to get expected dimensions from config
+                    const expectedDimensions = getExpectedDimensions(
+                        metadata.embedding
+                    )
+
+                    if (expectedDimensions >= 2) {
+                        effectiveDimensions = expectedDimensions
+                        console.log(
+                            `Using dimensions from config: ${effectiveDimensions}`
+                        )
+                    } else {
+                        // If can't determine from config, use EmbeddingService to get a test embedding
+                        const embeddingService = getEmbeddingService()
+                        console.log(
+                            "Getting dimensions from EmbeddingService"
+                        )
+                        console.log(
+                            "metadata.embedding",
+                            metadata.embedding
+                        )
+
+                        // Get a test embedding to determine dimensions
+                        const testEmbedding =
+                            await embeddingService.getEmbedding(
+                                "test",
+                                metadata.embedding
+                            )
+                        effectiveDimensions = testEmbedding.length
+                        console.log(
+                            `Determined dimensions using test embedding: ${effectiveDimensions}`
+                        )
+                    }
+                } catch (error) {
+                    throw new Error(
+                        `Failed to determine vector dimensions: ${
+                            error instanceof Error
+                                ? error.message
+                                : String(error)
+                        }`
+                    )
+                }
+            } else {
+                throw new Error("Dimensions must be at least 2")
+            }
+        }
+
         const response = await RedisConnection.withClient(
             redisUrl,
             async (client) => {
@@ -61,66 +125,6 @@ export async function POST(
                 const hashKey = `vset:${keyName}:metadata`
                 await client.hDel(configKey, hashKey)
 
-                let effectiveDimensions = dimensions
-
-                // If dimensions is not specified or zero, try to determine from metadata and/or embedding service
-                if (!dimensions || dimensions < 2) {
-                    // First, try to get dimensions from metadata directly
-                    if (metadata?.dimensions && metadata.dimensions >= 2) {
-                        effectiveDimensions = metadata.dimensions
-                        console.log(
-                            `Using dimensions from metadata: ${effectiveDimensions}`
-                        )
-                    }
-                    // If not available in metadata, try to determine from embedding configuration
-                    else if (metadata?.embedding) {
-                        try {
-                            // Try to get expected dimensions from config
-                            const expectedDimensions = getExpectedDimensions(
-                                metadata.embedding
-                            )
-
-                            if (expectedDimensions >= 2) {
-                                effectiveDimensions = expectedDimensions
-                                console.log(
-                                    `Using dimensions from config: ${effectiveDimensions}`
-                                )
-                            } else {
-                                // If can't determine from config, use EmbeddingService to get a test embedding
-                                const embeddingService = new EmbeddingService()
-                                console.log(
-                                    "Getting dimensions from EmbeddingService"
-                                )
-                                console.log(
-                                    "metadata.embedding",
-                                    metadata.embedding
-                                )
-
-                                // Get a test embedding to determine dimensions
-                                const testEmbedding =
-                                    await embeddingService.getEmbedding(
-                                        "test",
-                                        metadata.embedding
-                                    )
-                                effectiveDimensions = testEmbedding.length
-                                console.log(
-                                    `Determined dimensions using test embedding: ${effectiveDimensions}`
-                                )
-                            }
-                        } catch (error) {
-                            throw new Error(
-                                `Failed to determine vector dimensions: ${
-                                    error instanceof Error
-                                        ? error.message
-                                        : String(error)
-                                }`
-                            )
-                        }
-                    } else {
-                        throw new Error("Dimensions must be at least 2")
-                    }
-                }
-
                 // Create the vector set with either the custom vector or a dummy vector
                 const vector =
                     customData?.vector || Array(effectiveDimensions).fill(0)
@@ -145,7 +149,7 @@ export async function POST(
                 }
 
                 // Create the vector set
-                const command = ["VADD", keyName]
+                const command: (string | Buffer)[] = ["VADD", keyName]
 
                 // Add REDUCE flag if dimension reduction is configured
                 if (metadata?.redisConfig?.reduceDimensions) {
@@ -155,13 +159,8 @@ export async function POST(
                     )
                 }
 
-                // Add VALUES and vector data
-                command.push(
-                    "VALUES",
-                    effectiveDimensions.toString(),
-                    ...vector.map((v) => v.toString()),
-                    element
-                )
+                // Add vector data as an FP32 blob
+                command.push("FP32", vectorToFp32Buffer(vector), element)
 
                 // Add CAS flag if enabled
                 if (metadata?.redisConfig?.defaultCAS) {
@@ -206,6 +205,7 @@ export async function POST(
                 }
             }
         )
+        invalidateVectorSet(redisUrl, keyName)
 
         if (!response.success) {
             return NextResponse.json(
@@ -278,6 +278,7 @@ export async function DELETE(
                 return "deleted"
             }
         )
+        invalidateVectorSet(redisUrl, keyName)
 
         if (!response.success) {
             return NextResponse.json(
@@ -0,0 +1,41 @@
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import { describeShards, resolveShardKeys } from "@/lib/server/shards"
+
+// GET /api/vectorset/[setname]/shards - VINFO/VCARD of every shard of a logical set,
+// with totals. ?keys=a,b,c lists the shards explicitly instead of looking for name{*}
+export async function GET(
+    req: NextRequest,
+    { params }: any //{ params: { setname: string } }
+) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    try {
+        const { setname } = await params
+        const explicitKeys = req.nextUrl.searchParams.get("keys")
+        const keys = explicitKeys
+            ? explicitKeys.split(",").map((key) => key.trim()).filter(Boolean)
+            : await resolveShardKeys(redisUrl, setname)
+
+        if (keys.length === 0) {
+            return NextResponse.json(
+                { success: false, error: `No shards found for ${setname}` },
+                { status: 404 }
+            )
+        }
+
+        return NextResponse.json({ success: true, result: await describeShards(redisUrl, keys) })
+    } catch (error) {
+        console.error("Error describing shards:", error)
+        return NextResponse.json(
+            { success: false, error: error instanceof Error ? error.message : String(error) },
+            { status: 500 }
+        )
+    }
+}
@@ -0,0 +1,44 @@
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import { getVectorSetCatalog } from "@/lib/server/vectorset-catalog"
+
+// GET /api/vectorset/catalog - Every vector set with its VINFO, size, dimensions
+// and metadata in one response. ?name=a&name=b returns just those sets (null
+// when missing); ?refresh=1 waits for a fresh scan
+export async function GET(req: NextRequest) {
+    const redisUrl = await getRedisUrl()
+    if (!redisUrl) {
+        return NextResponse.json(
+            { success: false, error: "No Redis connection available" },
+            { status: 401 }
+        )
+    }
+
+    try {
+        const startTime = performance.now()
+        const catalog = getVectorSetCatalog(redisUrl)
+        if (req.nextUrl.searchParams.get("refresh") === "1") {
+            catalog.reset()
+        }
+
+        const names = req.nextUrl.searchParams.getAll("name")
+        const result = names.length > 0
+            ? await catalog.get(names)
+            : await catalog.list()
+
+        return NextResponse.json({
+            success: true,
+            result,
+            executionTimeMs: performance.now() - startTime,
+        })
+    } catch (error) {
+        console.error("Error reading vector set catalog:", error)
+        return NextResponse.json(
+            {
+                success: false,
+                error: error instanceof Error ? error.message : String(error),
+            },
+            { status: 500 }
+        )
+    }
+}
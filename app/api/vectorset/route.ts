@@ -1,12 +1,11 @@
-import { NextResponse } from "next/server"
-import {
-    RedisConnection,
-    getRedisUrl,
-} from "@/lib/redis-server/RedisConnection"
+import { NextRequest, NextResponse } from "next/server"
+import { getRedisUrl } from "@/lib/redis-server/RedisConnection"
+import { getVectorSetCatalog } from "@/lib/server/vectorset-catalog"
 
 // GET /api/vectorset - List all vector sets (scanVectorSets)
+// Served from the vector set catalog; ?refresh=1 waits for a fresh scan
 
-export async function GET() {
+export async function GET(req: NextRequest) {
     const redisUrl = await getRedisUrl()
     if (!redisUrl) {
         return NextResponse.json(
@@ -16,40 +15,17 @@ export async function GET() {
     }
 
     try {
-        const response = await RedisConnection.withClient(redisUrl, async (client) => {
-            try {
-                let cursor = "0"
-                const vectorSets = new Set<string>()
-
-                do {
-                    const [nextCursor, keys] = (await client.sendCommand([
-                        "SCAN",
-                        cursor,
-                        "TYPE",
-                        "vectorset",
-                    ])) as [string, string[]]
-
-                    keys.forEach((key) => vectorSets.add(key))
-                    cursor = nextCursor
-                } while (cursor !== "0")
-
-                return Array.from(vectorSets)
-            } catch (_error) {
-                return []
-            }
-        })
-
-        if (!response || !response.success) {
-            return NextResponse.json(
-                { success: false, error: "Error calling scanVectorSets" },
-                { status: 404 }
-            )
+        const startTime = performance.now()
+        const catalog = getVectorSetCatalog(redisUrl)
+        if (req.nextUrl.searchParams.get("refresh") === "1") {
+            catalog.reset()
         }
+        const entries = await catalog.list()
 
         return NextResponse.json({
             success: true,
-            result: response.result,
-            executionTimeMs: response.executionTimeMs,
+            result: entries.map((entry) => entry.name),
+            executionTimeMs: performance.now() - startTime,
         })
 
     } catch (error) {
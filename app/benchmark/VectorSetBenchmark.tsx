@@ -0,0 +1,409 @@
+"use client"
+
+import { useCallback, useEffect, useMemo, useState } from "react"
+import { Button } from "@/components/ui/button"
+import { Checkbox } from "@/components/ui/checkbox"
+import { Input } from "@/components/ui/input"
+import { Label } from "@/components/ui/label"
+import {
+    Select,
+    SelectContent,
+    SelectItem,
+    SelectTrigger,
+    SelectValue,
+} from "@/components/ui/select"
+import {
+    Table,
+    TableBody,
+    TableCell,
+    TableHead,
+    TableHeader,
+    TableRow,
+} from "@/components/ui/table"
+import { benchmark } from "@/app/api/benchmark"
+import { vectorSets } from "@/app/api/vector-sets"
+import {
+    BENCHMARK_MAX_QUERIES,
+    BenchmarkConfig,
+    BenchmarkResultRow,
+    BenchmarkRun,
+} from "@/lib/types/benchmark"
+
+const POLL_INTERVAL_MS = 1000
+
+// "0, 50, 100" -> [0, 50, 100]
+function parseList(value: string): number[] {
+    return value
+        .split(/[\s,]+/)
+        .filter(Boolean)
+        .map(Number)
+        .filter((n) => Number.isInteger(n) && n >= 0)
+}
+
+// Held-out queries: a JSON array of vectors (or of {vector}), or one per line
+function parseQueryVectors(text: string): number[][] {
+    const toVector = (item: any): number[] | null => {
+        const vector = Array.isArray(item) ? item : item?.vector ?? item?.values
+        return Array.isArray(vector) && vector.every((v) => typeof v === "number") ? vector : null
+    }
+    const trimmed = text.trim()
+    const items: any[] = trimmed.startsWith("[")
+        ? JSON.parse(trimmed)
+        : trimmed.split("\n").filter((line) => line.trim()).map((line) => JSON.parse(line))
+    return items.map(toVector).filter((v): v is number[] => v !== null)
+}
+
+function formatSetting(value: number): string {
+    return value > 0 ? String(value) : "default"
+}
+
+export default function VectorSetBenchmark() {
+    const [sets, setSets] = useState<string[]>([])
+    const [vectorSetName, setVectorSetName] = useState("")
+    const [sampleSize, setSampleSize] = useState(100)
+    const [queryVectors, setQueryVectors] = useState<number[][] | null>(null)
+    const [queryFileName, setQueryFileName] = useState("")
+    const [ef, setEf] = useState("0, 50, 100, 200, 500")
+    const [filterEf, setFilterEf] = useState("0")
+    const [count, setCount] = useState("10")
+    const [filter, setFilter] = useState("")
+    const [threaded, setThreaded] = useState(true)
+    const [noThread, setNoThread] = useState(false)
+    const [concurrency, setConcurrency] = useState(8)
+    const [warmupRounds, setWarmupRounds] = useState(1)
+
+    const [run, setRun] = useState<BenchmarkRun | null>(null)
+    const [history, setHistory] = useState<BenchmarkRun[]>([])
+    const [error, setError] = useState<string | null>(null)
+
+    useEffect(() => {
+        vectorSets.list().then((list) => {
+            setSets(list || [])
+            if (list && list.length > 0) setVectorSetName((current) => current || list[0])
+        }).catch((err) => setError(String(err)))
+    }, [])
+
+    const loadHistory = useCallback(async (name: string) => {
+        try {
+            setHistory(await benchmark.listRuns(name))
+        } catch (err) {
+            setError(String(err))
+        }
+    }, [])
+
+    useEffect(() => {
+        if (vectorSetName) loadHistory(vectorSetName)
+    }, [vectorSetName, loadHistory])
+
+    // Poll the run we started until it finishes
+    const runId = run?.status === "running" ? run.id : null
+    useEffect(() => {
+        if (!runId) return
+        const timer = setInterval(async () => {
+            try {
+                const latest = await benchmark.getRun(runId)
+                if (!latest) return
+                setRun(latest)
+                if (latest.status !== "running") loadHistory(latest.vectorSetName)
+            } catch (err) {
+                setError(String(err))
+            }
+        }, POLL_INTERVAL_MS)
+        return () => clearInterval(timer)
+    }, [runId, loadHistory])
+
+    const handleQueryFile = async (file: File | undefined) => {
+        if (!file) {
+            setQueryVectors(null)
+            setQueryFileName("")
+            return
+        }
+        try {
+            const vectors = parseQueryVectors(await file.text())
+            if (vectors.length === 0) throw new Error("No vectors found in file")
+            setQueryVectors(vectors.slice(0, BENCHMARK_MAX_QUERIES))
+            setQueryFileName(file.name)
+            setError(null)
+        } catch (err) {
+            setQueryVectors(null)
+            setError(`Could not read query vectors: ${err instanceof Error ? err.message : String(err)}`)
+        }
+    }
+
+    const startRun = async () => {
+        const modes: boolean[] = []
+        if (threaded) modes.push(true)
+        if (noThread) modes.push(false)
+
+        const config: BenchmarkConfig = {
+            vectorSetName,
+            queries: queryVectors
+                ? { type: "vectors", vectors: queryVectors }
+                : { type: "sample", count: sampleSize },
+            ef: parseList(ef),
+            filterEf: parseList(filterEf),
+            count: parseList(count),
+            threaded: modes.length > 0 ? modes : [true],
+            filter: filter.trim() || undefined,
+            concurrency,
+            warmupRounds,
+        }
+        try {
+            setError(null)
+            setRun(await benchmark.start(config))
+        } catch (err) {
+            setError(err instanceof Error ? err.message : String(err))
+        }
+    }
+
+    // Fastest setting per COUNT that reaches 95% recall, as a tuning hint
+    const recommended = useMemo(() => {
+        const best = new Map<number, BenchmarkResultRow>()
+        for (const row of run?.results || []) {
+            if (row.recall < 0.95) continue
+            const current = best.get(row.count)
+            if (!current || row.p99Ms < current.p99Ms) best.set(row.count, row)
+        }
+        return new Set(best.values())
+    }, [run])
+
+    const running = run?.status === "running"
+
+    return (
+        <div className="space-y-6">
+            <div className="grid grid-cols-2 gap-4 bg-gray-100 p-4">
+                <div className="space-y-4 p-2">
+                    <div>
+                        <Label htmlFor="benchmark-set">Vector Set</Label>
+                        <Select value={vectorSetName} onValueChange={setVectorSetName}>
+                            <SelectTrigger id="benchmark-set">
+                                <SelectValue placeholder="Select a vector set" />
+                            </SelectTrigger>
+                            <SelectContent>
+                                {sets.map((name) => (
+                                    <SelectItem key={name} value={name}>{name}</SelectItem>
+                                ))}
+                            </SelectContent>
+                        </Select>
+                    </div>
+                    <div>
+                        <Label htmlFor="benchmark-sample">Sampled Queries</Label>
+                        <Input
+                            id="benchmark-sample"
+                            type="number"
+                            min={1}
+                            max={BENCHMARK_MAX_QUERIES}
+                            value={sampleSize}
+                            disabled={queryVectors !== null}
+                            onChange={(e) => setSampleSize(parseInt(e.target.value) || 1)}
+                        />
+                        <p className="text-xs text-muted-foreground mt-1">
+                            Random elements of the set (VRANDMEMBER), each searched by itself.
+                        </p>
+                    </div>
+                    <div>
+                        <Label htmlFor="benchmark-file">Held-out Query Vectors (optional)</Label>
+                        <Input
+                            id="benchmark-file"
+                            type="file"
+                            accept=".json,.ndjson,.jsonl"
+                            onChange={(e) => handleQueryFile(e.target.files?.[0])}
+                        />
+                        <p className="text-xs text-muted-foreground mt-1">
+                            {queryVectors
+                                ? `${queryVectors.length} vectors from ${queryFileName}`
+                                : "A JSON array of vectors, or one JSON vector per line."}
+                        </p>
+                    </div>
+                    <div>
+                        <Label htmlFor="benchmark-filter">Filter (optional)</Label>
+                        <Input
+                            id="benchmark-filter"
+                            value={filter}
+                            placeholder=".year > 2000"
+                            onChange={(e) => setFilter(e.target.value)}
+                        />
+                    </div>
+                </div>
+
+                <div className="space-y-4 p-2">
+                    <div>
+                        <Label htmlFor="benchmark-ef">EF values</Label>
+                        <Input id="benchmark-ef" value={ef} onChange={(e) => setEf(e.target.value)} />
+                        <p className="text-xs text-muted-foreground mt-1">
+                            Comma separated; 0 uses the server default.
+                        </p>
+                    </div>
+                    <div>
+                        <Label htmlFor="benchmark-filter-ef">FILTER-EF values</Label>
+                        <Input
+                            id="benchmark-filter-ef"
+                            value={filterEf}
+                            disabled={!filter.trim()}
+                            onChange={(e) => setFilterEf(e.target.value)}
+                        />
+                    </div>
+                    <div>
+                        <Label htmlFor="benchmark-count">COUNT values</Label>
+                        <Input id="benchmark-count" value={count} onChange={(e) => setCount(e.target.value)} />
+                        <p className="text-xs text-muted-foreground mt-1">
+                            Recall is measured against the exact (TRUTH) top COUNT results.
+                        </p>
+                    </div>
+                    <div className="flex items-center gap-6">
+                        <label className="flex items-center gap-2 text-sm">
+                            <Checkbox checked={threaded} onCheckedChange={(v) => setThreaded(v === true)} />
+                            Threaded
+                        </label>
+                        <label className="flex items-center gap-2 text-sm">
+                            <Checkbox checked={noThread} onCheckedChange={(v) => setNoThread(v === true)} />
+                            NOTHREAD
+                        </label>
+                    </div>
+                    <div className="grid grid-cols-2 gap-4">
+                        <div>
+                            <Label htmlFor="benchmark-concurrency">Concurrency</Label>
+                            <Input
+                                id="benchmark-concurrency"
+                                type="number"
+                                min={1}
+                                value={concurrency}
+                                onChange={(e) => setConcurrency(parseInt(e.target.value) || 1)}
+                            />
+                        </div>
+                        <div>
+                            <Label htmlFor="benchmark-warmup">Warm-up Rounds</Label>
+                            <Input
+                                id="benchmark-warmup"
+                                type="number"
+                                min={0}
+                                max={5}
+                                value={warmupRounds}
+                                onChange={(e) => setWarmupRounds(parseInt(e.target.value) || 0)}
+                            />
+                        </div>
+                    </div>
+                </div>
+            </div>
+
+            <div className="flex items-center gap-4">
+                <Button onClick={startRun} disabled={!vectorSetName || running}>
+                    {running ? "Running..." : "Run Benchmark"}
+                </Button>
+                {run && (
+                    <span className="text-sm text-muted-foreground">
+                        {run.status === "running"
+                            ? `${run.completedCombinations} / ${run.totalCombinations} settings measured`
+                            : run.status === "failed"
+                                ? `Failed: ${run.error}`
+                                : `Finished ${run.results.length} settings over ${run.config.queryCount} queries`}
+                        {run.truthMs !== undefined && ` · exact results took ${run.truthMs} ms`}
+                    </span>
+                )}
+            </div>
+            {error && <p className="text-sm text-red-600">{error}</p>}
+
+            {run && run.results.length > 0 && (
+                <BenchmarkTable rows={run.results} highlighted={recommended} />
+            )}
+
+            {history.length > 0 && (
+                <div className="space-y-2">
+                    <div className="flex items-center justify-between">
+                        <h2 className="text-lg font-semibold">Previous Runs</h2>
+                        <Button
+                            variant="outline"
+                            size="sm"
+                            onClick={async () => {
+                                await benchmark.clearRuns(vectorSetName)
+                                setHistory([])
+                            }}
+                        >
+                            Clear
+                        </Button>
+                    </div>
+                    <Table>
+                        <TableHeader>
+                            <TableRow>
+                                <TableHead>Started</TableHead>
+                                <TableHead>Elements</TableHead>
+                                <TableHead>Queries</TableHead>
+                                <TableHead>Settings</TableHead>
+                                <TableHead>Best recall</TableHead>
+                                <TableHead>Status</TableHead>
+                            </TableRow>
+                        </TableHeader>
+                        <TableBody>
+                            {history.map((entry) => (
+                                <TableRow
+                                    key={entry.id}
+                                    className="cursor-pointer"
+                                    onClick={() => setRun(entry)}
+                                >
+                                    <TableCell>{new Date(entry.startedAt).toLocaleString()}</TableCell>
+                                    <TableCell>{entry.cardinality ?? "-"}</TableCell>
+                                    <TableCell>
+                                        {entry.config.queryCount} ({entry.config.querySource})
+                                    </TableCell>
+                                    <TableCell>{entry.results.length}</TableCell>
+                                    <TableCell>
+                                        {entry.results.length > 0
+                                            ? Math.max(...entry.results.map((r) => r.recall)).toFixed(3)
+                                            : "-"}
+                                    </TableCell>
+                                    <TableCell>{entry.status}</TableCell>
+                                </TableRow>
+                            ))}
+                        </TableBody>
+                    </Table>
+                </div>
+            )}
+        </div>
+    )
+}
+
+function BenchmarkTable({
+    rows,
+    highlighted,
+}: {
+    rows: BenchmarkResultRow[]
+    highlighted: Set<BenchmarkResultRow>
+}) {
+    return (
+        <div className="space-y-2">
+            <Table>
+                <TableHeader>
+                    <TableRow>
+                        <TableHead>COUNT</TableHead>
+                        <TableHead>EF</TableHead>
+                        <TableHead>FILTER-EF</TableHead>
+                        <TableHead>Threads</TableHead>
+                        <TableHead>Recall@k</TableHead>
+                        <TableHead>p50 ms</TableHead>
+                        <TableHead>p99 ms</TableHead>
+                        <TableHead>QPS</TableHead>
+                        <TableHead>Errors</TableHead>
+                    </TableRow>
+                </TableHeader>
+                <TableBody>
+                    {rows.map((row, index) => (
+                        <TableRow key={index} className={highlighted.has(row) ? "bg-green-50" : undefined}>
+                            <TableCell>{row.count}</TableCell>
+                            <TableCell>{formatSetting(row.ef)}</TableCell>
+                            <TableCell>{formatSetting(row.filterEf)}</TableCell>
+                            <TableCell>{row.threaded ? "threaded" : "NOTHREAD"}</TableCell>
+                            <TableCell>{row.recall.toFixed(3)}</TableCell>
+                            <TableCell>{row.p50Ms.toFixed(2)}</TableCell>
+                            <TableCell>{row.p99Ms.toFixed(2)}</TableCell>
+                            <TableCell>{row.qps.toFixed(0)}</TableCell>
+                            <TableCell>{row.errors}</TableCell>
+                        </TableRow>
+                    ))}
+                </TableBody>
+            </Table>
+            <p className="text-xs text-muted-foreground">
+                Highlighted: the lowest p99 reaching 95% recall for each COUNT.
+            </p>
+        </div>
+    )
+}
@@ -0,0 +1,15 @@
+"use client"
+
+import { Card } from "@/components/ui/card"
+import VectorSetBenchmark from "./VectorSetBenchmark"
+
+export default function BenchmarkPage() {
+    return (
+        <div className="container mx-auto py-6">
+            <h1 className="text-2xl font-bold mb-6">Search Benchmark</h1>
+            <Card className="p-6">
+                <VectorSetBenchmark />
+            </Card>
+        </div>
+    )
+}
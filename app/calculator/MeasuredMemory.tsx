@@ -0,0 +1,381 @@
+"use client"
+
+import { useCallback, useEffect, useState } from "react"
+import { Button } from "@/components/ui/button"
+import { Checkbox } from "@/components/ui/checkbox"
+import { Input } from "@/components/ui/input"
+import { Label } from "@/components/ui/label"
+import {
+    Select,
+    SelectContent,
+    SelectItem,
+    SelectTrigger,
+    SelectValue,
+} from "@/components/ui/select"
+import {
+    Table,
+    TableBody,
+    TableCell,
+    TableHead,
+    TableHeader,
+    TableRow,
+} from "@/components/ui/table"
+import { memory } from "@/app/api/memory"
+import { vectorSets } from "@/app/api/vector-sets"
+import { formatBytes } from "@/lib/storage/vectorSetMemory"
+import {
+    MemoryMeasurement,
+    QuantizationFlag,
+    WHATIF_MAX_QUERIES,
+    WHATIF_MAX_SAMPLE,
+    WhatIfRun,
+    WhatIfVariant,
+} from "@/lib/types/memory"
+
+const POLL_INTERVAL_MS = 1000
+const QUANTIZATIONS: QuantizationFlag[] = ["NOQUANT", "Q8", "BIN"]
+
+// "0, 256 512" -> [0, 256, 512]
+function parseList(value: string): number[] {
+    return value
+        .split(/[\s,]+/)
+        .filter(Boolean)
+        .map(Number)
+        .filter((n) => Number.isInteger(n) && n >= 0)
+}
+
+function formatPercent(ratio: number): string {
+    return `${ratio > 0 ? "+" : ""}${(ratio * 100).toFixed(1)}%`
+}
+
+export default function MeasuredMemory() {
+    const [sets, setSets] = useState<string[]>([])
+    const [vectorSetName, setVectorSetName] = useState("")
+    const [measurement, setMeasurement] = useState<MemoryMeasurement | null>(null)
+    const [measuring, setMeasuring] = useState(false)
+
+    const [quantizations, setQuantizations] = useState<QuantizationFlag[]>(["NOQUANT", "Q8", "BIN"])
+    const [reduce, setReduce] = useState("")
+    const [sampleSize, setSampleSize] = useState(2000)
+    const [queryCount, setQueryCount] = useState(100)
+    const [count, setCount] = useState(10)
+    const [ef, setEf] = useState("0")
+
+    const [run, setRun] = useState<WhatIfRun | null>(null)
+    const [history, setHistory] = useState<WhatIfRun[]>([])
+    const [error, setError] = useState<string | null>(null)
+
+    useEffect(() => {
+        vectorSets.list().then((list) => {
+            setSets(list || [])
+            if (list && list.length > 0) setVectorSetName((current) => current || list[0])
+        }).catch((err) => setError(String(err)))
+    }, [])
+
+    const loadHistory = useCallback(async (name: string) => {
+        try {
+            setHistory(await memory.listWhatIfRuns(name))
+        } catch (err) {
+            setError(String(err))
+        }
+    }, [])
+
+    useEffect(() => {
+        setMeasurement(null)
+        if (vectorSetName) loadHistory(vectorSetName)
+    }, [vectorSetName, loadHistory])
+
+    // Poll the run we started until it finishes
+    const runId = run?.status === "running" ? run.id : null
+    useEffect(() => {
+        if (!runId) return
+        const timer = setInterval(async () => {
+            try {
+                const latest = await memory.getWhatIfRun(runId)
+                if (!latest) return
+                setRun(latest)
+                if (latest.status !== "running") loadHistory(latest.vectorSetName)
+            } catch (err) {
+                setError(String(err))
+            }
+        }, POLL_INTERVAL_MS)
+        return () => clearInterval(timer)
+    }, [runId, loadHistory])
+
+    const measure = async () => {
+        try {
+            setError(null)
+            setMeasuring(true)
+            setMeasurement(await memory.measure(vectorSetName))
+        } catch (err) {
+            setError(err instanceof Error ? err.message : String(err))
+        } finally {
+            setMeasuring(false)
+        }
+    }
+
+    const startRun = async () => {
+        const dims = [0, ...parseList(reduce).filter((n) => n > 0)]
+        const variants: WhatIfVariant[] = quantizations.flatMap((quantization) =>
+            dims.map((dim) => ({ quantization, reduce: dim || undefined }))
+        )
+        try {
+            setError(null)
+            setRun(await memory.startWhatIf({
+                vectorSetName,
+                sampleSize,
+                queryCount,
+                variants,
+                count,
+                ef: parseList(ef),
+                concurrency: 8,
+            }))
+        } catch (err) {
+            setError(err instanceof Error ? err.message : String(err))
+        }
+    }
+
+    const toggleQuantization = (quantization: QuantizationFlag, checked: boolean) => {
+        setQuantizations((current) =>
+            checked
+                ? QUANTIZATIONS.filter((q) => q === quantization || current.includes(q))
+                : current.filter((q) => q !== quantization)
+        )
+    }
+
+    const running = run?.status === "running"
+
+    return (
+        <div className="space-y-6">
+            <div className="flex items-end gap-4">
+                <div className="w-72">
+                    <Label htmlFor="memory-set">Vector Set</Label>
+                    <Select value={vectorSetName} onValueChange={setVectorSetName}>
+                        <SelectTrigger id="memory-set">
+                            <SelectValue placeholder="Select a vector set" />
+                        </SelectTrigger>
+                        <SelectContent>
+                            {sets.map((name) => (
+                                <SelectItem key={name} value={name}>{name}</SelectItem>
+                            ))}
+                        </SelectContent>
+                    </Select>
+                </div>
+                <Button onClick={measure} disabled={!vectorSetName || measuring}>
+                    {measuring ? "Measuring..." : "Measure"}
+                </Button>
+            </div>
+
+            {measurement && (
+                <Table>
+                    <TableHeader>
+                        <TableRow>
+                            <TableHead>Elements</TableHead>
+                            <TableHead>Dims</TableHead>
+                            <TableHead>Quantization</TableHead>
+                            <TableHead>M</TableHead>
+                            <TableHead>MEMORY USAGE</TableHead>
+                            <TableHead>Bytes/vector</TableHead>
+                            <TableHead>Model</TableHead>
+                            <TableHead>Model error</TableHead>
+                        </TableRow>
+                    </TableHeader>
+                    <TableBody>
+                        <TableRow>
+                            <TableCell>{measurement.size.toLocaleString()}</TableCell>
+                            <TableCell>
+                                {measurement.inputDimensions !== measurement.dimensions
+                                    ? `${measurement.inputDimensions} → ${measurement.dimensions}`
+                                    : measurement.dimensions}
+                            </TableCell>
+                            <TableCell>{measurement.quantization}</TableCell>
+                            <TableCell>{measurement.hnswM}</TableCell>
+                            <TableCell>{formatBytes(measurement.memoryBytes)}</TableCell>
+                            <TableCell>{measurement.bytesPerVector.toLocaleString()} B</TableCell>
+                            <TableCell>{measurement.estimatedBytesPerVector.toLocaleString()} B</TableCell>
+                            <TableCell>{formatPercent(measurement.modelError)}</TableCell>
+                        </TableRow>
+                    </TableBody>
+                </Table>
+            )}
+
+            <div className="grid grid-cols-2 gap-4 bg-gray-100 p-4">
+                <div className="space-y-4 p-2">
+                    <div>
+                        <Label>Quantization</Label>
+                        <div className="flex gap-4 mt-2">
+                            {QUANTIZATIONS.map((quantization) => (
+                                <label key={quantization} className="flex items-center gap-2 text-sm">
+                                    <Checkbox
+                                        checked={quantizations.includes(quantization)}
+                                        onCheckedChange={(checked) => toggleQuantization(quantization, checked === true)}
+                                    />
+                                    {quantization}
+                                </label>
+                            ))}
+                        </div>
+                    </div>
+                    <div>
+                        <Label htmlFor="memory-reduce">REDUCE dimensions</Label>
+                        <Input
+                            id="memory-reduce"
+                            value={reduce}
+                            onChange={(e) => setReduce(e.target.value)}
+                            placeholder="e.g. 256, 512"
+                        />
+                        <p className="text-xs text-muted-foreground mt-1">
+                            Each quantization is tried at full dimensions and at each of these.
+                        </p>
+                    </div>
+                </div>
+                <div className="space-y-4 p-2">
+                    <div className="grid grid-cols-2 gap-4">
+                        <div>
+                            <Label htmlFor="memory-sample">Sampled elements</Label>
+                            <Input
+                                id="memory-sample"
+                                type="number"
+                                min={1}
+                                max={WHATIF_MAX_SAMPLE}
+                                value={sampleSize}
+                                onChange={(e) => setSampleSize(parseInt(e.target.value) || 1)}
+                            />
+                        </div>
+                        <div>
+                            <Label htmlFor="memory-queries">Held-out queries</Label>
+                            <Input
+                                id="memory-queries"
+                                type="number"
+                                min={1}
+                                max={WHATIF_MAX_QUERIES}
+                                value={queryCount}
+                                onChange={(e) => setQueryCount(parseInt(e.target.value) || 1)}
+                            />
+                        </div>
+                        <div>
+                            <Label htmlFor="memory-count">COUNT</Label>
+                            <Input
+                                id="memory-count"
+                                type="number"
+                                min={1}
+                                value={count}
+                                onChange={(e) => setCount(parseInt(e.target.value) || 1)}
+                            />
+                        </div>
+                        <div>
+                            <Label htmlFor="memory-ef">EF values</Label>
+                            <Input id="memory-ef" value={ef} onChange={(e) => setEf(e.target.value)} />
+                        </div>
+                    </div>
+                    <p className="text-xs text-muted-foreground">
+                        Shadow sets are built from the sample, measured with MEMORY USAGE and
+                        searched with the held-out queries. Recall is against the NOQUANT copy.
+                        They are deleted when the run ends.
+                    </p>
+                </div>
+            </div>
+
+            <div className="flex items-center gap-4">
+                <Button onClick={startRun} disabled={!vectorSetName || running || quantizations.length === 0}>
+                    {running ? "Running..." : "Run What-If"}
+                </Button>
+                {run && (
+                    <span className="text-sm text-muted-foreground">
+                        {run.status} · {run.completedVariants}/{run.totalVariants} variants
+                        {run.error && ` · ${run.error}`}
+                    </span>
+                )}
+            </div>
+            {error && <p className="text-sm text-red-600">{error}</p>}
+
+            {run && run.variants.length > 0 && <WhatIfTable run={run} />}
+
+            {history.length > 0 && (
+                <div className="space-y-2">
+                    <h3 className="text-lg font-semibold">Previous What-If Runs</h3>
+                    <Table>
+                        <TableHeader>
+                            <TableRow>
+                                <TableHead>Started</TableHead>
+                                <TableHead>Elements</TableHead>
+                                <TableHead>Sample</TableHead>
+                                <TableHead>Variants</TableHead>
+                                <TableHead>Status</TableHead>
+                            </TableRow>
+                        </TableHeader>
+                        <TableBody>
+                            {history.map((entry) => (
+                                <TableRow key={entry.id} className="cursor-pointer" onClick={() => setRun(entry)}>
+                                    <TableCell>{new Date(entry.startedAt).toLocaleString()}</TableCell>
+                                    <TableCell>{entry.source?.size.toLocaleString() ?? "-"}</TableCell>
+                                    <TableCell>{entry.config.sampleSize}</TableCell>
+                                    <TableCell>{entry.variants.map((v) => v.label).join(", ")}</TableCell>
+                                    <TableCell>{entry.status}</TableCell>
+                                </TableRow>
+                            ))}
+                        </TableBody>
+                    </Table>
+                </div>
+            )}
+        </div>
+    )
+}
+
+function WhatIfTable({ run }: { run: WhatIfRun }) {
+    const size = run.source?.size ?? 0
+    return (
+        <div className="space-y-2">
+            <Table>
+                <TableHeader>
+                    <TableRow>
+                        <TableHead>Variant</TableHead>
+                        <TableHead>Dims</TableHead>
+                        <TableHead>Bytes/vector</TableHead>
+                        <TableHead>Model</TableHead>
+                        <TableHead>At {size.toLocaleString()} elements</TableHead>
+                        <TableHead>EF</TableHead>
+                        <TableHead>Recall@{run.config.count}</TableHead>
+                        <TableHead>p50 ms</TableHead>
+                        <TableHead>p99 ms</TableHead>
+                        <TableHead>QPS</TableHead>
+                    </TableRow>
+                </TableHeader>
+                <TableBody>
+                    {run.variants.flatMap((variant) => {
+                        const cells = [
+                            <TableCell key="label">{variant.label}</TableCell>,
+                            <TableCell key="dims">{variant.dimensions}</TableCell>,
+                            <TableCell key="bytes">{variant.bytesPerVector.toLocaleString()} B</TableCell>,
+                            <TableCell key="model">{variant.estimatedBytesPerVector.toLocaleString()} B</TableCell>,
+                            <TableCell key="projected">{formatBytes(variant.projectedBytes)}</TableCell>,
+                        ]
+                        if (variant.error || variant.benchmark.length === 0) {
+                            return [
+                                <TableRow key={variant.label}>
+                                    {cells}
+                                    <TableCell colSpan={5} className="text-red-600">
+                                        {variant.error || "No results"}
+                                    </TableCell>
+                                </TableRow>,
+                            ]
+                        }
+                        return variant.benchmark.map((row) => (
+                            <TableRow key={`${variant.label}-${row.ef}`}>
+                                {cells}
+                                <TableCell>{row.ef > 0 ? row.ef : "default"}</TableCell>
+                                <TableCell>{row.recall.toFixed(3)}</TableCell>
+                                <TableCell>{row.p50Ms.toFixed(2)}</TableCell>
+                                <TableCell>{row.p99Ms.toFixed(2)}</TableCell>
+                                <TableCell>{row.qps.toFixed(0)}</TableCell>
+                            </TableRow>
+                        ))
+                    })}
+                </TableBody>
+            </Table>
+            <p className="text-xs text-muted-foreground">
+                Bytes/vector is MEMORY USAGE of the shadow set divided by its size, without the
+                REDUCE matrix; the projection adds the matrix once.
+            </p>
+        </div>
+    )
+}
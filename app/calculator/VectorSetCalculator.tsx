@@ -17,6 +17,10 @@ import {
     IMAGE_MODELS,
 } from "@/lib/embeddings/types/embeddingModels"
 import { DEFAULT_EMBEDDING } from "@/app/vectorset/utils/constants"
+import {
+    estimateVectorSetMemoryUsage,
+    parseQuantization,
+} from "@/lib/storage/vectorSetMemory"
 
 // Group models by provider for the dropdown
 const GROUPED_MODELS = [
@@ -70,13 +74,6 @@ export default function VectorSetCalculator() {
         redisCommand: "",
     })
 
-    // HNSW parameters (kept constant as in original calculator)
-    const p = 0.25
-    const M = 16
-    const M0 = 32
-    const maxThreads = 128
-    const MAX_LEVELS = 16
-
     function generateRedisCommand(modelDim: number, storeDim: number | null, quantization: string) {
         let cmd = "VADD myindex"
 
@@ -96,62 +93,6 @@ export default function VectorSetCalculator() {
         return cmd
     }
 
-    function estimateHNSWMemoryUsagePerNode(storeDim: number, quantType: string) {
-        // Node struct base overhead
-        const nodeStructOverhead =
-            4 * maxThreads + // visited_epoch array
-            4 + // uid
-            4 + // level
-            4 * MAX_LEVELS + // num_neighbors array
-            8 * MAX_LEVELS // neighbors pointer array
-
-        // Average number of levels and pointers
-        const avgLevels = 1.0 + p / (1.0 - p)
-        const effectiveUpperLayers = Math.max(avgLevels - 1.0, 0.0)
-        const avgPointers = M0 + effectiveUpperLayers * M
-        const pointerBytes = avgPointers * 8.0
-
-        // Vector storage based on quantization
-        let vectorBytes = 0.0
-        switch (quantType) {
-            case "NOQUANT": // FP32
-                vectorBytes = 4.0 * storeDim
-                break
-            case "Q8": // Q8
-                vectorBytes = storeDim + 8.0 // 1 byte per dim + 8 bytes for range
-                break
-            case "BIN": // BIN
-                vectorBytes = Math.ceil(storeDim / 8.0)
-                break
-            default:
-                vectorBytes = 4.0 * storeDim
-        }
-
-        return Math.floor(nodeStructOverhead + pointerBytes + vectorBytes + 0.5)
-    }
-
-    function estimateHNSWMemoryUsage(
-        N: number,
-        originalDim: number,
-        storeDim: number,
-        quantType: string,
-        useProjection: boolean
-    ) {
-        // Per-node usage
-        const perNode = estimateHNSWMemoryUsagePerNode(storeDim, quantType)
-
-        // Total for all N nodes
-        let total = perNode * N
-
-        // If we keep the projection matrix in memory, add it
-        if (useProjection && storeDim < originalDim) {
-            const matrixBytes = originalDim * storeDim * 4
-            total += matrixBytes
-        }
-
-        return total
-    }
-
     function formatBytes(bytes: number) {
         if (bytes < 1024) return bytes + " B"
         else if (bytes < 1024 * 1024) return (bytes / 1024).toFixed(2) + " KB"
@@ -170,11 +111,11 @@ export default function VectorSetCalculator() {
         const rawVectorBytesPerVec = 4 * config.modelDim
         const totalRawBytes = rawVectorBytesPerVec * config.numVectors
 
-        const estimateBytes = estimateHNSWMemoryUsage(
+        const estimateBytes = estimateVectorSetMemoryUsage(
             config.numVectors,
             config.modelDim,
             storeDim,
-            config.quantization,
+            parseQuantization(config.quantization),
             useProjection
         )
 
@@ -1,6 +1,7 @@
 "use client"
 
 import { Card } from "@/components/ui/card"
+import MeasuredMemory from "./MeasuredMemory"
 import VectorSetCalculator from "./VectorSetCalculator"
 
 export default function CalculatorPage() {
@@ -10,6 +11,10 @@ export default function CalculatorPage() {
             <Card className="p-6">
                 <VectorSetCalculator />
             </Card>
+            <h2 className="text-xl font-bold mt-8 mb-4">Measured</h2>
+            <Card className="p-6">
+                <MeasuredMemory />
+            </Card>
         </div>
     )
 } 
\ No newline at end of file
@@ -1,5 +1,7 @@
+import { Button } from "@/components/ui/button"
 import { Card, CardContent, CardHeader, CardTitle } from "@/components/ui/card"
-import { type ImportLogEntry } from "@/app/api/jobs"
+import { type ImportLogEntry, type Job } from "@/app/api/jobs"
+import { RotateCcw } from "lucide-react"
 
 // Helper function to format dates nicely
 const formatDate = (dateString: string): string => {
@@ -16,16 +18,57 @@ const formatDate = (dateString: string): string => {
 
 interface ImportHistoryProps {
     importLogs: ImportLogEntry[]
+    // Imports that failed or stopped making progress, which can continue from their checkpoint
+    interruptedJobs?: Job[]
+    onResumeJob?: (jobId: string) => void
 }
 
-export default function ImportHistory({ importLogs }: ImportHistoryProps) {
+export default function ImportHistory({
+    importLogs,
+    interruptedJobs = [],
+    onResumeJob,
+}: ImportHistoryProps) {
     return (
         <Card>
             <CardHeader>
                 <CardTitle>Import History</CardTitle>
             </CardHeader>
             <CardContent>
-                {importLogs.length === 0 ? (
+                {interruptedJobs.length > 0 && (
+                    <div className="space-y-2 mb-4">
+                        {interruptedJobs.map((job) => (
+                            <Card key={job.jobId} className="p-3">
+                                <div className="flex justify-between items-center">
+                                    <div>
+                                        <p className="font-medium">
+                                            {job.metadata.filename}
+                                        </p>
+                                        <p className="text-sm text-muted-foreground">
+                                            {job.status.status === "failed"
+                                                ? "Failed"
+                                                : "Interrupted"}{" "}
+                                            after{" "}
+                                            {job.checkpoint?.watermark ??
+                                                job.status.current}{" "}
+                                            of {job.status.total} records
+                                        </p>
+                                    </div>
+                                    {onResumeJob && (
+                                        <Button
+                                            variant="outline"
+                                            size="sm"
+                                            onClick={() => onResumeJob(job.jobId)}
+                                        >
+                                            <RotateCcw className="h-4 w-4 mr-1" />
+                                            Resume
+                                        </Button>
+                                    )}
+                                </div>
+                            </Card>
+                        ))}
+                    </div>
+                )}
+                {importLogs.length === 0 && interruptedJobs.length === 0 ? (
                     <p className="text-sm text-muted-foreground">
                         No import history available.
                     </p>
@@ -12,6 +12,13 @@ interface ImportProgressProps {
     onRemoveJob: (jobId: string) => void
 }
 
+// e.g. "45s", "3m 20s", "1h 5m"
+function formatEta(seconds: number): string {
+    if (seconds < 60) return `${Math.round(seconds)}s`
+    if (seconds < 3600) return `${Math.floor(seconds / 60)}m ${Math.floor(seconds % 60)}s`
+    return `${Math.floor(seconds / 3600)}h ${Math.floor((seconds % 3600) / 60)}m`
+}
+
 export default function ImportProgress({
     jobs,
     onPauseJob,
@@ -35,7 +42,9 @@ export default function ImportProgress({
                         <CardHeader>
                             <div className="flex justify-between items-center">
                                 <CardTitle className="text-base">
-                                    Importing {job.metadata.filename}
+                                    {job.metadata.bulkEdit
+                                        ? job.metadata.filename
+                                        : `Importing ${job.metadata.filename}`}
                                 </CardTitle>
                                 <div className="flex gap-2">
                                     {!isCompleted && !isFailed && !isCancelled && (
@@ -92,6 +101,19 @@ export default function ImportProgress({
                                     </span>
                                     <span>{progress}%</span>
                                 </div>
+                                {job.status.status === "processing" &&
+                                    !!job.status.rowsPerSecond && (
+                                        <div className="flex justify-between text-xs text-muted-foreground">
+                                            <span>
+                                                {job.status.rowsPerSecond.toFixed(1)} records/s
+                                            </span>
+                                            {job.status.etaSeconds !== undefined && (
+                                                <span>
+                                                    about {formatEta(job.status.etaSeconds)} left
+                                                </span>
+                                            )}
+                                        </div>
+                                    )}
                                 {job.status.message && (
                                     <p className="text-sm text-muted-foreground">
                                         {job.status.message}
@@ -8,7 +8,8 @@ import { getModelName } from "@/lib/embeddings/types/embeddingModels"
 import { VectorSetMetadata } from "@/lib/types/vectors"
 import eventBus, { AppEvents } from "@/lib/client/events/eventEmitter"
 import { Card, CardContent, CardHeader, CardTitle } from "@/components/ui/card"
-import { subscribe } from "@/lib/client/sse/sse"
+import { isStreamConnected, subscribe } from "@/lib/client/sse/sse"
+import type { JobProgressEvent } from "@/lib/types/jobs"
 import { useCallback, useEffect, useRef, useState } from "react"
 import ImportFromCSVFlow from "./CSV/ImportFromCSVFlow"
 import ImportHistory from "./ImportHistory"
@@ -16,6 +17,23 @@ import ImportJSONFlow from "./JSON/ImportJSONFlow"
 import ImportProgress from "./ImportProgress"
 import ImportSamplesFlow from "./Samples/ImportSamplesFlow"
 
+// A running job updates its progress several times a second; one that has not
+// for this long lost its processors (e.g. the server restarted)
+const STALLED_JOB_MS = 60 * 1000
+
+// Imports that can be continued from their checkpoint
+function isInterrupted(job: Job): boolean {
+    if (job.metadata.bulkEdit || job.metadata.exportType === "json") return false
+    if (job.status.status === "failed") return true
+    return (
+        // A streaming job stays pending until its upload arrives
+        (job.status.status === "processing" ||
+            (job.status.status === "pending" && !job.metadata.streaming)) &&
+        !!job.status.timestamp &&
+        Date.now() - job.status.timestamp > STALLED_JOB_MS
+    )
+}
+
 interface ImportTabProps {
     vectorSetName: string
     metadata: VectorSetMetadata | null
@@ -57,9 +75,14 @@ export default function ImportTab({
                     (job) => job.status.status === "processing"
                 )
 
-                // If we have active jobs, increase polling frequency and emit progress
+                // If we have active jobs, increase polling frequency and emit progress.
+                // Progress is pushed while the event stream is connected, so keep polling slow then
                 if (activeJobs.length > 0) {
-                    if (pollingInterval > 1000) {
+                    if (isStreamConnected()) {
+                        if (pollingInterval === 1000) {
+                            setPollingInterval(5000)
+                        }
+                    } else if (pollingInterval > 1000) {
                         setPollingInterval(1000) // Poll every second during active imports
                     }
 
@@ -119,6 +142,28 @@ export default function ImportTab({
         return () => unsubscribe()
     }, [vectorSetName, fetchJobs])
 
+    // Apply pushed progress to the jobs already on screen
+    useEffect(() => {
+        const unsubscribe = subscribe(
+            AppEvents.JOB_PROGRESS,
+            (event: JobProgressEvent) => {
+                if (event.vectorSetName !== vectorSetName) return
+                setJobList((current) => {
+                    const index = current.findIndex((job) => job.jobId === event.jobId)
+                    if (index === -1) return current
+                    const { jobId: _jobId, vectorSetName: _vectorSetName, ...status } = event
+                    const next = [...current]
+                    next[index] = {
+                        ...current[index],
+                        status: { ...current[index].status, ...status },
+                    }
+                    return next
+                })
+            }
+        )
+        return () => unsubscribe()
+    }, [vectorSetName])
+
     // Subscribe to vector imports if needed
     useEffect(() => {
         const unsubscribe = subscribe(
@@ -298,7 +343,11 @@ export default function ImportTab({
                 </CardContent>
             </Card>
 
-            <ImportHistory importLogs={importLogs} />
+            <ImportHistory
+                importLogs={importLogs}
+                interruptedJobs={jobList.filter(isInterrupted)}
+                onResumeJob={resumeJob}
+            />
 
             <input
                 type="file"
@@ -1,6 +1,6 @@
 import { ImportJobConfig } from "@/app/api/jobs"
 import { EmbeddingConfig, isImageEmbedding } from "@/lib/embeddings/types/embeddingModels"
-import { getImageEmbedding } from "@/lib/embeddings/image/imageEmbedding"
+import { getImageEmbeddings } from "@/lib/embeddings/image/imageEmbedding"
 import { Dataset, DatasetMetadata, DatasetProvider, ImportProgress } from "../../types/DatasetProvider"
 
 export interface ImageDatasetConfig extends DatasetMetadata {
@@ -57,43 +57,21 @@ export class ImageDataset implements Dataset {
     async prepareImport({ count = 5, onProgress }: { count?: number, onProgress?: (progress: ImportProgress) => void } = {}): Promise<{ file: File, config: ImportJobConfig }> {
         // Get list of images to process
         const imageList = await this.getImageList(count)
-        const embeddings: number[][] = []
-
-        // Process each image
-        for (let i = 0; i < imageList.length; i++) {
-            const filename = imageList[i]
-            const imageUrl = `${this.config.baseUrl}/${filename}`
-
-            try {
-                // Fetch image
-                const response = await fetch(imageUrl)
-                if (!response.ok) {
-                    console.warn(`Could not fetch ${imageUrl}, skipping`)
-                    continue
-                }
-
-                // Convert to base64
-                const imageBlob = await response.blob()
-                const reader = new FileReader()
-                const imageData = await new Promise<string>((resolve) => {
-                    reader.onloadend = () => resolve(reader.result as string)
-                    reader.readAsDataURL(imageBlob)
-                })
-
-                // Generate embedding
-                const embedding = await getImageEmbedding(imageData, { model: "mobilenet" })
-                embeddings.push(embedding)
-
-                // Update progress
-                onProgress?.({
-                    current: i + 1,
-                    total: imageList.length,
-                    status: `Processing image ${i + 1} of ${imageList.length}`
-                })
-            } catch (error) {
-                console.error(`Error processing image ${filename}:`, error)
-                continue
-            }
+        const sources = imageList.map(
+            filename => new URL(`${this.config.baseUrl}/${filename}`, window.location.href)
+        )
+
+        // Fetched and decoded concurrently, embedded in batches on the GPU
+        const results = await getImageEmbeddings(sources, { model: "mobilenet" }, {
+            onProgress: (done, total) => onProgress?.({
+                current: done,
+                total,
+                status: `Processing image ${done} of ${total}`
+            })
+        })
+        const embeddings = results.filter((embedding): embedding is number[] => embedding !== null)
+        if (embeddings.length < results.length) {
+            console.warn(`Skipped ${results.length - embeddings.length} images that could not be processed`)
         }
 
         // Create a sample image file for the import job
@@ -11,6 +11,7 @@ import {
   AlertDialogHeader,
   AlertDialogTitle,
 } from "@/components/ui/alert-dialog"
+import { Checkbox } from "@/components/ui/checkbox"
 
 interface DeleteVectorDialogProps {
   isOpen: boolean
@@ -19,6 +20,9 @@ interface DeleteVectorDialogProps {
   vectorName: string
   isMultiDelete?: boolean
   vectorCount?: number
+  // Offered on a filtered multi-delete: remove every match, not only the rows shown
+  filter?: string
+  onConfirmAllMatches?: () => void
 }
 
 export function DeleteVectorDialog({
@@ -28,9 +32,19 @@ export function DeleteVectorDialog({
   vectorName,
   isMultiDelete = false,
   vectorCount = 0,
+  filter,
+  onConfirmAllMatches,
 }: DeleteVectorDialogProps) {
+  const [allMatches, setAllMatches] = useState(false)
+  const canDeleteAllMatches = isMultiDelete && !!filter?.trim() && !!onConfirmAllMatches
+
   const handleConfirm = () => {
-    onConfirm()
+    if (canDeleteAllMatches && allMatches) {
+      onConfirmAllMatches!()
+    } else {
+      onConfirm()
+    }
+    setAllMatches(false)
     onOpenChange(false)
   }
 
@@ -45,6 +59,26 @@ export function DeleteVectorDialog({
               : "Are you sure you want to delete this vector?"}
           </AlertDialogDescription>
         </AlertDialogHeader>
+        {canDeleteAllMatches && (
+          <label className="flex items-start gap-2 text-sm">
+            <Checkbox
+              checked={allMatches}
+              onCheckedChange={(checked) => setAllMatches(checked === true)}
+            />
+            <span>
+              Delete every element matching <code>{filter}</code>, not only the
+              results shown. Runs as a background job.
+              <span className="block text-xs text-muted-foreground mt-1">
+                The job evaluates the filter itself while it walks the set, not VSIM.
+                Strings used as numbers count as 0 unless fully numeric, as in
+                Redis. <code>in</code> only accepts an array on the right, and
+                array-valued attributes are only supported there; other uses
+                are rejected. Elements whose attributes are missing, null or
+                objects never match.
+              </span>
+            </span>
+          </label>
+        )}
         <AlertDialogFooter>
           <AlertDialogCancel>Cancel</AlertDialogCancel>
           <AlertDialogAction
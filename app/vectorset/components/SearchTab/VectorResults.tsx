@@ -2,7 +2,7 @@ import {
     ColumnConfig,
     useVectorResultsSettings,
 } from "@/app/vectorset/hooks/useVectorResultsSettings"
-import { vgetattr_multi } from "@/lib/redis-server/api"
+import { elementCache, HYDRATE_PAGE_SIZE } from "@/lib/client/elements/elementCache"
 import { useEffect, useMemo, useRef, useState, useCallback } from "react"
 import AttributeColumnsDialog from "./components/AttributeColumnsDialog"
 import DropzoneResultsTable from "./components/DropzoneResultsTable"
@@ -86,12 +86,10 @@ export default function VectorResults({
         new Set()
     )
 
-    // Add ref to track the last results for comparison
-    const lastResultsRef = useRef<typeof results>([])
     const lastKeyNameRef = useRef<string>("")
-    
-    // Debouncing ref for attribute fetching
-    const attributeFetchTimeoutRef = useRef<NodeJS.Timeout>()
+
+    // Rows the table currently mounts; only their attributes are loaded
+    const [visibleRange, setVisibleRange] = useState({ start: 0, end: HYDRATE_PAGE_SIZE })
 
     // Filter fields state - memoized to prevent recalculation
     const filterFields = useMemo(
@@ -180,11 +178,6 @@ export default function VectorResults({
                 },
             ]
 
-            // Clear attribute fetch timeout
-            if (attributeFetchTimeoutRef.current) {
-                clearTimeout(attributeFetchTimeoutRef.current)
-            }
-
             // Batch all state updates
             setAvailableColumns(defaultColumns)
             setAttributeCache({})
@@ -195,153 +188,111 @@ export default function VectorResults({
             setSortDirection("asc")
             setFilterText("")
             setIsLoadingAttributes(false)
-            
-            // Reset results reference
-            lastResultsRef.current = []
         }
     }, [keyName])
 
-    // Single source of truth for attribute fetching - memoized
-    const fetchAttributes = useCallback(async (elements: string[]) => {
-        try {
-            const response = await vgetattr_multi({
-                keyName,
-                elements,
-                returnCommandOnly: false,
-            })
-
-            if (!response?.success || !response?.result) {
-                console.error(`Error fetching attributes`, response?.error)
-                return null
-            }
-            return response.result
-        } catch (error) {
-            console.error(`Error fetching attributes`, error)
-            return null
-        }
-    }, [keyName])
+    const handleVisibleRangeChange = useCallback((start: number, end: number) => {
+        setVisibleRange((prev) =>
+            prev.start === start && prev.end === end ? prev : { start, end }
+        )
+    }, [])
 
-    // Optimized attribute fetching with debouncing and comparison
+    // Loads attributes of the visible rows through the shared element cache,
+    // which already holds any the search returned. Rows are (re)loaded when
+    // not yet known here, or when the cache dropped them after an edit
     useEffect(() => {
-        if (!showAttributes || results.length === 0) {
-            if (attributeFetchTimeoutRef.current) {
-                clearTimeout(attributeFetchTimeoutRef.current)
-            }
-            return
-        }
-
-        // Check if results actually changed (avoid refetching for same data)
-        const currentElements = results.map(row => row[0]).sort()
-        const lastElements = lastResultsRef.current.map(row => row[0]).sort()
-        
-        const elementsChanged = currentElements.length !== lastElements.length || 
-            currentElements.some((element, index) => element !== lastElements[index])
-
-        if (!elementsChanged) {
-            return // No need to refetch if elements haven't changed
-        }
-
-        lastResultsRef.current = results
-
-        // Clear any pending attribute fetch
-        if (attributeFetchTimeoutRef.current) {
-            clearTimeout(attributeFetchTimeoutRef.current)
-        }
-
-        // Debounce attribute fetching to avoid rapid API calls during search
-        attributeFetchTimeoutRef.current = setTimeout(async () => {
-            let isCancelled = false
-            const elements = results.map((row) => row[0])
+        if (!showAttributes || filteredAndSortedResults.length === 0) return
+
+        const elements = filteredAndSortedResults
+            .slice(visibleRange.start, visibleRange.end)
+            .map((row) => row[0])
+            .filter(
+                (element) =>
+                    !(element in attributeCache) ||
+                    elementCache.peek(keyName, element)?.attributes === undefined
+            )
+        if (elements.length === 0) return
 
+        let isCancelled = false
+        // Debounce attribute fetching to avoid rapid API calls while scrolling or searching
+        const timeout = setTimeout(async () => {
             setIsLoadingAttributes(true)
             try {
-                const attributes = await fetchAttributes(elements)
-
-                if (isCancelled || !attributes) return
-
-                // Batch all state updates together
-                const updates = {
-                    newCache: { ...attributeCache },
-                    newParsedCache: {} as Record<string, ParsedAttributes>,
-                    allAttributeColumns: new Set<string>()
-                }
+                const attributes = await elementCache.getAttributes(keyName, elements)
+                if (isCancelled) return
 
+                const loaded: AttributeCache = {}
+                const parsedLoaded: Record<string, ParsedAttributes> = {}
                 elements.forEach((element, i) => {
-                    updates.newCache[element] = attributes[i]
-                    if (attributes[i]) {
-                        try {
-                            const parsed = JSON.parse(attributes[i])
-                            updates.newParsedCache[element] = parsed
-                            Object.keys(parsed).forEach((key) =>
-                                updates.allAttributeColumns.add(key)
-                            )
-                        } catch (error) {
-                            console.error(
-                                `Error parsing attributes for ${element}:`,
-                                error
-                            )
-                        }
+                    // Rows whose page failed stay unknown and are tried again later
+                    if (elementCache.peek(keyName, element)?.attributes === undefined) return
+                    loaded[element] = attributes[i]
+                    if (!attributes[i]) return
+                    try {
+                        parsedLoaded[element] = JSON.parse(attributes[i])
+                    } catch (error) {
+                        console.error(`Error parsing attributes for ${element}:`, error)
                     }
                 })
 
-                if (!isCancelled) {
-                    // Batch state updates
-                    setAttributeCache(updates.newCache)
-                    setParsedAttributeCache(updates.newParsedCache)
-
-                    // Only update columns if they actually changed
-                    setAvailableColumns((prev) => {
-                        const systemColumns = prev.filter(
-                            (col) => col.type === "system"
-                        )
-                        const existingAttributeColumns = new Set(
-                            prev.filter(col => col.type === "attribute").map(col => col.name)
-                        )
-                        
-                        // Only add new columns, don't recreate existing ones
-                        const newAttributeColumns = Array.from(
-                            updates.allAttributeColumns
-                        )
-                        .filter(name => !existingAttributeColumns.has(name))
-                        .map((name) => ({
-                            name,
-                            visible: getColumnVisibilityRef.current(name, true),
-                            type: "attribute" as const,
-                        }))
-
-                        if (newAttributeColumns.length === 0 && 
-                            prev.filter(col => col.type === "attribute").length === updates.allAttributeColumns.size) {
-                            return prev // No changes needed
-                        }
-
-                        const existingAttributeColumnsArray = prev.filter(col => 
-                            col.type === "attribute" && updates.allAttributeColumns.has(col.name)
-                        )
-
-                        return [...systemColumns, ...existingAttributeColumnsArray, ...newAttributeColumns]
-                    })
+                setIsLoadingAttributes(false)
+                if (Object.keys(loaded).length > 0) {
+                    setAttributeCache((prev) => ({ ...prev, ...loaded }))
+                    setParsedAttributeCache((prev) => ({ ...prev, ...parsedLoaded }))
                 }
             } catch (error) {
                 console.error("Error fetching attributes:", error)
-            } finally {
-                if (!isCancelled) {
-                    setIsLoadingAttributes(false)
-                }
+                if (!isCancelled) setIsLoadingAttributes(false)
             }
+        }, 150)
 
-            // Cleanup function
-            return () => {
-                isCancelled = true
+        return () => {
+            isCancelled = true
+            clearTimeout(timeout)
+            setIsLoadingAttributes(false)
+        }
+    }, [showAttributes, filteredAndSortedResults, visibleRange, keyName, attributeCache])
+
+    // Attribute columns follow the keys of the loaded rows of the current results
+    useEffect(() => {
+        const allAttributeColumns = new Set<string>()
+        results.forEach(([element]) => {
+            const parsed = parsedAttributeCache[element]
+            if (parsed && typeof parsed === "object") {
+                Object.keys(parsed).forEach((key) => allAttributeColumns.add(key))
             }
-        }, 150) // 150ms debounce
+        })
 
-        // Cleanup timeout on unmount or dependency change
-        return () => {
-            if (attributeFetchTimeoutRef.current) {
-                clearTimeout(attributeFetchTimeoutRef.current)
+        // Only update columns if they actually changed
+        setAvailableColumns((prev) => {
+            const systemColumns = prev.filter((col) => col.type === "system")
+            const existingAttributeColumns = new Set(
+                prev.filter((col) => col.type === "attribute").map((col) => col.name)
+            )
+
+            // Only add new columns, don't recreate existing ones
+            const newAttributeColumns = Array.from(allAttributeColumns)
+                .filter((name) => !existingAttributeColumns.has(name))
+                .map((name) => ({
+                    name,
+                    visible: getColumnVisibilityRef.current(name, true),
+                    type: "attribute" as const,
+                }))
+
+            if (
+                newAttributeColumns.length === 0 &&
+                existingAttributeColumns.size === allAttributeColumns.size
+            ) {
+                return prev // No changes needed
             }
-        }
-    }, [showAttributes, results, keyName, fetchAttributes])
+
+            const existingAttributeColumnsArray = prev.filter(
+                (col) => col.type === "attribute" && allAttributeColumns.has(col.name)
+            )
+
+            return [...systemColumns, ...existingAttributeColumnsArray, ...newAttributeColumns]
+        })
+    }, [results, parsedAttributeCache])
 
     // Extract field names from searchFilter - memoized
     const filteredFields = useMemo(() => {
@@ -443,6 +394,8 @@ export default function VectorResults({
     // Handle dialog close with updated attributes
     const handleAttributesDialogClose = useCallback((updatedAttributes?: string) => {
         if (updatedAttributes && editingAttributes) {
+            elementCache.setAttributes(keyName, editingAttributes, updatedAttributes)
+
             // If attributes were saved, update our cache directly
             setAttributeCache((prev) => ({
                 ...prev,
@@ -482,7 +435,7 @@ export default function VectorResults({
 
         // Clear the editing state
         setEditingAttributes(null)
-    }, [editingAttributes])
+    }, [editingAttributes, keyName])
 
     const handleSort = useCallback((column: SortColumn) => {
         setSortColumn(prevColumn => {
@@ -656,6 +609,7 @@ export default function VectorResults({
                         handleAddVectorWithImage || (async () => {})
                     }
                     metadata={metadata}
+                    onVisibleRangeChange={handleVisibleRangeChange}
                 />
             ) : (
                 <ExpandedResultsList
@@ -674,6 +628,7 @@ export default function VectorResults({
                     onShowVectorClick={onShowVectorClick}
                     setEditingAttributes={setEditingAttributes}
                     onDeleteClick={onDeleteClick}
+                    onVisibleRangeChange={handleVisibleRangeChange}
                 />
             )}
         </div>
@@ -4,7 +4,8 @@ import { useVectorSearch } from "@/app/vectorset/hooks/useVectorSearch"
 import SearchBox from "@/components/SearchBox"
 import { Tabs, TabsContent, TabsList, TabsTrigger } from "@/components/ui/tabs"
 import { isImageEmbedding, isMultiModalEmbedding, isTextEmbedding } from "@/lib/embeddings/types/embeddingModels"
-import { VectorTuple, vlinks, vsim } from "@/lib/redis-server/api"
+import { EmbeddingVector, VectorTuple, hasEmbedding, vlinks } from "@/lib/redis-server/api"
+import { elementCache } from "@/lib/client/elements/elementCache"
 import { VectorSetMetadata, VectorSetSearchOptions } from "@/lib/types/vectors"
 import { useCallback, useEffect, useRef, useState } from "react"
 import { toast } from "sonner"
@@ -13,13 +14,14 @@ import HNSW2dViz from "../VisualizationTab/vizualizer/HNSW2dViz"
 import { DeleteVectorDialog } from "./DeleteVectorDialog"
 import VectorResults from "./VectorResults"
 import { SearchType } from "@/components/SearchOptions/SearchTypeSelector"
+import { jobs } from "@/app/api/jobs"
     
 interface VectorSearchTabProps {
     vectorSetName: string
     dim: number | null
     metadata: VectorSetMetadata | null
     onAddVector: () => void
-    onShowVector: (element: string) => Promise<number[] | null>
+    onShowVector: (element: string) => Promise<EmbeddingVector | null>
     onDeleteVector: (element: string) => Promise<void>
     onDeleteVector_multi: (elements: string[]) => Promise<void>
     handleAddVector?: (
@@ -80,28 +82,23 @@ export default function VectorSearchTab({
         const fetchVectorsFor3D = async () => {
             if (activeResultsTab === "3d" && vectorSetName && results.length > 0) {
                 // Check if results already have vectors
-                const needsVectors = results.some(result => !result[2] || result[2].length === 0);
+                const needsVectors = results.some(result => !hasEmbedding(result[2]));
                 
                 if (needsVectors) {
                     try {
-                        // Re-fetch search results with embeddings
-                        const elements = results.map(r => r[0]);
-                        const count = results.length;
-                        
-                        // Get the first element to use as search base
-                        const searchElement = elements[0];
-                        
-                        const response = await vsim({
-                            keyName: vectorSetName,
-                            searchElement,
-                            count,
-                            withEmbeddings: true, // Always get embeddings for 3D viz
-                        });
-                        
-                        if (response.success && response.result) {
-                            // Update results with the vector data
-                            setResultsWithVectors(response.result);
-                        }
+                        // Load the missing vectors of these results; ones shown before are cached
+                        const vectors = await elementCache.getEmbeddings(
+                            vectorSetName,
+                            results.map(r => r[0])
+                        );
+                        setResultsWithVectors(
+                            results.map(([element, score, vector, attributes], index) => [
+                                element,
+                                score,
+                                hasEmbedding(vector) ? vector : vectors[index],
+                                attributes,
+                            ])
+                        );
                     } catch (error) {
                         console.error("Error fetching vectors for 3D visualization:", error);
                     }
@@ -120,9 +117,7 @@ export default function VectorSearchTab({
             setResults(newResults)
             
             // Check if results already have vectors
-            const hasVectors = newResults.some(result => 
-                Array.isArray(result[2]) && result[2].length > 0
-            );
+            const hasVectors = newResults.some(result => hasEmbedding(result[2]));
             
             // Update resultsWithVectors if vectors are present
             if (hasVectors) {
@@ -241,6 +236,19 @@ export default function VectorSearchTab({
         }
     }
 
+    const handleConfirmDeleteAllMatches = async () => {
+        try {
+            await jobs.createBulkEditJob(vectorSetName, {
+                action: { type: "delete" },
+                filter: searchFilter,
+            })
+            toast.success("Deleting all matches in the background; see the Import tab for progress")
+        } catch (error) {
+            console.error("Error starting bulk delete:", error)
+            toast.error(error instanceof Error ? error.message : "Failed to start bulk delete")
+        }
+    }
+
     const handleShowVectorClick = async (
         e: React.MouseEvent,
         element: string
@@ -253,7 +261,7 @@ export default function VectorSearchTab({
                 return
             }
 
-            await navigator.clipboard.writeText(JSON.stringify(vector))
+            await navigator.clipboard.writeText(JSON.stringify(Array.from(vector)))
             toast.success("Vector copied to clipboard")
         } catch (error) {
             console.error("Error copying vector:", error)
@@ -264,7 +272,7 @@ export default function VectorSearchTab({
     const getNeighbors = async (
         element: string,
         count: number
-    ): Promise<{ element: string; similarity: number; vector: number[] }[]> => {
+    ): Promise<{ element: string; similarity: number; vector: EmbeddingVector }[]> => {
         try {
             const response = await vlinks({
                 keyName: vectorSetName,
@@ -277,7 +285,12 @@ export default function VectorSearchTab({
 
             // data is an array of arrays
             // each inner array contains [element, similarity, vector]
-            return response.result.flat().map((item) => ({
+            const items = response.result.flat()
+            elementCache.setEmbeddings(
+                vectorSetName,
+                items.map((item) => [item[0], item[2]])
+            )
+            return items.map((item) => ({
                 element: item[0],
                 similarity: item[1],
                 vector: item[2] || [],
@@ -297,6 +310,8 @@ export default function VectorSearchTab({
                 vectorName={vectorToDelete || ""}
                 isMultiDelete={isBulkDelete}
                 vectorCount={vectorsToDelete.length}
+                filter={searchFilter}
+                onConfirmAllMatches={handleConfirmDeleteAllMatches}
             />
             <SearchBox
                 vectorSetName={vectorSetName}
@@ -397,13 +412,14 @@ export default function VectorSearchTab({
                         >
                             {resultsWithVectors.length > 0 && (
                                 <VectorViz3D
+                                    cacheKey={vectorSetName}
                                     data={resultsWithVectors.map((result) => {
                                         // Create an array with 3 zeros as fallback
                                         const fallbackVector = new Array(3).fill(0);
                                         
                                         // Ensure vector exists and has data
-                                        const vector = Array.isArray(result[2]) && result[2].length > 0 
-                                            ? result[2] 
+                                        const vector = hasEmbedding(result[2])
+                                            ? result[2]
                                             : fallbackVector;
                                         
                                         return {
@@ -8,14 +8,16 @@ import {
 } from "@/components/EmbeddingConfig/EmbeddingIcons"
 import { EmbeddingDataFormat, getEmbeddingDataFormat } from "@/lib/embeddings/types/embeddingModels"
 import { VectorSetMetadata } from "@/lib/types/vectors"
+import { areRowPropsEqual } from "../utils"
 
 interface CompactResultRowProps {
     row: VectorTuple
     index: number
     availableColumns: ColumnConfig[]
-    parsedAttributeCache: Record<string, Record<string, any>>
+    // Parsed attributes of this row's element
+    attributes?: Record<string, any>
     selectMode: boolean
-    selectedElements: Set<string>
+    isSelected: boolean
     handleSelectToggle: (element: string) => void
     handleSearchSimilar: (element: string) => void
     onShowVectorClick: (e: React.MouseEvent, element: string) => void
@@ -28,9 +30,9 @@ const CompactResultRow = React.memo(function CompactResultRow({
     row,
     index,
     availableColumns,
-    parsedAttributeCache,
+    attributes,
     selectMode,
-    selectedElements,
+    isSelected,
     handleSelectToggle,
     handleSearchSimilar,
     onShowVectorClick,
@@ -47,10 +49,10 @@ const CompactResultRow = React.memo(function CompactResultRow({
     }
 
     const element = row[0]
-    const isSelected = selectedElements.has(element)
 
     return (
         <TableRow
+            data-index={index}
             className={`group ${
                 isSelected
                     ? "bg-blue-50"
@@ -102,7 +104,7 @@ const CompactResultRow = React.memo(function CompactResultRow({
                         ) : (
                             <span className="text-xs">
                                 {formatAttributeValue(
-                                    parsedAttributeCache[element]?.[col.name]
+                                    attributes?.[col.name]
                                 )}
                             </span>
                         )}
@@ -202,6 +204,6 @@ const CompactResultRow = React.memo(function CompactResultRow({
             </TableCell>
         </TableRow>
     )
-})
+}, areRowPropsEqual)
 
 export default CompactResultRow 
\ No newline at end of file
@@ -1,4 +1,4 @@
-import React from "react"
+import React, { useEffect } from "react"
 import { Table, TableBody } from "@/components/ui/table"
 import { VectorTuple } from "@/lib/redis-server/api"
 import { ColumnConfig } from "@/app/vectorset/hooks/useVectorResultsSettings"
@@ -6,6 +6,10 @@ import { FilterField, SortColumn, SortDirection } from "../types"
 import ResultsTableHeader from "./ResultsTableHeader"
 import CompactResultRow from "./CompactResultRow"
 import { VectorSetMetadata } from "@/lib/types/vectors"
+import { useWindowedList } from "@/hooks/useWindowedList"
+
+// Compact rows are one or two lines of text
+const ESTIMATED_ROW_HEIGHT = 49
 
 export interface CompactResultsTableProps {
     filteredAndSortedResults: VectorTuple[]
@@ -25,6 +29,8 @@ export interface CompactResultsTableProps {
     setEditingAttributes: (element: string) => void
     onDeleteClick: (e: React.MouseEvent, element: string) => void
     metadata?: VectorSetMetadata | null
+    // Called with the mounted row range [start, end) whenever it changes
+    onVisibleRangeChange?: (start: number, end: number) => void
 }
 
 const CompactResultsTable = React.memo(function CompactResultsTable({
@@ -44,8 +50,24 @@ const CompactResultsTable = React.memo(function CompactResultsTable({
     onShowVectorClick,
     setEditingAttributes,
     onDeleteClick,
-    metadata
+    metadata,
+    onVisibleRangeChange
 }: CompactResultsTableProps) {
+    // Only rows near the viewport are mounted for large result sets
+    const { containerRef, start, end, paddingTop, paddingBottom } =
+        useWindowedList<HTMLTableSectionElement>({
+            count: filteredAndSortedResults.length,
+            estimatedRowHeight: ESTIMATED_ROW_HEIGHT,
+            resetKey: filteredAndSortedResults,
+        })
+
+    useEffect(() => {
+        onVisibleRangeChange?.(start, end)
+    }, [start, end, onVisibleRangeChange])
+
+    const columnCount =
+        availableColumns.filter((col) => col.visible).length + (selectMode ? 2 : 1)
+
     return (
         <Table>
             <ResultsTableHeader 
@@ -60,16 +82,21 @@ const CompactResultsTable = React.memo(function CompactResultsTable({
                 handleDeselectAll={handleDeselectAll}
                 filteredAndSortedResults={filteredAndSortedResults}
             />
-            <TableBody>
-                {filteredAndSortedResults.map((row, index) => (
+            <TableBody ref={containerRef}>
+                {paddingTop > 0 && (
+                    <tr aria-hidden="true">
+                        <td colSpan={columnCount} style={{ height: paddingTop, padding: 0 }} />
+                    </tr>
+                )}
+                {filteredAndSortedResults.slice(start, end).map((row, offset) => (
                     <CompactResultRow 
-                        key={`${row[0]}-${index}`}
+                        key={`${row[0]}-${start + offset}`}
                         row={row}
-                        index={index}
+                        index={start + offset}
                         availableColumns={availableColumns}
-                        parsedAttributeCache={parsedAttributeCache}
+                        attributes={parsedAttributeCache[row[0]]}
                         selectMode={selectMode}
-                        selectedElements={selectedElements}
+                        isSelected={selectedElements.has(row[0])}
                         handleSelectToggle={handleSelectToggle}
                         handleSearchSimilar={handleSearchSimilar}
                         onShowVectorClick={onShowVectorClick}
@@ -78,6 +105,11 @@ const CompactResultsTable = React.memo(function CompactResultsTable({
                         metadata={metadata}
                     />
                 ))}
+                {paddingBottom > 0 && (
+                    <tr aria-hidden="true">
+                        <td colSpan={columnCount} style={{ height: paddingBottom, padding: 0 }} />
+                    </tr>
+                )}
             </TableBody>
         </Table>
     )
@@ -1,3 +1,4 @@
+import React from "react"
 import { Button } from "@/components/ui/button"
 import { VectorTuple } from "@/lib/redis-server/api"
 import { 
@@ -5,19 +6,21 @@ import {
     ImageEmbeddingIcon, 
     MultiModalEmbeddingIcon 
 } from "@/components/EmbeddingConfig/EmbeddingIcons"
+import { areRowPropsEqual } from "../utils"
 
 interface ExpandedResultRowProps {
     row: VectorTuple
     index: number
     selectMode: boolean
-    selectedElements: Set<string>
+    isSelected: boolean
     showAttributes: boolean
     showOnlyFilteredAttributes: boolean
     isLoadingAttributes: boolean
-    attributeCache: Record<string, string | null>
-    parsedAttributeCache: Record<string, Record<string, any>>
+    // This row's raw attribute JSON: undefined until fetched, null when there is none
+    rawAttributes: string | null | undefined
+    attributes?: Record<string, any>
     filteredFields: string[]
-    filteredFieldValues: Record<string, Record<string, string>>
+    filteredValues?: Record<string, string>
     handleSelectToggle: (element: string) => void
     handleSearchSimilar: (element: string) => void
     onShowVectorClick: (e: React.MouseEvent, element: string) => void
@@ -25,18 +28,18 @@ interface ExpandedResultRowProps {
     onDeleteClick: (e: React.MouseEvent, element: string) => void
 }
 
-export default function ExpandedResultRow({
+const ExpandedResultRow = React.memo(function ExpandedResultRow({
     row,
     index,
     selectMode,
-    selectedElements,
+    isSelected,
     showAttributes,
     showOnlyFilteredAttributes,
     isLoadingAttributes,
-    attributeCache,
-    parsedAttributeCache,
+    rawAttributes,
+    attributes,
     filteredFields,
-    filteredFieldValues,
+    filteredValues,
     handleSelectToggle,
     handleSearchSimilar,
     onShowVectorClick,
@@ -52,9 +55,7 @@ export default function ExpandedResultRow({
     }
 
     // Helper to determine the vector type icon
-    const getVectorTypeIcon = (element: string) => {
-        const attributes = parsedAttributeCache[element]
-        
+    const getVectorTypeIcon = () => {
         // Check for content_type or type attribute that indicates image
         if (attributes?.content_type?.includes('image') || 
             attributes?.type === 'image' || 
@@ -78,7 +79,7 @@ export default function ExpandedResultRow({
     return (
         <div
             className={`bg-[white] rounded-lg border p-4 hover:shadow-md group ${
-                selectedElements.has(row[0])
+                isSelected
                     ? "border-blue-400 bg-blue-50"
                     : ""
             }`}
@@ -94,9 +95,7 @@ export default function ExpandedResultRow({
                     <div className="mr-2 mt-1">
                         <input
                             type="checkbox"
-                            checked={selectedElements.has(
-                                row[0]
-                            )}
+                            checked={isSelected}
                             onChange={() =>
                                 handleSelectToggle(row[0])
                             }
@@ -116,7 +115,7 @@ export default function ExpandedResultRow({
                             </div>
                             <div className="font-medium flex items-center gap-2">
                                 <span className="flex-shrink-0">
-                                    {getVectorTypeIcon(row[0])}
+                                    {getVectorTypeIcon()}
                                 </span>
                                 {row[0]}
                             </div>
@@ -239,9 +238,7 @@ export default function ExpandedResultRow({
                             {field}
                         </div>
                         <div className="font-medium">
-                            {filteredFieldValues[row[0]]?.[
-                                field
-                            ] || ""}
+                            {filteredValues?.[field] || ""}
                         </div>
                     </div>
                 ))}
@@ -251,15 +248,14 @@ export default function ExpandedResultRow({
                         ATTRIBUTES
                     </div>
                     {isLoadingAttributes &&
-                    attributeCache[row[0]] === undefined ? (
+                    rawAttributes === undefined ? (
                         <div className="text-sm text-gray-500">
                             Loading...
                         </div>
-                    ) : attributeCache[row[0]] ? (
+                    ) : rawAttributes ? (
                         <div className="flex gap-4 flex-wrap bg-gray-50 rounded-md p-2 w-full items-center">
                             {Object.entries(
-                                parsedAttributeCache[row[0]] ||
-                                    {}
+                                attributes || {}
                             ).map(([key, value]) => (
                                 <div
                                     key={key}
@@ -315,4 +311,6 @@ export default function ExpandedResultRow({
             )}
         </div>
     )
-} 
\ No newline at end of file
+}, areRowPropsEqual)
+
+export default ExpandedResultRow
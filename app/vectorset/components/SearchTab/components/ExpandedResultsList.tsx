@@ -1,6 +1,11 @@
+import { useEffect } from "react"
 import { VectorTuple } from "@/lib/redis-server/api"
+import { useWindowedList } from "@/hooks/useWindowedList"
 import ExpandedResultRow from "./ExpandedResultRow"
 
+// Card height without attributes, including the gap below it
+const ESTIMATED_ROW_HEIGHT = 136
+
 interface ExpandedResultsListProps {
     filteredAndSortedResults: VectorTuple[]
     selectMode: boolean
@@ -17,6 +22,8 @@ interface ExpandedResultsListProps {
     onShowVectorClick: (e: React.MouseEvent, element: string) => void
     setEditingAttributes: (element: string) => void
     onDeleteClick: (e: React.MouseEvent, element: string) => void
+    // Called with the mounted card range [start, end) whenever it changes
+    onVisibleRangeChange?: (start: number, end: number) => void
 }
 
 export default function ExpandedResultsList({
@@ -34,31 +41,51 @@ export default function ExpandedResultsList({
     handleSearchSimilar,
     onShowVectorClick,
     setEditingAttributes,
-    onDeleteClick
+    onDeleteClick,
+    onVisibleRangeChange
 }: ExpandedResultsListProps) {
+    // Only cards near the viewport are mounted for large result sets
+    const { containerRef, start, end, paddingTop, paddingBottom } =
+        useWindowedList<HTMLDivElement>({
+            count: filteredAndSortedResults.length,
+            estimatedRowHeight: ESTIMATED_ROW_HEIGHT,
+            resetKey: filteredAndSortedResults,
+        })
+
+    useEffect(() => {
+        onVisibleRangeChange?.(start, end)
+    }, [start, end, onVisibleRangeChange])
+
     return (
-        <div className="space-y-4 mb-8">
-            {filteredAndSortedResults.map((row, index) => (
-                <ExpandedResultRow 
-                    key={index}
-                    row={row}
-                    index={index}
-                    selectMode={selectMode}
-                    selectedElements={selectedElements}
-                    showAttributes={showAttributes}
-                    showOnlyFilteredAttributes={showOnlyFilteredAttributes}
-                    isLoadingAttributes={isLoadingAttributes}
-                    attributeCache={attributeCache}
-                    parsedAttributeCache={parsedAttributeCache}
-                    filteredFields={filteredFields}
-                    filteredFieldValues={filteredFieldValues}
-                    handleSelectToggle={handleSelectToggle}
-                    handleSearchSimilar={handleSearchSimilar}
-                    onShowVectorClick={onShowVectorClick}
-                    setEditingAttributes={setEditingAttributes}
-                    onDeleteClick={onDeleteClick}
-                />
-            ))}
+        <div ref={containerRef} className="mb-8">
+            {paddingTop > 0 && <div style={{ height: paddingTop }} />}
+            {filteredAndSortedResults.slice(start, end).map((row, offset) => {
+                const index = start + offset
+                // The gap is padding rather than margin so it is part of the measured height
+                return (
+                    <div key={index} data-index={index} className="pb-4">
+                        <ExpandedResultRow
+                            row={row}
+                            index={index}
+                            selectMode={selectMode}
+                            isSelected={selectedElements.has(row[0])}
+                            showAttributes={showAttributes}
+                            showOnlyFilteredAttributes={showOnlyFilteredAttributes}
+                            isLoadingAttributes={isLoadingAttributes}
+                            rawAttributes={attributeCache[row[0]]}
+                            attributes={parsedAttributeCache[row[0]]}
+                            filteredFields={filteredFields}
+                            filteredValues={filteredFieldValues[row[0]]}
+                            handleSelectToggle={handleSelectToggle}
+                            handleSearchSimilar={handleSearchSimilar}
+                            onShowVectorClick={onShowVectorClick}
+                            setEditingAttributes={setEditingAttributes}
+                            onDeleteClick={onDeleteClick}
+                        />
+                    </div>
+                )
+            })}
+            {paddingBottom > 0 && <div style={{ height: paddingBottom }} />}
         </div>
     )
 } 
\ No newline at end of file
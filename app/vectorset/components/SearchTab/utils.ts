@@ -55,4 +55,17 @@ export const sortResults = (
  */
 export const isEmptyVectorSet = (results: VectorTuple[]): boolean => {
     return results.length === 1 && results[0][0] === "Placeholder (Vector)"
-} 
\ No newline at end of file
+}
+
+/**
+ * React.memo comparator for result rows: rows are compared by element and
+ * score rather than tuple identity, so a search that returns the same rows
+ * does not re-render them. Other props are compared shallowly.
+ */
+export function areRowPropsEqual<P extends { row: VectorTuple }>(prev: P, next: P): boolean {
+    if (prev.row[0] !== next.row[0] || prev.row[1] !== next.row[1]) return false
+    for (const key of Object.keys(next) as (keyof P)[]) {
+        if (key !== "row" && prev[key] !== next[key]) return false
+    }
+    return true
+}
@@ -1,13 +1,13 @@
 import { ApiError } from "@/app/api/client"
 import { vectorSets } from "@/app/api/vector-sets"
 import EditEmbeddingConfigModal from "@/components/EmbeddingConfig/EditEmbeddingConfigDialog"
-import { vinfo_multi } from "@/lib/redis-server/api"
 import { VectorSetMetadata } from "@/lib/types/vectors"
 import eventBus, { AppEvents } from "@/lib/client/events/eventEmitter"
 import { sanitizeRedisUrl } from "@/lib/server/redis/url"
 import {
     estimateVectorSetMemoryUsage,
     formatBytes,
+    parseQuantization,
 } from "@/lib/storage/vectorSetMemory"
 import CreateVectorSetModal from "@/app/vectorset/components/CreateVectorSetDialog"
 import DeleteVectorSetDialog from "@/app/vectorset/components/DeleteVectorSetDialog"
@@ -129,84 +129,31 @@ export default function VectorSetNav({
         refreshingRef.current = true
 
         try {
-            const sets = await vectorSets.list() || []
-
-            // If there are no vector sets, just set empty state and return
-            if (sets.length === 0) {
-                setVectorSetState(prev => ({
-                    ...prev,
-                    list: [],
-                    info: {},
-                    hasLoadedOnce: true,
-                    loading: false
-                }))
-                return
-            }
+            // One request returns every set with its info and metadata
+            const entries = await vectorSets.catalog()
 
             const info: Record<string, VectorSetInfo> = {}
-
-            // Create default info object for a vector set
-            const createDefaultInfo = (set: string): VectorSetInfo => ({
-                name: set,
-                memoryBytes: 0,
-                dimensions: 0,
-                vectorCount: 0,
-            })
-
-            // Fetch info for all vector sets at once
-            const vinfoResponse = await vinfo_multi({ keyNames: sets }).catch(err => {
-                console.error("Error fetching vector set info:", err)
-                return null
-            })
-
-            // If the entire request failed, set default values for all sets
-            if (!vinfoResponse?.success || !vinfoResponse?.result) {
-                console.error(`Failed to fetch vector info: ${vinfoResponse?.error || 'Unknown error'}`)
-                sets.forEach(set => {
-                    info[set] = createDefaultInfo(set)
-                })
-                setVectorSetState(prev => ({
-                    ...prev,
-                    list: [],
-                    info,
-                    hasLoadedOnce: true,
-                    loading: false
-                }))
-                return
-            }
-
-            // Process results for each vector set
-            vinfoResponse.result.forEach((result, index) => {
-                const set = sets[index]
-
-                // Skip if the result is null or undefined (vector set may have been deleted)
-                if (!result) {
-                    return
-                }
-
-                // Handle error case or invalid result
-                if (typeof result !== 'object' || 'error' in result) {
-                    console.debug(`Skipping info for vector set ${set}:`, result)
-                    return
-                }
-
-                const dimensions = Number(result["vector-dim"])
-                const vectorCount = Number(result["size"])
-                const memoryBytes = estimateVectorSetMemoryUsage(dimensions, vectorCount)
-
-                info[set] = {
-                    name: set,
-                    memoryBytes,
-                    dimensions,
-                    vectorCount,
+            entries.forEach((entry) => {
+                const inputDim = Number(entry.info["projection-input-dim"]) || entry.dimensions
+                info[entry.name] = {
+                    name: entry.name,
+                    memoryBytes: estimateVectorSetMemoryUsage(
+                        entry.size,
+                        inputDim,
+                        entry.dimensions,
+                        parseQuantization(String(entry.info["quant-type"] ?? "int8")),
+                        inputDim > entry.dimensions,
+                        Number(entry.info["hnsw-m"]) || undefined
+                    ),
+                    dimensions: entry.dimensions,
+                    vectorCount: entry.size,
+                    metadata: entry.metadata ?? undefined,
                 }
             })
 
-            // Only include vector sets that we successfully got info for
-            const validSets = sets.filter(set => info[set])
             setVectorSetState(prev => ({
                 ...prev,
-                list: validSets,
+                list: entries.map((entry) => entry.name),
                 info,
                 hasLoadedOnce: true,
                 loading: false
@@ -11,7 +11,7 @@ import {
     SelectTrigger,
     SelectValue,
 } from "@/components/ui/select"
-import { VectorTuple, vlinks } from "@/lib/redis-server/api"
+import { VectorTuple, hasEmbedding, vlinks } from "@/lib/redis-server/api"
 import { VectorSetMetadata, VectorSetSearchOptions } from "@/lib/types/vectors"
 import { useCallback, useEffect, useState } from "react"
 import VectorViz3D from "./VectorViz3D"
@@ -118,7 +118,7 @@ export default function VectorSetVisualization({
             // data is an array of arrays
             // each inner array contains [element, similarity, vector]
             // we want to return an array of objects with the following structure:
-            // { element: string, similarity: number, vector: number[] }
+            // { element: string, similarity: number, vector: EmbeddingVector }
             const response = neighbors.flat().map((item) => {
                 if (!item[2]) {
                     console.warn(
@@ -250,7 +250,7 @@ export default function VectorSetVisualization({
                                     initialElement={{
                                         element: results[0][0],
                                         similarity: results[0][1],
-                                        vector: Array.isArray(results[0][2])
+                                        vector: hasEmbedding(results[0][2])
                                             ? results[0][2]
                                             : [],
                                     }}
@@ -261,11 +261,12 @@ export default function VectorSetVisualization({
                                 />
                             ) : (
                                 <VectorViz3D
+                                    cacheKey={vectorSetName}
                                     data={results.map((result) => ({
                                         label: `${
                                             result[0]
                                         } (${result[1].toFixed(3)})`,
-                                        vector: Array.isArray(result[2])
+                                        vector: hasEmbedding(result[2])
                                             ? result[2]
                                             : [],
                                     }))}
@@ -3,94 +3,48 @@ import { Canvas, useFrame, useThree } from "@react-three/fiber"
 import React, { useCallback, useRef, useState } from "react"
 import { Box3, Mesh, Vector3 } from "three"
 import { OrbitControls as OrbitControlsImpl } from "three-stdlib"
+import { EmbeddingVector, hasEmbedding } from "@/lib/redis-server/api"
+import {
+    ProjectionCancelledError,
+    ProjectionParams,
+    projectionCacheKey,
+    runProjection,
+} from "@/lib/vector/projection/service"
 
 // Type definition for data points
 interface DataPoint {
     label: string
-    vector: number[]
+    vector: EmbeddingVector
 }
 
 interface VectorViz3DProps {
     data: DataPoint[]
+    // Scopes cached projections, typically the vector set name
+    cacheKey?: string
 }
 
-// UMAP-inspired dimensionality reduction for 3D visualization
-function reduceToThreeD(vectors: number[][]): number[][] {
-    if (vectors.length === 0) return []
+// Half-width of the cube projected points are scaled into
+const PROJECTION_EXTENT = 3
 
-    // If vectors are already 3D or less, return them directly
-    if (vectors[0].length <= 3) {
-        return vectors.map((v) => {
-            while (v.length < 3) v.push(0)
-            return v.slice(0, 3)
-        })
-    }
-
-    // Compute distance matrix
-    const distMatrix = vectors.map((v1) =>
-        vectors.map((v2) => {
-            // Cosine similarity
-            const dotProduct = v1.reduce((sum, val, i) => sum + val * v2[i], 0)
-            const mag1 = Math.sqrt(v1.reduce((sum, val) => sum + val * val, 0))
-            const mag2 = Math.sqrt(v2.reduce((sum, val) => sum + val * val, 0))
-            const cosSim = dotProduct / (mag1 * mag2) || 0
-            // Convert to distance (1 - similarity)
-            return 1 - cosSim
-        })
-    )
-
-    // Simple MDS-inspired approach
-    const positions: number[][] = []
-
-    // Initialize with random positions
-    for (let i = 0; i < vectors.length; i++) {
-        positions.push([
-            (Math.random() - 0.5) * 3,
-            (Math.random() - 0.5) * 3,
-            (Math.random() - 0.5) * 3,
-        ])
-    }
-
-    // Simple force-directed layout
-    const iterations = 50
-    const learningRate = 0.1
-
-    for (let iter = 0; iter < iterations; iter++) {
-        for (let i = 0; i < vectors.length; i++) {
-            const forces = [0, 0, 0]
-
-            for (let j = 0; j < vectors.length; j++) {
-                if (i === j) continue
-
-                // Current distance in 3D space
-                const dx = positions[i][0] - positions[j][0]
-                const dy = positions[i][1] - positions[j][1]
-                const dz = positions[i][2] - positions[j][2]
-                const currentDist =
-                    Math.sqrt(dx * dx + dy * dy + dz * dz) || 0.001
-
-                // Target distance from distance matrix
-                const targetDist = distMatrix[i][j] * 3
-
-                // Force direction
-                const fx = (dx / currentDist) * (targetDist - currentDist)
-                const fy = (dy / currentDist) * (targetDist - currentDist)
-                const fz = (dz / currentDist) * (targetDist - currentDist)
-
-                forces[0] += fx
-                forces[1] += fy
-                forces[2] += fz
-            }
+// Centres the projection and scales its largest axis to the viz cube, since
+// UMAP and PCA output ranges vary with the data
+function fitToCube(points: number[][]): number[][] {
+    if (points.length === 0) return points
 
-            // Apply forces with decreasing learning rate
-            const currentLR = learningRate * (1 - iter / iterations)
-            positions[i][0] += forces[0] * currentLR
-            positions[i][1] += forces[1] * currentLR
-            positions[i][2] += forces[2] * currentLR
+    const min = [Infinity, Infinity, Infinity]
+    const max = [-Infinity, -Infinity, -Infinity]
+    points.forEach((p) => {
+        for (let c = 0; c < 3; c++) {
+            min[c] = Math.min(min[c], p[c])
+            max[c] = Math.max(max[c], p[c])
         }
-    }
+    })
+    const range = Math.max(max[0] - min[0], max[1] - min[1], max[2] - min[2]) || 1
+    const scale = (PROJECTION_EXTENT * 2) / range
 
-    return positions
+    return points.map((p) =>
+        p.map((value, c) => (value - (min[c] + max[c]) / 2) * scale)
+    )
 }
 
 // Calculate a color based on vector properties
@@ -359,6 +313,7 @@ const CameraController = ({
 export default function VectorViz3D({
     data,
     onVectorSelect,
+    cacheKey,
 }: VectorViz3DProps & {
     onVectorSelect?: (element: string) => void
 }) {
@@ -379,66 +334,68 @@ export default function VectorViz3D({
 
     // Filter out invalid data
     const validData = React.useMemo(() => {
-        return data.filter(
-            (item) =>
-                item &&
-                item.vector &&
-                Array.isArray(item.vector) &&
-                item.vector.length > 0
-        )
+        return data.filter((item) => item && hasEmbedding(item.vector))
     }, [data])
 
-    // Extract vectors for dimensionality reduction
+    // Extract vectors as plain arrays so typed arrays from binary responses
+    // work with the array math below
     const vectors = React.useMemo(() => {
-        return validData.map((item) => item.vector)
+        return validData.map((item) => Array.from(item.vector))
     }, [validData])
 
-    // Use a ref to store positions so they don't change on re-renders
-    const positionsRef = useRef<number[][]>([])
-    const isInitializedRef = useRef<boolean>(false)
     const isProcessingClickRef = useRef<boolean>(false)
+    const [positions, setPositions] = useState<number[][]>([])
+    const [projectionProgress, setProjectionProgress] = useState<number | null>(null)
 
-    // Calculate positions using useMemo instead of useEffect
-    const positions = React.useMemo(() => {
-
-        // If we already have positions and we're initialized, only recalculate if data changed
-        if (isInitializedRef.current && positionsRef.current.length > 0) {
-            const dataChanged = vectors.some((vector, idx) => {
-                const changed =
-                    !positionsRef.current[idx] ||
-                    vector.length !== positionsRef.current[idx].length ||
-                    vector.some(
-                        (val, i) =>
-                            Math.abs(val - positionsRef.current[idx][i]) >
-                            0.0001
-                    )
-                if (changed) {
-                    return true
-                }
-                return false
-            })
+    // Project in the background; results are cached per vector set and sample
+    React.useEffect(() => {
+        if (vectors.length === 0) {
+            setPositions([])
+            setProjectionProgress(null)
+            return
+        }
 
-            if (!dataChanged) {
-                return positionsRef.current
-            }
+        const params: ProjectionParams = {
+            method: vectors.length >= 10 ? "umap" : "pca",
+            components: 3,
         }
+        const job = runProjection(vectors, params, {
+            cacheKey: projectionCacheKey(
+                `3d:${cacheKey ?? ""}`,
+                params,
+                validData.map((item) => item.label)
+            ),
+            onProgress: setProjectionProgress,
+        })
 
-        // Calculate new positions
-        const newPositions = vectors.length > 0 ? reduceToThreeD(vectors) : []
-        positionsRef.current = newPositions
-        isInitializedRef.current = true
-        return newPositions
-    }, [vectors])
+        let active = true
+        job.promise
+            .then((projected) => {
+                if (!active) return
+                setPositions(fitToCube(projected))
+                setProjectionProgress(null)
+            })
+            .catch((error) => {
+                if (!active || error instanceof ProjectionCancelledError) return
+                console.error("[VectorViz3D] Projection failed:", error)
+                setProjectionProgress(null)
+            })
+
+        return () => {
+            active = false
+            job.cancel()
+        }
+    }, [vectors, validData, cacheKey])
 
     // Combine data with positions using the memoized positions
     const pointsData = React.useMemo(() => {
         return validData.map((item, idx) => ({
             label: item.label,
-            vector: item.vector,
+            vector: vectors[idx],
             position: (positions[idx] || [0, 0, 0]) as [number, number, number],
-            color: getVectorColor(item.vector),
+            color: getVectorColor(vectors[idx]),
         }))
-    }, [validData, positions])
+    }, [validData, vectors, positions])
 
     // Calculate bounding box using memoized pointsData
     const { center, maxDim } = React.useMemo(() => {
@@ -831,6 +788,25 @@ export default function VectorViz3D({
                 )}
             </div>
 
+            {projectionProgress !== null && (
+                <div
+                    style={{
+                        position: "absolute",
+                        top: "50%",
+                        left: "50%",
+                        transform: "translate(-50%, -50%)",
+                        background: "rgba(255,255,255,0.9)",
+                        color: "#333",
+                        padding: "8px 12px",
+                        borderRadius: "4px",
+                        fontSize: "12px",
+                        boxShadow: "0 2px 4px rgba(0,0,0,0.1)",
+                    }}
+                >
+                    Projecting vectors... {Math.round(projectionProgress * 100)}%
+                </div>
+            )}
+
             {/* Info panel */}
             <div
                 style={{
@@ -16,11 +16,17 @@ import {
     useNodeManager,
     useThreeScene,
     useVisualizationState,
+    useInstancedGraph,
+    updateEdgeLine,
 } from "./hooks"
 import type { HNSWVizPureProps } from "./types"
-import { vemb } from "@/lib/redis-server/api"
+import { EmbeddingVector } from "@/lib/redis-server/api"
+import { elementCache } from "@/lib/client/elements/elementCache"
 import { COLORS_REDIS_DARK, COLORS_REDIS_LIGHT, NODE_SIZE } from "./constants"
 
+// Shared by every node mesh; disposing it only frees GPU buffers, which are re-created on demand
+const NODE_GEOMETRY = new THREE.SphereGeometry(NODE_SIZE.DEFAULT, 32, 32)
+
 // Add error message display
 const ErrorMessage = ({ message }: { message: string }) => (
     <div className="absolute top-4 left-1/2 transform -translate-x-1/2 bg-red-500/80 text-white px-4 py-2 rounded-md z-50">
@@ -34,6 +40,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
     initialNodes = 20,
     vectorSetName,
     getNeighbors,
+    renderMode = "auto",
 }) => {
     // Refs for hover and selection effects
     const hoverHighlightRef = useRef<THREE.Mesh | null>(null)
@@ -177,12 +184,16 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
     const { nodesRef, edgesRef, addNode, addEdge, startSimulation } =
         useForceSimulator(scene, fitCameraToNodes)
 
+    // Large graphs are drawn with one instanced batch for nodes and one for edges
+    useInstancedGraph(scene, nodesRef, edgesRef, renderMode)
+
     // Initialize layout management
     const {
         currentLayout,
         applyLayout,
         forceSimulationActive,
         isProjectionRunning,
+        projectionProgress,
     } = useLayoutManager(
         nodesRef,
         edgesRef,
@@ -190,22 +201,32 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
         camera,
         renderer,
         fitCameraToNodes,
-        typedCanvasRef
+        typedCanvasRef,
+        vectorSetName
     )
 
     // Initialize node management
-    const { errorMessage, fetchNeighbors } = useNodeManager(
-        maxNodes,
-        getNeighbors
+    const { errorMessage, fetchNeighbors, prefetchNeighbors, resetNeighborCache } =
+        useNodeManager(maxNodes, getNeighbors, vectorSetName)
+
+    // Requests the neighbours of freshly added nodes in one batch, ahead of their expansion
+    const prefetchNextRing = useCallback(
+        (elements: string[]) => {
+            if (elements.length === 0) return
+            prefetchNeighbors(
+                elements,
+                nodesRef.current.map((node) => node.mesh.userData.element)
+            )
+        },
+        [prefetchNeighbors, nodesRef]
     )
 
     // Function to create a node mesh
-    const createNodeMesh = (element: string, vector?: number[]) => {
-        const geometry = new THREE.SphereGeometry(NODE_SIZE.DEFAULT, 32, 32)
+    const createNodeMesh = (element: string, vector?: EmbeddingVector) => {
         const material = new THREE.MeshBasicMaterial({
             color: isDarkMode ? COLORS_REDIS_DARK.NODE.DEFAULT : COLORS_REDIS_LIGHT.NODE.DEFAULT,
         })
-        const mesh = new THREE.Mesh(geometry, material)
+        const mesh = new THREE.Mesh(NODE_GEOMETRY, material)
         mesh.userData = {
             isNode: true,
             element,
@@ -280,15 +301,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
         (node: THREE.Mesh) => {
             edgesRef.current.forEach((edge) => {
                 if (edge.source.mesh === node || edge.target.mesh === node) {
-                    const points = [
-                        edge.source.mesh.position,
-                        edge.target.mesh.position,
-                    ]
-                    const geometry = new THREE.BufferGeometry().setFromPoints(
-                        points
-                    )
-                    edge.line.geometry.dispose()
-                    edge.line.geometry = geometry
+                    updateEdgeLine(edge)
                 }
             })
         },
@@ -370,6 +383,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
 
         // Process each neighbor
         let addedNodes = 0
+        const addedElements: string[] = []
 
         // In user click mode, we want all neighbors
         // In initial expansion mode, we limit by remainingSlots
@@ -432,6 +446,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
                 )
 
                 addedNodes++
+                addedElements.push(item.element)
 
                 // Track the most similar neighbor for potential recursive expansion
                 if (
@@ -447,6 +462,8 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
             }
         }
 
+        prefetchNextRing(addedElements)
+
         // Apply current layout
         applyLayout(currentLayout)
 
@@ -617,6 +634,8 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
                 nodesRef.current = []
                 edgesRef.current = []
                 highlightedEdgesRef.current.clear()
+                // Prefetched lists skip embeddings of nodes that are about to be removed
+                resetNeighborCache()
                 selectedNodeRef.current = null
                 setSelectedNode(null)
                 pulseScaleRef.current = 1
@@ -636,15 +655,14 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
             let vector = initialElement.vector
             if (!vector || vector.length === 0) {
                 try {
-                    const response = await vemb({
-                        keyName: vectorSetName,
-                        element: initialElement.element,
-                        returnCommandOnly: false
-                    })
-                    if (response.success && response.result) {
-                        vector = response.result
+                    // Usually cached already by the results table or 3D view
+                    const [cached] = await elementCache.getEmbeddings(vectorSetName, [
+                        initialElement.element,
+                    ])
+                    if (cached) {
+                        vector = cached
                     } else {
-                        console.error("Failed to fetch vector:", response.error)
+                        console.error("Failed to fetch vector:", initialElement.element)
                     }
                 } catch (error) {
                     console.error("Error fetching vector:", error)
@@ -809,6 +827,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
                 }
 
                 let count = 0
+                const addedElements: string[] = []
                 // Take only as many neighbors as we have slots for
                 const neighborsToProcess = response.result.slice(
                     0,
@@ -853,6 +872,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
                             line
                         )
                         count++
+                        addedElements.push(item.element)
                     }
 
                     // Stop if we've reached the maximum number of nodes
@@ -866,6 +886,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
                 node.userData.expanded = true
                 node.userData.displayState = "expanded"
                 node.userData.neighborCount = count
+                prefetchNextRing(addedElements)
 
                 // Reapply current layout if not using force-directed and not skipping layout reapplication
                 if (currentLayout !== "force" && !skipLayoutReapplication) {
@@ -888,6 +909,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
             createNodeMesh,
             addEdge,
             fetchNeighbors,
+            prefetchNextRing,
             maxNodes,
             edgesRef,
             nodesRef,
@@ -913,7 +935,7 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
         try {
             if (selectedNode.userData.vector) {
                 const vectorString = JSON.stringify(
-                    selectedNode.userData.vector
+                    Array.from(selectedNode.userData.vector as ArrayLike<number>)
                 )
                 await navigator.clipboard.writeText(vectorString)
                 toast.success("Vector copied to clipboard")
@@ -1133,7 +1155,10 @@ const HNSWVizPure: React.FC<HNSWVizPureProps> = ({
                 y={hoverLabel.y}
             />
 
-            <LoadingOverlay isVisible={isProjectionRunning} />
+            <LoadingOverlay
+                isVisible={isProjectionRunning}
+                message={`Running projection... ${Math.round(projectionProgress * 100)}%`}
+            />
         </div>
     )
 }
@@ -37,8 +37,17 @@ export const FORCE_SIMULATION_CONSTANTS = {
     SPRING_COEFFICIENT: 0.1,
     TIMESTEP: 0.1,
     ITERATIONS_PER_FRAME: 10,
+    DAMPING: 0.9,
+    // Barnes–Hut opening angle: cells narrower than theta × distance are summarised
+    BARNES_HUT_THETA: 0.8,
+    // The simulation stops once mean squared speed stays below this for CONVERGED_TICKS ticks
+    CONVERGENCE_ENERGY: 1e-4,
+    CONVERGED_TICKS: 5,
 } as const 
 
+// In "auto" render mode, graphs with at least this many nodes are drawn instanced
+export const INSTANCED_RENDER_THRESHOLD = 300
+
 // Node size constants
 export const NODE_SIZE = {
     DEFAULT: 0.7,       // Regular node size
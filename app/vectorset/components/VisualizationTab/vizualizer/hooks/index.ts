@@ -1,6 +1,7 @@
 export { useThreeScene } from "./useThreeScene"
-export { useForceSimulator } from "./useForceSimulator"
+export { useForceSimulator, updateEdgeLine } from "./useForceSimulator"
 export { useLayoutManager } from "./useLayoutManager"
 export { useNodeManager } from "./useNodeManager"
 export { useCanvasEvents } from "./useCanvasEvents"
-export { useVisualizationState } from "./useVisualizationState" 
\ No newline at end of file
+export { useVisualizationState } from "./useVisualizationState"
+export { useInstancedGraph } from "./useInstancedGraph"
@@ -1,6 +1,20 @@
 import { useEffect, useRef } from "react"
 import * as THREE from "three"
 
+// Resolves the first node under the pointer, including hits on the instanced node batch
+function pickNode(intersects: THREE.Intersection[]): THREE.Mesh | null {
+    for (const hit of intersects) {
+        if (hit.object.userData.isNode) {
+            return hit.object as THREE.Mesh
+        }
+        if (hit.object.userData.isInstancedNodes && hit.instanceId !== undefined) {
+            const mesh = hit.object.userData.nodeAt(hit.instanceId) as THREE.Mesh | null
+            if (mesh) return mesh
+        }
+    }
+    return null
+}
+
 export function useCanvasEvents(
     canvasRef: React.RefObject<HTMLCanvasElement>,
     camera: THREE.OrthographicCamera | null,
@@ -60,12 +74,12 @@ export function useCanvasEvents(
 
             // Handle hover effects
             const intersects = raycaster.intersectObjects(scene.children)
-            const hovered = intersects.find((i) => i.object.userData.isNode)
+            const hovered = pickNode(intersects)
 
             if (hovered) {
-                if (hoveredNodeRef.current !== hovered.object) {
+                if (hoveredNodeRef.current !== hovered) {
                     // New node hovered
-                    hoveredNodeRef.current = hovered.object as THREE.Mesh
+                    hoveredNodeRef.current = hovered
                     onNodeHover(hoveredNodeRef.current)
                     // Update hover label with mouse position
                     updateHoverLabel(
@@ -100,10 +114,9 @@ export function useCanvasEvents(
             mouse.y = -((event.clientY - rect.top) / rect.height) * 2 + 1
             raycaster.setFromCamera(mouse, camera)
             const intersects = raycaster.intersectObjects(scene.children)
-            const clicked = intersects.find((i) => i.object.userData.isNode)
+            const clickedNode = pickNode(intersects)
 
-            if (clicked) {
-                const clickedNode = clicked.object as THREE.Mesh
+            if (clickedNode) {
                 const now = Date.now()
                 const timeSinceLastClick = now - lastClickTimeRef.current
                 const isDoubleClick =
@@ -133,9 +146,7 @@ export function useCanvasEvents(
             mouse.y = -((event.clientY - rect.top) / rect.height) * 2 + 1
             raycaster.setFromCamera(mouse, camera)
             const intersects = raycaster.intersectObjects(scene.children)
-            const clickedOnNode = intersects.find(
-                (i) => i.object.userData.isNode
-            )
+            const clickedOnNode = pickNode(intersects)
 
             if (!clickedOnNode) {
                 isDraggingRef.current = true
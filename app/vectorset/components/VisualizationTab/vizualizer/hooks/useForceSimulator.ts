@@ -3,14 +3,51 @@ import { useCallback, useEffect, useRef } from "react"
 import * as THREE from "three"
 import { FORCE_SIMULATION_CONSTANTS } from "../constants"
 import { ForceEdge, ForceNode } from "../types"
+import {
+    ForceLayoutState,
+    createForceLayoutState,
+    resizeForceLayoutState,
+    stepForceLayout,
+} from "../workers/forceLayout"
+import type {
+    ForceResultMessage,
+    ForceTickMessage,
+} from "../workers/forceSimulation.worker"
 
-const {
-    REPULSION,
-    SPRING_LENGTH,
-    SPRING_COEFFICIENT,
-    TIMESTEP,
-    ITERATIONS_PER_FRAME,
-} = FORCE_SIMULATION_CONSTANTS
+const { ITERATIONS_PER_FRAME, CONVERGENCE_ENERGY, CONVERGED_TICKS } =
+    FORCE_SIMULATION_CONSTANTS
+
+// Moves an edge's two vertices in place rather than allocating a new geometry
+export function updateEdgeLine(edge: ForceEdge) {
+    const geometry = edge.line.geometry
+    const attribute = geometry.getAttribute("position")
+    if (!attribute || attribute.count !== 2) {
+        geometry.setFromPoints([edge.source.mesh.position, edge.target.mesh.position])
+    } else {
+        const s = edge.source.mesh.position
+        const t = edge.target.mesh.position
+        attribute.setXYZ(0, s.x, s.y, s.z)
+        attribute.setXYZ(1, t.x, t.y, t.z)
+        attribute.needsUpdate = true
+    }
+    // The bounding sphere is not recomputed on every move, so never cull on it
+    edge.line.frustumCulled = false
+}
+
+interface SimulationState {
+    // Main-thread copy of the last positions, [x0, y0, x1, y1, ...]; empty while a tick is in flight
+    positions: Float32Array
+    inFlight: boolean
+    // Node array and counts the worker last received edges for
+    syncedNodes: ForceNode[] | null
+    syncedNodeCount: number
+    syncedEdgeCount: number
+    // Nodes the in-flight tick was computed for
+    tickNodes: ForceNode[] | null
+    convergedTicks: number
+    converged: boolean
+    wasActive: boolean
+}
 
 export function useForceSimulator(
     scene: THREE.Scene | null,
@@ -19,6 +56,29 @@ export function useForceSimulator(
     const nodesRef = useRef<ForceNode[]>([])
     const edgesRef = useRef<ForceEdge[]>([])
     const animationFrameId = useRef<number>(null)
+    const workerRef = useRef<Worker | null>(null)
+    // Used instead of the worker when Workers are unavailable
+    const localStateRef = useRef<ForceLayoutState>(createForceLayoutState())
+    const isForceActiveRef = useRef<React.MutableRefObject<boolean> | null>(null)
+    const fitCameraRef = useRef(fitCameraToNodes)
+    fitCameraRef.current = fitCameraToNodes
+    const simRef = useRef<SimulationState>({
+        positions: new Float32Array(0),
+        inFlight: false,
+        syncedNodes: null,
+        syncedNodeCount: 0,
+        syncedEdgeCount: 0,
+        tickNodes: null,
+        convergedTicks: 0,
+        converged: false,
+        wasActive: false,
+    })
+
+    // Restarts a simulation that stopped after converging
+    const wakeSimulation = useCallback(() => {
+        simRef.current.converged = false
+        simRef.current.convergedTicks = 0
+    }, [])
 
     const addNode = useCallback((mesh: THREE.Mesh) => {
         const node: ForceNode = {
@@ -28,8 +88,9 @@ export function useForceSimulator(
             vector: mesh.userData.vector,
         }
         nodesRef.current.push(node)
+        wakeSimulation()
         return node
-    }, [])
+    }, [wakeSimulation])
 
     const addEdge = useCallback(
         (
@@ -40,81 +101,143 @@ export function useForceSimulator(
         ) => {
             const edge: ForceEdge = { source, target, line, strength }
             edgesRef.current.push(edge)
+            wakeSimulation()
             return edge
         },
-        []
+        [wakeSimulation]
     )
 
-    const simulateForces = useCallback(() => {
-        // Run several iterations per frame
-        for (let iter = 0; iter < ITERATIONS_PER_FRAME; iter++) {
-            // Reset forces and apply damping
-            nodesRef.current.forEach((node) => {
-                node.force.set(0, 0)
-                node.velocity.multiplyScalar(0.9)
-            })
+    const applyResult = useCallback((positions: Float32Array, energy: number) => {
+        const sim = simRef.current
+        sim.inFlight = false
+        sim.positions = positions
 
-            // Calculate repulsive forces between nodes
-            for (let i = 0; i < nodesRef.current.length; i++) {
-                for (let j = i + 1; j < nodesRef.current.length; j++) {
-                    const nodeA = nodesRef.current[i]
-                    const nodeB = nodesRef.current[j]
-                    const dx = nodeB.mesh.position.x - nodeA.mesh.position.x
-                    const dy = nodeB.mesh.position.y - nodeA.mesh.position.y
-                    const distSq = dx * dx + dy * dy || 0.001
-                    const dist = Math.sqrt(distSq)
-                    const force = REPULSION / distSq
-                    const fx = (dx / dist) * force
-                    const fy = (dy / dist) * force
-                    nodeA.force.x -= fx
-                    nodeA.force.y -= fy
-                    nodeB.force.x += fx
-                    nodeB.force.y += fy
-                }
+        const nodes = nodesRef.current
+        // Drop results for a graph that was cleared, or a layout that is no longer active
+        if (sim.tickNodes !== nodes || !isForceActiveRef.current?.current) {
+            return
+        }
+
+        // Nodes added while the tick ran keep their own position until the next tick
+        const count = Math.min(nodes.length, positions.length / 2)
+        for (let i = 0; i < count; i++) {
+            nodes[i].mesh.position.x = positions[i * 2]
+            nodes[i].mesh.position.y = positions[i * 2 + 1]
+        }
+        edgesRef.current.forEach(updateEdgeLine)
+
+        if (energy < CONVERGENCE_ENERGY) {
+            sim.convergedTicks++
+            if (sim.convergedTicks >= CONVERGED_TICKS) {
+                sim.converged = true
             }
+        } else {
+            sim.convergedTicks = 0
+        }
 
-            // Calculate spring forces along edges
-            edgesRef.current.forEach((edge) => {
-                const dx =
-                    edge.target.mesh.position.x - edge.source.mesh.position.x
-                const dy =
-                    edge.target.mesh.position.y - edge.source.mesh.position.y
-                const dist = Math.sqrt(dx * dx + dy * dy) || 0.001
-                const force =
-                    (dist - SPRING_LENGTH) * SPRING_COEFFICIENT * edge.strength
-                const fx = (dx / dist) * force
-                const fy = (dy / dist) * force
-                edge.source.force.x += fx
-                edge.source.force.y += fy
-                edge.target.force.x -= fx
-                edge.target.force.y -= fy
-            })
+        // Adjust camera to fit all nodes after forces are applied
+        fitCameraRef.current()
+    }, [])
 
-            // Update positions based on forces
-            nodesRef.current.forEach((node) => {
-                node.velocity.x += node.force.x * TIMESTEP
-                node.velocity.y += node.force.y * TIMESTEP
-                node.mesh.position.x += node.velocity.x * TIMESTEP
-                node.mesh.position.y += node.velocity.y * TIMESTEP
-            })
+    const requestTick = useCallback(() => {
+        const sim = simRef.current
+        const nodes = nodesRef.current
+        const edges = edgesRef.current
+        const n = nodes.length
+        if (n === 0) return
 
-            // Update edge geometries
-            edgesRef.current.forEach((edge) => {
-                const points = [
-                    edge.source.mesh.position.clone(),
-                    edge.target.mesh.position.clone(),
-                ]
-                const geometry = new THREE.BufferGeometry().setFromPoints(
-                    points
-                )
-                edge.line.geometry.dispose()
-                edge.line.geometry = geometry
+        // Start from the meshes' current positions so drags and other layouts are respected
+        let positions = sim.positions
+        if (positions.length !== n * 2) {
+            positions = new Float32Array(n * 2)
+        }
+        for (let i = 0; i < n; i++) {
+            positions[i * 2] = nodes[i].mesh.position.x
+            positions[i * 2 + 1] = nodes[i].mesh.position.y
+        }
+
+        const message: ForceTickMessage = {
+            type: "tick",
+            positions,
+            iterations: ITERATIONS_PER_FRAME,
+        }
+
+        if (
+            nodes !== sim.syncedNodes ||
+            n !== sim.syncedNodeCount ||
+            edges.length !== sim.syncedEdgeCount
+        ) {
+            const index = new Map<ForceNode, number>()
+            nodes.forEach((node, i) => index.set(node, i))
+
+            const edgeIndices: number[] = []
+            const strengths: number[] = []
+            edges.forEach((edge) => {
+                const s = index.get(edge.source)
+                const t = index.get(edge.target)
+                if (s !== undefined && t !== undefined) {
+                    edgeIndices.push(s, t)
+                    strengths.push(edge.strength)
+                }
             })
+
+            message.edges = new Uint32Array(edgeIndices)
+            message.strengths = new Float32Array(strengths)
+            message.resetVelocities = nodes !== sim.syncedNodes
+            sim.syncedNodes = nodes
+            sim.syncedNodeCount = n
+            sim.syncedEdgeCount = edges.length
         }
 
-        // Adjust camera to fit all nodes after forces are applied
-        fitCameraToNodes()
-    }, [fitCameraToNodes])
+        sim.tickNodes = nodes
+        sim.inFlight = true
+
+        const worker = workerRef.current
+        if (worker) {
+            sim.positions = new Float32Array(0)
+            const transfer: Transferable[] = [positions.buffer]
+            if (message.edges) transfer.push(message.edges.buffer, message.strengths.buffer)
+            worker.postMessage(message, transfer)
+            return
+        }
+
+        const state = localStateRef.current
+        if (message.edges) {
+            state.edges = message.edges
+            state.strengths = message.strengths
+        }
+        resizeForceLayoutState(state, n, message.resetVelocities === true)
+        applyResult(positions, stepForceLayout(state, positions, message.iterations))
+    }, [applyResult])
+
+    // True when something other than the simulation moved a node (e.g. dragging)
+    const movedSinceLastTick = useCallback(() => {
+        const positions = simRef.current.positions
+        const nodes = nodesRef.current
+        if (positions.length !== nodes.length * 2) return true
+        for (let i = 0; i < nodes.length; i++) {
+            if (
+                positions[i * 2] !== Math.fround(nodes[i].mesh.position.x) ||
+                positions[i * 2 + 1] !== Math.fround(nodes[i].mesh.position.y)
+            ) {
+                return true
+            }
+        }
+        return false
+    }, [])
+
+    const simulateForces = useCallback(() => {
+        const sim = simRef.current
+        if (sim.inFlight) return
+
+        const edgesChanged = edgesRef.current.length !== sim.syncedEdgeCount
+        if (sim.converged && (edgesChanged || movedSinceLastTick())) {
+            wakeSimulation()
+        }
+        if (!sim.converged) {
+            requestTick()
+        }
+    }, [requestTick, movedSinceLastTick, wakeSimulation])
 
     const startSimulation = useCallback(
         (
@@ -123,9 +246,19 @@ export function useForceSimulator(
             renderer: THREE.WebGLRenderer | null,
             isForceActive: React.MutableRefObject<boolean>
         ) => {
+            isForceActiveRef.current = isForceActive
+            if (animationFrameId.current) {
+                cancelAnimationFrame(animationFrameId.current)
+            }
+
             const animate = () => {
                 // Only run force simulation if it's the active layout
-                if (isForceActive.current) {
+                const active = isForceActive.current
+                if (active && !simRef.current.wasActive) {
+                    wakeSimulation()
+                }
+                simRef.current.wasActive = active
+                if (active) {
                     simulateForces()
                 }
 
@@ -144,16 +277,40 @@ export function useForceSimulator(
             }
             animate()
         },
-        [simulateForces]
+        [simulateForces, wakeSimulation]
     )
 
     useEffect(() => {
+        if (typeof Worker !== "undefined") {
+            try {
+                const worker = new Worker(
+                    new URL("../workers/forceSimulation.worker.ts", import.meta.url)
+                )
+                worker.onmessage = (event: MessageEvent<ForceResultMessage>) => {
+                    applyResult(event.data.positions, event.data.energy)
+                }
+                worker.onerror = (error) => {
+                    console.error("[ForceSimulator] Worker failed, simulating on the main thread:", error)
+                    worker.terminate()
+                    workerRef.current = null
+                    // Resend edges and velocities to the local engine on the next tick
+                    simRef.current.inFlight = false
+                    simRef.current.syncedNodes = null
+                }
+                workerRef.current = worker
+            } catch (error) {
+                console.error("[ForceSimulator] Could not start worker:", error)
+            }
+        }
+
         return () => {
             if (animationFrameId.current) {
                 cancelAnimationFrame(animationFrameId.current)
             }
+            workerRef.current?.terminate()
+            workerRef.current = null
         }
-    }, [])
+    }, [applyResult])
 
-    return { nodesRef, edgesRef, addNode, addEdge, startSimulation }
+    return { nodesRef, edgesRef, addNode, addEdge, startSimulation, wakeSimulation }
 }
@@ -0,0 +1,170 @@
+import { useEffect } from "react"
+import * as THREE from "three"
+import { INSTANCED_RENDER_THRESHOLD, NODE_SIZE } from "../constants"
+import { ForceEdge, ForceNode, GraphRenderMode } from "../types"
+
+// Per-node meshes and per-edge lines move here when the instanced batch draws them
+const PROXY_LAYER = 1
+
+export function isInstancedRenderActive(mode: GraphRenderMode, nodeCount: number) {
+    return mode === "instanced" || (mode === "auto" && nodeCount >= INSTANCED_RENDER_THRESHOLD)
+}
+
+/**
+ * Draws the graph with one InstancedMesh for nodes and one LineSegments for
+ * edges, instead of a mesh and a line per element.
+ *
+ * The per-node meshes and per-edge lines stay in the scene as the source of
+ * truth (position, scale, visibility, material colour and opacity), so the
+ * layout, selection and highlight code keeps working unchanged. They are
+ * moved to a layer the camera and raycaster ignore, and copied into the
+ * instance buffers just before each render.
+ */
+export function useInstancedGraph(
+    scene: THREE.Scene | null,
+    nodesRef: React.MutableRefObject<ForceNode[]>,
+    edgesRef: React.MutableRefObject<ForceEdge[]>,
+    mode: GraphRenderMode
+) {
+    useEffect(() => {
+        if (!scene) return
+
+        const nodeGeometry = new THREE.SphereGeometry(NODE_SIZE.DEFAULT, 16, 12)
+        const nodeMaterial = new THREE.MeshBasicMaterial({ color: 0xffffff })
+        let nodeBatch: THREE.InstancedMesh | null = null
+        let nodeCapacity = 0
+
+        const edgeGeometry = new THREE.BufferGeometry()
+        const edgeMaterial = new THREE.LineBasicMaterial({
+            vertexColors: true,
+            transparent: true,
+        })
+        const edgeBatch = new THREE.LineSegments(edgeGeometry, edgeMaterial)
+        edgeBatch.frustumCulled = false
+        edgeBatch.visible = false
+        scene.add(edgeBatch)
+        let edgeCapacity = 0
+        let edgePositions = new Float32Array(0)
+        // RGBA per vertex so each edge keeps its own opacity
+        let edgeColors = new Float32Array(0)
+
+        const matrix = new THREE.Matrix4()
+        const scale = new THREE.Vector3()
+
+        const ensureNodeCapacity = (count: number) => {
+            if (count <= nodeCapacity && nodeBatch) return
+            nodeCapacity = Math.max(count, nodeCapacity * 2, 256)
+            if (nodeBatch) {
+                scene.remove(nodeBatch)
+                nodeBatch.dispose()
+            }
+            nodeBatch = new THREE.InstancedMesh(nodeGeometry, nodeMaterial, nodeCapacity)
+            nodeBatch.instanceMatrix.setUsage(THREE.DynamicDrawUsage)
+            nodeBatch.instanceColor = new THREE.InstancedBufferAttribute(
+                new Float32Array(nodeCapacity * 3),
+                3
+            )
+            nodeBatch.instanceColor.setUsage(THREE.DynamicDrawUsage)
+            nodeBatch.frustumCulled = false
+            // Lets canvas picking map an instance id back to its node mesh
+            nodeBatch.userData = {
+                isInstancedNodes: true,
+                nodeAt: (instanceId: number) => nodesRef.current[instanceId]?.mesh ?? null,
+            }
+            scene.add(nodeBatch)
+        }
+
+        const ensureEdgeCapacity = (count: number) => {
+            if (count <= edgeCapacity) return
+            edgeCapacity = Math.max(count, edgeCapacity * 2, 256)
+            edgePositions = new Float32Array(edgeCapacity * 6)
+            edgeColors = new Float32Array(edgeCapacity * 8)
+            edgeGeometry.setAttribute(
+                "position",
+                new THREE.BufferAttribute(edgePositions, 3).setUsage(THREE.DynamicDrawUsage)
+            )
+            edgeGeometry.setAttribute(
+                "color",
+                new THREE.BufferAttribute(edgeColors, 4).setUsage(THREE.DynamicDrawUsage)
+            )
+        }
+
+        const sync = () => {
+            const nodes = nodesRef.current
+            const edges = edgesRef.current
+            const active = isInstancedRenderActive(mode, nodes.length)
+
+            const layer = active ? PROXY_LAYER : 0
+            for (let i = 0; i < nodes.length; i++) nodes[i].mesh.layers.set(layer)
+            for (let i = 0; i < edges.length; i++) edges[i].line.layers.set(layer)
+
+            edgeBatch.visible = active && edges.length > 0
+            if (nodeBatch) nodeBatch.visible = active
+            if (!active) return
+
+            ensureNodeCapacity(nodes.length)
+            const batch = nodeBatch!
+            for (let i = 0; i < nodes.length; i++) {
+                const mesh = nodes[i].mesh
+                scale.copy(mesh.scale)
+                if (!mesh.visible) scale.setScalar(0)
+                matrix.compose(mesh.position, mesh.quaternion, scale)
+                batch.setMatrixAt(i, matrix)
+                batch.setColorAt(i, (mesh.material as THREE.MeshBasicMaterial).color)
+            }
+            batch.count = nodes.length
+            batch.instanceMatrix.needsUpdate = true
+            batch.instanceColor!.needsUpdate = true
+            // Recomputed lazily by the next raycast, since nodes move every frame
+            batch.boundingSphere = null
+
+            ensureEdgeCapacity(edges.length)
+            for (let e = 0; e < edges.length; e++) {
+                const line = edges[e].line
+                const s = edges[e].source.mesh.position
+                const t = edges[e].target.mesh.position
+                const p = e * 6
+                edgePositions[p] = s.x
+                edgePositions[p + 1] = s.y
+                edgePositions[p + 2] = s.z
+                edgePositions[p + 3] = t.x
+                edgePositions[p + 4] = t.y
+                edgePositions[p + 5] = t.z
+
+                const material = line.material as THREE.LineBasicMaterial
+                const alpha = line.visible ? material.opacity : 0
+                const c = e * 8
+                for (let v = 0; v < 2; v++) {
+                    edgeColors[c + v * 4] = material.color.r
+                    edgeColors[c + v * 4 + 1] = material.color.g
+                    edgeColors[c + v * 4 + 2] = material.color.b
+                    edgeColors[c + v * 4 + 3] = alpha
+                }
+            }
+            if (edges.length > 0) {
+                edgeGeometry.getAttribute("position").needsUpdate = true
+                edgeGeometry.getAttribute("color").needsUpdate = true
+                edgeGeometry.setDrawRange(0, edges.length * 2)
+            }
+        }
+
+        // Runs before every render, whichever loop triggers it
+        scene.onBeforeRender = sync
+
+        return () => {
+            scene.onBeforeRender = () => {}
+            if (nodeBatch) {
+                scene.remove(nodeBatch)
+                nodeBatch.dispose()
+            }
+            scene.remove(edgeBatch)
+            nodeGeometry.dispose()
+            nodeMaterial.dispose()
+            edgeGeometry.dispose()
+            edgeMaterial.dispose()
+            // Hand drawing back to the per-element objects
+            nodesRef.current.forEach((node) => node.mesh.layers.set(0))
+            edgesRef.current.forEach((edge) => edge.line.layers.set(0))
+        }
+    }, [scene, nodesRef, edgesRef, mode])
+}
@@ -1,15 +1,22 @@
 import { userSettings } from "@/lib/storage/userSettings"
-import { PCA } from "ml-pca"
+import {
+    ProjectionCancelledError,
+    ProjectionJob,
+    ProjectionMethod,
+    ProjectionParams,
+    projectionCacheKey,
+    runProjection,
+} from "@/lib/vector/projection/service"
 import { useCallback, useEffect, useRef, useState } from "react"
 import { toast } from "sonner"
 import * as THREE from "three"
-import { UMAP } from "umap-js"
 import {
     ForceEdge,
     ForceNode,
     LayoutAlgorithm,
     LayoutAlgorithmType,
 } from "../types"
+import { updateEdgeLine } from "./useForceSimulator"
 
 export function useLayoutManager(
     nodesRef: React.MutableRefObject<ForceNode[]>,
@@ -18,7 +25,9 @@ export function useLayoutManager(
     camera: THREE.OrthographicCamera | null,
     renderer: THREE.WebGLRenderer | null,
     fitCameraToNodes: () => void,
-    canvasRef: React.RefObject<HTMLCanvasElement>
+    canvasRef: React.RefObject<HTMLCanvasElement>,
+    // Scopes cached projections to one vector set
+    vectorSetName?: string
 ) {
     // Get stored layout or default to "pca"
     const [currentLayout, setCurrentLayout] =
@@ -26,6 +35,13 @@ export function useLayoutManager(
     const forceSimulationActive = useRef<boolean>(true)
     const [isProjectionRunning, setIsProjectionRunning] =
         useState<boolean>(false)
+    const [projectionProgress, setProjectionProgress] = useState<number>(0)
+    const projectionJobRef = useRef<ProjectionJob | null>(null)
+
+    // Stop any running projection when the visualizer goes away
+    useEffect(() => {
+        return () => projectionJobRef.current?.cancel()
+    }, [])
 
     // Load stored layout on mount
     useEffect(() => {
@@ -104,59 +120,60 @@ export function useLayoutManager(
         name: "Force-Directed",
         description: "Physics-based layout that simulates forces between nodes",
         apply: () => {
+            projectionJobRef.current?.cancel()
             forceSimulationActive.current = true
         },
         animate: true,
     }
 
-    // UMAP layout
-    const umapLayout: LayoutAlgorithm = {
-        name: "UMAP",
-        description:
-            "Uniform Manifold Approximation and Projection - preserves both local and global structure of high-dimensional data. Good for visualizing clusters.",
-        apply: async (nodes) => {
-            forceSimulationActive.current = false
-
-            if (nodes.length === 0) return
-            if (isProjectionRunning) return
+    // Runs a UMAP or PCA projection off the main thread and moves the nodes to it
+    const applyProjection = useCallback(
+        async (nodes: ForceNode[], method: ProjectionMethod) => {
+            const label = method === "umap" ? "UMAP" : "PCA"
+
+            // A newer layout request supersedes whatever is still projecting
+            projectionJobRef.current?.cancel()
+            projectionJobRef.current = null
+
+            const nodeOrder: ForceNode[] = []
+            const vectors: ArrayLike<number>[] = []
+            nodes.forEach((node) => {
+                if (node.vector && node.vector.length > 0) {
+                    vectors.push(node.vector)
+                    nodeOrder.push(node)
+                } else {
+                    console.error("vector is not available for node", node.mesh.userData)
+                }
+            })
 
-            // UMAP requires at least 2 nodes to work properly
-            if (nodes.length < 2) {
+            if (vectors.length < 2) {
+                toast.error(
+                    `Not enough valid vectors for ${label} projection (need at least 2)`
+                )
                 return
             }
 
+            const params: ProjectionParams = {
+                method,
+                components: 2,
+                nEpochs: 200,
+                nNeighbors: 15,
+                minDist: 0.1,
+            }
+            const job = runProjection(vectors, params, {
+                cacheKey: projectionCacheKey(
+                    `hnsw:${vectorSetName ?? ""}`,
+                    params,
+                    nodeOrder.map((node) => String(node.mesh.userData.element ?? ""))
+                ),
+                onProgress: (fraction) => setProjectionProgress(fraction),
+            })
+            projectionJobRef.current = job
+            setProjectionProgress(0)
             setIsProjectionRunning(true)
 
             try {
-                // Prepare data for UMAP
-                const nodeOrder: ForceNode[] = []
-                const vectors: number[][] = []
-                nodes.forEach((node) => {
-                    const vector = node.vector
-                    if (vector) {
-                        vectors.push(vector)
-                        nodeOrder.push(node)
-                    }
-                })
-
-                if (vectors.length < 2) {
-                    toast.error(
-                        "Not enough valid vectors for UMAP projection (need at least 2)"
-                    )
-                    setIsProjectionRunning(false)
-                    return
-                }
-
-                // Configure and run UMAP
-                const umap = new UMAP({
-                    nComponents: 2,
-                    nEpochs: 200,
-                    nNeighbors: Math.min(15, vectors.length - 1),
-                    minDist: 0.1,
-                })
-
-                // Fit and transform the data
-                const embedding = umap.fit(vectors)
+                const embedding = await job.promise
 
                 // Normalize and scale the projection
                 const normalizedEmbedding =
@@ -171,32 +188,38 @@ export function useLayoutManager(
                 })
 
                 // Update edge geometries
-                edgesRef.current.forEach((edge) => {
-                    const points = [
-                        edge.source.mesh.position.clone(),
-                        edge.target.mesh.position.clone(),
-                    ]
-                    const geometry = new THREE.BufferGeometry().setFromPoints(
-                        points
-                    )
-                    edge.line.geometry.dispose()
-                    edge.line.geometry = geometry
-                })
+                edgesRef.current.forEach(updateEdgeLine)
 
                 // Ensure camera fits all nodes after projection
                 setTimeout(() => {
                     fitCameraToNodes()
                 }, 100)
             } catch (error) {
-                console.error("Error in UMAP projection:", error)
+                if (error instanceof ProjectionCancelledError) return
+                console.error(`Error in ${label} projection:`, error)
                 toast.error(
-                    `Error in UMAP projection: ${error instanceof Error ? error.message : "Unknown error"
+                    `Error in ${label} projection: ${error instanceof Error ? error.message : "Unknown error"
                     }`
                 )
             } finally {
-                setIsProjectionRunning(false)
+                if (projectionJobRef.current === job) {
+                    projectionJobRef.current = null
+                    setIsProjectionRunning(false)
+                }
             }
         },
+        [edgesRef, fitCameraToNodes, normalizeAndScaleProjection, vectorSetName]
+    )
+
+    // UMAP layout
+    const umapLayout: LayoutAlgorithm = {
+        name: "UMAP",
+        description:
+            "Uniform Manifold Approximation and Projection - preserves both local and global structure of high-dimensional data. Good for visualizing clusters.",
+        apply: async (nodes) => {
+            forceSimulationActive.current = false
+            await applyProjection(nodes, "umap")
+        },
         animate: false,
     }
 
@@ -207,86 +230,7 @@ export function useLayoutManager(
             "Principal Component Analysis - linear projection that preserves global variance. Fast but may not capture complex relationships between points.",
         apply: async (nodes) => {
             forceSimulationActive.current = false
-
-            if (nodes.length === 0) return
-            if (isProjectionRunning) return
-
-            // PCA requires at least 2 nodes to work properly
-            if (nodes.length < 2) {
-                return
-            }
-
-            setIsProjectionRunning(true)
-
-            try {
-                // Prepare data for PCA
-                const vectors: number[][] = []
-                const nodeOrder: ForceNode[] = []
-
-                nodes.forEach((node) => {
-                    if (node.vector && node.vector.length > 0) {
-                        vectors.push(node.vector)
-                        nodeOrder.push(node)
-                    } else {
-                        console.error("vector is not available for node", node.mesh.userData)
-                    }
-                })
-                if (vectors.length === 0) {
-                    toast.error("No valid vectors for PCA projection")
-                    setIsProjectionRunning(false)
-                    return
-                }
-
-                // Run PCA
-                console.log("vectors", vectors.length)
-                console.log("vector length", vectors[0].length)
-                const pca = new PCA(vectors)
-                const embedding = pca.predict(vectors, { nComponents: 2 })
-
-                // Convert to array of arrays format
-                const pcaEmbedding: number[][] = []
-                for (let i = 0; i < embedding.rows; i++) {
-                    pcaEmbedding.push([
-                        embedding.getRow(i)[0],
-                        embedding.getRow(i)[1],
-                    ])
-                }
-
-                // Normalize and scale the projection
-                const normalizedEmbedding =
-                    normalizeAndScaleProjection(pcaEmbedding)
-
-                // Apply the projection to node positions
-                nodeOrder.forEach((node, i) => {
-                    if (i < normalizedEmbedding.length) {
-                        const [x, y] = normalizedEmbedding[i]
-                        node.mesh.position.set(x, y, node.mesh.position.z)
-                    }
-                })
-
-                // Update edge geometries
-                edgesRef.current.forEach((edge) => {
-                    const points = [
-                        edge.source.mesh.position.clone(),
-                        edge.target.mesh.position.clone(),
-                    ]
-                    const geometry = new THREE.BufferGeometry().setFromPoints(
-                        points
-                    )
-                    edge.line.geometry.dispose()
-                    edge.line.geometry = geometry
-                })
-
-                // Ensure camera fits all nodes after projection
-                setTimeout(() => {
-                    fitCameraToNodes()
-                }, 100)
-            } catch (error) {
-                console.error("Error in PCA projection:", error)
-                toast.error("Error in PCA projection")
-            } finally {
-                setIsProjectionRunning(false)
-            }
+            await applyProjection(nodes, "pca")
         },
         animate: false,
     }
@@ -371,5 +315,6 @@ export function useLayoutManager(
         applyLayout,
         forceSimulationActive,
         isProjectionRunning,
+        projectionProgress,
     }
 }
@@ -1,5 +1,7 @@
-import { useCallback, useState } from "react"
+import { useCallback, useEffect, useRef, useState } from "react"
 import { toast } from "sonner"
+import { vlinks_multi } from "@/lib/redis-server/api"
+import { elementCache } from "@/lib/client/elements/elementCache"
 import { SimilarityItem } from "../types"
 
 interface FetchNeighborsResponse {
@@ -13,9 +15,77 @@ export function useNodeManager(
     getNeighbors: (
         element: string,
         count: number,
-    ) => Promise<SimilarityItem[]>
+    ) => Promise<SimilarityItem[]>,
+    // Enables batched prefetching through VLINKS_MULTI
+    vectorSetName?: string
 ) {
     const [errorMessage, setErrorMessage] = useState<string | null>(null)
+    // Neighbour lists requested ahead of time, keyed by element; null when the batch failed
+    const prefetchedRef = useRef(new Map<string, Promise<SimilarityItem[] | null>>())
+
+    const resetNeighborCache = useCallback(() => {
+        prefetchedRef.current.clear()
+    }, [])
+
+    useEffect(() => {
+        resetNeighborCache()
+    }, [vectorSetName, resetNeighborCache])
+
+    /**
+     * Fetches the neighbours of a whole ring of elements in one request, in
+     * the background, so expanding any of them later needs no round trip.
+     * Embeddings of knownElements (nodes already in the graph) are not sent.
+     */
+    const prefetchNeighbors = useCallback(
+        (elements: string[], knownElements: string[] = []) => {
+            if (!vectorSetName) return
+            const keyName = vectorSetName
+            const cache = prefetchedRef.current
+            const wanted = elements.filter((element) => element && !cache.has(element))
+            if (wanted.length === 0) return
+
+            const batch = vlinks_multi({
+                keyName,
+                elements: wanted,
+                count: maxNodes,
+                withEmbeddings: true,
+                knownElements,
+                vectorEncoding: "binary",
+            })
+                .then((response) => {
+                    if (!response.success || !response.result) {
+                        console.warn("[useNodeManager] Neighbor prefetch failed:", response.error)
+                        return null
+                    }
+                    // Shared with the results table and the 3D view
+                    elementCache.setEmbeddings(keyName, response.result.embeddings)
+                    return response.result
+                })
+                .catch((error) => {
+                    console.warn("[useNodeManager] Neighbor prefetch failed:", error)
+                    return null
+                })
+
+            wanted.forEach((element) => {
+                cache.set(
+                    element,
+                    batch.then((result) => {
+                        if (!result) return null
+                        const vectors = new Map(result.embeddings)
+                        return (result.links[element] ?? []).map(([neighbor, similarity]) => ({
+                            element: neighbor,
+                            similarity,
+                            vector:
+                                vectors.get(neighbor) ??
+                                elementCache.peek(keyName, neighbor)?.embedding ??
+                                [],
+                        }))
+                    })
+                )
+            })
+        },
+        [vectorSetName, maxNodes]
+    )
 
     const fetchNeighbors = useCallback(
         async (element: string): Promise<FetchNeighborsResponse> => {
@@ -26,7 +96,11 @@ export function useNodeManager(
                     return { success: false, result: [], error }
                 }
 
-                const response = await getNeighbors(element, maxNodes)
+                // Use a prefetched list when there is one, even if it is still in flight
+                const prefetched = prefetchedRef.current.get(element)
+                const response =
+                    (prefetched && (await prefetched)) ||
+                    (await getNeighbors(element, maxNodes))
 
                 if (!Array.isArray(response)) {
                     const error = "Invalid response format from getNeighbors"
@@ -59,5 +133,5 @@ export function useNodeManager(
         [maxNodes, getNeighbors]
     )
 
-    return { errorMessage, fetchNeighbors }
+    return { errorMessage, fetchNeighbors, prefetchNeighbors, resetNeighborCache }
 }
@@ -1,4 +1,5 @@
 import * as THREE from "three"
+import { EmbeddingVector } from "@/lib/redis-server/api"
 
 export interface VLinkResponse {
     success: boolean
@@ -13,7 +14,7 @@ export interface VembResponse {
 export interface ForceNode {
     mesh: THREE.Mesh
     label?: THREE.Sprite
-    vector?: number[]
+    vector?: EmbeddingVector
     x: number
     y: number
     vx?: number
@@ -31,19 +32,23 @@ export interface ForceEdge {
 export interface SimilarityItem {
     element: string
     similarity: number
-    vector: number[]
+    vector: EmbeddingVector
 }
 
 export interface FetchNeighborsResponse {
     success: boolean
-    result: Array<{ element: string; similarity: number; vector?: number[] }>
+    result: Array<{ element: string; similarity: number; vector?: EmbeddingVector }>
 }
 
+// "auto" switches to instanced drawing once the graph reaches INSTANCED_RENDER_THRESHOLD nodes
+export type GraphRenderMode = "auto" | "standard" | "instanced"
+
 export interface HNSWVizPureProps {
     initialElement: SimilarityItem
     maxNodes?: number
     initialNodes?: number
     vectorSetName: string
+    renderMode?: GraphRenderMode
     getNeighbors: (
         element: string,
         count: number,
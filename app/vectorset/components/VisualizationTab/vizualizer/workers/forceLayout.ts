@@ -0,0 +1,305 @@
+import { FORCE_SIMULATION_CONSTANTS } from "../constants"
+
+/*
+ * Force-directed layout over flat buffers: positions and velocities are
+ * [x0, y0, x1, y1, ...] and edges are [source0, target0, source1, ...].
+ * Repulsion is approximated with a Barnes–Hut quadtree, so one iteration is
+ * O(n log n) instead of all-pairs. Used by forceSimulation.worker.ts, and
+ * directly on the main thread when Workers are unavailable.
+ */
+
+const {
+    REPULSION,
+    SPRING_LENGTH,
+    SPRING_COEFFICIENT,
+    TIMESTEP,
+    DAMPING,
+    BARNES_HUT_THETA,
+} = FORCE_SIMULATION_CONSTANTS
+
+// Coincident points stop subdividing here and share one leaf
+const MAX_DEPTH = 24
+const EMPTY = -1
+const INTERNAL = -2
+
+export interface ForceLayoutState {
+    velocities: Float32Array
+    forces: Float32Array
+    edges: Uint32Array
+    strengths: Float32Array
+}
+
+export function createForceLayoutState(): ForceLayoutState {
+    return {
+        velocities: new Float32Array(0),
+        forces: new Float32Array(0),
+        edges: new Uint32Array(0),
+        strengths: new Float32Array(0),
+    }
+}
+
+// Resizes for a new node count, keeping the velocity of nodes that already existed
+export function resizeForceLayoutState(
+    state: ForceLayoutState,
+    nodeCount: number,
+    resetVelocities: boolean
+): void {
+    if (state.velocities.length !== nodeCount * 2 || resetVelocities) {
+        const velocities = new Float32Array(nodeCount * 2)
+        if (!resetVelocities) {
+            velocities.set(state.velocities.subarray(0, Math.min(velocities.length, state.velocities.length)))
+        }
+        state.velocities = velocities
+        state.forces = new Float32Array(nodeCount * 2)
+    }
+}
+
+class QuadTree {
+    // Per cell: centre and half width, accumulated mass and mass-weighted position
+    private cx = new Float64Array(0)
+    private cy = new Float64Array(0)
+    private half = new Float64Array(0)
+    private mass = new Float64Array(0)
+    private mx = new Float64Array(0)
+    private my = new Float64Array(0)
+    // Body index for a leaf holding one body, EMPTY, or INTERNAL
+    private body = new Int32Array(0)
+    private children = new Int32Array(0)
+    private depth = new Uint8Array(0)
+    private count = 0
+
+    private ensureCapacity(cells: number): void {
+        if (cells <= this.body.length) return
+        const capacity = Math.max(cells, this.body.length * 2, 64)
+        const grow64 = (old: Float64Array) => {
+            const next = new Float64Array(capacity)
+            next.set(old)
+            return next
+        }
+        this.cx = grow64(this.cx)
+        this.cy = grow64(this.cy)
+        this.half = grow64(this.half)
+        this.mass = grow64(this.mass)
+        this.mx = grow64(this.mx)
+        this.my = grow64(this.my)
+        const body = new Int32Array(capacity)
+        body.set(this.body)
+        this.body = body
+        const children = new Int32Array(capacity * 4)
+        children.set(this.children)
+        this.children = children
+        const depth = new Uint8Array(capacity)
+        depth.set(this.depth)
+        this.depth = depth
+    }
+
+    private addCell(cx: number, cy: number, half: number, depth: number): number {
+        this.ensureCapacity(this.count + 1)
+        const c = this.count++
+        this.cx[c] = cx
+        this.cy[c] = cy
+        this.half[c] = half
+        this.mass[c] = 0
+        this.mx[c] = 0
+        this.my[c] = 0
+        this.body[c] = EMPTY
+        this.depth[c] = depth
+        this.children.fill(EMPTY, c * 4, c * 4 + 4)
+        return c
+    }
+
+    private childFor(cell: number, x: number, y: number): number {
+        const quadrant = (x >= this.cx[cell] ? 1 : 0) + (y >= this.cy[cell] ? 2 : 0)
+        let child = this.children[cell * 4 + quadrant]
+        if (child === EMPTY) {
+            const h = this.half[cell] / 2
+            child = this.addCell(
+                this.cx[cell] + (quadrant & 1 ? h : -h),
+                this.cy[cell] + (quadrant & 2 ? h : -h),
+                h,
+                this.depth[cell] + 1
+            )
+            this.children[cell * 4 + quadrant] = child
+        }
+        return child
+    }
+
+    build(positions: Float32Array, n: number): void {
+        this.count = 0
+        if (n === 0) return
+
+        let minX = Infinity, minY = Infinity, maxX = -Infinity, maxY = -Infinity
+        for (let i = 0; i < n; i++) {
+            const x = positions[i * 2]
+            const y = positions[i * 2 + 1]
+            if (x < minX) minX = x
+            if (x > maxX) maxX = x
+            if (y < minY) minY = y
+            if (y > maxY) maxY = y
+        }
+        const half = Math.max(maxX - minX, maxY - minY, 1e-3) / 2 + 1e-3
+        this.ensureCapacity(n * 2 + 1)
+        this.addCell((minX + maxX) / 2, (minY + maxY) / 2, half, 0)
+
+        for (let i = 0; i < n; i++) {
+            this.insert(i, positions[i * 2], positions[i * 2 + 1], positions)
+        }
+    }
+
+    private insert(i: number, x: number, y: number, positions: Float32Array): void {
+        let cell = 0
+        while (true) {
+            this.mass[cell] += 1
+            this.mx[cell] += x
+            this.my[cell] += y
+
+            const occupant = this.body[cell]
+            if (occupant === EMPTY && this.mass[cell] === 1) {
+                // First body in an empty leaf
+                this.body[cell] = i
+                return
+            }
+            if (occupant === INTERNAL) {
+                cell = this.childFor(cell, x, y)
+                continue
+            }
+            if (this.depth[cell] >= MAX_DEPTH) {
+                // Too deep to separate; the leaf keeps the aggregate only
+                this.body[cell] = EMPTY
+                return
+            }
+
+            // Split a leaf holding one body and push that body down a level
+            this.body[cell] = INTERNAL
+            if (occupant >= 0) {
+                const ox = positions[occupant * 2]
+                const oy = positions[occupant * 2 + 1]
+                const child = this.childFor(cell, ox, oy)
+                this.mass[child] = 1
+                this.mx[child] = ox
+                this.my[child] = oy
+                this.body[child] = occupant
+            }
+            cell = this.childFor(cell, x, y)
+        }
+    }
+
+    // Adds the repulsion acting on body i to forces
+    accumulateRepulsion(i: number, positions: Float32Array, forces: Float32Array, stack: Int32Array): void {
+        if (this.count === 0) return
+
+        const x = positions[i * 2]
+        const y = positions[i * 2 + 1]
+        const thetaSq = BARNES_HUT_THETA * BARNES_HUT_THETA
+        let fx = 0
+        let fy = 0
+        let top = 0
+        stack[top++] = 0
+
+        while (top > 0) {
+            const cell = stack[--top]
+            let mass = this.mass[cell]
+            if (mass === 0 || this.body[cell] === i) continue
+
+            let px = this.mx[cell]
+            let py = this.my[cell]
+            const width = this.half[cell] * 2
+            const internal = this.body[cell] === INTERNAL
+
+            if (internal) {
+                const ddx = px / mass - x
+                const ddy = py / mass - y
+                const distSq = ddx * ddx + ddy * ddy
+                if (width * width >= thetaSq * distSq) {
+                    // Too close to summarise; open the cell
+                    for (let q = 0; q < 4; q++) {
+                        const child = this.children[cell * 4 + q]
+                        if (child !== EMPTY) stack[top++] = child
+                    }
+                    continue
+                }
+            } else if (mass > 1 && x >= this.cx[cell] - this.half[cell] && x < this.cx[cell] + this.half[cell]
+                && y >= this.cy[cell] - this.half[cell] && y < this.cy[cell] + this.half[cell]) {
+                // A depth-capped leaf that may contain i itself
+                px -= x
+                py -= y
+                mass -= 1
+            }
+
+            const dx = px / mass - x
+            const dy = py / mass - y
+            const distSq = dx * dx + dy * dy || 0.001
+            const dist = Math.sqrt(distSq)
+            const force = (REPULSION * mass) / distSq
+            fx -= (dx / dist) * force
+            fy -= (dy / dist) * force
+        }
+
+        forces[i * 2] += fx
+        forces[i * 2 + 1] += fy
+    }
+
+    get cells(): number {
+        return this.count
+    }
+}
+
+const tree = new QuadTree()
+let traversalStack = new Int32Array(256)
+
+/**
+ * Advances the layout by `iterations` steps, moving positions in place.
+ * Returns the mean squared speed after the last step, used to detect convergence.
+ */
+export function stepForceLayout(
+    state: ForceLayoutState,
+    positions: Float32Array,
+    iterations: number
+): number {
+    const n = positions.length / 2
+    const { velocities, forces, edges, strengths } = state
+    let energy = 0
+
+    for (let iter = 0; iter < iterations; iter++) {
+        // Reset forces and apply damping
+        forces.fill(0)
+        for (let k = 0; k < n * 2; k++) {
+            velocities[k] *= DAMPING
+        }
+
+        tree.build(positions, n)
+        // Depth-first traversal holds at most 3 siblings per level plus one cell
+        if (traversalStack.length < tree.cells * 4 + 4) {
+            traversalStack = new Int32Array(tree.cells * 4 + 4)
+        }
+        for (let i = 0; i < n; i++) {
+            tree.accumulateRepulsion(i, positions, forces, traversalStack)
+        }
+
+        // Spring forces along edges
+        for (let e = 0; e < strengths.length; e++) {
+            const s = edges[e * 2]
+            const t = edges[e * 2 + 1]
+            const dx = positions[t * 2] - positions[s * 2]
+            const dy = positions[t * 2 + 1] - positions[s * 2 + 1]
+            const dist = Math.sqrt(dx * dx + dy * dy) || 0.001
+            const force = (dist - SPRING_LENGTH) * SPRING_COEFFICIENT * strengths[e]
+            const fx = (dx / dist) * force
+            const fy = (dy / dist) * force
+            forces[s * 2] += fx
+            forces[s * 2 + 1] += fy
+            forces[t * 2] -= fx
+            forces[t * 2 + 1] -= fy
+        }
+
+        // Integrate
+        energy = 0
+        for (let k = 0; k < n * 2; k++) {
+            velocities[k] += forces[k] * TIMESTEP
+            positions[k] += velocities[k] * TIMESTEP
+            energy += velocities[k] * velocities[k]
+        }
+    }
+
+    return n > 0 ? energy / n : 0
+}
@@ -0,0 +1,51 @@
+import {
+    createForceLayoutState,
+    resizeForceLayoutState,
+    stepForceLayout,
+} from "./forceLayout"
+
+/*
+ * Runs the force layout off the main thread. The positions buffer is
+ * transferred in with every "tick" and transferred back when the step is
+ * done, so the two threads never copy it.
+ */
+
+export interface ForceTickMessage {
+    type: "tick"
+    positions: Float32Array
+    iterations: number
+    // Present when nodes or edges changed since the previous tick
+    edges?: Uint32Array
+    strengths?: Float32Array
+    resetVelocities?: boolean
+}
+
+export interface ForceResultMessage {
+    type: "positions"
+    positions: Float32Array
+    energy: number
+}
+
+const ctx = self as unknown as {
+    onmessage: ((event: MessageEvent<ForceTickMessage>) => void) | null
+    postMessage: (message: ForceResultMessage, transfer: Transferable[]) => void
+}
+
+const state = createForceLayoutState()
+
+ctx.onmessage = (event) => {
+    const message = event.data
+    if (message.type !== "tick") return
+
+    if (message.edges && message.strengths) {
+        state.edges = message.edges
+        state.strengths = message.strengths
+    }
+    resizeForceLayoutState(state, message.positions.length / 2, message.resetVelocities === true)
+
+    const energy = stepForceLayout(state, message.positions, message.iterations)
+    ctx.postMessage(
+        { type: "positions", positions: message.positions, energy },
+        [message.positions.buffer]
+    )
+}
@@ -1,5 +1,6 @@
 import { useEffect, useState } from "react"
-import { VectorTuple, vgetattr_multi } from "@/lib/redis-server/api"
+import { VectorTuple } from "@/lib/redis-server/api"
+import { elementCache, HYDRATE_PAGE_SIZE } from "@/lib/client/elements/elementCache"
 
 export default function useFilterAttributes(
     results: VectorTuple[],
@@ -20,19 +21,15 @@ export default function useFilterAttributes(
             const attributes = new Set<string>()
 
             try {
-                // Extract elements from results
-                const elements = results.map((result) => result[0])
-
-                // Fetch attributes using vgetattr_multi
-                const response = await vgetattr_multi({
-                    keyName: vectorSetName,
-                    elements,
-                    returnCommandOnly: false,
-                })
-                if (!response || !response.success) {
-                    return
-                }
-                const attributesResults = response.result
+                // Field names are read from the first page of results, which the
+                // results table has usually loaded into the element cache already
+                const elements = results
+                    .slice(0, HYDRATE_PAGE_SIZE)
+                    .map((result) => result[0])
+                const attributesResults = await elementCache.getAttributes(
+                    vectorSetName,
+                    elements
+                )
 
                 if (attributesResults && attributesResults.length > 0) {
                     // Process each attribute JSON string
@@ -73,6 +73,11 @@ export default function useSearchOptions({
         return userSettings.getUseWithAttribs()
     })
 
+    // State for progressive search option
+    const [progressiveSearch, setProgressiveSearch] = useState(() => {
+        return userSettings.getProgressiveSearch()
+    })
+
     // State for vector format option
     const [localVectorFormat, setVectorFormatState] = useState<'FP32' | 'VALUES'>(() => {
         const stored = userSettings.get("vectorFormat") as 'FP32' | 'VALUES' | undefined
@@ -194,6 +199,13 @@ export default function useSearchOptions({
         triggerSearchAfterOptionChange()
     }
 
+    // Handle progressive search toggle
+    const handleProgressiveSearchToggle = (checked: boolean) => {
+        setProgressiveSearch(checked)
+        userSettings.setProgressiveSearch(checked)
+        triggerSearchAfterOptionChange()
+    }
+
     // Handle vector format change
     const handleVectorFormatChange = (format: 'FP32' | 'VALUES') => {
         setVectorFormatState(format)
@@ -332,6 +344,10 @@ export default function useSearchOptions({
         // WITHATTRIBS state
         useWithAttribs,
         handleWithAttribsToggle,
+
+        // Progressive search state
+        progressiveSearch,
+        handleProgressiveSearchToggle,
         
         // Vector format state
         vectorFormat: localVectorFormat,
@@ -1,6 +1,8 @@
 import { ApiError } from "@/app/api/client"
 import { embeddings } from "@/lib/embeddings/client"
 import { VectorTuple, vdim, vsim, VsimResult } from "@/lib/redis-server/api"
+import { elementCache } from "@/lib/client/elements/elementCache"
+import { localEmbeddingEngine } from "@/lib/embeddings/client/localEmbeddingEngine"
 import { useCallback, useEffect, useRef, useState } from "react"
 import { VectorSetMetadata, VectorSetSearchOptions } from "@/lib/types/vectors"
 import { userSettings } from "@/lib/storage/userSettings"
@@ -150,6 +152,67 @@ export function useVectorSearch({
         [onError]
     )
 
+    // Bumped by every delivered result set, so loading embeddings for an older one stops
+    const resultsSequenceRef = useRef(0)
+
+    // What VSIM returns with each element; progressive searches ask only for [element, score]
+    const getResultFields = useCallback(() => {
+        if (userSettings.getProgressiveSearch()) {
+            return { withEmbeddings: false, withAttribs: false }
+        }
+        return {
+            withEmbeddings: fetchEmbeddings,
+            vectorEncoding: fetchEmbeddings ? ("binary" as const) : ("json" as const),
+            withAttribs: userSettings.getUseWithAttribs(),
+        }
+    }, [fetchEmbeddings])
+
+    // Shows results right away. Progressive searches then load embeddings through
+    // the shared element cache; attributes are loaded by the rows that show them
+    const deliverResults = useCallback(
+        (result: VsimResult) => {
+            const sequence = ++resultsSequenceRef.current
+            const tuples = convertToVectorTuple(result)
+            onSearchResults(tuples)
+            if (!vectorSetName) return
+
+            if (!userSettings.getProgressiveSearch()) {
+                elementCache.prime(vectorSetName, tuples, {
+                    embedding: fetchEmbeddings,
+                    attributes: userSettings.getUseWithAttribs(),
+                })
+                return
+            }
+            if (!fetchEmbeddings || tuples.length === 0) return
+
+            // Every point of a plot is on screen, so all rows are hydrated
+            elementCache
+                .getEmbeddings(vectorSetName, tuples.map(([element]) => element))
+                .then((vectors) => {
+                    if (sequence !== resultsSequenceRef.current) return
+                    onSearchResults(
+                        tuples.map(([element, score, , attributes], index) => [
+                            element,
+                            score,
+                            vectors[index],
+                            attributes,
+                        ])
+                    )
+                })
+                .catch((error) => {
+                    console.error("Error loading result embeddings:", error)
+                })
+        },
+        [vectorSetName, fetchEmbeddings, onSearchResults]
+    )
+
+    // Load the query model in the embedding worker before the first query, when it runs in the browser
+    useEffect(() => {
+        if (metadata?.embedding) {
+            localEmbeddingEngine.warmUp(metadata.embedding)
+        }
+    }, [metadata?.embedding])
+
     // Function to perform a zero vector search
     const performZeroVectorSearch = useCallback(
         async (count: number) => {
@@ -172,8 +235,7 @@ export function useVectorSearch({
                     keyName: vectorSetName!,
                     searchVector: zeroVector,
                     count,
-                    withEmbeddings: fetchEmbeddings,
-                    withAttribs: userSettings.getUseWithAttribs(),
+                    ...getResultFields(),
                     filter: internalSearchState.searchFilter,
                     searchExplorationFactor: internalSearchState.searchExplorationFactor,
                     filterExplorationFactor: internalSearchState.filterExplorationFactor,
@@ -196,7 +258,7 @@ export function useVectorSearch({
                 }
                 onStatusChange("")
                 // Process results
-                onSearchResults(convertToVectorTuple(vsimResponse.result || []))
+                deliverResults(vsimResponse.result || [])
 
                 if (vsimResponse.executedCommand) {
                     updateSearchState({ executedCommand: vsimResponse.executedCommand })
@@ -216,7 +278,8 @@ export function useVectorSearch({
             vectorSetName,
             onSearchResults,
             onStatusChange,
-            fetchEmbeddings,
+            getResultFields,
+            deliverResults,
             internalSearchState.searchFilter,
             internalSearchState.searchExplorationFactor,
             internalSearchState.filterExplorationFactor,
@@ -523,8 +586,7 @@ export function useVectorSearch({
                 keyName: vectorSetName!,
                 searchVector,
                 count,
-                withEmbeddings: fetchEmbeddings,
-                withAttribs: userSettings.getUseWithAttribs(),
+                ...getResultFields(),
                 filter: internalSearchState.searchFilter,
                 searchExplorationFactor: internalSearchState.searchExplorationFactor,
                 filterExplorationFactor: internalSearchState.filterExplorationFactor,
@@ -545,7 +607,7 @@ export function useVectorSearch({
             updateSearchState({ resultsTitle: searchString })
 
             // Process results
-            onSearchResults(convertToVectorTuple(vsimResponse.result || []))
+            deliverResults(vsimResponse.result || [])
 
             onStatusChange(searchString)
 
@@ -564,7 +626,8 @@ export function useVectorSearch({
             getVectorFromText,
             onSearchResults,
             onStatusChange,
-            fetchEmbeddings,
+            getResultFields,
+            deliverResults,
             updateSearchState,
             clearError,
         ]
@@ -584,8 +647,7 @@ export function useVectorSearch({
                 keyName: vectorSetName!,
                 searchElement: internalSearchState.searchQuery,
                 count,
-                withEmbeddings: fetchEmbeddings,
-                withAttribs: userSettings.getUseWithAttribs(),
+                ...getResultFields(),
                 filter: internalSearchState.searchFilter,
                 searchExplorationFactor: internalSearchState.searchExplorationFactor,
                 filterExplorationFactor: internalSearchState.filterExplorationFactor,
@@ -608,7 +670,7 @@ export function useVectorSearch({
             })
 
             // Process results
-            onSearchResults(convertToVectorTuple(vsimResponse.result || []))
+            deliverResults(vsimResponse.result || [])
 
             if (vsimResponse.executedCommand) {
                 updateSearchState({ executedCommand: vsimResponse.executedCommand })
@@ -624,7 +686,8 @@ export function useVectorSearch({
             onSearchStateChange,
             onSearchResults,
             onStatusChange,
-            fetchEmbeddings,
+            getResultFields,
+            deliverResults,
             clearError,
         ]
     )
@@ -677,8 +740,7 @@ export function useVectorSearch({
                     keyName: vectorSetName!,
                     searchVector: vectorData,
                     count,
-                    withEmbeddings: fetchEmbeddings,
-                    withAttribs: userSettings.getUseWithAttribs(),
+                    ...getResultFields(),
                     filter: internalSearchState.searchFilter,
                     searchExplorationFactor: internalSearchState.searchExplorationFactor,
                     filterExplorationFactor: internalSearchState.filterExplorationFactor,
@@ -701,7 +763,7 @@ export function useVectorSearch({
                 })
 
                 // Process results
-                onSearchResults(convertToVectorTuple(vsimResponse.result || []))
+                deliverResults(vsimResponse.result || [])
                 onStatusChange("Image search complete")
 
                 if (vsimResponse.executedCommand) {
@@ -722,7 +784,8 @@ export function useVectorSearch({
             internalSearchState.noThread,
             onSearchResults,
             onStatusChange,
-            fetchEmbeddings,
+            getResultFields,
+            deliverResults,
             clearError,
             handleError,
             updateSearchState,
@@ -3,14 +3,15 @@ import { vectorSets } from "@/app/api/vector-sets"
 import { embeddings } from "@/lib/embeddings/client"
 import { getExpectedDimensions } from "@/lib/embeddings/types/embeddingModels"
 import {
+    EmbeddingVector,
     VectorTuple,
+    hasEmbedding,
     vadd,
     vcard,
-    vdim,
     vemb,
     vgetattr,
-    vinfo,
     vrem,
+    vrem_multi,
     vsim
 } from "@/lib/redis-server/api"
 import { VectorSetMetadata } from "@/lib/types/vectors"
@@ -39,7 +40,7 @@ interface UseVectorSetReturn {
     ) => Promise<void>
     handleDeleteVector: (element: string) => Promise<void>
     handleDeleteVector_multi: (elements: string[]) => Promise<void>
-    handleShowVector: (element: string) => Promise<number[] | null>
+    handleShowVector: (element: string) => Promise<EmbeddingVector | null>
     updateMetadata: (newMetadata: VectorSetMetadata) => Promise<void>
 }
 
@@ -51,6 +52,25 @@ interface VectorSetCache {
     loaded: boolean
 }
 
+// Record count after a write; the server re-reads the set it was written to
+async function fetchRecordCount(vectorSetName: string): Promise<number> {
+    const info = await vectorSets.getInfo(vectorSetName)
+    if (!info) {
+        throw new Error("Failed to get updated record count")
+    }
+    return info.size
+}
+
+// Live element count for the placeholder decisions. The catalog size can lag
+// behind other tabs and clients, so it is only used for display
+async function fetchLiveCount(vectorSetName: string): Promise<number> {
+    const response = await vcard({ keyName: vectorSetName })
+    if (!response.success || response.result === undefined) {
+        throw new Error(response.error || "Failed to get vector count")
+    }
+    return response.result
+}
+
 const useVectorSet = (): UseVectorSetReturn => {
     const [vectorSetName, setVectorSetName] = useState<string | null>(null)
     const [dim, setDim] = useState<number | null>(null)
@@ -62,35 +82,6 @@ const useVectorSet = (): UseVectorSetReturn => {
     // Cache for vector set data
     const vectorSetCacheRef = useRef<Record<string, VectorSetCache>>({})
 
-    // Load metadata when vector set changes
-    const loadMetadata = useCallback(async () => {
-        if (!vectorSetName) return null
-
-        // Check if metadata is already cached
-        const cache = vectorSetCacheRef.current[vectorSetName]
-        if (cache?.metadata) {
-            setMetadata(cache.metadata)
-            return cache.metadata
-        }
-
-        try {
-            const metadataResult = await vectorSets.getMetadata(vectorSetName)
-            setMetadata(metadataResult)
-
-            // Cache the metadata
-            vectorSetCacheRef.current[vectorSetName] = {
-                ...vectorSetCacheRef.current[vectorSetName],
-                metadata: metadataResult,
-            }
-
-            return metadataResult
-        } catch (error) {
-            console.error("[useVectorSet] Error loading metadata:", error)
-            setMetadata(null)
-            return null
-        }
-    }, [vectorSetName])
-
     // Load vector set data when name changes
     const loadVectorSet = useCallback(async () => {
         if (!vectorSetName) return;
@@ -112,20 +103,18 @@ const useVectorSet = (): UseVectorSetReturn => {
             // Set status message
             setStatusMessage(`Loading vector set "${vectorSetName}"...`)
 
-            // Load information from the vector set
-            // use vinfo to get the dimensions and record count
-            const infoResponse = await vinfo({ keyName: vectorSetName })
-            if (!infoResponse.success || !infoResponse.result) {
-                throw new Error(infoResponse.error || "Failed to get vector set info")
+            // Dimensions, record count and metadata come from the server's catalog in one call
+            const info = await vectorSets.getInfo(vectorSetName)
+            if (!info) {
+                throw new Error(`Vector set "${vectorSetName}" not found`)
             }
-            const dim = Number(infoResponse.result["vector-dim"])
-            const recordCount = Number(infoResponse.result["size"])
+            const dim = info.dimensions
+            const recordCount = info.size
+            const metadataValue = info.metadata
 
             setDim(dim)
             setRecordCount(recordCount)
-
-            // Always load fresh metadata when loadVectorSet is called
-            const metadataValue = await loadMetadata()
+            setMetadata(metadataValue)
 
             // Update the cache with fresh data
             vectorSetCacheRef.current[vectorSetName] = {
@@ -144,7 +133,7 @@ const useVectorSet = (): UseVectorSetReturn => {
                     : "Error loading vector set"
             )
         }
-    }, [vectorSetName, loadMetadata])
+    }, [vectorSetName])
 
     useEffect(() => {
         if (vectorSetName) {
@@ -224,8 +213,7 @@ const useVectorSet = (): UseVectorSetReturn => {
             // special case for default vector.  IF the vector set contains only one vector
             // and it is the default vector, then we should delete the Placeholder (Vector)
             // after adding the new vector.
-            const vectorCountResponse = await vcard({ keyName: vectorSetName })
-            let vectorCount = vectorCountResponse.success ? vectorCountResponse.result : 0
+            const vectorCount = await fetchLiveCount(vectorSetName)
 
             // Use original vector
             const result = await vadd({
@@ -267,33 +255,19 @@ const useVectorSet = (): UseVectorSetReturn => {
             }
 
             // Get the new record count
-            const newRecordCountResponse = await vcard({
-                keyName: vectorSetName,
-            })
-
-            if (
-                !newRecordCountResponse.success ||
-                newRecordCountResponse.result === undefined
-            ) {
-                throw new Error(
-                    newRecordCountResponse.error ||
-                        "Failed to get updated record count"
-                )
-            }
-
-            setRecordCount(newRecordCountResponse.result)
+            const newCount = await fetchRecordCount(vectorSetName)
+            setRecordCount(newCount)
 
             // Update the cache
             if (vectorSetCacheRef.current[vectorSetName]) {
-                vectorSetCacheRef.current[vectorSetName].recordCount =
-                    newRecordCountResponse.result
+                vectorSetCacheRef.current[vectorSetName].recordCount = newCount
             }
 
             // Emit the vector added event
             eventBus.emit(AppEvents.VECTOR_ADDED, {
                 vectorSetName,
                 element,
-                newCount: newRecordCountResponse.result,
+                newCount,
             })
 
             setStatusMessage("Vector created successfully")
@@ -335,12 +309,14 @@ const useVectorSet = (): UseVectorSetReturn => {
             // before deleting the record. This way the placeholder is maintained and the vector set stays valid 
             let placeholderAdded = false;
             if (element !== "Placeholder (Vector)") {
-                const vectorCountResponse = await vcard({ keyName: vectorSetName })
+                const [info, liveCount] = await Promise.all([
+                    vectorSets.getInfo(vectorSetName),
+                    fetchLiveCount(vectorSetName),
+                ])
                 
-                if (vectorCountResponse.success && vectorCountResponse.result === 1) {
-                    const dimResponse = await vdim({ keyName: vectorSetName })
-                    if (dimResponse.success && dimResponse.result) {
-                        const placeholderVector = Array(dimResponse.result).fill(0);
+                if (info && liveCount === 1) {
+                    if (info.dimensions) {
+                        const placeholderVector = Array(info.dimensions).fill(0);
                         await vadd({
                             keyName: vectorSetName,
                             element: "Placeholder (Vector)",
@@ -361,26 +337,19 @@ const useVectorSet = (): UseVectorSetReturn => {
             })
 
             // Get the new record count
-            const newRecordCountResponse = await vcard({
-                keyName: vectorSetName,
-            })
-
-            if (!newRecordCountResponse.success || newRecordCountResponse.result === undefined) {
-                throw new Error(newRecordCountResponse.error || "Failed to get updated record count")
-            }
-
-            setRecordCount(newRecordCountResponse.result)
+            const newCount = await fetchRecordCount(vectorSetName)
+            setRecordCount(newCount)
 
             // Update the cache
             if (vectorSetCacheRef.current[vectorSetName]) {
-                vectorSetCacheRef.current[vectorSetName].recordCount = newRecordCountResponse.result
+                vectorSetCacheRef.current[vectorSetName].recordCount = newCount
             }
 
             // Emit event to notify other components
             eventBus.emit(AppEvents.VECTOR_DELETED, {
                 vectorSetName,
                 element,
-                newCount: newRecordCountResponse.result
+                newCount
             })
 
             setStatusMessage("Vector deleted successfully")
@@ -416,12 +385,15 @@ const useVectorSet = (): UseVectorSetReturn => {
             setStatusMessage(`Deleting elements "${elements}"...`)
             
             // Check if deleting these elements would leave the vector set empty
-            const vectorCountResponse = await vcard({ keyName: vectorSetName })
+            const [info, liveCount] = await Promise.all([
+                vectorSets.getInfo(vectorSetName),
+                fetchLiveCount(vectorSetName),
+            ])
             let placeholderAdded = false;
             
             // If we're going to delete all vectors (or all but the placeholder)
-            if (vectorCountResponse.success) {
-                const currentCount = vectorCountResponse.result;
+            if (info) {
+                const currentCount = liveCount;
                 const deletingCount = elements.length;
                 const hasPlaceholder = elements.includes("Placeholder (Vector)");
                 
@@ -431,9 +403,8 @@ const useVectorSet = (): UseVectorSetReturn => {
                     (!hasPlaceholder && currentCount - deletingCount <= 0))) {
                     
                     // Add a placeholder vector to keep the vector set valid
-                    const dimResponse = await vdim({ keyName: vectorSetName })
-                    if (dimResponse.success && dimResponse.result) {
-                        const placeholderVector = Array(dimResponse.result).fill(0);
+                    if (info.dimensions) {
+                        const placeholderVector = Array(info.dimensions).fill(0);
                         await vadd({
                             keyName: vectorSetName,
                             element: "Placeholder (Vector)",
@@ -449,32 +420,25 @@ const useVectorSet = (): UseVectorSetReturn => {
             }
             
             // Delete the vectors
-            await vrem({
+            await vrem_multi({
                 keyName: vectorSetName,
                 elements,
             })
 
             // Get the new record count
-            const newRecordCountResponse = await vcard({
-                keyName: vectorSetName,
-            })
-
-            if (!newRecordCountResponse.success || newRecordCountResponse.result === undefined) {
-                throw new Error(newRecordCountResponse.error || "Failed to get updated record count")
-            }
-
-            setRecordCount(newRecordCountResponse.result)
+            const newCount = await fetchRecordCount(vectorSetName)
+            setRecordCount(newCount)
 
             // Update the cache
             if (vectorSetCacheRef.current[vectorSetName]) {
-                vectorSetCacheRef.current[vectorSetName].recordCount = newRecordCountResponse.result
+                vectorSetCacheRef.current[vectorSetName].recordCount = newCount
             }
 
             // Emit event to notify other components
             eventBus.emit(AppEvents.VECTOR_DELETED, {
                 vectorSetName,
                 elements,
-                newCount: newRecordCountResponse.result
+                newCount
             })
 
             setStatusMessage("Vectors deleted successfully")
@@ -516,12 +480,7 @@ const useVectorSet = (): UseVectorSetReturn => {
                 (result) => result[0] === element
             )
 
-            if (
-                existingResult &&
-                existingResult[2] !== null &&
-                Array.isArray(existingResult[2]) &&
-                existingResult[2].length > 0
-            ) {
+            if (existingResult && hasEmbedding(existingResult[2])) {
                 // Use the existing vector and update results to ensure it's at the top
                 setResults((prevResults) => {
                     const filteredResults = prevResults.filter(
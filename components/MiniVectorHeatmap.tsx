@@ -3,9 +3,11 @@ import VectorVisualizationRenderer from "./VectorVisualizationRenderer"
 import VectorHeatmap from "./VectorHeatmap"
 import { BarChart2 } from "lucide-react"
 import { useVectorSettings } from "@/hooks/useVectorSettings"
+import { useInView } from "@/hooks/useInView"
+import { EmbeddingVector, hasEmbedding } from "@/lib/redis-server/api"
 
 interface MiniVectorHeatmapProps {
-    vector: number[] | null
+    vector: EmbeddingVector | null
     disabled?: boolean
     isGeneratingEmbedding?: boolean
 }
@@ -18,9 +20,11 @@ export default function MiniVectorHeatmap({
     const [showHeatmap, setShowHeatmap] = useState(false)
     const [isResolving, setIsResolving] = useState(false)
     const { settings } = useVectorSettings()
+    // The canvas is only drawn once the thumbnail scrolls into view
+    const { ref: inViewRef, inView } = useInView<HTMLDivElement>()
         
     // Check if we have a valid vector to display
-    const hasValidVector = vector && vector.length > 0 && vector.every(val => 
+    const hasValidVector = hasEmbedding(vector) && Array.prototype.every.call(vector, (val: number) =>
         typeof val === 'number' && !isNaN(val) && isFinite(val)
     )
     
@@ -46,6 +50,7 @@ export default function MiniVectorHeatmap({
     if (isGeneratingEmbedding || (hasValidVector && !isResolving)) {
         return (
             <div 
+                ref={inViewRef}
                 className="mini-vector-heatmap flex w-20 h-20 items-center justify-center rounded bg-gray-50 relative overflow-hidden"
                 title="Generating embedding..."
             >
@@ -84,6 +89,7 @@ export default function MiniVectorHeatmap({
     return (
         <>
             <div 
+                ref={inViewRef}
                 className="mini-vector-heatmap cursor-pointer flex w-20 h-20 items-center justify-center rounded bg-gray-50 hover:bg-gray-100 transition-colors relative overflow-hidden"
                 onClick={() => setShowHeatmap(true)}
                 title="View vector visualization"
@@ -96,14 +102,16 @@ export default function MiniVectorHeatmap({
                         transform: isResolving ? 'scale(1)' : 'scale(1.05)'
                     }}
                 >
-                    <VectorVisualizationRenderer 
-                        vector={vector}
-                        showStats={false}
-                        size={80}
-                        colorScheme={settings.colorScheme}
-                        scalingMode={settings.scalingMode}
-                        visualizationType={settings.visualizationType}
-                    />
+                    {inView && (
+                        <VectorVisualizationRenderer 
+                            vector={vector}
+                            showStats={false}
+                            size={80}
+                            colorScheme={settings.colorScheme}
+                            scalingMode={settings.scalingMode}
+                            visualizationType={settings.visualizationType}
+                        />
+                    )}
                 </div>
             </div>
             
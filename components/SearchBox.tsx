@@ -307,6 +307,8 @@ export default function SearchBox({
                 handleNoThreadToggle={searchOptions.handleNoThreadToggle}
                 useWithAttribs={searchOptions.useWithAttribs}
                 handleWithAttribsToggle={searchOptions.handleWithAttribsToggle}
+                progressiveSearch={searchOptions.progressiveSearch}
+                handleProgressiveSearchToggle={searchOptions.handleProgressiveSearchToggle}
                 vectorFormat={searchOptions.vectorFormat}
                 handleVectorFormatChange={searchOptions.handleVectorFormatChange}
                 onDone={searchOptions.handleDoneButtonClick}
@@ -44,6 +44,10 @@ interface SearchOptionsDialogProps {
     // WITHATTRIBS option
     useWithAttribs: boolean
     handleWithAttribsToggle: (checked: boolean) => void
+
+    // Progressive search option
+    progressiveSearch: boolean
+    handleProgressiveSearchToggle: (checked: boolean) => void
     
     // Vector format option
     vectorFormat: 'FP32' | 'VALUES'
@@ -70,6 +74,8 @@ export default function SearchOptionsDialog({
     handleNoThreadToggle,
     useWithAttribs,
     handleWithAttribsToggle,
+    progressiveSearch,
+    handleProgressiveSearchToggle,
     vectorFormat,
     handleVectorFormatChange,
     onDone,
@@ -252,6 +258,25 @@ export default function SearchOptionsDialog({
                                 onCheckedChange={handleWithAttribsToggle}
                             />
                         </div>
+
+                        {/* Progressive results */}
+                        <div className="flex items-center justify-between pt-4 border-t">
+                            <div className="space-y-0.5">
+                                <Label htmlFor="progressive-search">
+                                    Progressive results
+                                </Label>
+                                <p className="text-sm text-gray-500">
+                                    Show elements and scores as soon as VSIM returns, then
+                                    load attributes and vectors only for the rows on screen.
+                                    When off, VSIM returns everything in one response.
+                                </p>
+                            </div>
+                            <Switch
+                                id="progressive-search"
+                                checked={progressiveSearch}
+                                onCheckedChange={handleProgressiveSearchToggle}
+                            />
+                        </div>
                     </div>
                 </div>
                 <DialogFooter>
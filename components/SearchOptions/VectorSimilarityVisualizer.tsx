@@ -27,49 +27,57 @@ export default function VectorSimilarityVisualizer({ inputs, combinedVector }: V
         });
     }, [inputs]);
     
+    // Vector data (embedding or parsed string) per valid input, parsed once so
+    // the similarity matrix and heatmaps share the same arrays across renders
+    const vectors = useMemo(() => {
+        return validInputs.map((input): number[] | null => {
+            // Prefer stored embedding
+            if (input.embedding && input.embedding.length > 5) {
+                return input.embedding;
+            }
+            
+            // Fall back to parsing vector string
+            const parsed = parseVectorString(input.vector);
+            if (parsed.length > 5 && !parsed.some(isNaN)) {
+                return parsed;
+            }
+            
+            return null;
+        });
+    }, [validInputs]);
+    
+    // Pairwise cosine similarities; only the upper triangle is computed,
+    // since the matrix is symmetric
+    const similarityMatrix = useMemo(() => {
+        const matrix: (number | null)[][] = vectors.map(() => []);
+        for (let i = 0; i < vectors.length; i++) {
+            // The diagonal is self-similarity
+            matrix[i][i] = 1;
+            for (let j = i + 1; j < vectors.length; j++) {
+                const vec1 = vectors[i];
+                const vec2 = vectors[j];
+                let similarity: number | null = null;
+                
+                // Both vectors must be valid and have the same dimension
+                if (vec1 && vec2 && vec1.length === vec2.length) {
+                    try {
+                        similarity = cosineSimilarity(vec1, vec2);
+                    } catch (error) {
+                        console.error("Error calculating similarity:", error);
+                    }
+                }
+                matrix[i][j] = similarity;
+                matrix[j][i] = similarity;
+            }
+        }
+        return matrix;
+    }, [vectors]);
+    
     // Skip rendering if we don't have at least 2 valid vectors
     if (validInputs.length < 2) {
         return null;
     }
     
-    // Helper function to get vector data (embedding or parsed string)
-    const getVectorData = (input: VectorInput): number[] | null => {
-        // Prefer stored embedding
-        if (input.embedding && input.embedding.length > 5) {
-            return input.embedding;
-        }
-        
-        // Fall back to parsing vector string
-        const parsed = parseVectorString(input.vector);
-        if (parsed.length > 5 && !parsed.some(isNaN)) {
-            return parsed;
-        }
-        
-        return null;
-    };
-    
-    // Calculate similarity matrix
-    const similarityMatrix = validInputs.map((input1, i) => {
-        const vec1 = getVectorData(input1);
-        
-        return validInputs.map((input2, j) => {
-            // For the diagonal, just return 1 (self-similarity)
-            if (i === j) return 1;
-            
-            const vec2 = getVectorData(input2);
-            
-            // Both vectors must be valid and have the same dimension
-            if (!vec1 || !vec2 || vec1.length !== vec2.length) return null;
-            
-            try {
-                return cosineSimilarity(vec1, vec2);
-            } catch (error) {
-                console.error("Error calculating similarity:", error);
-                return null;
-            }
-        });
-    });
-    
     // Helper function to get a color for a similarity value
     const getSimilarityColor = (sim: number | null) => {
         if (sim === null) return 'bg-gray-200';
@@ -141,7 +149,7 @@ export default function VectorSimilarityVisualizer({ inputs, combinedVector }: V
                     <div className="flex items-center justify-center gap-4 mb-3">
                         <div className="flex flex-wrap items-center gap-3">
                             {validInputs.map((input, index) => {
-                                const vector = getVectorData(input);
+                                const vector = vectors[index];
                                 const isPositive = input.weight >= 0;
                                 
                                 // Skip invalid vectors
@@ -1,4 +1,5 @@
 import { useRef, useEffect, useState } from "react"
+import { heatmapColor } from "@/lib/vector/heatmap/raster"
 
 interface VectorDistributionRendererProps {
     vector: number[] | null
@@ -24,63 +25,8 @@ export default function VectorDistributionRenderer({
     // Determine if this is a mini view (simplified rendering)
     const isMiniView = size <= 100
 
-    // Get color based on normalized value (0-1) and color scheme
-    const getColor = (normalizedValue: number): [number, number, number] => {
-        const t = Math.max(0, Math.min(1, normalizedValue))
-
-        switch (colorScheme) {
-            case 'thermal':
-                if (t < 0.2) {
-                    const s = t / 0.2
-                    return [Math.round(s * 64), 0, Math.round(s * 128)]
-                } else if (t < 0.4) {
-                    const s = (t - 0.2) / 0.2
-                    return [Math.round(64 + s * (255 - 64)), 0, Math.round(128 * (1 - s))]
-                } else if (t < 0.6) {
-                    const s = (t - 0.4) / 0.2
-                    return [255, Math.round(s * 165), 0]
-                } else if (t < 0.8) {
-                    const s = (t - 0.6) / 0.2
-                    return [255, Math.round(165 + s * (255 - 165)), 0]
-                } else {
-                    const s = (t - 0.8) / 0.2
-                    return [255, 255, Math.round(s * 255)]
-                }
-
-            case 'viridis':
-                if (t < 0.25) {
-                    const s = t / 0.25
-                    return [Math.round(s * 68), Math.round(s * 1), Math.round(84 + s * (140 - 84))]
-                } else if (t < 0.5) {
-                    const s = (t - 0.25) / 0.25
-                    return [Math.round(68 + s * (53 - 68)), Math.round(1 + s * (95 - 1)), Math.round(140 + s * (169 - 140))]
-                } else if (t < 0.75) {
-                    const s = (t - 0.5) / 0.25
-                    return [Math.round(53 + s * (35 - 53)), Math.round(95 + s * (140 - 95)), Math.round(169 + s * (69 - 169))]
-                } else {
-                    const s = (t - 0.75) / 0.25
-                    return [Math.round(35 + s * (253 - 35)), Math.round(140 + s * (231 - 140)), Math.round(69 + s * (37 - 69))]
-                }
-
-            case 'classic':
-            default:
-                if (t < 0.5) {
-                    const s = t / 0.5
-                    return [
-                        Math.round(100 + s * (255 - 100)),
-                        Math.round(149 + s * (255 - 149)),
-                        Math.round(237 + s * (255 - 237))
-                    ]
-                } else {
-                    const s = (t - 0.5) / 0.5
-                    return [
-                        255,
-                        Math.round(255 - s * (255 - 20)),
-                        Math.round(255 - s * (255 - 60))
-                    ]
-                }
-        }
-    }
+    // Same palette as the heatmap
+    const getColor = (normalizedValue: number) => heatmapColor(normalizedValue, colorScheme)
 
     // Create histogram data from vector
     const createHistogram = (vector: number[], numBins?: number) => {
@@ -5,9 +5,10 @@ import { Download, X } from "lucide-react"
 import VectorVisualizationRenderer from "./VectorVisualizationRenderer"
 import ColorSchemeSelector from "./ColorSchemeSelector"
 import { useVectorSettings } from "@/hooks/useVectorSettings"
+import { EmbeddingVector } from "@/lib/redis-server/api"
 
 interface VectorHeatmapProps {
-    vector: number[] | null
+    vector: EmbeddingVector | null
     open: boolean
     onOpenChange: (open: boolean) => void
 }
@@ -46,10 +47,18 @@ export default function VectorHeatmap({
     const renderVectorStats = () => {
         if (!vector || vector.length === 0) return null
 
-        const min = Math.min(...vector)
-        const max = Math.max(...vector)
-        const avg = vector.reduce((sum, val) => sum + val, 0) / vector.length
-        const nonZeroCount = vector.filter(v => v !== 0).length
+        let min = Infinity
+        let max = -Infinity
+        let sum = 0
+        let nonZeroCount = 0
+        for (let i = 0; i < vector.length; i++) {
+            const v = vector[i]
+            if (v < min) min = v
+            if (v > max) max = v
+            sum += v
+            if (v !== 0) nonZeroCount++
+        }
+        const avg = sum / vector.length
         const nonZeroPercent = ((nonZeroCount / vector.length) * 100).toFixed(1)
 
         return (
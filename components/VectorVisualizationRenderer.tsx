@@ -1,9 +1,11 @@
 import VectorHeatmapRenderer from "./VectorHeatmapRenderer"
 import VectorDistributionRenderer from "./VectorDistributionRenderer"
 import VectorRadialRenderer from "./VectorRadialRenderer"
+import { useMemo } from "react"
+import { EmbeddingVector } from "@/lib/redis-server/api"
 
 interface VectorVisualizationRendererProps {
-    vector: number[] | null
+    vector: EmbeddingVector | null
     className?: string
     size?: number
     showStats?: boolean
@@ -21,11 +23,16 @@ export default function VectorVisualizationRenderer({
     colorScheme = 'thermal',
     visualizationType = 'heatmap'
 }: VectorVisualizationRendererProps) {
-    
+    // The heatmap reads typed arrays directly; the other renderers use array methods
+    const vectorArray = useMemo(
+        () => (vector && visualizationType !== 'heatmap' ? Array.from(vector) : null),
+        [vector, visualizationType]
+    )
+
     if (visualizationType === 'distribution') {
         return (
             <VectorDistributionRenderer
-                vector={vector}
+                vector={vectorArray}
                 className={className}
                 size={size}
                 showStats={showStats}
@@ -38,7 +45,7 @@ export default function VectorVisualizationRenderer({
     if (visualizationType === 'radial') {
         return (
             <VectorRadialRenderer
-                vector={vector}
+                vector={vectorArray}
                 className={className}
                 size={size}
                 showStats={showStats}
@@ -7,6 +7,7 @@ export default function TopNav() {
     const navItems = [
         { href: "/vectorset", paths: ["/vectorset", "/console"], label: "Console", visible: true },
         { href: "/calculator", paths: ["/calculator"], label: "Calculator", visible: true },
+        { href: "/benchmark", paths: ["/benchmark"], label: "Benchmark", visible: true },
         { href: "/docs", paths: ["/docs"], label: "Docs", visible: true },
         {
             href: "/config",
@@ -0,0 +1,34 @@
+import { useEffect, useState } from "react"
+
+/**
+ * Becomes true once the element has come within `rootMargin` of the
+ * viewport and stays true, so expensive content (e.g. a canvas) is only
+ * drawn for elements the user actually scrolls to. `ref` is a callback
+ * ref, so it can move between elements across renders.
+ */
+export function useInView<T extends Element>(rootMargin = "200px") {
+    const [element, ref] = useState<T | null>(null)
+    const [inView, setInView] = useState(false)
+
+    useEffect(() => {
+        if (!element || inView) return
+        if (typeof IntersectionObserver === "undefined") {
+            setInView(true)
+            return
+        }
+
+        const observer = new IntersectionObserver(
+            (entries) => {
+                if (entries.some((entry) => entry.isIntersecting)) {
+                    setInView(true)
+                    observer.disconnect()
+                }
+            },
+            { rootMargin }
+        )
+        observer.observe(element)
+        return () => observer.disconnect()
+    }, [element, inView, rootMargin])
+
+    return { ref, inView }
+}
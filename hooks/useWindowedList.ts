@@ -0,0 +1,143 @@
+import { useCallback, useEffect, useLayoutEffect, useRef, useState } from "react"
+
+// Lists shorter than this are rendered in full
+export const WINDOWED_LIST_THRESHOLD = 100
+
+interface WindowedListOptions {
+    count: number
+    // Height assumed for rows that have not been rendered yet
+    estimatedRowHeight: number
+    // Rows rendered beyond each edge of the viewport
+    overscan?: number
+    // Changing this (e.g. a new result set) discards measured heights
+    resetKey?: unknown
+}
+
+export interface WindowedList<T extends HTMLElement> {
+    // Attach to the element whose children are the rows, each marked with data-index
+    containerRef: React.RefObject<T | null>
+    start: number
+    end: number // Exclusive
+    paddingTop: number
+    paddingBottom: number
+    isWindowed: boolean
+}
+
+/**
+ * Windows a long list of variable-height rows so only the rows near the
+ * viewport are mounted. Rendered rows are measured after each commit and
+ * unmeasured ones use the estimate, so the spacers before and after the
+ * window keep the scroll height close to the full list.
+ *
+ * Scroll events are listened for in the capture phase on document, so the
+ * list works under whichever ancestor actually scrolls.
+ */
+export function useWindowedList<T extends HTMLElement>({
+    count,
+    estimatedRowHeight,
+    overscan = 10,
+    resetKey,
+}: WindowedListOptions): WindowedList<T> {
+    const containerRef = useRef<T | null>(null)
+    const heightsRef = useRef<number[]>([])
+    const isWindowed = count >= WINDOWED_LIST_THRESHOLD
+    const [range, setRange] = useState({ start: 0, end: Math.min(count, overscan * 2) })
+    // Bumped when measurements change the layout, so spacers are recomputed
+    const [, setLayoutVersion] = useState(0)
+
+    useEffect(() => {
+        heightsRef.current = []
+    }, [resetKey])
+
+    const heightAt = useCallback(
+        (index: number) => heightsRef.current[index] ?? estimatedRowHeight,
+        [estimatedRowHeight]
+    )
+
+    const updateRange = useCallback(() => {
+        const container = containerRef.current
+        if (!container || !isWindowed) return
+
+        // Visible slice of the list in list coordinates
+        const rect = container.getBoundingClientRect()
+        const viewTop = Math.max(0, -rect.top)
+        const viewBottom = Math.max(0, window.innerHeight - rect.top)
+
+        let offset = 0
+        let start = 0
+        while (start < count && offset + heightAt(start) <= viewTop) {
+            offset += heightAt(start)
+            start++
+        }
+        let end = start
+        while (end < count && offset < viewBottom) {
+            offset += heightAt(end)
+            end++
+        }
+
+        const next = {
+            start: Math.max(0, start - overscan),
+            end: Math.min(count, end + overscan),
+        }
+        setRange((prev) =>
+            prev.start === next.start && prev.end === next.end ? prev : next
+        )
+    }, [count, heightAt, isWindowed, overscan])
+
+    useEffect(() => {
+        if (!isWindowed) return
+
+        let frame = 0
+        const onScroll = () => {
+            if (frame) return
+            frame = requestAnimationFrame(() => {
+                frame = 0
+                updateRange()
+            })
+        }
+
+        updateRange()
+        document.addEventListener("scroll", onScroll, { capture: true, passive: true })
+        window.addEventListener("resize", onScroll)
+        return () => {
+            if (frame) cancelAnimationFrame(frame)
+            document.removeEventListener("scroll", onScroll, { capture: true })
+            window.removeEventListener("resize", onScroll)
+        }
+    }, [isWindowed, updateRange])
+
+    // Record the real height of every mounted row
+    useLayoutEffect(() => {
+        const container = containerRef.current
+        if (!container || !isWindowed) return
+
+        let changed = false
+        for (const child of Array.from(container.children)) {
+            const index = (child as HTMLElement).dataset.index
+            if (index === undefined) continue
+            const height = (child as HTMLElement).offsetHeight
+            const i = Number(index)
+            if (Math.abs((heightsRef.current[i] ?? -1) - height) > 0.5) {
+                heightsRef.current[i] = height
+                changed = true
+            }
+        }
+        if (changed) {
+            setLayoutVersion((version) => version + 1)
+            updateRange()
+        }
+    })
+
+    if (!isWindowed) {
+        return { containerRef, start: 0, end: count, paddingTop: 0, paddingBottom: 0, isWindowed }
+    }
+
+    const start = Math.min(range.start, count)
+    const end = Math.min(range.end, count)
+    let paddingTop = 0
+    for (let i = 0; i < start; i++) paddingTop += heightAt(i)
+    let paddingBottom = 0
+    for (let i = end; i < count; i++) paddingBottom += heightAt(i)
+
+    return { containerRef, start, end, paddingTop, paddingBottom, isWindowed }
+}
@@ -0,0 +1,8 @@
+// Runs once when the Next.js server starts. `npm run worker` sets JOB_WORKER=1
+// to turn the built app into an import worker (see scripts/job-worker.ts)
+export async function register() {
+    if (process.env.NEXT_RUNTIME !== "nodejs" || process.env.JOB_WORKER !== "1") {
+        return
+    }
+    await import("./scripts/job-worker")
+}
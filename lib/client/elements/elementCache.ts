@@ -0,0 +1,179 @@
+import eventBus, { AppEvents } from "@/lib/client/events/eventEmitter"
+import { MemoryLRU } from "@/lib/embeddings/cache/memory-cache"
+import {
+    EmbeddingVector,
+    hasEmbedding,
+    VectorTuple,
+    vemb_multi,
+    vgetattr_multi,
+} from "@/lib/redis-server/api"
+
+// Elements requested per hydration call
+export const HYDRATE_PAGE_SIZE = 100
+// Elements kept across all vector sets
+const MAX_ENTRIES = 5000
+
+// A field is undefined until it has been loaded, and null when the element has none
+interface ElementEntry {
+    attributes?: string | null
+    embedding?: EmbeddingVector | null
+}
+
+type ElementField = keyof ElementEntry
+type FieldValue<F extends ElementField> = NonNullable<ElementEntry[F]> | null
+
+/**
+ * Attributes and embeddings of single elements, keyed by (vector set,
+ * element) and shared by everything that shows them: the results table, the
+ * 3D view and the HNSW visualizer. Searches can then return only
+ * [element, score], and each view hydrates just the rows it shows, in pages,
+ * without fetching a value another view already has.
+ */
+class ElementCache {
+    private entries = new MemoryLRU<ElementEntry>(MAX_ENTRIES)
+    // Bumped to drop every entry of a set at once; old entries age out of the LRU
+    private generations = new Map<string, number>()
+    // Pages in flight, per field and element, so overlapping callers share them
+    private pending = new Map<string, Promise<Map<string, unknown>>>()
+
+    private entryKey(keyName: string, element: string): string {
+        return `${keyName}\u0000${this.generations.get(keyName) ?? 0}\u0000${element}`
+    }
+
+    private update(keyName: string, element: string, patch: ElementEntry): void {
+        const key = this.entryKey(keyName, element)
+        this.entries.set(key, { ...this.entries.get(key), ...patch })
+    }
+
+    peek(keyName: string, element: string): ElementEntry | undefined {
+        return this.entries.get(this.entryKey(keyName, element))
+    }
+
+    // Stores the fields a search already returned
+    prime(
+        keyName: string,
+        tuples: VectorTuple[],
+        fields: { attributes?: boolean; embedding?: boolean }
+    ): void {
+        for (const [element, , vector, attributes] of tuples) {
+            const patch: ElementEntry = {}
+            if (fields.embedding && hasEmbedding(vector)) patch.embedding = vector
+            if (fields.attributes) patch.attributes = attributes ?? null
+            if (Object.keys(patch).length > 0) this.update(keyName, element, patch)
+        }
+    }
+
+    setAttributes(keyName: string, element: string, attributes: string | null): void {
+        this.update(keyName, element, { attributes })
+    }
+
+    setEmbeddings(keyName: string, embeddings: [string, EmbeddingVector | null][]): void {
+        for (const [element, embedding] of embeddings) {
+            if (hasEmbedding(embedding)) this.update(keyName, element, { embedding })
+        }
+    }
+
+    // Forgets the given elements, or the whole set
+    invalidate(keyName: string, elements?: string[]): void {
+        if (!elements) {
+            this.generations.set(keyName, (this.generations.get(keyName) ?? 0) + 1)
+            return
+        }
+        elements.forEach((element) => this.entries.delete(this.entryKey(keyName, element)))
+    }
+
+    getAttributes(keyName: string, elements: string[]): Promise<(string | null)[]> {
+        return this.load(keyName, elements, "attributes")
+    }
+
+    getEmbeddings(keyName: string, elements: string[]): Promise<(EmbeddingVector | null)[]> {
+        return this.load(keyName, elements, "embedding")
+    }
+
+    /**
+     * Returns the field for each element, fetching the ones not cached in
+     * pages of HYDRATE_PAGE_SIZE. Elements whose page failed come back as
+     * null and stay unloaded, so a later call tries again.
+     */
+    private async load<F extends ElementField>(
+        keyName: string,
+        elements: string[],
+        field: F
+    ): Promise<FieldValue<F>[]> {
+        const values = new Map<string, unknown>()
+        const waits: Promise<Map<string, unknown>>[] = []
+        const missing: string[] = []
+
+        for (const element of new Set(elements)) {
+            const cached = this.peek(keyName, element)?.[field]
+            if (cached !== undefined) {
+                values.set(element, cached)
+                continue
+            }
+            const inFlight = this.pending.get(this.pendingKey(keyName, element, field))
+            if (inFlight) {
+                waits.push(inFlight)
+            } else {
+                missing.push(element)
+            }
+        }
+
+        for (let i = 0; i < missing.length; i += HYDRATE_PAGE_SIZE) {
+            const page = missing.slice(i, i + HYDRATE_PAGE_SIZE)
+            const request = this.fetchPage(keyName, page, field)
+            page.forEach((element) => this.pending.set(this.pendingKey(keyName, element, field), request))
+            request.finally(() => {
+                page.forEach((element) => {
+                    const key = this.pendingKey(keyName, element, field)
+                    if (this.pending.get(key) === request) this.pending.delete(key)
+                })
+            })
+            waits.push(request)
+        }
+
+        for (const page of await Promise.all(waits)) {
+            page.forEach((value, element) => values.set(element, value))
+        }
+        return elements.map((element) => (values.get(element) ?? null) as FieldValue<F>)
+    }
+
+    private pendingKey(keyName: string, element: string, field: ElementField): string {
+        return `${field}\u0000${this.entryKey(keyName, element)}`
+    }
+
+    private async fetchPage(
+        keyName: string,
+        page: string[],
+        field: ElementField
+    ): Promise<Map<string, unknown>> {
+        const response =
+            field === "attributes"
+                ? await vgetattr_multi({ keyName, elements: page, returnCommandOnly: false })
+                : await vemb_multi({ keyName, elements: page, vectorEncoding: "binary" })
+
+        const values = new Map<string, unknown>()
+        if (!response.success || !response.result) {
+            console.warn(`[ElementCache] Failed to load ${field} of ${page.length} elements:`, response.error)
+            return values
+        }
+        page.forEach((element, index) => {
+            const value = response.result![index] ?? null
+            values.set(element, value)
+            this.update(keyName, element, { [field]: value })
+        })
+        return values
+    }
+}
+
+export const elementCache = new ElementCache()
+
+// Keep cached values in step with changes made through the browser
+eventBus.on(AppEvents.VECTOR_ADDED, ({ vectorSetName, element }) => {
+    elementCache.invalidate(vectorSetName, [element])
+})
+eventBus.on(AppEvents.VECTOR_DELETED, ({ vectorSetName, element, elements }) => {
+    elementCache.invalidate(vectorSetName, elements ?? [element])
+})
+eventBus.on(AppEvents.VECTORS_IMPORTED, ({ vectorSetName }) => {
+    elementCache.invalidate(vectorSetName)
+})
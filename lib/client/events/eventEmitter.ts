@@ -10,6 +10,7 @@ export enum AppEvents {
     VECTOR_DELETED = "vector_deleted",
     VECTORS_IMPORTED = "vectors_imported",
     JOB_STATUS_CHANGED = "job_status_changed",
+    JOB_PROGRESS = "job_progress",
     METADATA_UPDATED = "metadata_updated",
     VECTORSET_DIMENSIONS_CHANGED = "vectorset_dimensions_changed",
 }
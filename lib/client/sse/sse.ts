@@ -1,5 +1,13 @@
 import { AppEvents } from "@/lib/client/events/eventEmitter"
 import eventBus from "@/lib/client/events/eventEmitter"
+import type { JobProgressEvent } from "@/lib/types/jobs"
+
+// Server-Sent Events state
+let eventSource: EventSource | null = null
+let streamRetryTimer: NodeJS.Timeout | null = null
+const STREAM_RETRY_INTERVAL = 30000 // Try the stream again this long after falling back
+// Last status seen per job, so JOB_STATUS_CHANGED only fires on changes
+const lastJobStatus = new Map<string, string>()
 
 // Fallback polling state
 let pollingInterval: NodeJS.Timeout | null = null
@@ -7,11 +15,95 @@ let lastPollTime = 0
 const POLLING_INTERVAL = 2000 // 1.5 seconds to match previous interval
 
 /**
- * Initialize real-time updates using Server-Sent Events
+ * Initialize real-time updates using Server-Sent Events, falling back to
+ * polling when the stream is unavailable
  */
 export function initSocket() {
-    if (pollingInterval) return
+    if (eventSource || pollingInterval) return
+    if (typeof EventSource === "undefined") {
+        startPolling()
+        return
+    }
+    openStream()
+}
+
+/**
+ * True while job updates are pushed over the event stream, so callers can
+ * poll less often
+ */
+export function isStreamConnected(): boolean {
+    return eventSource?.readyState === EventSource.OPEN
+}
+
+function openStream() {
+    if (eventSource) return
+
+    const source = new EventSource("/api/jobs/events")
+    eventSource = source
+
+    source.addEventListener("ready", () => {
+        console.log("Job event stream connected")
+        stopPolling()
+    })
+
+    source.addEventListener("progress", (event) => {
+        let progress: JobProgressEvent
+        try {
+            progress = JSON.parse((event as MessageEvent).data)
+        } catch (error) {
+            console.error("Malformed job event:", error)
+            return
+        }
+
+        eventBus.emit(AppEvents.JOB_PROGRESS, progress)
+
+        if (lastJobStatus.get(progress.jobId) !== progress.status) {
+            lastJobStatus.set(progress.jobId, progress.status)
+            eventBus.emit(AppEvents.JOB_STATUS_CHANGED, {
+                vectorSetName: progress.vectorSetName,
+                status: progress.status,
+                jobId: progress.jobId,
+            })
+        }
+        if (
+            progress.status === "completed" ||
+            progress.status === "failed" ||
+            progress.status === "cancelled"
+        ) {
+            lastJobStatus.delete(progress.jobId)
+        }
+    })
+
+    // The server could not subscribe to job events
+    source.addEventListener("unavailable", () => fallBackToPolling())
+
+    source.onerror = () => {
+        // EventSource reconnects on its own unless the server refused the stream
+        if (source.readyState === EventSource.CLOSED) {
+            fallBackToPolling()
+        }
+    }
+}
+
+function closeStream() {
+    if (streamRetryTimer) {
+        clearTimeout(streamRetryTimer)
+        streamRetryTimer = null
+    }
+    if (eventSource) {
+        eventSource.close()
+        eventSource = null
+    }
+}
+
+function fallBackToPolling() {
+    console.warn("Job event stream unavailable, polling instead")
+    closeStream()
     startPolling()
+    streamRetryTimer = setTimeout(() => {
+        streamRetryTimer = null
+        openStream()
+    }, STREAM_RETRY_INTERVAL)
 }
 
 /**
@@ -135,5 +227,6 @@ function stopPolling() {
  * Close SSE connection and stop polling
  */
 export function closeSocket() {
+    closeStream()
     stopPolling()
 }
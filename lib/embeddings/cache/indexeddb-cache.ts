@@ -0,0 +1,162 @@
+/*
+ * Browser-side persistent caches in IndexedDB, usable from the page and
+ * from workers: recent query embeddings, and the model files that the
+ * in-browser embedding engine downloads. Every operation degrades to a
+ * miss when IndexedDB is unavailable (private windows, server rendering).
+ */
+
+const DB_NAME = "vector-sets-browser"
+const DB_VERSION = 1
+const EMBEDDINGS_STORE = "embeddings"
+const MODELS_STORE = "models"
+
+// Query embeddings kept; the least recently written are dropped beyond this
+const EMBEDDING_LIMIT = 1000
+// Checked every this many writes, rather than on each one
+const PRUNE_INTERVAL = 50
+
+interface EmbeddingRecord {
+    key: string
+    embedding: Float32Array
+    timestamp: number
+}
+
+interface ModelRecord {
+    url: string
+    body: ArrayBuffer
+    headers: [string, string][]
+    timestamp: number
+}
+
+let database: Promise<IDBDatabase | null> | null = null
+
+function openDatabase(): Promise<IDBDatabase | null> {
+    if (!database) {
+        database = new Promise((resolve) => {
+            if (typeof indexedDB === "undefined") {
+                resolve(null)
+                return
+            }
+            const request = indexedDB.open(DB_NAME, DB_VERSION)
+            request.onupgradeneeded = () => {
+                const db = request.result
+                if (!db.objectStoreNames.contains(EMBEDDINGS_STORE)) {
+                    db.createObjectStore(EMBEDDINGS_STORE, { keyPath: "key" }).createIndex("timestamp", "timestamp")
+                }
+                if (!db.objectStoreNames.contains(MODELS_STORE)) {
+                    db.createObjectStore(MODELS_STORE, { keyPath: "url" })
+                }
+            }
+            request.onsuccess = () => resolve(request.result)
+            request.onerror = () => {
+                console.warn("[IndexedDBCache] Could not open database:", request.error)
+                resolve(null)
+            }
+        })
+    }
+    return database
+}
+
+function promisify<T>(request: IDBRequest<T>): Promise<T> {
+    return new Promise((resolve, reject) => {
+        request.onsuccess = () => resolve(request.result)
+        request.onerror = () => reject(request.error)
+    })
+}
+
+async function withStore<T>(
+    store: string,
+    mode: IDBTransactionMode,
+    operation: (objectStore: IDBObjectStore) => Promise<T>
+): Promise<T | undefined> {
+    try {
+        const db = await openDatabase()
+        if (!db) return undefined
+        return await operation(db.transaction(store, mode).objectStore(store))
+    } catch (error) {
+        console.warn(`[IndexedDBCache] ${store} ${mode} failed:`, error)
+        return undefined
+    }
+}
+
+/**
+ * SHA-256 of the input and the embedding config, so long inputs such as
+ * image data URLs make short keys that cannot collide by prefix.
+ */
+export async function embeddingCacheKey(input: string, config: unknown, isImage: boolean): Promise<string> {
+    const source = `${isImage ? "image" : "text"}\u0000${JSON.stringify(config)}\u0000${input}`
+    if (typeof crypto === "undefined" || !crypto.subtle) {
+        return source
+    }
+    const digest = await crypto.subtle.digest("SHA-256", new TextEncoder().encode(source))
+    return Array.from(new Uint8Array(digest), (byte) => byte.toString(16).padStart(2, "0")).join("")
+}
+
+let writesSincePrune = 0
+
+export const indexedDBEmbeddingCache = {
+    async get(key: string): Promise<number[] | null> {
+        const record = await withStore(EMBEDDINGS_STORE, "readonly", (store) =>
+            promisify(store.get(key) as IDBRequest<EmbeddingRecord | undefined>)
+        )
+        return record ? Array.from(record.embedding) : null
+    },
+
+    async set(key: string, embedding: number[]): Promise<void> {
+        const record: EmbeddingRecord = { key, embedding: Float32Array.from(embedding), timestamp: Date.now() }
+        await withStore(EMBEDDINGS_STORE, "readwrite", (store) => promisify(store.put(record)))
+
+        if (++writesSincePrune >= PRUNE_INTERVAL) {
+            writesSincePrune = 0
+            await this.prune()
+        }
+    },
+
+    // Deletes the oldest records beyond EMBEDDING_LIMIT
+    async prune(): Promise<void> {
+        await withStore(EMBEDDINGS_STORE, "readwrite", async (store) => {
+            const excess = (await promisify(store.count())) - EMBEDDING_LIMIT
+            if (excess <= 0) return
+            await new Promise<void>((resolve, reject) => {
+                let removed = 0
+                const cursor = store.index("timestamp").openCursor()
+                cursor.onsuccess = () => {
+                    const current = cursor.result
+                    if (!current || removed >= excess) {
+                        resolve()
+                        return
+                    }
+                    current.delete()
+                    removed++
+                    current.continue()
+                }
+                cursor.onerror = () => reject(cursor.error)
+            })
+        })
+    },
+}
+
+/**
+ * Model files by URL, in the shape transformers.js expects of
+ * env.customCache (match/put with Response objects).
+ */
+export const indexedDBModelCache = {
+    async match(request: string | Request): Promise<Response | undefined> {
+        const url = typeof request === "string" ? request : request.url
+        const record = await withStore(MODELS_STORE, "readonly", (store) =>
+            promisify(store.get(url) as IDBRequest<ModelRecord | undefined>)
+        )
+        return record ? new Response(record.body, { headers: record.headers }) : undefined
+    },
+
+    async put(request: string | Request, response: Response): Promise<void> {
+        const url = typeof request === "string" ? request : request.url
+        const record: ModelRecord = {
+            url,
+            body: await response.arrayBuffer(),
+            headers: Array.from(response.headers.entries()),
+            timestamp: Date.now(),
+        }
+        await withStore(MODELS_STORE, "readwrite", (store) => promisify(store.put(record)))
+    },
+}
@@ -0,0 +1,54 @@
+// Least-recently-used map with a fixed entry limit, used as the in-process
+// front tier of the embedding cache. With `weigh`, the limit applies to the
+// summed weight of the entries (e.g. estimated bytes) instead of their number
+export class MemoryLRU<V> {
+    // Map iteration order is insertion order, so the first key is the least recently used
+    private entries = new Map<string, V>()
+    private weights = new Map<string, number>()
+    private totalWeight = 0
+
+    constructor(
+        private readonly capacity: number,
+        private readonly weigh: (value: V) => number = () => 1
+    ) {}
+
+    get(key: string): V | undefined {
+        const value = this.entries.get(key)
+        if (value !== undefined) {
+            this.entries.delete(key)
+            this.entries.set(key, value)
+        }
+        return value
+    }
+
+    set(key: string, value: V): void {
+        this.delete(key)
+        const weight = this.weigh(value)
+        this.entries.set(key, value)
+        this.weights.set(key, weight)
+        this.totalWeight += weight
+
+        while (this.totalWeight > this.capacity) {
+            const oldest = this.entries.keys().next().value
+            if (oldest === undefined) break
+            this.delete(oldest)
+        }
+    }
+
+    delete(key: string): void {
+        if (this.entries.delete(key)) {
+            this.totalWeight -= this.weights.get(key) ?? 0
+            this.weights.delete(key)
+        }
+    }
+
+    clear(): void {
+        this.entries.clear()
+        this.weights.clear()
+        this.totalWeight = 0
+    }
+
+    get size(): number {
+        return this.entries.size
+    }
+}
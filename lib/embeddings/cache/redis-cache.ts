@@ -1,76 +1,242 @@
+import { createHash } from "crypto"
 import { RedisConnection, getRedisUrl } from "@/lib/redis-server/RedisConnection"
-import { EmbeddingConfig } from "../types/embeddingModels"
+import { fp32BufferToVector, vectorToFp32Buffer } from "@/lib/redis-server/utils"
+import { EmbeddingConfig, getExpectedDimensions } from "../types/embeddingModels"
+import { MemoryLRU } from "./memory-cache"
 
 export const EMBEDDING_CACHE_KEY = "embeddingCache"
 export const EMBEDDING_CACHE_LOG_KEY = "embeddingCache:log"
 
+// Where the cache settings edited in the UI are stored
+export const EMBEDDING_CACHE_CONFIG_HASH = "vector-set-browser:config"
+export const EMBEDDING_CACHE_CONFIG_FIELD = "embedding_cache_config"
+
+// Fields written by this version; older base64-prefix fields are never read and age out via eviction
+const FIELD_PREFIX = "v2:"
+
+const DEFAULT_MAX_SIZE = 1000
+const CONFIG_REFRESH_MS = 30000
+// How often a hit served from memory refreshes its access time in embeddingCache:log
+const TOUCH_INTERVAL_MS = 60000
+
+interface MemoryEntry {
+    embedding: number[]
+    touchedAt: number
+}
+
+interface CacheSettings {
+    useCache: boolean
+    maxSize: number
+    loadedAt: number
+}
+
+// Shared by every EmbeddingCache in the process; keys include the Redis URL
+const memoryTier = new MemoryLRU<MemoryEntry>(
+    Number(process.env.EMBEDDING_MEMORY_CACHE_SIZE) > 0
+        ? Number(process.env.EMBEDDING_MEMORY_CACHE_SIZE)
+        : 2000
+)
+const settingsByUrl = new Map<string, CacheSettings>()
+
+// Drops the in-process tier, e.g. after the Redis cache has been cleared
+export function clearMemoryEmbeddingCache(): void {
+    memoryTier.clear()
+}
+
+// Forces the next lookup to re-read useCache/maxSize after the config changes
+export function invalidateEmbeddingCacheSettings(): void {
+    settingsByUrl.clear()
+}
+
 export class EmbeddingCache {
-    async get(input: string, config: EmbeddingConfig): Promise<number[] | null> {
+    // redisUrl is passed explicitly by callers outside a request scope (e.g. background jobs)
+    async get(input: string, config: EmbeddingConfig, url?: string | null): Promise<number[] | null> {
+        return (await this.getMany([input], config, url))[0]
+    }
+
+    async set(input: string, embedding: number[], config: EmbeddingConfig, url?: string | null): Promise<void> {
+        await this.setMany([input], [embedding], config, url)
+    }
+
+    /**
+     * Looks up several inputs at once: memory first, then one HMGET for the rest.
+     * Returns null in each slot that missed both tiers. Settings are cached for
+     * CONFIG_REFRESH_MS, so a lookup answered from memory normally does not
+     * touch Redis at all.
+     */
+    async getMany(
+        inputs: string[],
+        config: EmbeddingConfig,
+        url?: string | null
+    ): Promise<(number[] | null)[]> {
+        const results: (number[] | null)[] = inputs.map(() => null)
+
         try {
-            const redisUrl = await getRedisUrl()
-            if (!redisUrl) {
-                return null
+            const redisUrl = url || await getRedisUrl()
+            if (!redisUrl || !(await this.getSettings(redisUrl)).useCache) {
+                return results
             }
 
-            return await RedisConnection.withClient(redisUrl, async (client) => {
-                const field = this.generateHashField(input, config)
-                const cached = await client.hGet(EMBEDDING_CACHE_KEY, field)
+            const now = Date.now()
+            const fields = inputs.map((input) => this.generateHashField(input, config))
+            const missing: number[] = []
+            const touched: string[] = []
+
+            fields.forEach((field, i) => {
+                const entry = memoryTier.get(`${redisUrl}|${field}`)
+                if (entry) {
+                    results[i] = entry.embedding
+                    if (now - entry.touchedAt > TOUCH_INTERVAL_MS) {
+                        entry.touchedAt = now
+                        touched.push(field)
+                    }
+                } else {
+                    missing.push(i)
+                }
+            })
 
-                if (cached) {
-                    // Update access time in sorted set
-                    await client.zAdd(EMBEDDING_CACHE_LOG_KEY, {
-                        score: Date.now(),
-                        value: field,
+            // Served from memory with no access times to refresh: no connection is leased
+            if (missing.length === 0 && touched.length === 0) {
+                return results
+            }
+
+            const response = await RedisConnection.withClient(redisUrl, async (client) => {
+                if (missing.length > 0) {
+                    const replies = (await client.sendCommand(
+                        ["HMGET", EMBEDDING_CACHE_KEY, ...missing.map((i) => fields[i])],
+                        { returnBuffers: true }
+                    )) as (Buffer | null)[]
+
+                    replies.forEach((reply, j) => {
+                        if (reply && reply.length > 0 && reply.length % 4 === 0) {
+                            const i = missing[j]
+                            const embedding = fp32BufferToVector(reply)
+                            results[i] = embedding
+                            memoryTier.set(`${redisUrl}|${fields[i]}`, { embedding, touchedAt: now })
+                            touched.push(fields[i])
+                        }
                     })
-                    return JSON.parse(cached)
                 }
 
-                return null
-            }).then((result) => {
-                if (!result.success) {
-                    console.error("[Embedding] Cache read error:", result.error)
-                    return null
+                // One ZADD for every hit in the batch keeps eviction order current
+                if (touched.length > 0) {
+                    await client.zAdd(
+                        EMBEDDING_CACHE_LOG_KEY,
+                        touched.map((value) => ({ score: now, value }))
+                    )
                 }
-                return result.result
+                return true
             })
+
+            if (!response.success) {
+                console.error("[Embedding] Cache read error:", response.error)
+            }
         } catch (error) {
             console.error("[Embedding] Cache read error:", error)
-            return null
         }
+
+        return results
     }
 
-    async set(input: string, embedding: number[], config: EmbeddingConfig): Promise<void> {
+    // Stores several embeddings with one pipelined round trip, then trims the cache to maxSize
+    async setMany(
+        inputs: string[],
+        embeddings: number[][],
+        config: EmbeddingConfig,
+        url?: string | null
+    ): Promise<void> {
+        if (inputs.length === 0) return
+
         try {
-            const redisUrl = await getRedisUrl()
+            const redisUrl = url || await getRedisUrl()
             if (!redisUrl) {
                 return
             }
 
-            const field = this.generateHashField(input, config)
+            const settings = await this.getSettings(redisUrl)
+            if (!settings.useCache) {
+                return
+            }
 
-            await RedisConnection.withClient(redisUrl, async (client) => {
-                // Store the embedding in the hash
-                await client.hSet(
-                    EMBEDDING_CACHE_KEY,
-                    field,
-                    JSON.stringify(embedding)
-                )
+            const now = Date.now()
+            const fields = inputs.map((input) => this.generateHashField(input, config))
+            const hashArgs: (string | Buffer)[] = []
+            fields.forEach((field, i) => {
+                hashArgs.push(field, vectorToFp32Buffer(embeddings[i]))
+                memoryTier.set(`${redisUrl}|${field}`, { embedding: embeddings[i], touchedAt: now })
+            })
 
-                // Update access time in sorted set
-                await client.zAdd(EMBEDDING_CACHE_LOG_KEY, {
-                    score: Date.now(),
-                    value: field,
-                })
+            const response = await RedisConnection.withClient(redisUrl, async (client) => {
+                const pipeline = client.multi()
+                pipeline.addCommand(["HSET", EMBEDDING_CACHE_KEY, ...hashArgs])
+                pipeline.zAdd(
+                    EMBEDDING_CACHE_LOG_KEY,
+                    fields.map((value) => ({ score: now, value }))
+                )
+                pipeline.zCard(EMBEDDING_CACHE_LOG_KEY)
+                const replies = await pipeline.execAsPipeline()
 
+                // Evict the least recently used entries beyond the configured size
+                const size = Number(replies[2])
+                const excess = size - settings.maxSize
+                if (excess > 0) {
+                    const evicted = await client.zRange(EMBEDDING_CACHE_LOG_KEY, 0, excess - 1)
+                    if (evicted.length > 0) {
+                        await client
+                            .multi()
+                            .hDel(EMBEDDING_CACHE_KEY, evicted)
+                            .zRem(EMBEDDING_CACHE_LOG_KEY, evicted)
+                            .execAsPipeline()
+                        evicted.forEach((field) => memoryTier.delete(`${redisUrl}|${field}`))
+                    }
+                }
                 return true
             })
+
+            if (!response.success) {
+                console.error("[Embedding] Cache write error:", response.error)
+            }
         } catch (error) {
             console.error("[Embedding] Cache write error:", error)
         }
     }
 
+    // Reads useCache/maxSize from the cache config, re-reading at most every 30 seconds
+    private async getSettings(redisUrl: string): Promise<CacheSettings> {
+        const cached = settingsByUrl.get(redisUrl)
+        if (cached && Date.now() - cached.loadedAt < CONFIG_REFRESH_MS) {
+            return cached
+        }
+
+        const settings: CacheSettings = {
+            useCache: true,
+            maxSize: DEFAULT_MAX_SIZE,
+            loadedAt: Date.now(),
+        }
+
+        const response = await RedisConnection.withClient(redisUrl, async (client) => {
+            return await client.hGet(EMBEDDING_CACHE_CONFIG_HASH, EMBEDDING_CACHE_CONFIG_FIELD)
+        })
+        if (response.success && response.result) {
+            try {
+                const config = JSON.parse(response.result)
+                if (typeof config.useCache === "boolean") {
+                    settings.useCache = config.useCache
+                }
+                if (typeof config.maxSize === "number" && config.maxSize > 0) {
+                    settings.maxSize = config.maxSize
+                }
+            } catch (error) {
+                console.error("[Embedding] Invalid cache config:", error)
+            }
+        }
+
+        settingsByUrl.set(redisUrl, settings)
+        return settings
+    }
+
     private generateHashField(input: string, config: EmbeddingConfig): string {
-        // Create a unique hash field based on the input and provider configuration
+        // Everything that changes the resulting vector is part of the key
         const provider = config.provider
         let modelIdentifier = ""
 
@@ -79,16 +245,20 @@ export class EmbeddingCache {
                 modelIdentifier = config.openai?.model || ""
                 break
             case "ollama":
-                modelIdentifier = config.ollama?.modelName || ""
+                modelIdentifier = `${config.ollama?.modelName || ""}|${config.ollama?.promptTemplate || ""}`
                 break
             case "image":
                 modelIdentifier = config.image?.model || ""
                 break
+            case "clip":
+                modelIdentifier = config.clip?.model || ""
+                break
             // Add other providers as needed
         }
 
-        // Create a hash of the input to avoid special characters
-        const inputHash = Buffer.from(input).toString("base64").substring(0, 40)
-        return `${provider}:${modelIdentifier}:${inputHash}`
+        const digest = createHash("sha256")
+            .update(JSON.stringify([provider, modelIdentifier, getExpectedDimensions(config), input]))
+            .digest("hex")
+        return `${FIELD_PREFIX}${provider}:${digest}`
     }
-} 
\ No newline at end of file
+}
@@ -0,0 +1,74 @@
+import { env } from "@xenova/transformers"
+import { indexedDBModelCache } from "@/lib/embeddings/cache/indexeddb-cache"
+import { CLIPProvider } from "@/lib/embeddings/providers/clip"
+import { getImageEmbedding, loadImageModel } from "@/lib/embeddings/image/imageEmbedding"
+
+/*
+ * Embeds queries off the main thread with the models that run in JS (CLIP
+ * through transformers.js, MobileNet through TensorFlow.js). The worker
+ * lives as long as the page, so a model is loaded once and stays warm;
+ * model files are kept in IndexedDB so a reload does not download them
+ * again.
+ */
+
+export type LocalEmbeddingTask =
+    | { kind: "clip"; modelPath: string }
+    | { kind: "mobilenet" }
+
+export type EmbeddingWorkerRequest =
+    | { type: "embed"; id: number; task: LocalEmbeddingTask; input: string; isImage: boolean }
+    | { type: "warm"; id: number; task: LocalEmbeddingTask }
+
+export type EmbeddingWorkerResponse =
+    | { id: number; embedding: Float32Array }
+    | { id: number; warmed: true }
+    | { id: number; error: string }
+
+// transformers.js fetches model files through this cache instead of the Cache API
+env.allowLocalModels = false
+env.useBrowserCache = false
+env.useCustomCache = true
+env.customCache = indexedDBModelCache
+
+const clip = new CLIPProvider()
+
+const ctx = self as unknown as {
+    onmessage: ((event: MessageEvent<EmbeddingWorkerRequest>) => void) | null
+    postMessage: (message: EmbeddingWorkerResponse, transfer?: Transferable[]) => void
+}
+
+async function embed(task: LocalEmbeddingTask, input: string, isImage: boolean): Promise<number[]> {
+    if (task.kind === "mobilenet") {
+        if (!isImage) throw new Error("MobileNet only embeds images")
+        return getImageEmbedding(input, { model: "mobilenet" })
+    }
+    if (isImage) {
+        return clip.getImageEmbedding(input, task.modelPath)
+    }
+    const [embedding] = await clip.getTextEmbeddings([input], task.modelPath)
+    return embedding
+}
+
+async function warm(task: LocalEmbeddingTask): Promise<void> {
+    if (task.kind === "mobilenet") {
+        await loadImageModel({ model: "mobilenet" })
+    } else {
+        // Text queries are the common case; the vision model loads on the first image
+        await clip.getTextEmbeddings([""], task.modelPath)
+    }
+}
+
+ctx.onmessage = async (event) => {
+    const message = event.data
+    try {
+        if (message.type === "warm") {
+            await warm(message.task)
+            ctx.postMessage({ id: message.id, warmed: true })
+            return
+        }
+        const embedding = Float32Array.from(await embed(message.task, message.input, message.isImage))
+        ctx.postMessage({ id: message.id, embedding }, [embedding.buffer])
+    } catch (error) {
+        ctx.postMessage({ id: message.id, error: error instanceof Error ? error.message : String(error) })
+    }
+}
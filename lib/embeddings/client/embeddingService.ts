@@ -1,10 +1,7 @@
 import { EmbeddingConfig, CLIP_MODELS } from "@/lib/embeddings/types/embeddingModels"
-import { preprocessImage } from "./imageProcessingService"
-
-// Cache for models to avoid reloading
-const modelCache: Record<string, any> = {}
-let mobilenetModule: any = null
-let isModelLoading = false
+import { getImageEmbedding } from "@/lib/embeddings/image/imageEmbedding"
+import { embeddingCacheKey, indexedDBEmbeddingCache } from "@/lib/embeddings/cache/indexeddb-cache"
+import { localEmbeddingEngine } from "./localEmbeddingEngine"
 
 // Embedding cache to avoid regenerating the same embeddings
 interface EmbeddingCacheEntry {
@@ -14,15 +11,6 @@ interface EmbeddingCacheEntry {
 const embeddingCache: Map<string, EmbeddingCacheEntry> = new Map();
 const CACHE_TTL = 5 * 60 * 1000; // 5 minutes in milliseconds
 
-// Calculate a cache key based on input data and config
-const getCacheKey = (inputData: string, config: EmbeddingConfig, isImage: boolean = false): string => {
-    const configStr = JSON.stringify(config);
-    // Use just first 50 chars + length of data for the cache key to avoid 
-    // memory issues with very large data strings
-    const dataKey = `${inputData.substring(0, 50)}_${inputData.length}_${isImage ? 'image' : 'text'}`;
-    return `${dataKey}_${configStr}`;
-};
-
 /**
  * Client-side embedding service that handles caching and generation of embeddings
  */
@@ -39,8 +27,8 @@ export class ClientEmbeddingService {
             throw new Error("No input data provided")
         }
 
-        // Check cache first
-        const cacheKey = getCacheKey(inputData, config, isImage);
+        // Check cache first; the key is a digest, so large image data stays out of it
+        const cacheKey = await embeddingCacheKey(inputData, config, isImage);
         const now = Date.now();
         const cached = embeddingCache.get(cacheKey);
         
@@ -49,24 +37,36 @@ export class ClientEmbeddingService {
             return cached.embedding;
         }
 
-        let embedding: number[];
+        // Then the IndexedDB cache, which outlives the page
+        const stored = await indexedDBEmbeddingCache.get(cacheKey);
+        if (stored) {
+            embeddingCache.set(cacheKey, { embedding: stored, timestamp: now });
+            return stored;
+        }
 
-        if (isImage) {
-            // Handle image embedding
-            if (config.provider === "clip") {
-                embedding = await this.generateClipEmbedding(inputData, config)
-            } else if (config.provider === "image") {
-                embedding = await this.generateTensorFlowEmbedding(inputData)
+        // CLIP and MobileNet run in the embedding worker; the paths below are for
+        // the other providers, and for browsers where the worker cannot run
+        let embedding = await this.generateLocalEmbedding(inputData, config, isImage);
+
+        if (!embedding) {
+            if (isImage) {
+                // Handle image embedding
+                if (config.provider === "clip") {
+                    embedding = await this.generateClipEmbedding(inputData, config)
+                } else if (config.provider === "image") {
+                    embedding = await this.generateTensorFlowEmbedding(inputData)
+                } else {
+                    throw new Error(`Unsupported provider for image embedding: ${config.provider}`)
+                }
             } else {
-                throw new Error(`Unsupported provider for image embedding: ${config.provider}`)
+                // Handle text embedding (via API)
+                embedding = await this.generateTextEmbedding(inputData, config)
             }
-        } else {
-            // Handle text embedding (via API)
-            embedding = await this.generateTextEmbedding(inputData, config)
         }
 
         // Cache the result
         embeddingCache.set(cacheKey, { embedding, timestamp: now });
+        indexedDBEmbeddingCache.set(cacheKey, embedding).catch(() => {});
         
         // Cleanup old cache entries if cache gets too large
         if (embeddingCache.size > 100) {
@@ -82,6 +82,23 @@ export class ClientEmbeddingService {
         return embedding;
     }
 
+    /**
+     * Generate an embedding in the browser's embedding worker, or null when
+     * the provider needs the server or the worker is unavailable
+     */
+    private async generateLocalEmbedding(
+        inputData: string,
+        config: EmbeddingConfig,
+        isImage: boolean
+    ): Promise<number[] | null> {
+        try {
+            return await localEmbeddingEngine.embed(inputData, config, isImage)
+        } catch (error) {
+            console.warn("Embedding worker failed, falling back:", error)
+            return null
+        }
+    }
+
     /**
      * Generate embedding using CLIP model
      */
@@ -115,30 +132,8 @@ export class ClientEmbeddingService {
         imageData: string
     ): Promise<number[]> {
         try {
-            const model = await this.loadImageModel()
-
-            // Preprocess the image
-            const tensor = await preprocessImage(imageData)
-
-            console.log("Generating embedding using TensorFlow MobileNet...")
-            // Get the internal model to access the penultimate layer
-            // @ts-ignore - accessing internal property
-            const internalModel = model.model
-
-            // Execute the model up to the penultimate layer
-            // This gives us the feature vector (embedding) before classification
-            let activationLayer
-
-            activationLayer = model.infer(tensor, true)
-
-            // Convert to array and check values
-            const embedding = Array.from(await activationLayer.data()) as number[]
-
-            // Clean up the tensors
-            tensor.dispose()
-            activationLayer.dispose()
-
-            return embedding
+            // The model is loaded once and shared with the batch importers
+            return await getImageEmbedding(imageData, { model: "mobilenet" })
         } catch (error) {
             console.error("Error generating TensorFlow embedding:", error)
             throw error
@@ -182,60 +177,6 @@ export class ClientEmbeddingService {
             throw error
         }
     }
-
-    /**
-     * Load a TensorFlow.js image model (MobileNet)
-     */
-    private async loadImageModel(): Promise<any> {
-        const modelName = "mobilenet"
-
-        // Return cached model if available
-        if (modelCache[modelName]) {
-            return modelCache[modelName]
-        }
-
-        // Wait if model is already loading
-        if (isModelLoading) {
-            while (isModelLoading) {
-                await new Promise((resolve) => setTimeout(resolve, 100))
-            }
-            if (modelCache[modelName]) {
-                return modelCache[modelName]
-            }
-        }
-
-        try {
-            isModelLoading = true
-            console.log(`Loading image model: ${modelName}`)
-
-            // Ensure TensorFlow.js is loaded via ImageProcessingService
-            await preprocessImage("data:image/gif;base64,R0lGODlhAQABAIAAAP///wAAACH5BAEAAAAALAAAAAABAAEAAAICRAEAOw==")
-
-            // Lazy load MobileNet
-            if (!mobilenetModule) {
-                console.log("Dynamically importing MobileNet")
-                mobilenetModule = await import("@tensorflow-models/mobilenet")
-            }
-
-            // For now, we only support MobileNet
-            // Use version 1 with alpha 1.0 for best compatibility
-            const model = await mobilenetModule.load({
-                version: 1,
-                alpha: 1.0,
-            })
-
-            // Cache the model
-            modelCache[modelName] = model
-
-            console.log(`Image model loaded: ${modelName}`)
-            return model
-        } catch (error) {
-            console.error(`Error loading image model: ${modelName}`, error)
-            throw error
-        } finally {
-            isModelLoading = false
-        }
-    }
 }
 
 // Create a singleton instance
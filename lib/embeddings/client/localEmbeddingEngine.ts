@@ -0,0 +1,123 @@
+import { CLIP_MODELS, EmbeddingConfig } from "@/lib/embeddings/types/embeddingModels"
+import type {
+    EmbeddingWorkerRequest,
+    EmbeddingWorkerResponse,
+    LocalEmbeddingTask,
+} from "./embedding.worker"
+
+/*
+ * Client-side entry point for embedding queries in the browser. Requests go
+ * to one dedicated worker (embedding.worker.ts) that keeps its models loaded
+ * for the life of the page. Providers that need a server (OpenAI, Ollama)
+ * have no local task and keep using /api/embeddings.
+ */
+
+const DEFAULT_CLIP_MODEL_PATH = "Xenova/clip-vit-base-patch32"
+
+interface PendingRequest {
+    resolve: (message: EmbeddingWorkerResponse) => void
+    reject: (error: Error) => void
+}
+
+const pending = new Map<number, PendingRequest>()
+const warmed = new Map<string, Promise<void>>()
+let nextRequestId = 1
+let worker: Worker | null | undefined
+
+function getWorker(): Worker | null {
+    if (worker !== undefined) return worker
+    if (typeof Worker === "undefined") {
+        worker = null
+        return worker
+    }
+
+    try {
+        const created = new Worker(new URL("./embedding.worker.ts", import.meta.url))
+        created.onmessage = (event: MessageEvent<EmbeddingWorkerResponse>) => {
+            const message = event.data
+            const request = pending.get(message.id)
+            if (!request) return
+            pending.delete(message.id)
+            if ("error" in message) {
+                request.reject(new Error(message.error))
+            } else {
+                request.resolve(message)
+            }
+        }
+        created.onerror = (event) => {
+            console.error("[LocalEmbedding] Worker failed, embedding on the main thread or server:", event)
+            created.terminate()
+            worker = null
+            warmed.clear()
+            pending.forEach((request) => request.reject(new Error("Embedding worker failed")))
+            pending.clear()
+        }
+        worker = created
+    } catch (error) {
+        console.error("[LocalEmbedding] Could not start worker:", error)
+        worker = null
+    }
+    return worker
+}
+
+// Each member of a union without its id, which send() assigns
+type WithoutId<T> = T extends unknown ? Omit<T, "id"> : never
+
+function send(target: Worker, request: WithoutId<EmbeddingWorkerRequest>): Promise<EmbeddingWorkerResponse> {
+    const id = nextRequestId++
+    return new Promise((resolve, reject) => {
+        pending.set(id, { resolve, reject })
+        target.postMessage({ ...request, id } as EmbeddingWorkerRequest)
+    })
+}
+
+/**
+ * The worker task for a config, or null when the provider has to be called
+ * through the server (or cannot embed this kind of input)
+ */
+export function localEmbeddingTask(config: EmbeddingConfig, isImage: boolean): LocalEmbeddingTask | null {
+    if (config.provider === "clip") {
+        const modelPath = config.clip?.model
+            ? CLIP_MODELS.find((model) => model.id === config.clip?.model)?.modelPath
+            : DEFAULT_CLIP_MODEL_PATH
+        return { kind: "clip", modelPath: modelPath ?? DEFAULT_CLIP_MODEL_PATH }
+    }
+    if (config.provider === "image" && isImage) {
+        return { kind: "mobilenet" }
+    }
+    return null
+}
+
+export const localEmbeddingEngine = {
+    /**
+     * Embeds in the worker. Resolves to null when this config has no local
+     * task or Workers are unavailable, so the caller uses another path.
+     */
+    async embed(input: string, config: EmbeddingConfig, isImage: boolean): Promise<number[] | null> {
+        const task = localEmbeddingTask(config, isImage)
+        const target = task && getWorker()
+        if (!task || !target) return null
+
+        const message = await send(target, { type: "embed", task, input, isImage })
+        return "embedding" in message ? Array.from(message.embedding) : null
+    },
+
+    // Starts loading the model for a config in the background, once
+    warmUp(config: EmbeddingConfig): void {
+        const task = localEmbeddingTask(config, config.provider === "image")
+        const target = task && getWorker()
+        if (!task || !target) return
+
+        const key = JSON.stringify(task)
+        if (warmed.has(key)) return
+        warmed.set(
+            key,
+            send(target, { type: "warm", task })
+                .then(() => undefined)
+                .catch((error) => {
+                    warmed.delete(key)
+                    console.warn("[LocalEmbedding] Could not preload model:", error)
+                })
+        )
+    },
+}
@@ -1,16 +1,36 @@
 import { ImageConfig } from "@/lib/embeddings/types/embeddingModels"
 
 // Module references for lazy loading
-let tf: any = null
 let mobilenetModule: any = null
 
-// Cache for models to avoid reloading
-const modelCache: Record<string, any> = {}
-let isModelLoading = false
-let tfInitialized = false
+// Loaded (or loading) models by name, shared by every caller on the page.
+// Concurrent callers await the same promise instead of loading twice.
+const modelRegistry = new Map<string, Promise<any>>()
+let tfLoad: Promise<any> | null = null
 
-// Check if code is running in browser environment
-const isBrowser = typeof window !== "undefined"
+// Check if code is running in browser environment, on the page or in a worker
+const isBrowser =
+    typeof window !== "undefined" ||
+    typeof (globalThis as { WorkerGlobalScope?: unknown }).WorkerGlobalScope !== "undefined"
+
+// Where the MobileNet graph is saved after its first download
+const MOBILENET_STORAGE_URL = "indexeddb://vector-sets-browser-mobilenet-v1-1.0"
+
+// MobileNet expects 224x224 images
+const INPUT_SIZE = 224
+
+// Images per forward pass, and images fetched/decoded at once
+const DEFAULT_BATCH_SIZE = 16
+const DEFAULT_CONCURRENCY = 6
+
+// A data URL, bare base64 JPEG data, an image file or an image URL to fetch
+export type ImageSource = string | Blob | URL
+
+export interface BatchEmbeddingOptions {
+    batchSize?: number
+    concurrency?: number
+    onProgress?: (done: number, total: number) => void
+}
 
 // Initialize canvas in non-browser environments
 async function initializeCanvas() {
@@ -30,88 +50,164 @@ initializeCanvas().catch(console.error)
 // Don't try to load tfjs-node directly, as it causes webpack issues
 // We'll use dynamic imports instead when needed
 
+function assertBrowser() {
+    if (!isBrowser) {
+        // Server-side processing is not supported
+        throw new Error(
+            "Image processing in server components is not supported. " +
+            "Please use client components for image processing."
+        )
+    }
+}
+
 /**
- * Load a TensorFlow.js image model
+ * Load and initialize TensorFlow.js once, on WebGL when the browser has it
  */
-export async function loadImageModel(config: ImageConfig): Promise<any> {
-    const modelName = config.model
+async function loadTensorFlow(): Promise<any> {
+    if (!tfLoad) {
+        tfLoad = (async () => {
+            console.log("[TensorFlow.js] Dynamically importing TensorFlow.js")
+            const module = await import("@tensorflow/tfjs")
+            await module.ready()
 
-    // Return cached model if available
-    if (modelCache[modelName]) {
-        return modelCache[modelName]
+            if (isBrowser && module.getBackend() !== "webgl" && module.ENV.getBool("HAS_WEBGL")) {
+                console.log(
+                    "[TensorFlow.js] Setting backend to WebGL for client-side processing"
+                )
+                await module.setBackend("webgl")
+            }
+            console.log(`[TensorFlow.js] Using backend: ${module.getBackend()}`)
+            return module
+        })().catch((error) => {
+            tfLoad = null
+            throw error
+        })
     }
+    return tfLoad
+}
 
-    // Wait if model is already loading
-    if (isModelLoading) {
-        while (isModelLoading) {
-            await new Promise((resolve) => setTimeout(resolve, 100))
-        }
-        if (modelCache[modelName]) {
-            return modelCache[modelName]
+/**
+ * Load MobileNet from IndexedDB when an earlier visit saved it there, and
+ * from TF Hub (saving it for next time) otherwise
+ */
+async function loadMobileNet(): Promise<any> {
+    if (typeof indexedDB !== "undefined") {
+        try {
+            return await mobilenetModule.load({
+                version: 1,
+                alpha: 1.0,
+                modelUrl: MOBILENET_STORAGE_URL,
+            })
+        } catch (_error) {
+            // Not saved yet
         }
     }
 
-    try {
-        isModelLoading = true
-        console.log(`[TensorFlow.js] Loading image model: ${modelName}`)
-
-        // Lazy load TensorFlow.js and MobileNet
-        if (!tf) {
-            console.log("[TensorFlow.js] Dynamically importing TensorFlow.js")
-            tf = await import("@tensorflow/tfjs")
-        }
+    const model = await mobilenetModule.load({
+        version: 1,
+        alpha: 1.0,
+    })
+    if (typeof indexedDB !== "undefined") {
+        Promise.resolve()
+            // @ts-ignore - accessing internal property
+            .then(() => model.model.save(MOBILENET_STORAGE_URL))
+            .catch((error: unknown) => {
+                console.warn("[TensorFlow.js] Could not save MobileNet to IndexedDB:", error)
+            })
+    }
+    return model
+}
 
-        if (!mobilenetModule) {
-            console.log("[TensorFlow.js] Dynamically importing MobileNet")
-            mobilenetModule = await import("@tensorflow-models/mobilenet")
-        }
+/**
+ * Load a TensorFlow.js image model
+ */
+export async function loadImageModel(config: ImageConfig): Promise<any> {
+    const modelName = config.model
 
-        // Initialize TensorFlow.js
-        if (!tfInitialized) {
-            console.log("[TensorFlow.js] Initializing TensorFlow.js")
-            await tf.ready()
-            tfInitialized = true
-        }
+    let load = modelRegistry.get(modelName)
+    if (!load) {
+        load = (async () => {
+            assertBrowser()
+            console.log(`[TensorFlow.js] Loading image model: ${modelName}`)
+            await loadTensorFlow()
 
-        // Set the appropriate backend based on environment
-        if (isBrowser) {
-            // For browser, prefer WebGL if available
-            if (tf.getBackend() !== "webgl" && tf.ENV.getBool("HAS_WEBGL")) {
-                console.log(
-                    "[TensorFlow.js] Setting backend to WebGL for client-side processing"
-                )
-                await tf.setBackend("webgl")
+            if (!mobilenetModule) {
+                console.log("[TensorFlow.js] Dynamically importing MobileNet")
+                mobilenetModule = await import("@tensorflow-models/mobilenet")
             }
-        } else {
-            // Server-side processing is not supported
-            throw new Error(
-                "Image processing in server components is not supported. " +
-                "Please use client components for image processing."
-            )
-        }
-
-        console.log(`[TensorFlow.js] Using backend: ${tf.getBackend()}`)
 
-        // For now, we only support MobileNet
-        // Use version 1 with alpha 1.0 for best compatibility
-        const model = await mobilenetModule.load({
-            version: 1,
-            alpha: 1.0,
+            // For now, we only support MobileNet
+            // Use version 1 with alpha 1.0 for best compatibility
+            const model = await loadMobileNet()
+
+            console.log(`[TensorFlow.js] Image model loaded: ${modelName}`)
+            return model
+        })().catch((error) => {
+            // Let the next caller try again
+            modelRegistry.delete(modelName)
+            console.error(
+                `[TensorFlow.js] Error loading image model: ${modelName}`,
+                error
+            )
+            throw error
         })
+        modelRegistry.set(modelName, load)
+    }
+    return load
+}
+
+/**
+ * Decode a data URL (or bare base64 JPEG data) into a Blob without a fetch
+ */
+export function dataUrlToBlob(imageData: string): Blob {
+    const dataUrl = imageData.startsWith("data:")
+        ? imageData
+        : `data:image/jpeg;base64,${imageData}`
+    const comma = dataUrl.indexOf(",")
+    const header = dataUrl.slice(5, comma)
+    const type = header.split(";")[0] || "image/jpeg"
+    const payload = dataUrl.slice(comma + 1)
+
+    if (!header.endsWith(";base64")) {
+        return new Blob([decodeURIComponent(payload)], { type })
+    }
+    const binary = atob(payload)
+    const bytes = new Uint8Array(binary.length)
+    for (let i = 0; i < binary.length; i++) {
+        bytes[i] = binary.charCodeAt(i)
+    }
+    return new Blob([bytes], { type })
+}
 
-        // Cache the model
-        modelCache[modelName] = model
+async function toBlob(source: ImageSource): Promise<Blob> {
+    if (source instanceof Blob) return source
+    if (source instanceof URL) {
+        const response = await fetch(source)
+        if (!response.ok) {
+            throw new Error(`Could not fetch ${source}: ${response.statusText}`)
+        }
+        return response.blob()
+    }
+    return dataUrlToBlob(source)
+}
 
-        console.log(`[TensorFlow.js] Image model loaded: ${modelName}`)
-        return model
-    } catch (error) {
-        console.error(
-            `[TensorFlow.js] Error loading image model: ${modelName}`,
-            error
+/**
+ * Decode an image straight into a normalized [224, 224, 3] tensor
+ */
+export async function decodeImage(source: ImageSource): Promise<any> {
+    assertBrowser()
+    const tf = await loadTensorFlow()
+    const bitmap = await createImageBitmap(await toBlob(source))
+    try {
+        return tf.tidy(() =>
+            tf.image
+                .resizeBilinear(tf.browser.fromPixels(bitmap), [INPUT_SIZE, INPUT_SIZE])
+                .toFloat()
+                .div(127.5)
+                .sub(1)
         )
-        throw error
     } finally {
-        isModelLoading = false
+        bitmap.close()
     }
 }
 
@@ -122,102 +218,119 @@ export async function preprocessImage(
     imageData: string,
 ): Promise<any> {
     try {
-        // Ensure TensorFlow.js is loaded
-        if (!tf) {
-            console.log(
-                "[TensorFlow.js] Dynamically importing TensorFlow.js for preprocessing"
-            )
-            tf = await import("@tensorflow/tfjs")
-
-            if (!tfInitialized) {
-                console.log("[TensorFlow.js] Initializing TensorFlow.js")
-                await tf.ready()
-                tfInitialized = true
-            }
-        }
-
-        // MobileNet expects 224x224 images
-        const inputSize = 224
+        return await decodeImage(imageData)
+    } catch (error) {
+        console.error("[TensorFlow.js] Error processing image:", error)
 
-        if (!isBrowser) {
-            // Server-side processing is not supported
-            throw new Error(
-                "Image processing in server components is not supported. " +
-                "Please use client components for image processing."
-            )
-        }
+        // Fallback: create an empty tensor with the right dimensions
+        // This ensures we don't crash the app even if image processing fails
+        const tf = await loadTensorFlow()
+        console.log("[TensorFlow.js] Creating fallback tensor")
+        return tf.zeros([INPUT_SIZE, INPUT_SIZE, 3])
+    }
+}
 
-        // Remove data URL prefix if present for processing
-        const base64Data = imageData.startsWith("data:image")
-            ? imageData
-            : `data:image/jpeg;base64,${imageData}`
-
-        // Client-side processing using browser APIs
-        // Create an HTMLImageElement from the base64 data
-        const image = new window.Image()
-        const imagePromise = new Promise<HTMLImageElement>(
-            (resolve, reject) => {
-                image.onload = () => resolve(image)
-                image.onerror = (err) => {
-                    console.error("[TensorFlow.js] Error loading image:", err);
-                    reject(err);
-                }
-            }
-        )
+// Names of the penultimate layer in the MobileNet v1 graph, newest first
+const EMBEDDING_LAYERS = ["global_average_pooling2d_1", "global_average_pooling2d"]
 
-        // Set crossOrigin to anonymous to avoid CORS issues with data URLs
-        image.crossOrigin = "anonymous"
-        image.src = base64Data
+/**
+ * Run a [batch, 224, 224, 3] tensor up to the penultimate layer, which
+ * gives the feature vector (embedding) before classification
+ */
+async function embedBatch(model: any, batch: any): Promise<number[][]> {
+    // @ts-ignore - accessing internal property
+    const internalModel = model.model
 
+    let activation: any = null
+    for (const layer of EMBEDDING_LAYERS) {
         try {
-            await imagePromise
-
-            console.log(
-                "[TensorFlow.js] Image loaded successfully:",
-                image.width,
-                "x",
-                image.height
-            )
-
-            // Create a tensor from the image
-            const tensor = tf.browser.fromPixels(image)
-            console.log(
-                "[TensorFlow.js] Image tensor created with shape:",
-                tensor.shape
-            )
-
-            // Resize to the expected input size
-            const resized = tf.image.resizeBilinear(tensor, [inputSize, inputSize])
-            console.log("[TensorFlow.js] Image resized to:", resized.shape)
+            activation = internalModel.execute(batch, [layer])
+            break
+        } catch (_e) {
+            console.log(`[TensorFlow.js] Layer '${layer}' not found, trying the next one`)
+        }
+    }
+    if (!activation) {
+        activation = model.infer(batch, true)
+    }
 
-            // Convert to float and normalize to [-1, 1]
-            const normalized = resized
-                .toFloat()
-                .div(tf.scalar(127.5))
-                .sub(tf.scalar(1))
-            console.log(
-                "[TensorFlow.js] Image normalized with shape:",
-                normalized.shape
-            )
+    try {
+        const flat = activation.reshape([batch.shape[0], -1])
+        const rows = (await flat.array()) as number[][]
+        flat.dispose()
+        return rows
+    } finally {
+        activation.dispose()
+    }
+}
 
-            // Clean up intermediate tensors
-            tensor.dispose()
-            resized.dispose()
+/**
+ * Get embeddings for many images with one forward pass per batch.
+ *
+ * Images are fetched and decoded by a small pool of concurrent tasks; the
+ * next batch is decoded while the current one runs on the GPU. Results are
+ * in input order, with null for images that could not be fetched or decoded.
+ */
+export async function getImageEmbeddings(
+    sources: ImageSource[],
+    config: ImageConfig,
+    options: BatchEmbeddingOptions = {}
+): Promise<(number[] | null)[]> {
+    const batchSize = Math.max(1, options.batchSize ?? DEFAULT_BATCH_SIZE)
+    const concurrency = Math.max(1, options.concurrency ?? DEFAULT_CONCURRENCY)
+    const model = await loadImageModel(config)
+    const tf = await loadTensorFlow()
+
+    const results: (number[] | null)[] = new Array(sources.length).fill(null)
+    let done = 0
+
+    // Decoded tensors for sources[start, start + batchSize), null where decoding failed
+    const decodeBatch = async (start: number): Promise<(any | null)[]> => {
+        const slice = sources.slice(start, start + batchSize)
+        const tensors: (any | null)[] = new Array(slice.length).fill(null)
+        let next = 0
+        const worker = async () => {
+            while (next < slice.length) {
+                const index = next++
+                try {
+                    tensors[index] = await decodeImage(slice[index])
+                } catch (error) {
+                    console.warn(`[TensorFlow.js] Skipping image ${start + index}:`, error)
+                }
+            }
+        }
+        await Promise.all(Array.from({ length: Math.min(concurrency, slice.length) }, worker))
+        return tensors
+    }
 
-            return normalized
-        } catch (error) {
-            console.error("[TensorFlow.js] Error processing image:", error);
+    let pending: Promise<(any | null)[]> | null = decodeBatch(0)
+    for (let start = 0; pending; start += batchSize) {
+        const tensors: (any | null)[] = await pending
+        pending = start + batchSize < sources.length ? decodeBatch(start + batchSize) : null
 
-            // Fallback: create an empty tensor with the right dimensions
-            // This ensures we don't crash the app even if image processing fails
-            console.log("[TensorFlow.js] Creating fallback tensor");
-            const fallbackTensor = tf.zeros([inputSize, inputSize, 3]);
-            return fallbackTensor;
+        const decoded = tensors
+            .map((tensor, index) => ({ tensor, index: start + index }))
+            .filter(({ tensor }) => tensor !== null)
+        if (decoded.length > 0) {
+            const batch = tf.stack(decoded.map(({ tensor }) => tensor))
+            try {
+                const rows = await embedBatch(model, batch)
+                decoded.forEach(({ index }, row) => {
+                    results[index] = rows[row]
+                })
+            } catch (error) {
+                console.error("[TensorFlow.js] Error embedding image batch:", error)
+            } finally {
+                batch.dispose()
+            }
         }
-    } catch (error) {
-        console.error("[TensorFlow.js] Error preprocessing image:", error)
-        throw error
+        tensors.forEach((tensor) => tensor?.dispose())
+
+        done += tensors.length
+        options.onProgress?.(done, sources.length)
     }
+
+    return results
 }
 
 /**
@@ -228,80 +341,17 @@ export async function getImageEmbedding(
     config: ImageConfig
 ): Promise<number[]> {
     try {
-        console.log("[TensorFlow.js] Starting image embedding generation")
-
-        // Load the model
         const model = await loadImageModel(config)
-
-        // Preprocess the image
         const tensor = await preprocessImage(imageData)
-
-        console.log(
-            "[TensorFlow.js] Generating embedding with model:",
-            config.model
-        )
-
-        // Get the internal model to access the penultimate layer
-        // @ts-ignore - accessing internal property
-        const internalModel = model.model
-
-        // Add batch dimension [1, height, width, channels]
-        const batchedTensor = tensor.expandDims(0);
-        console.log("[TensorFlow.js] Added batch dimension, new shape:", batchedTensor.shape);
-
-        // Execute the model up to the penultimate layer
-        // This gives us the feature vector (embedding) before classification
-        let activationLayer;
-
+        const batch = tensor.expandDims(0)
         try {
-            console.log("[TensorFlow.js] Attempting to execute model with layer name 'global_average_pooling2d_1'");
-            // Try first with the expected layer name
-            activationLayer = internalModel.execute(
-                batchedTensor,
-                ["global_average_pooling2d_1"] // This is the name of the penultimate layer in MobileNet v1
-            );
-        } catch (_e) {
-            console.log("[TensorFlow.js] First layer name failed, trying alternate layer name 'global_average_pooling2d'");
-            try {
-                // Try alternate layer name
-                activationLayer = internalModel.execute(
-                    batchedTensor,
-                    ["global_average_pooling2d"]
-                );
-            } catch (_e2) {
-                console.log("[TensorFlow.js] Both layer names failed, using model.infer() method");
-                // If both specific layers fail, use model's infer method
-                activationLayer = model.infer(batchedTensor, true);
-            }
+            const [embedding] = await embedBatch(model, batch)
+            console.log("[TensorFlow.js] Embedding length:", embedding.length)
+            return embedding
+        } finally {
+            tensor.dispose()
+            batch.dispose()
         }
-
-        // Debug the tensor shape and values
-        console.log(
-            "[TensorFlow.js] Embedding tensor shape:",
-            activationLayer.shape
-        )
-
-        // Convert to array
-        const rawData = await activationLayer.data();
-        const embedding = Array.from(rawData).map(val => Number(val));
-
-        // Debug the embedding
-        console.log(
-            "[TensorFlow.js] Embedding sample (first 10 values):",
-            embedding.slice(0, 10)
-        )
-        console.log("[TensorFlow.js] Embedding length:", embedding.length)
-        console.log(
-            "[TensorFlow.js] Embedding has zeros:",
-            embedding.filter((v) => v === 0).length
-        )
-
-        // Clean up the tensors
-        tensor.dispose()
-        batchedTensor.dispose()
-        activationLayer.dispose()
-
-        return embedding
     } catch (error) {
         console.error(
             "[TensorFlow.js] Error generating image embedding:",
@@ -1,6 +1,7 @@
 import { EmbeddingConfig } from "../types/embeddingModels"
 
 export interface EmbeddingProvider {
-    getEmbedding(input: string, config: EmbeddingConfig): Promise<number[]>
-    getBatchEmbeddings?(inputs: string[], config: EmbeddingConfig): Promise<number[][]>
+    // apiKey is supplied per call so a shared provider never holds one caller's key
+    getEmbedding(input: string, config: EmbeddingConfig, apiKey?: string | null): Promise<number[]>
+    getBatchEmbeddings?(inputs: string[], config: EmbeddingConfig, apiKey?: string | null): Promise<number[][]>
 } 
\ No newline at end of file
@@ -1,51 +1,79 @@
 import { EmbeddingConfig, getModelData, CLIP_MODELS } from "../types/embeddingModels"
 import { EmbeddingProvider } from "./base"
+import { dataUrlToBlob, ImageSource } from "@/lib/embeddings/image/imageEmbedding"
 import { AutoProcessor, AutoTokenizer, CLIPTextModelWithProjection, CLIPVisionModelWithProjection, RawImage } from '@xenova/transformers'
 
-export class CLIPProvider implements EmbeddingProvider {
-    private imageProcessor: any = null
-    private visionModel: any = null
-    private textModel: any = null
-    private tokenizer: any = null
-    
-    async getImageEmbedding(imageData: string, modelPath: string): Promise<number[]> {
-        try {
-            // Initialize the image models if not already done
-            if (!this.imageProcessor || !this.visionModel) {
-                this.imageProcessor = await AutoProcessor.from_pretrained(modelPath)
-                this.visionModel = await CLIPVisionModelWithProjection.from_pretrained(modelPath, {
-                    quantized: true
-                })
-            }
+// Loaded CLIP models by path, shared by every provider instance on the page
+const visionModels = new Map<string, Promise<{ processor: any, model: any }>>()
+const textModels = new Map<string, Promise<{ tokenizer: any, model: any }>>()
+
+function loadOnce<T>(registry: Map<string, Promise<T>>, modelPath: string, load: () => Promise<T>): Promise<T> {
+    let loading = registry.get(modelPath)
+    if (!loading) {
+        loading = load().catch((error) => {
+            // Let the next caller try again
+            registry.delete(modelPath)
+            throw error
+        })
+        registry.set(modelPath, loading)
+    }
+    return loading
+}
+
+function loadVisionModel(modelPath: string) {
+    return loadOnce(visionModels, modelPath, async () => ({
+        processor: await AutoProcessor.from_pretrained(modelPath),
+        model: await CLIPVisionModelWithProjection.from_pretrained(modelPath, {
+            quantized: true
+        }),
+    }))
+}
 
-            // Convert base64 to blob
-            const response = await fetch(imageData)
-            const blob = await response.blob()
+function loadTextModel(modelPath: string) {
+    return loadOnce(textModels, modelPath, async () => ({
+        tokenizer: await AutoTokenizer.from_pretrained(modelPath),
+        model: await CLIPTextModelWithProjection.from_pretrained(modelPath, {
+            quantized: true
+        }),
+    }))
+}
 
-            // Create a File object from the blob
-            const file = new File([blob], 'image.jpg', { type: blob.type })
+// Splits a [batch, dims] output tensor into one array per row
+function toRows(tensor: any): number[][] {
+    const [batch, dims] = tensor.dims
+    const data = tensor.data as Float32Array
+    return Array.from({ length: batch }, (_, row) =>
+        Array.from(data.subarray(row * dims, (row + 1) * dims))
+    )
+}
 
-            // Create an object URL for the file
-            const objectUrl = URL.createObjectURL(file)
+export class CLIPProvider implements EmbeddingProvider {
+    async getImageEmbedding(imageData: ImageSource, modelPath: string): Promise<number[]> {
+        const [embedding] = await this.getImageEmbeddings([imageData], modelPath)
+        return embedding
+    }
+
+    // One forward pass for all the images; they are decoded from their bytes directly
+    async getImageEmbeddings(images: ImageSource[], modelPath: string): Promise<number[][]> {
+        try {
+            const { processor, model } = await loadVisionModel(modelPath)
+            const decoded = await Promise.all(
+                images.map(async (image) => {
+                    if (image instanceof URL) return RawImage.fromURL(image.toString())
+                    return RawImage.fromBlob(image instanceof Blob ? image : dataUrlToBlob(image))
+                })
+            )
 
             try {
-                // Process the image
-                const image = await RawImage.read(objectUrl)
-                
-                try {
-                    const imageInputs = await this.imageProcessor(image)
-                    const { image_embeds } = await this.visionModel(imageInputs)
-                    return Array.from(image_embeds.data)
-                } catch (processingError) {
-                    // Handle specific memory-related errors
-                    if (processingError instanceof RangeError && processingError.message.includes('offset')) {
-                        throw new Error('Image processing failed due to memory limitations. Try a smaller or less complex image.')
-                    }
-                    throw processingError
+                const imageInputs = await processor(decoded)
+                const { image_embeds } = await model(imageInputs)
+                return toRows(image_embeds)
+            } catch (processingError) {
+                // Handle specific memory-related errors
+                if (processingError instanceof RangeError && processingError.message.includes('offset')) {
+                    throw new Error('Image processing failed due to memory limitations. Try a smaller or less complex image.')
                 }
-            } finally {
-                // Clean up the object URL
-                URL.revokeObjectURL(objectUrl)
+                throw processingError
             }
         } catch (error) {
             console.error("[CLIP] Error generating image embedding:", error)
@@ -53,80 +81,88 @@ export class CLIPProvider implements EmbeddingProvider {
         }
     }
 
-    async getEmbedding(input: string, config: EmbeddingConfig): Promise<number[]> {
-        if (!config.clip) {
-            throw new Error("CLIP configuration is missing")
-        }
+    async getTextEmbeddings(texts: string[], modelPath: string): Promise<number[][]> {
+        const { tokenizer, model } = await loadTextModel(modelPath)
+        const textInputs = tokenizer(texts, {
+            padding: true,
+            truncation: true
+        })
+        const { text_embeds } = await model(textInputs)
+        return toRows(text_embeds)
+    }
 
-        try {
-            let modelPath: string = 'Xenova/clip-vit-base-patch32'
-            
-            if (config.clip.model) {
-                const model = CLIP_MODELS.find(model => model.id === config.clip?.model)
-                if (model?.modelPath) {
-                    modelPath = model.modelPath
-                }
-            }
+    private getModelPath(config: EmbeddingConfig): string {
+        let modelPath: string = 'Xenova/clip-vit-base-patch32'
 
-            if (!modelPath) {
-                throw new Error("Model path is undefined")
+        if (config.clip?.model) {
+            const model = CLIP_MODELS.find(model => model.id === config.clip?.model)
+            if (model?.modelPath) {
+                modelPath = model.modelPath
             }
+        }
 
-            // Determine if input is base64 image data or text
-            const isBase64Image = input.startsWith('data:image')
-            
-            let embedding: number[]
-            if (isBase64Image) {
-                embedding = await this.getImageEmbedding(input, modelPath)
-            } else {
-                // Initialize the text model and tokenizer if not already done
-                if (!this.textModel || !this.tokenizer) {
-                    this.tokenizer = await AutoTokenizer.from_pretrained(modelPath)
-                    this.textModel = await CLIPTextModelWithProjection.from_pretrained(modelPath, {
-                        quantized: true
-                    })
-                }
+        if (!modelPath) {
+            throw new Error("Model path is undefined")
+        }
+        return modelPath
+    }
 
-                // Process text input
-                const textInputs = this.tokenizer([input], { 
-                    padding: true, 
-                    truncation: true 
-                })
-                const { text_embeds } = await this.textModel(textInputs)
-                embedding = Array.from(text_embeds.data)
-            }
+    private validateEmbedding(embedding: number[], config: EmbeddingConfig) {
+        // Validate embedding dimensions
+        const modelData = getModelData(config)
+        const expectedDim = modelData?.dimensions
+        if (expectedDim && embedding.length !== expectedDim) {
+            throw new Error(
+                `Unexpected embedding dimension: got ${embedding.length}, expected ${expectedDim}`
+            )
+        }
 
-            // Validate embedding dimensions
-            const modelData = getModelData(config)
-            const expectedDim = modelData?.dimensions
-            if (expectedDim && embedding.length !== expectedDim) {
-                throw new Error(
-                    `Unexpected embedding dimension: got ${embedding.length}, expected ${expectedDim}`
-                )
-            }
+        // Validate vector values
+        if (embedding.some(v => typeof v !== 'number' || isNaN(v) || !isFinite(v))) {
+            console.error("Invalid vector values:", embedding)
+            throw new Error("Vector contains invalid values (NaN or Infinity)")
+        }
+    }
 
-            // Validate vector values
-            if (embedding.some(v => typeof v !== 'number' || isNaN(v) || !isFinite(v))) {
-                console.error("Invalid vector values:", embedding)
-                throw new Error("Vector contains invalid values (NaN or Infinity)")
-            }
+    async getEmbedding(input: string, config: EmbeddingConfig): Promise<number[]> {
+        const [embedding] = await this.getBatchEmbeddings([input], config)
+        console.log("Generated embedding dimensions:", embedding.length)
+        return embedding
+    }
 
-            console.log("Generated embedding dimensions:", embedding.length)
+    // Images (data URLs) and texts are each embedded in a single batch
+    async getBatchEmbeddings(inputs: string[], config: EmbeddingConfig): Promise<number[][]> {
+        if (!config.clip) {
+            throw new Error("CLIP configuration is missing")
+        }
+
+        try {
+            const modelPath = this.getModelPath(config)
+
+            // Determine if each input is base64 image data or text
+            const imageIndexes: number[] = []
+            const textIndexes: number[] = []
+            inputs.forEach((input, index) => {
+                (input.startsWith('data:image') ? imageIndexes : textIndexes).push(index)
+            })
 
-            return embedding
+            const [imageEmbeddings, textEmbeddings] = await Promise.all([
+                imageIndexes.length > 0
+                    ? this.getImageEmbeddings(imageIndexes.map(index => inputs[index]), modelPath)
+                    : [],
+                textIndexes.length > 0
+                    ? this.getTextEmbeddings(textIndexes.map(index => inputs[index]), modelPath)
+                    : [],
+            ])
+
+            const embeddings: number[][] = new Array(inputs.length)
+            imageIndexes.forEach((index, i) => { embeddings[index] = imageEmbeddings[i] })
+            textIndexes.forEach((index, i) => { embeddings[index] = textEmbeddings[i] })
+            embeddings.forEach(embedding => this.validateEmbedding(embedding, config))
+            return embeddings
         } catch (error) {
             console.error("[CLIP] Error generating embedding:", error)
             throw error
         }
     }
-
-    // Batch processing is not yet supported for CLIP
-    async getBatchEmbeddings(inputs: string[], config: EmbeddingConfig): Promise<number[][]> {
-        const embeddings: number[][] = []
-        for (const input of inputs) {
-            const embedding = await this.getEmbedding(input, config)
-            embeddings.push(embedding)
-        }
-        return embeddings
-    }
-} 
\ No newline at end of file
+}
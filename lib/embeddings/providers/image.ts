@@ -1,6 +1,6 @@
 import { EmbeddingConfig, getModelData } from "../types/embeddingModels"
 import { EmbeddingProvider } from "./base"
-import { getImageEmbedding } from "@/lib/embeddings/image/imageEmbedding"
+import { getImageEmbedding, getImageEmbeddings } from "@/lib/embeddings/image/imageEmbedding"
 
 export class ImageProvider implements EmbeddingProvider {
     async getEmbedding(input: string, config: EmbeddingConfig): Promise<number[]> {
@@ -43,14 +43,18 @@ export class ImageProvider implements EmbeddingProvider {
         }
     }
 
-    // Image provider doesn't support batch embeddings directly
-    // Each image would need to be processed individually
+    // One forward pass per batch of images; see getImageEmbeddings
     async getBatchEmbeddings(inputs: string[], config: EmbeddingConfig): Promise<number[][]> {
-        const embeddings: number[][] = []
-        for (const input of inputs) {
-            const embedding = await this.getEmbedding(input, config)
-            embeddings.push(embedding)
+        if (!config.image) {
+            throw new Error("Image configuration is missing")
         }
-        return embeddings
+
+        const embeddings = await getImageEmbeddings(inputs, config.image)
+        return embeddings.map((embedding, index) => {
+            if (!embedding) {
+                throw new Error(`Could not decode image ${index}`)
+            }
+            return embedding
+        })
     }
-} 
\ No newline at end of file
+}
@@ -8,13 +8,13 @@ export class OpenAIProvider implements EmbeddingProvider {
         this.apiKey = apiKey;
     }
 
-    async getEmbedding(input: string, config: EmbeddingConfig): Promise<number[]> {
+    async getEmbedding(input: string, config: EmbeddingConfig, requestApiKey?: string | null): Promise<number[]> {
         if (!config.openai) {
             throw new Error("OpenAI configuration is missing")
         }
 
-        // Use the instance API key if available, otherwise try to get it from the environment
-        const apiKey = this.apiKey || process.env.OPENAI_API_KEY;
+        // Use the per-request key, then the instance key, then the environment
+        const apiKey = requestApiKey || this.apiKey || process.env.OPENAI_API_KEY;
         if (!apiKey) {
             throw new Error("OpenAI API key is missing. Please configure it in your user settings.")
         }
@@ -53,13 +53,13 @@ export class OpenAIProvider implements EmbeddingProvider {
         return embedding
     }
 
-    async getBatchEmbeddings(inputs: string[], config: EmbeddingConfig): Promise<number[][]> {
+    async getBatchEmbeddings(inputs: string[], config: EmbeddingConfig, requestApiKey?: string | null): Promise<number[][]> {
         if (!config.openai) {
             throw new Error("OpenAI configuration is missing")
         }
 
-        // Use the instance API key if available, otherwise try to get it from the environment
-        const apiKey = this.apiKey || process.env.OPENAI_API_KEY;
+        // Use the per-request key, then the instance key, then the environment
+        const apiKey = requestApiKey || this.apiKey || process.env.OPENAI_API_KEY;
         if (!apiKey) {
             throw new Error("OpenAI API key is missing. Please configure it in your user settings.")
         }
@@ -1,3 +1,4 @@
+import { createHash } from "crypto"
 import { EmbeddingConfig, getExpectedDimensions } from "./types/embeddingModels"
 import { OpenAIProvider } from "./providers/openai"
 import { OllamaProvider } from "./providers/ollama"
@@ -7,10 +8,14 @@ import { EmbeddingProvider } from "./providers/base"
 import { validateVector } from "./utils/validation"
 import { EmbeddingCache } from "./cache/redis-cache"
 import { PROVIDERS } from "./constants"
+import { recordEmbeddingCacheLookup, recordEmbeddingRequest } from "@/lib/server/metrics"
+import { SingleFlight } from "@/lib/server/single-flight"
 
 export class EmbeddingService {
     private providers: Map<string, EmbeddingProvider>
     private cache: EmbeddingCache
+    // Identical concurrent requests (e.g. several tabs typing the same query) share one provider call
+    private inFlight = new SingleFlight<number[]>()
 
     constructor() {
         this.providers = new Map()
@@ -27,7 +32,8 @@ export class EmbeddingService {
         input: string,
         config: EmbeddingConfig,
         isImage: boolean = false,
-        apiKey?: string | null
+        apiKey?: string | null,
+        redisUrl?: string | null
     ): Promise<number[]> {
         // For image data, ensure we're using the image provider
         if (isImage && config.provider !== PROVIDERS.IMAGE) {
@@ -38,8 +44,23 @@ export class EmbeddingService {
             throw new Error("Image provider requires image data")
         }
 
+        const key = createHash("sha256")
+            .update(JSON.stringify([config, input, isImage, redisUrl ?? "", apiKey ?? ""]))
+            .digest("hex")
+        return this.inFlight.run(key, () =>
+            this.computeEmbedding(input, config, apiKey, redisUrl)
+        )
+    }
+
+    private async computeEmbedding(
+        input: string,
+        config: EmbeddingConfig,
+        apiKey?: string | null,
+        redisUrl?: string | null
+    ): Promise<number[]> {
         // Check cache first if caching is enabled
-        const cachedEmbedding = await this.cache.get(input, config)
+        const cachedEmbedding = await this.cache.get(input, config, redisUrl)
+        recordEmbeddingCacheLookup(cachedEmbedding !== null)
         if (cachedEmbedding) {
             console.log("[EmbeddingService] Returning cached embedding")
             return cachedEmbedding
@@ -50,12 +71,9 @@ export class EmbeddingService {
             throw new Error(`Unsupported provider: ${config.provider}`)
         }
 
-        // Pass the API key to the provider if it's OpenAI
-        if (config.provider === PROVIDERS.OPENAI && provider instanceof OpenAIProvider) {
-            provider.setApiKey(apiKey || null);
-        }
-
-        const embedding = await provider.getEmbedding(input, config)
+        const startTime = performance.now()
+        const embedding = await provider.getEmbedding(input, config, apiKey)
+        recordEmbeddingRequest(config.provider, performance.now() - startTime, 1)
         // TODO: Validate the embedding
         // THIS DOES NOT WORK WITH REDUCE... WE lose track of the original embedding size
         // and the VDIM returns the REDUCE size...
@@ -76,7 +94,7 @@ export class EmbeddingService {
         }
 
         // Cache the result if caching is enabled
-        await this.cache.set(input, embedding, config)
+        await this.cache.set(input, embedding, config, redisUrl)
 
         // Return the original embedding, not normalized
         return embedding
@@ -86,7 +104,8 @@ export class EmbeddingService {
         inputs: string[],
         config: EmbeddingConfig,
         areImages: boolean = false,
-        apiKey?: string | null
+        apiKey?: string | null,
+        redisUrl?: string | null
     ): Promise<number[][]> {
         // For image data, ensure we're using the image provider
         if (areImages && config.provider !== PROVIDERS.IMAGE) {
@@ -102,28 +121,21 @@ export class EmbeddingService {
             throw new Error(`Unsupported provider: ${config.provider}`)
         }
 
-        // Pass the API key to the provider if it's OpenAI
-        if (config.provider === PROVIDERS.OPENAI && provider instanceof OpenAIProvider) {
-            provider.setApiKey(apiKey);
-        }
-
-        // Check cache first if caching is enabled
+        // Check cache first if caching is enabled; one round trip for the whole batch
         const embeddings: number[][] = []
         const uncachedInputs: string[] = []
         const uncachedIndices: number[] = []
 
-        // Try to get embeddings from cache
-        for (let i = 0; i < inputs.length; i++) {
-            const input = inputs[i]
-            const cachedEmbedding = await this.cache.get(input, config)
-
+        const cachedEmbeddings = await this.cache.getMany(inputs, config, redisUrl)
+        cachedEmbeddings.forEach((cachedEmbedding, i) => {
+            recordEmbeddingCacheLookup(cachedEmbedding !== null)
             if (cachedEmbedding) {
                 embeddings[i] = cachedEmbedding
             } else {
-                uncachedInputs.push(input)
+                uncachedInputs.push(inputs[i])
                 uncachedIndices.push(i)
             }
-        }
+        })
 
         // If all embeddings were cached, return them
         if (uncachedInputs.length === 0) {
@@ -135,16 +147,24 @@ export class EmbeddingService {
 
         if (provider.getBatchEmbeddings && uncachedInputs.length > 1) {
             // Use batch processing if available
+            const startTime = performance.now()
             uncachedEmbeddings = await provider.getBatchEmbeddings(
                 uncachedInputs,
-                config
+                config,
+                apiKey
+            )
+            recordEmbeddingRequest(
+                config.provider,
+                performance.now() - startTime,
+                uncachedInputs.length
             )
         } else {
-            // Fall back to sequential processing
+            // Fall back to sequential processing; the cache was already checked above
             uncachedEmbeddings = []
             for (const input of uncachedInputs) {
-                const embedding = await this.getEmbedding(input, config, areImages, apiKey)
-                uncachedEmbeddings.push(embedding)
+                const startTime = performance.now()
+                uncachedEmbeddings.push(await provider.getEmbedding(input, config, apiKey))
+                recordEmbeddingRequest(config.provider, performance.now() - startTime, 1)
             }
         }
 
@@ -168,13 +188,7 @@ export class EmbeddingService {
         )
 
         // Cache the results if caching is enabled
-        for (let i = 0; i < uncachedInputs.length; i++) {
-            await this.cache.set(
-                uncachedInputs[i],
-                validatedEmbeddings[i],
-                config
-            )
-        }
+        await this.cache.setMany(uncachedInputs, validatedEmbeddings, config, redisUrl)
 
         // Merge cached and newly computed embeddings
         for (let i = 0; i < uncachedIndices.length; i++) {
@@ -184,3 +198,14 @@ export class EmbeddingService {
         return embeddings
     }
 }
+
+let sharedService: EmbeddingService | null = null
+
+// One service per server process, shared by the API routes and background jobs
+// so provider models and clients are only initialised once
+export function getEmbeddingService(): EmbeddingService {
+    if (!sharedService) {
+        sharedService = new EmbeddingService()
+    }
+    return sharedService
+}
@@ -1,11 +1,8 @@
 import { VectorSetAdvancedConfig } from "@/lib/types/vectors"
 import { vadd_multi } from "../redis-server/api"
+import { readVectorExport, VectorExportElement } from "./vectorExport"
 
-interface VectorElement {
-    element: string
-    vector: number[]
-    attributes?: Record<string, string | number | boolean>
-}
+type VectorElement = VectorExportElement
 
 /**
  * Imports vector data into Redis in chunks using VADD_MULTI and SETATTRIB
@@ -19,24 +16,32 @@ export async function importVectorData(
     const chunks = chunkArray(data, chunkSize)
 
     for (const chunk of chunks) {
-        // Prepare VADD_MULTI payload
-        const elements = chunk.map((item) => item.element)
-        const vectors = chunk.map((item) => item.vector)
-        const attributes = chunk.map((item) => item.attributes || {}) 
+        await importChunk(vectorSetName, chunk, config)
+    }
+}
 
-        const response = await vadd_multi({
-            keyName: vectorSetName,
-            elements,
-            vectors,
-            attributes,
-            reduceDimensions: config?.reduceDimensions,
-            useCAS: config?.defaultCAS,
-            ef: config?.buildExplorationFactor,
-        })
+async function importChunk(
+    vectorSetName: string,
+    chunk: VectorElement[],
+    config?: VectorSetAdvancedConfig
+) {
+    // Prepare VADD_MULTI payload
+    const elements = chunk.map((item) => item.element)
+    const vectors = chunk.map((item) => item.vector)
+    const attributes = chunk.map((item) => item.attributes || {}) 
 
-        if (!response) {
-            throw new Error('Failed to import vectors')
-        }
+    const response = await vadd_multi({
+        keyName: vectorSetName,
+        elements,
+        vectors,
+        attributes,
+        reduceDimensions: config?.reduceDimensions,
+        useCAS: config?.defaultCAS,
+        ef: config?.buildExplorationFactor,
+    })
+
+    if (!response) {
+        throw new Error('Failed to import vectors')
     }
 }
 
@@ -94,26 +99,31 @@ export async function saveVectorData(
 }
 
 /**
- * Reads vector data from a JSON file and imports it into Redis
+ * Streams vector data from an export file (JSON, NDJSON or binary manifest)
+ * and imports it into Redis one chunk at a time, so the whole file is never
+ * held in memory
  */
 export async function importVectorDataFromFile(
     filename: string,
     vectorSetName: string,
     config: VectorSetAdvancedConfig,
-    chunkSize?: number
+    chunkSize: number = 100
 ): Promise<void> {
     try {
-        const response = await fetch(`/${filename}`);
-        if (!response.ok) {
-            throw new Error('Failed to read vector data file');
+        let chunk: VectorElement[] = []
+        for await (const item of readVectorExport(`/${filename.replace(/^\//, '')}`)) {
+            if (!item || typeof item.element !== 'string' || !item.vector) {
+                throw new Error('File content must be a list of vector elements');
+            }
+            chunk.push(item);
+            if (chunk.length >= chunkSize) {
+                await importChunk(vectorSetName, chunk, config);
+                chunk = [];
+            }
         }
-        const vectorData = await response.json() as VectorElement[];
-        
-        if (!Array.isArray(vectorData)) {
-            throw new Error('File content must be an array of vector elements');
+        if (chunk.length > 0) {
+            await importChunk(vectorSetName, chunk, config);
         }
-        
-        await importVectorData(vectorSetName, vectorData, config, chunkSize);
     } catch (error) {
         if (error instanceof Error) {
             throw new Error(`Failed to import vector data from file: ${error.message}`);
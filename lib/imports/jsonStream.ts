@@ -0,0 +1,83 @@
+/**
+ * Parses a JSON document incrementally. A top-level array yields each of its
+ * elements; any other top-level value is yielded once. Only the element being
+ * scanned is held in memory, never the whole document.
+ */
+export async function* parseJSONStream(
+    stream: ReadableStream<Uint8Array>
+): AsyncGenerator<any> {
+    const decoder = new TextDecoder()
+    const reader = stream.getReader()
+
+    let isArray: boolean | null = null
+    let depth = 0
+    let inString = false
+    let escaped = false
+    // Part of the current element carried over from earlier chunks
+    let buffered = ""
+
+    try {
+        while (true) {
+            const { done, value } = await reader.read()
+            const text = done ? decoder.decode() : decoder.decode(value, { stream: true })
+            // Start of the current element within this chunk
+            let start = 0
+
+            for (let i = 0; i < text.length; i++) {
+                const ch = text[i]
+
+                // Detect the document shape from the first significant character
+                if (isArray === null) {
+                    if (/\s/.test(ch)) {
+                        start = i + 1
+                        continue
+                    }
+                    isArray = ch === "["
+                    if (isArray) {
+                        start = i + 1
+                        continue
+                    }
+                }
+
+                if (inString) {
+                    if (escaped) {
+                        escaped = false
+                    } else if (ch === "\\") {
+                        escaped = true
+                    } else if (ch === '"') {
+                        inString = false
+                    }
+                    continue
+                }
+
+                // A comma or the closing bracket at depth 0 ends an array element
+                if (isArray && depth === 0 && (ch === "," || ch === "]")) {
+                    const element = buffered + text.slice(start, i)
+                    if (element.trim()) {
+                        yield JSON.parse(element)
+                    }
+                    buffered = ""
+                    start = i + 1
+                    continue
+                }
+
+                if (ch === '"') {
+                    inString = true
+                } else if (ch === "{" || ch === "[") {
+                    depth++
+                } else if (ch === "}" || ch === "]") {
+                    depth--
+                }
+            }
+
+            buffered += text.slice(start)
+            if (done) break
+        }
+    } finally {
+        reader.releaseLock()
+    }
+
+    if (isArray === false && buffered.trim()) {
+        yield JSON.parse(buffered)
+    }
+}
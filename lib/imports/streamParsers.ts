@@ -0,0 +1,34 @@
+import { parse } from "csv-parse"
+import { Readable } from "stream"
+import { CSVRow } from "@/lib/types/jobs"
+
+export interface CSVStreamOptions {
+    delimiter: string
+    hasHeader: boolean
+    skipRows: number
+}
+
+/**
+ * Parses a CSV byte stream incrementally, yielding one record at a time.
+ * Uses the same options as the csv-parse/sync call in JobQueueService.createJob
+ */
+export async function* parseCSVStream(
+    stream: ReadableStream<Uint8Array>,
+    options: CSVStreamOptions
+): AsyncGenerator<CSVRow> {
+    const parser = Readable.fromWeb(stream as any).pipe(
+        parse({
+            columns: options.hasHeader,
+            skip_empty_lines: true,
+            delimiter: options.delimiter,
+            from_line: Math.max(1, options.skipRows + (options.hasHeader ? 1 : 0)),
+        })
+    )
+
+    for await (const record of parser) {
+        yield record as CSVRow
+    }
+}
+
+// Browser-safe, so it lives in its own module; re-exported for existing imports
+export { parseJSONStream } from "./jsonStream"
@@ -0,0 +1,225 @@
+import { parseJSONStream } from "./jsonStream"
+
+/*
+ * On-disk formats for vector set exports, shared by the server-side writer
+ * (lib/server/export-writer.ts) and the streaming reader below.
+ *
+ *   json    A compact JSON array of { element, vector, attributes? }.
+ *   ndjson  One { element, vector, attributes? } object per line.
+ *   binary  A small JSON manifest (the export's own filename) naming two
+ *           sidecar files: row-major little-endian FP32 vectors, and an
+ *           NDJSON file of { element, attributes? } in the same order.
+ */
+
+export type VectorExportFormat = "json" | "ndjson" | "binary"
+
+export interface VectorExportElement {
+    element: string
+    vector: number[]
+    attributes?: Record<string, string | number | boolean>
+}
+
+export const VECTOR_EXPORT_MANIFEST_FORMAT = "fp32-vectors"
+
+export interface VectorExportManifest {
+    format: typeof VECTOR_EXPORT_MANIFEST_FORMAT
+    version: 1
+    dimension: number
+    count: number
+    // Sidecar filenames, relative to the manifest
+    vectors: string
+    attributes: string
+}
+
+// The format implied by a filename when none is given explicitly
+export function resolveExportFormat(
+    filename: string,
+    format?: VectorExportFormat
+): VectorExportFormat {
+    if (format) return format
+    return filename.toLowerCase().endsWith(".ndjson") ? "ndjson" : "json"
+}
+
+export interface ExportFileNames {
+    main: string
+    vectors?: string
+    attributes?: string
+}
+
+/**
+ * Names of the files making up an export. `main` is the file the export is
+ * known by; binary exports add their two sidecars.
+ */
+export function exportFileNames(filename: string, format: VectorExportFormat): ExportFileNames {
+    const base = filename.replace(/\.(nd)?json$/i, "")
+    switch (format) {
+        case "ndjson":
+            return { main: `${base}.ndjson` }
+        case "binary":
+            return {
+                main: `${base}.json`,
+                vectors: `${base}.f32`,
+                attributes: `${base}.attributes.ndjson`,
+            }
+        case "json":
+        default:
+            return { main: `${base}.json` }
+    }
+}
+
+/**
+ * Splits a byte stream into lines and parses each non-empty line as JSON.
+ * Only the line being read is held in memory.
+ */
+export async function* parseNDJSONStream(
+    stream: ReadableStream<Uint8Array>
+): AsyncGenerator<any> {
+    const decoder = new TextDecoder()
+    const reader = stream.getReader()
+    let buffered = ""
+
+    try {
+        while (true) {
+            const { done, value } = await reader.read()
+            buffered += done ? decoder.decode() : decoder.decode(value, { stream: true })
+
+            let newline = buffered.indexOf("\n")
+            while (newline !== -1) {
+                const line = buffered.slice(0, newline).trim()
+                buffered = buffered.slice(newline + 1)
+                if (line) {
+                    yield JSON.parse(line)
+                }
+                newline = buffered.indexOf("\n")
+            }
+
+            if (done) break
+        }
+    } finally {
+        reader.releaseLock()
+    }
+
+    if (buffered.trim()) {
+        yield JSON.parse(buffered)
+    }
+}
+
+const HOST_IS_LITTLE_ENDIAN = new Uint8Array(new Uint16Array([1]).buffer)[0] === 1
+
+// Vector files are always little-endian
+function decodeFp32Row(row: Uint8Array, dimension: number): Float32Array {
+    if (HOST_IS_LITTLE_ENDIAN) {
+        return new Float32Array(row.slice().buffer)
+    }
+    const view = new DataView(row.buffer, row.byteOffset, row.byteLength)
+    const vector = new Float32Array(dimension)
+    for (let i = 0; i < dimension; i++) {
+        vector[i] = view.getFloat32(i * 4, true)
+    }
+    return vector
+}
+
+/**
+ * Reads a stream of FP32 vectors of the given dimension, yielding one
+ * Float32Array per row. Rows may straddle chunk boundaries.
+ */
+export async function* parseFp32Stream(
+    stream: ReadableStream<Uint8Array>,
+    dimension: number
+): AsyncGenerator<Float32Array> {
+    const rowBytes = dimension * 4
+    const reader = stream.getReader()
+    const row = new Uint8Array(rowBytes)
+    let filled = 0
+
+    try {
+        while (true) {
+            const { done, value } = await reader.read()
+            if (done) break
+
+            let offset = 0
+            while (offset < value.length) {
+                const take = Math.min(rowBytes - filled, value.length - offset)
+                row.set(value.subarray(offset, offset + take), filled)
+                filled += take
+                offset += take
+                if (filled === rowBytes) {
+                    // Copied out, so the row buffer can be reused for the next row
+                    yield decodeFp32Row(row, dimension)
+                    filled = 0
+                }
+            }
+        }
+    } finally {
+        reader.releaseLock()
+    }
+
+    if (filled !== 0) {
+        throw new Error("Vector file ends in the middle of a row")
+    }
+}
+
+function isManifest(value: any): value is VectorExportManifest {
+    return value && typeof value === "object" && value.format === VECTOR_EXPORT_MANIFEST_FORMAT
+}
+
+async function openStream(url: string): Promise<ReadableStream<Uint8Array>> {
+    const response = await fetch(url)
+    if (!response.ok || !response.body) {
+        throw new Error(`Failed to read ${url}: ${response.status} ${response.statusText}`)
+    }
+    return response.body
+}
+
+async function* readBinaryExport(
+    baseUrl: string,
+    manifest: VectorExportManifest
+): AsyncGenerator<VectorExportElement> {
+    const rows = parseNDJSONStream(await openStream(baseUrl + manifest.attributes))
+    const vectors = parseFp32Stream(await openStream(baseUrl + manifest.vectors), manifest.dimension)
+
+    try {
+        while (true) {
+            const [row, vector] = await Promise.all([rows.next(), vectors.next()])
+            if (row.done || vector.done) {
+                if (row.done !== vector.done) {
+                    throw new Error("Vector and attribute files have different row counts")
+                }
+                return
+            }
+            yield {
+                element: row.value.element,
+                vector: Array.from(vector.value),
+                ...(row.value.attributes && { attributes: row.value.attributes }),
+            }
+        }
+    } finally {
+        await rows.return(undefined)
+        await vectors.return(undefined)
+    }
+}
+
+/**
+ * Streams the elements of an export in any of the formats above, fetched
+ * from `url`. A JSON document that turns out to be a binary manifest is
+ * followed to its sidecar files.
+ */
+export async function* readVectorExport(url: string): AsyncGenerator<VectorExportElement> {
+    const path = url.split("?")[0]
+    const stream = await openStream(url)
+
+    if (path.toLowerCase().endsWith(".ndjson")) {
+        yield* parseNDJSONStream(stream)
+        return
+    }
+
+    let isFirst = true
+    for await (const value of parseJSONStream(stream)) {
+        if (isFirst && isManifest(value)) {
+            yield* readBinaryExport(path.slice(0, path.lastIndexOf("/") + 1), value)
+            return
+        }
+        isFirst = false
+        yield value as VectorExportElement
+    }
+}
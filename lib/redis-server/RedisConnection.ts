@@ -1,5 +1,26 @@
 import { createClient } from "redis"
 import { cookies } from "next/headers"
+import {
+    ClusterTopology,
+    nodeLabel,
+    nodeUrl,
+    parseClusterSlots,
+    parseRedirect,
+    primaryForKey,
+} from "./cluster"
+import {
+    ASSUMED_CAPABILITIES,
+    CapabilityName,
+    RedisCapabilities,
+    capabilityProbeKey,
+    probeCapabilities,
+} from "./capabilities"
+
+export interface RedisOperationTimings {
+    queueWaitMs: number // Waiting for a pooled connection, excluding connect
+    connectMs: number // Opening the connection, when this call caused one
+    redisMs: number // Running the operation against Redis
+}
 
 export interface RedisOperationResult<T> {
     success: boolean
@@ -7,6 +28,7 @@ export interface RedisOperationResult<T> {
     error?: string
     executionTimeMs?: number
     executedCommand?: string
+    timings?: RedisOperationTimings
 }
 
 // Helper to get Redis URL from cookies
@@ -16,148 +38,522 @@ export async function getRedisUrl(): Promise<string | null> {
 }
 
 // Define a type alias for our Redis client to avoid type mismatches
-type RedisClient = ReturnType<typeof createClient>
+export type RedisClient = ReturnType<typeof createClient>
 
-export class RedisConnection {
-    private static connectionPool: Map<
-        string,
-        {
-            client: RedisClient
-            lastUsed: number
-            isConnecting: boolean
+// Interactive traffic (UI routes) and bulk traffic (imports, jobs) use separate
+// connections so a long pipeline never queues a user's search behind it
+export type ConnectionLane = "interactive" | "bulk"
+
+export interface CapabilityOptions {
+    // Run the probe (which writes a short-lived set) if the node has not been
+    // probed yet. Only paths about to write pass this; the others use what is
+    // already known, or ASSUMED_CAPABILITIES
+    probe?: boolean
+}
+
+export interface WithClientOptions {
+    lane?: ConnectionLane
+    // On a cluster, run against the primary owning this key's slot
+    key?: string
+}
+
+export interface NodeOperationResult<T> extends RedisOperationResult<T> {
+    node: string // host:port the operation ran on
+}
+
+export interface PoolStats {
+    url: string
+    lane: ConnectionLane
+    size: number
+    active: number
+    idle: number
+    waiting: number
+    acquires: number
+    avgWaitMs: number
+    maxWaitMs: number
+}
+
+interface PooledClient {
+    client: RedisClient
+    leased: boolean
+    lastUsed: number
+    // Connect time, reported by (and cleared on) the first lease
+    connectMs?: number
+}
+
+interface Waiter {
+    resolve: (connection: PooledClient) => void
+    reject: (error: Error) => void
+    timer: NodeJS.Timeout
+}
+
+interface LanePool {
+    connections: PooledClient[]
+    waiters: Waiter[]
+    // Only one connect per lane is in flight; callers queue instead of racing
+    connecting: Promise<void> | null
+    maxSize: number
+    acquires: number
+    totalWaitMs: number
+    maxWaitMs: number
+}
+
+function readPoolSize(name: string, fallback: number): number {
+    const value = Number(process.env[name])
+    return Number.isInteger(value) && value > 0 ? value : fallback
+}
+
+// Rewrites auth-related failures into something the user can act on
+function toConnectionError(error: unknown): Error {
+    if (error instanceof Error) {
+        if (error.message.includes("NOAUTH") || error.message.includes("AUTH")) {
+            return new Error("Authentication failed: Please check your Redis password")
         }
-    > = new Map()
+        return error
+    }
+    return new Error(String(error))
+}
 
-    private static readonly CONNECTION_TIMEOUT = 60000 // 1 minute timeout
+export class RedisConnection {
+    private static pools: Map<string, LanePool> = new Map()
+
+    private static readonly CONNECTION_TIMEOUT = 60000 // 1 minute idle timeout
+    private static readonly POOL_SIZES: Record<ConnectionLane, number> = {
+        interactive: readPoolSize("REDIS_POOL_SIZE", 4),
+        bulk: readPoolSize("REDIS_BULK_POOL_SIZE", 2),
+    }
+    private static readonly ACQUIRE_TIMEOUT = readPoolSize(
+        "REDIS_POOL_ACQUIRE_TIMEOUT_MS",
+        30000
+    )
     private static cleanupInterval: NodeJS.Timeout | null = null
 
-    private static async getClient(url: string): Promise<RedisClient> {
-        // Check if we have an existing connection
-        const existingConnection = this.connectionPool.get(url)
-
-        if (existingConnection) {
-            // If connection exists and is connecting, wait for it
-            if (existingConnection.isConnecting) {
-                let attempts = 0
-                while (existingConnection.isConnecting && attempts < 10) {
-                    await new Promise((resolve) => setTimeout(resolve, 100))
-                    attempts++
-                }
-            }
+    // Cluster layout per seed URL; null once the server is known to be standalone
+    private static topologies: Map<
+        string,
+        { topology: ClusterTopology | null; expires: number; pending?: Promise<ClusterTopology | null> }
+    > = new Map()
+    private static readonly TOPOLOGY_TTL = 30000
 
-            // Update last used timestamp
-            existingConnection.lastUsed = Date.now()
+    // What each node's vector set commands accept, probed once per node URL
+    // and dropped with the node's last pooled connection
+    private static capabilities: Map<string, RedisCapabilities | Promise<RedisCapabilities>> = new Map()
+    // Nodes whose probe failed (read-only replica, missing ACLs) keep the assumed
+    // capabilities until this time instead of being probed on every request
+    private static probeRetryAt: Map<string, number> = new Map()
+    private static readonly PROBE_RETRY_MS = 60000
 
-            // Check if connection is still valid
-            try {
-                if (existingConnection.client.isOpen) {
-                    return existingConnection.client
-                }
-            } catch (error) {
-                console.warn("[RedisConnection] Error checking connection status:", error)
+    private static poolKey(url: string, lane: ConnectionLane): string {
+        return `${lane}|${url}`
+    }
+
+    private static getPool(url: string, lane: ConnectionLane): LanePool {
+        const key = this.poolKey(url, lane)
+        let pool = this.pools.get(key)
+        if (!pool) {
+            pool = {
+                connections: [],
+                waiters: [],
+                connecting: null,
+                maxSize: this.POOL_SIZES[lane],
+                acquires: 0,
+                totalWaitMs: 0,
+                maxWaitMs: 0,
             }
+            this.pools.set(key, pool)
         }
+        return pool
+    }
 
-        // Create a new connection
-        const connectionInfo = {
-            client: null as unknown as RedisClient,
-            lastUsed: Date.now(),
-            isConnecting: true,
-        }
+    private static async createConnection(url: string): Promise<RedisClient> {
+        const client = createClient({
+            url,
+            socket: {
+                connectTimeout: 5000,
+            },
+        })
 
-        this.connectionPool.set(url, connectionInfo)
+        // Log only: throwing here would surface as an uncaught exception.
+        // Broken clients are dropped from the pool when they are next released or acquired
+        client.on("error", (err) => {
+            console.error("[RedisConnection] Redis Client Error:", err)
+        })
 
         try {
-            const client = createClient({
-                url,
-                socket: {
-                    connectTimeout: 5000,
-                },
-            })
+            await client.connect()
+        } catch (error) {
+            client.disconnect().catch(() => {})
+            throw toConnectionError(error)
+        }
+
+        return client as RedisClient
+    }
 
-            client.on("error", (err) => {
-                console.error("Redis Client Error:", err)
-                // If this is an authentication error, make it clear in the error message
-                if (err.message.includes("NOAUTH") || err.message.includes("AUTH")) {
-                    throw new Error("Authentication failed: Please check your Redis password")
+    // Opens one more connection for the lane and hands it to the longest waiter
+    private static grow(url: string, pool: LanePool): void {
+        let connected = false
+        const connectStart = performance.now()
+        pool.connecting = this.createConnection(url)
+            .then((client) => {
+                connected = true
+                const connection: PooledClient = {
+                    client,
+                    leased: false,
+                    lastUsed: Date.now(),
+                    connectMs: performance.now() - connectStart,
                 }
+                pool.connections.push(connection)
+                this.ensureCleanupInterval()
+                this.release(url, pool, connection)
             })
-            
-            await client.connect()
+            .catch((error) => {
+                console.error("[RedisConnection] Failed to open connection:", error)
+                // With nothing to fall back on, everyone queued would hit the same
+                // failure, so fail them together. Otherwise they wait for a release
+                if (pool.connections.length === 0) {
+                    pool.waiters.splice(0).forEach((waiter) => {
+                        clearTimeout(waiter.timer)
+                        waiter.reject(error)
+                    })
+                }
+            })
+            .finally(() => {
+                pool.connecting = null
+                // Waiters that arrived during the connect may still need capacity
+                if (
+                    connected &&
+                    pool.waiters.length > 0 &&
+                    pool.connections.length < pool.maxSize
+                ) {
+                    this.grow(url, pool)
+                }
+            })
+    }
 
-            connectionInfo.client = client as RedisClient
-            connectionInfo.isConnecting = false
+    private static async acquire(
+        url: string,
+        lane: ConnectionLane
+    ): Promise<{ connection: PooledClient; waitMs: number; connectMs: number }> {
+        const pool = this.getPool(url, lane)
+        const startTime = performance.now()
 
-            // Start cleanup interval if not already running
-            if (!this.cleanupInterval) {
-                this.cleanupInterval = setInterval(
-                    () => this.cleanupConnections(),
-                    this.CONNECTION_TIMEOUT
-                )
+        const connection = await new Promise<PooledClient>((resolve, reject) => {
+            // Drop connections that died while idle
+            pool.connections = pool.connections.filter(
+                (connection) => connection.leased || connection.client.isOpen
+            )
+
+            const idle = pool.connections.find((connection) => !connection.leased)
+            if (idle) {
+                idle.leased = true
+                resolve(idle)
+                return
             }
 
-            return client as RedisClient
-        } catch (error) {
-            connectionInfo.isConnecting = false
-            this.connectionPool.delete(url)
-            // Enhance error message for authentication errors
-            if (error instanceof Error) {
-                if (error.message.includes("NOAUTH") || error.message.includes("AUTH")) {
-                    throw new Error("Authentication failed: Please check your Redis password")
-                }
+            const timer = setTimeout(() => {
+                pool.waiters = pool.waiters.filter((waiter) => waiter.timer !== timer)
+                reject(new Error(`Timed out waiting for a Redis connection (${lane})`))
+            }, this.ACQUIRE_TIMEOUT)
+
+            pool.waiters.push({ resolve, reject, timer })
+
+            if (!pool.connecting && pool.connections.length < pool.maxSize) {
+                this.grow(url, pool)
+            }
+        })
+
+        const waitMs = performance.now() - startTime
+        pool.acquires++
+        pool.totalWaitMs += waitMs
+        pool.maxWaitMs = Math.max(pool.maxWaitMs, waitMs)
+
+        const connectMs = Math.min(waitMs, connection.connectMs ?? 0)
+        connection.connectMs = undefined
+
+        return { connection, waitMs: waitMs - connectMs, connectMs }
+    }
+
+    private static release(url: string, pool: LanePool, connection: PooledClient): void {
+        connection.leased = false
+        connection.lastUsed = Date.now()
+
+        if (!connection.client.isOpen) {
+            pool.connections = pool.connections.filter((c) => c !== connection)
+            if (pool.waiters.length > 0 && !pool.connecting) {
+                this.grow(url, pool)
             }
-            throw error
+            return
+        }
+
+        const waiter = pool.waiters.shift()
+        if (waiter) {
+            clearTimeout(waiter.timer)
+            connection.leased = true
+            waiter.resolve(connection)
+        }
+    }
+
+    private static ensureCleanupInterval(): void {
+        if (!this.cleanupInterval) {
+            this.cleanupInterval = setInterval(
+                () => this.cleanupConnections(),
+                this.CONNECTION_TIMEOUT
+            )
         }
     }
 
     private static async cleanupConnections() {
         const now = Date.now()
-        const expiredUrls: string[] = []
 
-        // Find expired connections
-        Array.from(this.connectionPool.entries()).forEach(([url, connection]) => {
-            if (now - connection.lastUsed > this.CONNECTION_TIMEOUT) {
-                expiredUrls.push(url)
-            }
-        })
+        for (const [key, pool] of Array.from(this.pools.entries())) {
+            // Leased connections are never reaped, however long their command runs
+            const expired = pool.connections.filter(
+                (connection) =>
+                    !connection.leased &&
+                    now - connection.lastUsed > this.CONNECTION_TIMEOUT
+            )
+            pool.connections = pool.connections.filter(
+                (connection) => !expired.includes(connection)
+            )
 
-        // Close expired connections
-        for (const url of expiredUrls) {
-            const connection = this.connectionPool.get(url)
-            if (connection) {
+            for (const connection of expired) {
                 try {
                     await connection.client.quit()
                 } catch (error) {
                     console.error(
-                        `[RedisConnection] Error closing idle connection for ${url}:`,
+                        `[RedisConnection] Error closing idle connection for ${key}:`,
                         error
                     )
                 }
-                this.connectionPool.delete(url)
+            }
+
+            if (
+                pool.connections.length === 0 &&
+                pool.waiters.length === 0 &&
+                !pool.connecting
+            ) {
+                this.pools.delete(key)
+            }
+        }
+
+        // A node with no pooled connections is probed again when next used
+        for (const url of Array.from(this.capabilities.keys())) {
+            const lanes = Object.keys(this.POOL_SIZES) as ConnectionLane[]
+            if (!lanes.some((lane) => this.pools.has(this.poolKey(url, lane)))) {
+                this.capabilities.delete(url)
+                this.probeRetryAt.delete(url)
             }
         }
 
         // Clear interval if no more connections
-        if (this.connectionPool.size === 0 && this.cleanupInterval) {
+        if (this.pools.size === 0 && this.cleanupInterval) {
             clearInterval(this.cleanupInterval)
             this.cleanupInterval = null
         }
     }
 
+    /**
+     * The cluster layout behind a URL, from CLUSTER SLOTS, or null for a
+     * standalone server. Cached for TOPOLOGY_TTL and refreshed after a
+     * MOVED reply.
+     */
+    public static async getTopology(url: string): Promise<ClusterTopology | null> {
+        const cached = this.topologies.get(url)
+        if (cached?.pending) return cached.pending
+        if (cached && cached.expires > Date.now()) return cached.topology
+
+        const pending = this.withClient(url, (client) => client.sendCommand(["CLUSTER", "SLOTS"]))
+            .then((response) => {
+                const topology = response.success ? parseClusterSlots(url, response.result) : null
+                const usable = topology && topology.primaries.length > 0 ? topology : null
+                // Standalone servers reply "ERR This instance has cluster support disabled";
+                // anything else (e.g. no connection) is not remembered
+                const known = response.success || /^(ERR|NOPERM)/.test(response.error || "")
+                this.topologies.set(url, {
+                    topology: usable,
+                    expires: known ? Date.now() + this.TOPOLOGY_TTL : 0,
+                })
+                return usable
+            })
+        this.topologies.set(url, { topology: cached?.topology ?? null, expires: 0, pending })
+        return pending
+    }
+
+    // URL of the node serving `key`: its primary on a cluster, else `url` itself
+    public static async urlForKey(url: string, key: string): Promise<string> {
+        const topology = await this.getTopology(url)
+        return (topology && primaryForKey(topology, key)?.url) || url
+    }
+
+    /**
+     * Capabilities of the node serving `key` (or of `url` itself), cached
+     * with that node's connections. The node is probed only when a caller
+     * passes `probe` (connecting, or about to write); until then reads get
+     * ASSUMED_CAPABILITIES. A failed probe caches that fallback for
+     * PROBE_RETRY_MS, so a read-only or restricted node is not probed with
+     * every write.
+     */
+    public static async getCapabilities(
+        url: string,
+        key?: string,
+        options: CapabilityOptions = {}
+    ): Promise<RedisCapabilities> {
+        const target = key === undefined ? url : await this.urlForKey(url, key)
+        const cached = this.capabilities.get(target)
+        if (cached) {
+            // Unprobed entries (a failed probe, or corrections made by
+            // markUnsupported) are probed again once the retry time has passed
+            const known = await cached
+            if (known.probed || !options.probe || Date.now() < (this.probeRetryAt.get(target) ?? 0)) {
+                return known
+            }
+        } else if (!options.probe) {
+            return ASSUMED_CAPABILITIES
+        }
+
+        const pending = (async () => {
+            const topology = await this.getTopology(url)
+            const probeKey = capabilityProbeKey(topology, target)
+            const response = await this.runOnNode(
+                target,
+                (client) => probeCapabilities(client, probeKey),
+                "interactive"
+            )
+            if (!response.success || !response.result) {
+                console.warn(`[RedisConnection] Capability probe failed on ${nodeLabel(target)}:`, response.error)
+                this.capabilities.set(target, ASSUMED_CAPABILITIES)
+                this.probeRetryAt.set(target, Date.now() + this.PROBE_RETRY_MS)
+                return ASSUMED_CAPABILITIES
+            }
+            console.log(`[RedisConnection] Capabilities of ${nodeLabel(target)}:`, response.result)
+            this.capabilities.set(target, response.result)
+            this.probeRetryAt.delete(target)
+            return response.result
+        })()
+        this.capabilities.set(target, pending)
+        return pending
+    }
+
+    // Records that a node rejected an option its (assumed) capabilities allowed
+    public static async markUnsupported(url: string, key: string | undefined, capability: CapabilityName): Promise<void> {
+        const target = key === undefined ? url : await this.urlForKey(url, key)
+        const current = await this.getCapabilities(url, key)
+        this.capabilities.set(target, { ...current, [capability]: false })
+    }
+
     public static async withClient<T>(
         url: string,
-        operation: (client: RedisClient) => Promise<T>
+        operation: (client: RedisClient) => Promise<T>,
+        options: WithClientOptions = {}
+    ): Promise<RedisOperationResult<T>> {
+        const lane = options.lane ?? "interactive"
+        if (options.key === undefined) {
+            return this.runOnNode(url, operation, lane)
+        }
+
+        const target = await this.urlForKey(url, options.key)
+        const result = await this.runOnNode(target, operation, lane)
+
+        // A MOVED reply means slots were resharded since the layout was read
+        const redirect = !result.success && result.error ? parseRedirect(result.error) : null
+        if (redirect) {
+            this.topologies.delete(url)
+            return this.runOnNode(nodeUrl(url, redirect.host, redirect.port), operation, lane)
+        }
+        return result
+    }
+
+    /**
+     * Runs `operation` on every primary of a cluster in parallel, or once on
+     * a standalone server. Each node's outcome and timing is reported
+     * separately, so one failing shard does not hide the others.
+     */
+    public static async withEachPrimary<T>(
+        url: string,
+        operation: (client: RedisClient) => Promise<T>,
+        options: WithClientOptions = {}
+    ): Promise<NodeOperationResult<T>[]> {
+        const lane = options.lane ?? "interactive"
+        const topology = await this.getTopology(url)
+        const urls = topology ? topology.primaries.map((node) => node.url) : [url]
+        return Promise.all(
+            urls.map(async (primaryUrl) => ({
+                ...(await this.runOnNode(primaryUrl, operation, lane)),
+                node: nodeLabel(primaryUrl),
+            }))
+        )
+    }
+
+    /**
+     * Runs `operation` with `count` connections of its own, opened outside
+     * the pools and closed afterwards. For measurements that need several
+     * independent sockets at once (the benchmark times each request on the
+     * connection that sent it), which a pooled lease could not provide
+     * without starving other traffic.
+     */
+    public static async withDedicatedClients<T>(
+        url: string,
+        count: number,
+        operation: (clients: RedisClient[]) => Promise<T>,
+        options: Pick<WithClientOptions, "key"> = {}
     ): Promise<RedisOperationResult<T>> {
+        const target = options.key === undefined ? url : await this.urlForKey(url, options.key)
+        const opened = await Promise.allSettled(
+            Array.from({ length: count }, () => this.createConnection(target))
+        )
+        const clients = opened.flatMap((outcome) => (outcome.status === "fulfilled" ? [outcome.value] : []))
+
         try {
+            const failed = opened.find((outcome): outcome is PromiseRejectedResult => outcome.status === "rejected")
+            if (failed) {
+                throw toConnectionError(failed.reason)
+            }
+
             const startTime = performance.now()
-            const client = await RedisConnection.getClient(url)
-            const result = await operation(client)
+            const result = await operation(clients)
+            return {
+                success: true,
+                result,
+                executionTimeMs: performance.now() - startTime,
+            }
+        } catch (error) {
+            console.error("[RedisConnection] Operation on dedicated connections failed:", error)
+            return {
+                success: false,
+                error: error instanceof Error ? error.message : String(error)
+            }
+        } finally {
+            await Promise.all(
+                clients.map((client) => client.quit().catch(() => client.disconnect().catch(() => {})))
+            )
+        }
+    }
+
+    private static async runOnNode<T>(
+        url: string,
+        operation: (client: RedisClient) => Promise<T>,
+        lane: ConnectionLane
+    ): Promise<RedisOperationResult<T>> {
+        let connection: PooledClient | null = null
+
+        try {
+            const lease = await RedisConnection.acquire(url, lane)
+            connection = lease.connection
+
+            // executionTimeMs covers only the operation, not pool wait or connect
+            const startTime = performance.now()
+            const result = await operation(connection.client)
             const endTime = performance.now()
 
             return {
                 success: true,
                 result,
-                executionTimeMs: endTime - startTime
+                executionTimeMs: endTime - startTime,
+                timings: {
+                    queueWaitMs: lease.waitMs,
+                    connectMs: lease.connectMs,
+                    redisMs: endTime - startTime,
+                },
             }
         } catch (error) {
             console.error("[RedisConnection] Operation failed:", error)
@@ -165,29 +561,74 @@ export class RedisConnection {
                 success: false,
                 error: error instanceof Error ? error.message : String(error)
             }
+        } finally {
+            if (connection) {
+                RedisConnection.release(url, RedisConnection.getPool(url, lane), connection)
+            }
         }
     }
 
+    // Per-URL, per-lane pool usage. Credentials are stripped from the URL
+    public static getPoolStats(): PoolStats[] {
+        return Array.from(this.pools.entries()).map(([key, pool]) => {
+            const separator = key.indexOf("|")
+            const lane = key.slice(0, separator) as ConnectionLane
+            const url = key.slice(separator + 1)
+
+            let safeUrl = url
+            try {
+                const parsed = new URL(url)
+                parsed.username = ""
+                parsed.password = ""
+                safeUrl = parsed.toString()
+            } catch (_error) {
+                // Leave unparseable URLs as they are
+            }
+
+            const active = pool.connections.filter((c) => c.leased).length
+            return {
+                url: safeUrl,
+                lane,
+                size: pool.connections.length,
+                active,
+                idle: pool.connections.length - active,
+                waiting: pool.waiters.length,
+                acquires: pool.acquires,
+                avgWaitMs: pool.acquires > 0 ? pool.totalWaitMs / pool.acquires : 0,
+                maxWaitMs: pool.maxWaitMs,
+            }
+        })
+    }
+
     // Add a method to explicitly close all connections (useful for cleanup)
     public static async closeAllConnections(): Promise<void> {
+        const pools = Array.from(this.pools.entries())
+        this.pools.clear()
+
         await Promise.all(
-            Array.from(this.connectionPool.entries()).map(async ([url, connection]) => {
-                try {
-                    await connection.client.quit()
-                } catch (error) {
-                    console.error(
-                        `[RedisConnection] Error closing connection for ${url}:`,
-                        error
-                    )
-                }
+            pools.flatMap(([key, pool]) => {
+                pool.waiters.splice(0).forEach((waiter) => {
+                    clearTimeout(waiter.timer)
+                    waiter.reject(new Error("Redis connections are closing"))
+                })
+
+                return pool.connections.map(async (connection) => {
+                    try {
+                        await connection.client.quit()
+                    } catch (error) {
+                        console.error(
+                            `[RedisConnection] Error closing connection for ${key}:`,
+                            error
+                        )
+                    }
+                })
             })
         )
 
-        this.connectionPool.clear()
-
         if (this.cleanupInterval) {
             clearInterval(this.cleanupInterval)
             this.cleanupInterval = null
         }
+        this.topologies.clear()
     }
-} 
\ No newline at end of file
+}
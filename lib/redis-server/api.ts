@@ -1,8 +1,16 @@
 import { apiClient } from "@/app/api/client"
 import { ApiResponse } from "@/app/api/client"
+import { VectorEncoding } from "@/lib/redis-server/vectorFrame"
 
 // Common vector types
-export type VectorTuple = [string, number, number[] | null, string | null] // [element, score, vector?, attributes?]
+// Embeddings arrive as number[] from JSON responses and as Float32Array with vectorEncoding: "binary"
+export type EmbeddingVector = number[] | Float32Array
+export type VectorTuple = [string, number, EmbeddingVector | null, string | null] // [element, score, vector?, attributes?]
+
+// True for a non-empty embedding in either representation
+export function hasEmbedding(vector: unknown): vector is EmbeddingVector {
+    return (Array.isArray(vector) || vector instanceof Float32Array) && vector.length > 0
+}
 export type VectorTupleLevel = VectorTuple[]
 export type VectorTupleLevels = VectorTupleLevel[]
 
@@ -115,19 +123,57 @@ export async function vrem(
     }
 }
 
+// Most elements one *_multi request may carry; bulk edit jobs handle more
+export const MULTI_ELEMENT_LIMIT = 10000
+
+// VREM_MULTI command: pipelined VREMs, reported per element
+export interface VremMultiRequestBody {
+    keyName: string
+    elements: string[]
+    returnCommandOnly?: boolean
+}
+
+export interface VremMultiResult {
+    totalElements: number
+    successfulRemovals: number
+    results: { element: string; removed: boolean; error?: string }[]
+}
+
+export async function vrem_multi(
+    request: VremMultiRequestBody
+): Promise<ApiResponse<VremMultiResult>> {
+    try {
+        return await apiClient.post<VremMultiResult, VremMultiRequestBody>(
+            "/api/redis/command/vrem_multi",
+            request
+        )
+    } catch (error) {
+        return { success: false, error: String(error) }
+    }
+}
+
 // VEMB command
 export interface VembRequestBody {
     keyName: string
     element: string
+    vectorEncoding?: VectorEncoding
     returnCommandOnly?: boolean
 }
 
-export type VembResult = number[]
+export type VembResult = EmbeddingVector
 
 export async function vemb(
     request: VembRequestBody
 ): Promise<ApiResponse<VembResult>> {
     try {
+        if (request.vectorEncoding === "binary" && !request.returnCommandOnly) {
+            const { vectors, ...response } = await apiClient.postVectorFrame<null, VembRequestBody>(
+                "/api/redis/command/vemb",
+                request
+            )
+            return { ...response, result: vectors[0] ?? undefined }
+        }
+
         return await apiClient.post<VembResult, VembRequestBody>(
             "/api/redis/command/vemb",
             request
@@ -147,6 +193,7 @@ export interface VaddRequestBody {
     useCAS?: boolean
     ef?: number
     quantization?: string
+    vectorFormat?: 'FP32' | 'VALUES' // How the server sends the vector to Redis (default FP32)
     returnCommandOnly?: boolean
 }
 
@@ -170,21 +217,58 @@ export interface VaddMultiRequestBody {
     keyName: string
     elements: string[]
     vectors: number[][]
+    // Alternative to vectors: base64 of every vector as concatenated FP32 little-endian values
+    vectorsFp32?: string
+    dimensions?: number
     attributes?: Record<string, string | boolean | number>[]
     reduceDimensions?: number
     useCAS?: boolean
     ef?: number
+    vectorFormat?: 'FP32' | 'VALUES'
 }
 
 export type VaddMultiResult = boolean[]
 
+// Packs equal-length vectors into one base64 FP32 blob for the request body
+function vectorsToFp32Base64(vectors: number[][], dimensions: number): string {
+    const view = new DataView(new ArrayBuffer(vectors.length * dimensions * 4))
+    vectors.forEach((vector, v) => {
+        for (let i = 0; i < dimensions; i++) {
+            view.setFloat32((v * dimensions + i) * 4, vector[i], true)
+        }
+    })
+
+    const bytes = new Uint8Array(view.buffer)
+    let binary = ""
+    // Convert in slices to stay under argument limits of String.fromCharCode
+    for (let i = 0; i < bytes.length; i += 0x8000) {
+        binary += String.fromCharCode(...bytes.subarray(i, i + 0x8000))
+    }
+    return btoa(binary)
+}
+
 export async function vadd_multi(
     request: VaddMultiRequestBody
 ): Promise<ApiResponse<VaddMultiResult>> {
     try {
+        // Ship vectors as a binary blob rather than number[] JSON when they share a dimension
+        const dimensions = request.vectors[0]?.length
+        const body =
+            !request.vectorsFp32 &&
+            request.vectorFormat !== 'VALUES' &&
+            dimensions &&
+            request.vectors.every((vector) => vector.length === dimensions)
+                ? {
+                    ...request,
+                    vectors: [],
+                    vectorsFp32: vectorsToFp32Base64(request.vectors, dimensions),
+                    dimensions,
+                }
+                : request
+
         return await apiClient.post<VaddMultiResult, VaddMultiRequestBody>(
             "/api/redis/command/vadd_multi",
-            request
+            body
         )
     } catch (error) {
         return { success: false, error: String(error) }
@@ -214,8 +298,55 @@ export async function vlinks(
     }
 }
 
+// VLINKS_MULTI command
+export interface VlinksMultiRequestBody {
+    keyName: string
+    elements: string[] // Frontier to expand
+    depth?: number // Rings to walk out from the frontier (default 1)
+    count?: number // Neighbours kept per element, highest score first
+    withEmbeddings?: boolean
+    knownElements?: string[] // Elements the caller already has vectors for; their embeddings are skipped
+    vectorEncoding?: VectorEncoding
+    returnCommandOnly?: boolean
+}
+
+export interface VlinksMultiResult {
+    // Neighbours of every expanded element, deduplicated across HNSW levels
+    links: Record<string, [string, number][]>
+    // Embeddings of the elements discovered, when withEmbeddings is set
+    embeddings: [string, EmbeddingVector | null][]
+}
+
+export async function vlinks_multi(
+    request: VlinksMultiRequestBody
+): Promise<ApiResponse<VlinksMultiResult>> {
+    try {
+        if (request.vectorEncoding === "binary" && request.withEmbeddings && !request.returnCommandOnly) {
+            const { vectors, ...response } = await apiClient.postVectorFrame<VlinksMultiResult, VlinksMultiRequestBody>(
+                "/api/redis/command/vlinks_multi",
+                request
+            )
+            if (!response.result) return response
+            return {
+                ...response,
+                result: {
+                    ...response.result,
+                    embeddings: response.result.embeddings.map(([element], index) => [element, vectors[index]]),
+                },
+            }
+        }
+
+        return await apiClient.post<VlinksMultiResult, VlinksMultiRequestBody>(
+            "/api/redis/command/vlinks_multi",
+            request
+        )
+    } catch (error) {
+        return { success: false, error: String(error) }
+    }
+}
+
 // VSIM command
-export type VsimResult = [string, number, number[] | null, string | null][] // Keep the existing tuple type
+export type VsimResult = [string, number, EmbeddingVector | null, string | null][] // Keep the existing tuple type
 
 export interface VsimRequestBody {
     keyName: string
@@ -231,12 +362,28 @@ export interface VsimRequestBody {
     forceLinearScan?: boolean
     noThread?: boolean
     vectorFormat?: 'FP32' | 'VALUES' // New field for vector format selection
+    vectorEncoding?: VectorEncoding // How withEmbeddings vectors come back to the browser
 }
 
 export async function vsim(
     request: VsimRequestBody
 ): Promise<ApiResponse<VsimResult>> {
     try {
+        if (request.vectorEncoding === "binary" && request.withEmbeddings && !request.returnCommandOnly) {
+            const { vectors, ...response } = await apiClient.postVectorFrame<VsimResult, VsimRequestBody>(
+                "/api/redis/command/vsim",
+                request
+            )
+            return {
+                ...response,
+                result: response.result?.map((tuple, index) => {
+                    const withVector = [...tuple] as VsimResult[number]
+                    withVector[2] = vectors[index]
+                    return withVector
+                }),
+            }
+        }
+
         return await apiClient.post<VsimResult, VsimRequestBody>(
             "/api/redis/command/vsim",
             request
@@ -250,6 +397,34 @@ export async function vsim(
     }
 }
 
+// VSIM over every shard of a logical set (see lib/server/shards.ts)
+export type VsimFanoutRequestBody = Omit<VsimRequestBody, "keyName" | "returnCommandOnly" | "withEmbeddings"> & {
+    keys?: string[] // Shard keys; found from keyName (name{*}) when omitted
+    keyName?: string
+}
+
+export interface VsimFanoutResult {
+    results: [string, number, string, string | null][] // [element, score, shard key, attributes?]
+    shards: { key: string; node: string; results: number; executionTimeMs?: number; error?: string }[]
+}
+
+export async function vsim_fanout(
+    request: VsimFanoutRequestBody
+): Promise<ApiResponse<VsimFanoutResult>> {
+    try {
+        return await apiClient.post<VsimFanoutResult, VsimFanoutRequestBody>(
+            "/api/redis/command/vsim_fanout",
+            request
+        )
+    } catch (error) {
+        console.error("Error in vsim_fanout:", error)
+        return {
+            success: false,
+            error: String(error),
+        }
+    }
+}
+
 // VRANDMEMBER command
 export interface VrandMemberRequestBody {
     keyName: string
@@ -294,6 +469,32 @@ export async function vsetattr(
     }
 }
 
+// VSETATTR_MULTI command: pipelined VSETATTRs, reported per element
+export interface VsetAttrMultiRequestBody {
+    keyName: string
+    updates: { element: string; attributes: string }[] // JSON strings; "" clears
+    returnCommandOnly?: boolean
+}
+
+export interface VsetAttrMultiResult {
+    totalElements: number
+    successfulUpdates: number
+    results: { element: string; updated: boolean; error?: string }[]
+}
+
+export async function vsetattr_multi(
+    request: VsetAttrMultiRequestBody
+): Promise<ApiResponse<VsetAttrMultiResult>> {
+    try {
+        return await apiClient.post<VsetAttrMultiResult, VsetAttrMultiRequestBody>(
+            "/api/redis/command/vsetattr_multi",
+            request
+        )
+    } catch (error) {
+        return { success: false, error: String(error) }
+    }
+}
+
 // VGETATTR command
 export interface VgetAttrRequestBody {
     keyName: string
@@ -346,15 +547,24 @@ export async function vgetattr_multi(
 export interface VembMultiRequestBody {
     keyName: string
     elements: string[]
+    vectorEncoding?: VectorEncoding
     returnCommandOnly?: boolean
 }
 
-export type VembMultiResult = number[][]
+export type VembMultiResult = (EmbeddingVector | null)[]
 
 export async function vemb_multi(
     request: VembMultiRequestBody
 ): Promise<ApiResponse<VembMultiResult>> {
     try {
+        if (request.vectorEncoding === "binary" && !request.returnCommandOnly) {
+            const { vectors, ...response } = await apiClient.postVectorFrame<null[], VembMultiRequestBody>(
+                "/api/redis/command/vemb_multi",
+                request
+            )
+            return { ...response, result: vectors }
+        }
+
         return await apiClient.post<VembMultiResult, VembMultiRequestBody>(
             "/api/redis/command/vemb_multi",
             request
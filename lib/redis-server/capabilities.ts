@@ -0,0 +1,143 @@
+/*
+ * What the vector set commands of a server accept. Probed once per node
+ * (RedisConnection.getCapabilities) so command builders can pick the
+ * cheapest form up front instead of trying an option and re-running the
+ * command without it.
+ */
+
+import type { RedisClient } from "./RedisConnection"
+import { ClusterTopology, keySlot } from "./cluster"
+import { vectorToFp32Buffer } from "./utils"
+
+export interface RedisCapabilities {
+    redisVersion: string | null
+    vectorSetVersion: number | null // "ver" of the vectorset module in MODULE LIST
+    vectorSets: boolean // VADD exists at all
+    fp32: boolean // VADD/VSIM ... FP32 <blob>; VALUES otherwise
+    withAttribs: boolean // VSIM ... WITHATTRIBS
+    filterEf: boolean // VSIM ... FILTER-EF
+    vembRaw: boolean // VEMB ... RAW
+    vrange: boolean // VRANGE (Redis 8.2+)
+    probed: boolean // False when the probe could not run and these are assumed
+}
+
+export type CapabilityName = "fp32" | "withAttribs" | "filterEf" | "vembRaw" | "vrange"
+
+// Used until a probe succeeds, e.g. on a read-only replica or without write ACLs.
+// VSIM still corrects WITHATTRIBS the first time the server rejects it
+export const ASSUMED_CAPABILITIES: RedisCapabilities = {
+    redisVersion: null,
+    vectorSetVersion: null,
+    vectorSets: true,
+    fp32: true,
+    withAttribs: true,
+    filterEf: true,
+    vembRaw: true,
+    vrange: false,
+    probed: false,
+}
+
+// Probe sets are created under this prefix, expire on their own and are
+// hidden from the vector set list
+export const CAPABILITY_PROBE_PREFIX = "vector-set-browser:probe:"
+
+/**
+ * A probe key on the node at `nodeUrl`: on a cluster, its hash tag is
+ * chosen so the key's slot belongs to that node.
+ */
+export function capabilityProbeKey(topology: ClusterTopology | null, nodeUrl: string): string {
+    const suffix = `${process.pid}-${Math.random().toString(36).slice(2, 10)}`
+    if (!topology) {
+        return `${CAPABILITY_PROBE_PREFIX}${suffix}`
+    }
+    const owner = topology.primaries.findIndex((node) => node.url === nodeUrl)
+    for (let tag = 0; owner >= 0 && tag < 100000; tag++) {
+        if (topology.slotOwners[keySlot(`{${tag}}`)] === owner) {
+            return `${CAPABILITY_PROBE_PREFIX}{${tag}}:${suffix}`
+        }
+    }
+    return `${CAPABILITY_PROBE_PREFIX}${suffix}`
+}
+
+// True for replies that mean the server does not know an option or command
+export function isUnsupportedError(error: unknown): boolean {
+    const message = error instanceof Error ? error.message : String(error ?? "")
+    return /syntax error|wrong number of arguments|unknown (command|option|argument)|unrecognized|invalid option/i.test(message)
+}
+
+async function succeeds(attempt: Promise<unknown>): Promise<boolean> {
+    try {
+        await attempt
+        return true
+    } catch (error) {
+        if (!isUnsupportedError(error)) {
+            // Anything else (e.g. NOPERM) says nothing about support
+            throw error
+        }
+        return false
+    }
+}
+
+async function readVersions(client: RedisClient): Promise<Pick<RedisCapabilities, "redisVersion" | "vectorSetVersion">> {
+    let redisVersion: string | null = null
+    let vectorSetVersion: number | null = null
+    try {
+        const info = String(await client.sendCommand(["INFO", "server"]))
+        redisVersion = /redis_version:([^\r\n]+)/.exec(info)?.[1] ?? null
+    } catch (_error) {
+        // INFO may be denied by ACLs
+    }
+    try {
+        const modules = (await client.sendCommand(["MODULE", "LIST"])) as unknown[]
+        for (const entry of modules || []) {
+            if (!Array.isArray(entry)) continue
+            const fields: Record<string, unknown> = {}
+            for (let i = 0; i + 1 < entry.length; i += 2) {
+                fields[String(entry[i])] = entry[i + 1]
+            }
+            if (String(fields.name).toLowerCase() === "vectorset") {
+                vectorSetVersion = Number(fields.ver)
+            }
+        }
+    } catch (_error) {
+        // MODULE LIST may be denied by ACLs
+    }
+    return { redisVersion, vectorSetVersion }
+}
+
+/**
+ * Builds a two-element set at `probeKey` and tries each optional form on
+ * it. The set gets a short TTL as soon as it exists, and is removed at
+ * the end. Throws when the probe cannot write, so the caller can fall back
+ * to ASSUMED_CAPABILITIES.
+ */
+export async function probeCapabilities(client: RedisClient, probeKey: string): Promise<RedisCapabilities> {
+    const versions = await readVersions(client)
+
+    let fp32 = true
+    try {
+        await client.sendCommand(["VADD", probeKey, "FP32", vectorToFp32Buffer([1, 0]), "a", "SETATTR", '{"p":1}'])
+    } catch (error) {
+        if (/unknown command/i.test(String(error))) {
+            return { ...versions, vectorSets: false, fp32: false, withAttribs: false, filterEf: false, vembRaw: false, vrange: false, probed: true }
+        }
+        if (!isUnsupportedError(error)) throw error
+        fp32 = false
+        await client.sendCommand(["VADD", probeKey, "VALUES", "2", "1", "0", "a", "SETATTR", '{"p":1}'])
+    }
+
+    try {
+        await client.sendCommand(["PEXPIRE", probeKey, "60000"])
+        await client.sendCommand(["VADD", probeKey, "VALUES", "2", "0", "1", "b"])
+
+        const [withAttribs, filterEf, vembRaw, vrange] = await Promise.all([
+            succeeds(client.sendCommand(["VSIM", probeKey, "ELE", "a", "WITHSCORES", "WITHATTRIBS", "COUNT", "1"])),
+            succeeds(client.sendCommand(["VSIM", probeKey, "ELE", "a", "FILTER", ".p == 1", "FILTER-EF", "10", "COUNT", "1"])),
+            succeeds(client.sendCommand(["VEMB", probeKey, "a", "RAW"])),
+            succeeds(client.sendCommand(["VRANGE", probeKey, "-", "+", "1"])),
+        ])
+        return { ...versions, vectorSets: true, fp32, withAttribs, filterEf, vembRaw, vrange, probed: true }
+    } finally {
+        await client.sendCommand(["DEL", probeKey]).catch(() => {})
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Redis Cluster topology helpers: hash slots, CLUSTER SLOTS parsing and the
+ * URLs of a cluster's primaries. RedisConnection uses these to route keyed
+ * operations and to fan out across primaries; nothing here opens a socket.
+ */
+
+export const CLUSTER_SLOT_COUNT = 16384
+
+export interface ClusterNode {
+    id: string
+    host: string
+    port: number
+    url: string // Seed URL with this node's host and port, credentials kept
+    slots: [number, number][]
+}
+
+export interface ClusterTopology {
+    primaries: ClusterNode[]
+    // Owner of every slot, as an index into primaries (-1 when unassigned)
+    slotOwners: Int16Array
+}
+
+// CRC16/XMODEM, as used for Redis Cluster key slots
+const CRC16_TABLE = (() => {
+    const table = new Uint16Array(256)
+    for (let i = 0; i < 256; i++) {
+        let crc = i << 8
+        for (let bit = 0; bit < 8; bit++) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1
+        }
+        table[i] = crc & 0xffff
+    }
+    return table
+})()
+
+function crc16(bytes: Uint8Array): number {
+    let crc = 0
+    for (let i = 0; i < bytes.length; i++) {
+        crc = ((crc << 8) ^ CRC16_TABLE[((crc >> 8) ^ bytes[i]) & 0xff]) & 0xffff
+    }
+    return crc
+}
+
+const encoder = new TextEncoder()
+
+// Hash slot of a key, honouring {hash tags}
+export function keySlot(key: string): number {
+    const open = key.indexOf("{")
+    if (open !== -1) {
+        const close = key.indexOf("}", open + 1)
+        if (close > open + 1) {
+            key = key.slice(open + 1, close)
+        }
+    }
+    return crc16(encoder.encode(key)) % CLUSTER_SLOT_COUNT
+}
+
+// The seed URL pointed at another node, keeping scheme, credentials and options
+export function nodeUrl(seedUrl: string, host: string, port: number): string {
+    const url = new URL(seedUrl)
+    if (host) {
+        url.hostname = host.includes(":") ? `[${host}]` : host
+    }
+    url.port = String(port)
+    return url.toString()
+}
+
+// host:port of a URL, for logs and responses
+export function nodeLabel(url: string): string {
+    try {
+        const parsed = new URL(url)
+        return `${parsed.hostname}:${parsed.port || "6379"}`
+    } catch (_error) {
+        return url
+    }
+}
+
+/**
+ * Builds the topology from a CLUSTER SLOTS reply:
+ * [[start, end, [host, port, id, ...], ...replicas], ...].
+ * An empty host means the node is reachable at the seed's host.
+ */
+export function parseClusterSlots(seedUrl: string, reply: unknown): ClusterTopology {
+    const primaries: ClusterNode[] = []
+    const byAddress = new Map<string, number>()
+    const slotOwners = new Int16Array(CLUSTER_SLOT_COUNT).fill(-1)
+
+    for (const range of Array.isArray(reply) ? reply : []) {
+        if (!Array.isArray(range) || !Array.isArray(range[2])) continue
+        const start = Number(range[0])
+        const end = Number(range[1])
+        const [rawHost, rawPort, rawId] = range[2]
+        const host = rawHost ? String(rawHost) : ""
+        const port = Number(rawPort)
+        const address = `${host}:${port}`
+
+        let index = byAddress.get(address)
+        if (index === undefined) {
+            index = primaries.length
+            byAddress.set(address, index)
+            primaries.push({
+                id: rawId ? String(rawId) : address,
+                host: host || new URL(seedUrl).hostname,
+                port,
+                url: nodeUrl(seedUrl, host, port),
+                slots: [],
+            })
+        }
+        primaries[index].slots.push([start, end])
+        slotOwners.fill(index, start, end + 1)
+    }
+
+    return { primaries, slotOwners }
+}
+
+export function primaryForKey(topology: ClusterTopology, key: string): ClusterNode | null {
+    const owner = topology.slotOwners[keySlot(key)]
+    return owner >= 0 ? topology.primaries[owner] : null
+}
+
+// "MOVED 3999 10.0.0.2:6381" -> { host, port }; also handles ASK
+export function parseRedirect(message: string): { host: string; port: number } | null {
+    const match = /^(?:MOVED|ASK) \d+ (.*):(\d+)$/.exec(message.trim())
+    return match ? { host: match[1], port: Number(match[2]) } : null
+}
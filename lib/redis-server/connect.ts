@@ -1,8 +1,11 @@
+import type { RedisCapabilities } from "./capabilities"
+
 interface RedisResponse {
     success?: boolean
     error?: string
     message?: string
     url?: string
+    capabilities?: RedisCapabilities // Returned by connect
 }
 
 export class RedisService {
@@ -1,5 +1,6 @@
 import { NextResponse } from 'next/server'
-import { RedisOperationResult } from './RedisConnection'
+import { RedisClient, RedisOperationResult } from './RedisConnection'
+import { createVectorFrameStream, VECTOR_FRAME_CONTENT_TYPE } from './vectorFrame'
 
 export interface ApiResponse<T = any> {
     success: boolean
@@ -48,6 +49,16 @@ export function formatResponse<T>(response: RedisOperationResult<T>): NextRespon
     })
 }
 
+// Successful response whose vectors travel as FP32 after the JSON header (see vectorFrame.ts)
+export function formatVectorFrameResponse<T>(
+    response: ApiResponse<T>,
+    vectors: (Float32Array | null)[]
+): NextResponse {
+    return new NextResponse(createVectorFrameStream(response, vectors), {
+        headers: { 'Content-Type': VECTOR_FRAME_CONTENT_TYPE }
+    })
+}
+
 export function handleError(error: unknown): NextResponse {
     console.error('Redis operation error:', error)
 
@@ -93,6 +104,38 @@ export function validateElement(element: string | undefined): boolean {
     return typeof element === 'string' && element.length > 0
 }
 
+// Decodes a base64 blob of concatenated FP32 little-endian vectors into one Buffer per vector
+export function fp32Base64ToBuffers(
+    data: string,
+    dimensions: number,
+    count: number
+): { isValid: boolean; error?: string; buffers?: Buffer[] } {
+    if (!Number.isInteger(dimensions) || dimensions <= 0) {
+        return { isValid: false, error: 'Dimensions must be a positive integer' }
+    }
+
+    const bytes = Buffer.from(data, 'base64')
+    const stride = dimensions * 4
+    if (bytes.length !== stride * count) {
+        return {
+            isValid: false,
+            error: `Vector data is ${bytes.length} bytes, expected ${stride * count} for ${count} vectors of ${dimensions} dimensions`,
+        }
+    }
+
+    const buffers: Buffer[] = []
+    for (let offset = 0; offset < bytes.length; offset += stride) {
+        for (let i = offset; i < offset + stride; i += 4) {
+            if (!isFinite(bytes.readFloatLE(i))) {
+                return { isValid: false, error: 'Vector must contain only finite numbers' }
+            }
+        }
+        buffers.push(bytes.subarray(offset, offset + stride))
+    }
+
+    return { isValid: true, buffers }
+}
+
 // Helper to encode an array of numbers into a Buffer of FP32 little-endian values
 export function vectorToFp32Buffer(vector: number[]): Buffer {
     const buffer = Buffer.allocUnsafe(vector.length * 4)
@@ -101,3 +144,51 @@ export function vectorToFp32Buffer(vector: number[]): Buffer {
     }
     return buffer
 }
+
+// Decodes FP32 little-endian values, e.g. a VEMB RAW blob or a staged embedding
+export function fp32BufferToVector(buffer: Buffer): number[] {
+    const vector = new Array<number>(buffer.length / 4)
+    for (let i = 0; i < vector.length; i++) {
+        vector[i] = buffer.readFloatLE(i * 4)
+    }
+    return vector
+}
+
+// VINFO replies field, value, field, value, ...; null for anything else (e.g. a missing key)
+export function parseVinfo(reply: unknown): Record<string, string | number> | null {
+    if (!Array.isArray(reply)) return null
+    const info: Record<string, string | number> = {}
+    for (let i = 0; i + 1 < reply.length; i += 2) {
+        const value = reply[i + 1]
+        info[String(reply[i])] = typeof value === "number" ? value : String(value)
+    }
+    return info
+}
+
+// Commands per round trip when a batch is pipelined instead of sent as one MULTI
+export const PIPELINE_CHUNK_SIZE = 500
+
+/**
+ * Sends commands in pipelined chunks. Unlike MULTI, a large batch does not
+ * hold the server for its whole length, and a failing command leaves its
+ * Error in the results without stopping the others.
+ */
+export async function sendPipelined(
+    client: RedisClient,
+    commands: (string | Buffer)[][],
+    chunkSize: number = PIPELINE_CHUNK_SIZE
+): Promise<unknown[]> {
+    const results: unknown[] = []
+    for (let start = 0; start < commands.length; start += chunkSize) {
+        const chunk = commands.slice(start, start + chunkSize)
+        const replies = await Promise.all(
+            chunk.map((command) =>
+                client
+                    .sendCommand(command)
+                    .catch((error: unknown) => (error instanceof Error ? error : new Error(String(error))))
+            )
+        )
+        results.push(...replies)
+    }
+    return results
+}
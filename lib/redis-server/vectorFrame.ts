@@ -0,0 +1,110 @@
+/*
+ * Binary response format for routes called with vectorEncoding: "binary".
+ *
+ *   [u32 header length][header JSON, UTF-8][zero padding to a 4 byte boundary]
+ *   [u32 vector count]
+ *   then per vector: [u32 dimensions, NULL_VECTOR for a missing vector][dimensions x FP32]
+ *
+ * All integers and floats are little-endian. The header is the usual
+ * ApiResponse with vector slots left null; the client fills them from the
+ * frame. Every float run starts on a 4 byte boundary so the client can view
+ * it as a Float32Array without copying.
+ */
+
+export const VECTOR_FRAME_CONTENT_TYPE = "application/x-vector-frame"
+
+const NULL_VECTOR = 0xffffffff
+
+export type VectorEncoding = "json" | "binary"
+
+function encodeUint32(value: number): Uint8Array {
+    const bytes = new Uint8Array(4)
+    new DataView(bytes.buffer).setUint32(0, value, true)
+    return bytes
+}
+
+function encodeVector(vector: Float32Array | null): Uint8Array {
+    if (!vector) {
+        return encodeUint32(NULL_VECTOR)
+    }
+
+    const bytes = new Uint8Array(4 + vector.length * 4)
+    const view = new DataView(bytes.buffer)
+    view.setUint32(0, vector.length, true)
+    for (let i = 0; i < vector.length; i++) {
+        view.setFloat32(4 + i * 4, vector[i], true)
+    }
+    return bytes
+}
+
+// Streams the header followed by one chunk per vector
+export function createVectorFrameStream(
+    header: unknown,
+    vectors: (Float32Array | null)[]
+): ReadableStream<Uint8Array> {
+    const json = new TextEncoder().encode(JSON.stringify(header))
+    const padding = (4 - (json.length % 4)) % 4
+
+    let index = -1
+    return new ReadableStream<Uint8Array>({
+        pull(controller) {
+            if (index === -1) {
+                const head = new Uint8Array(4 + json.length + padding + 4)
+                const view = new DataView(head.buffer)
+                view.setUint32(0, json.length, true)
+                head.set(json, 4)
+                view.setUint32(4 + json.length + padding, vectors.length, true)
+                controller.enqueue(head)
+            } else if (index < vectors.length) {
+                controller.enqueue(encodeVector(vectors[index]))
+            } else {
+                controller.close()
+            }
+            index++
+        },
+    })
+}
+
+const isLittleEndian =
+    new Uint8Array(new Uint16Array([1]).buffer)[0] === 1
+
+export function decodeVectorFrame<THeader>(buffer: ArrayBuffer): {
+    header: THeader
+    vectors: (Float32Array | null)[]
+} {
+    const view = new DataView(buffer)
+    const headerLength = view.getUint32(0, true)
+    const header = JSON.parse(
+        new TextDecoder().decode(new Uint8Array(buffer, 4, headerLength))
+    ) as THeader
+
+    let offset = 4 + headerLength
+    offset += (4 - (offset % 4)) % 4
+
+    const count = view.getUint32(offset, true)
+    offset += 4
+
+    const vectors: (Float32Array | null)[] = []
+    for (let v = 0; v < count; v++) {
+        const dimensions = view.getUint32(offset, true)
+        offset += 4
+
+        if (dimensions === NULL_VECTOR) {
+            vectors.push(null)
+            continue
+        }
+
+        if (isLittleEndian) {
+            vectors.push(new Float32Array(buffer, offset, dimensions))
+        } else {
+            const vector = new Float32Array(dimensions)
+            for (let i = 0; i < dimensions; i++) {
+                vector[i] = view.getFloat32(offset + i * 4, true)
+            }
+            vectors.push(vector)
+        }
+        offset += dimensions * 4
+    }
+
+    return { header, vectors }
+}
@@ -0,0 +1,410 @@
+import { randomUUID } from "crypto"
+import { buildVsimCommand } from "@/app/api/redis/command/vsim/command"
+import { RedisClient, RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { VsimRequestBody } from "@/lib/redis-server/api"
+import {
+    BENCHMARK_HISTORY_LENGTH,
+    BENCHMARK_MAX_COMBINATIONS,
+    BENCHMARK_MAX_CONCURRENCY,
+    BENCHMARK_MAX_QUERIES,
+    BenchmarkConfig,
+    BenchmarkResultRow,
+    BenchmarkRun,
+    getBenchmarkHistoryKey,
+    getBenchmarkRunKey,
+} from "@/lib/types/benchmark"
+
+// A run's live state is kept this long; finished runs also go to the history list
+const RUN_TTL_SECONDS = 24 * 60 * 60
+
+type Query = Pick<VsimRequestBody, "searchElement" | "searchVector">
+
+interface Combination {
+    ef: number
+    filterEf: number
+    count: number
+    threaded: boolean
+}
+
+function positiveIntegers(value: unknown, fallback: number[]): number[] | null {
+    if (value === undefined) return fallback
+    if (!Array.isArray(value) || value.length === 0) return null
+    const numbers = value.map(Number)
+    if (numbers.some((n) => !Number.isInteger(n) || n < 0)) return null
+    return Array.from(new Set(numbers))
+}
+
+export function validateBenchmarkConfig(body: any): { isValid: boolean; error?: string; value?: BenchmarkConfig } {
+    if (!body || typeof body.vectorSetName !== "string" || !body.vectorSetName) {
+        return { isValid: false, error: "vectorSetName is required" }
+    }
+
+    const queries = body.queries
+    if (queries?.type === "vectors") {
+        if (!Array.isArray(queries.vectors) || queries.vectors.length === 0) {
+            return { isValid: false, error: "Query vectors must be a non-empty array" }
+        }
+        if (queries.vectors.length > BENCHMARK_MAX_QUERIES) {
+            return { isValid: false, error: `At most ${BENCHMARK_MAX_QUERIES} query vectors are supported` }
+        }
+        const invalid = queries.vectors.some((vector: unknown) =>
+            !Array.isArray(vector) || vector.some((v) => typeof v !== "number" || !isFinite(v))
+        )
+        if (invalid) {
+            return { isValid: false, error: "Query vectors contain invalid values" }
+        }
+    } else if (queries?.type === "sample") {
+        const count = Number(queries.count)
+        if (!Number.isInteger(count) || count < 1 || count > BENCHMARK_MAX_QUERIES) {
+            return { isValid: false, error: `Sample size must be between 1 and ${BENCHMARK_MAX_QUERIES}` }
+        }
+    } else {
+        return { isValid: false, error: "queries must be a sample or a list of vectors" }
+    }
+
+    const ef = positiveIntegers(body.ef, [0])
+    const filterEf = positiveIntegers(body.filterEf, [0])
+    const count = positiveIntegers(body.count, [10])
+    if (!ef || !filterEf || !count || count.includes(0)) {
+        return { isValid: false, error: "ef, filterEf and count must be lists of non-negative integers (count > 0)" }
+    }
+    const threaded = Array.isArray(body.threaded) && body.threaded.length > 0
+        ? Array.from(new Set(body.threaded.map(Boolean))) as boolean[]
+        : [true]
+
+    const filter = typeof body.filter === "string" ? body.filter.trim() : ""
+    // FILTER-EF only changes anything when there is a filter
+    const combinations = ef.length * (filter ? filterEf.length : 1) * count.length * threaded.length
+    if (combinations > BENCHMARK_MAX_COMBINATIONS) {
+        return {
+            isValid: false,
+            error: `${combinations} combinations requested, at most ${BENCHMARK_MAX_COMBINATIONS} are supported`,
+        }
+    }
+
+    const concurrency = Number(body.concurrency ?? 1)
+    if (!Number.isInteger(concurrency) || concurrency < 1 || concurrency > BENCHMARK_MAX_CONCURRENCY) {
+        return { isValid: false, error: `Concurrency must be between 1 and ${BENCHMARK_MAX_CONCURRENCY}` }
+    }
+
+    return {
+        isValid: true,
+        value: {
+            vectorSetName: body.vectorSetName,
+            queries,
+            ef,
+            filterEf,
+            count,
+            threaded,
+            filter,
+            concurrency,
+            warmupRounds: Math.max(0, Math.min(5, Number(body.warmupRounds) || 0)),
+        },
+    }
+}
+
+function percentile(sorted: number[], p: number): number {
+    if (sorted.length === 0) return 0
+    const index = Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1)
+    return sorted[Math.max(0, index)]
+}
+
+// VSIM ... WITHSCORES replies element, score, element, score, ...
+function replyElements(reply: unknown): string[] {
+    if (!Array.isArray(reply)) return []
+    const elements: string[] = []
+    for (let i = 0; i < reply.length; i += 2) {
+        elements.push(String(reply[i]))
+    }
+    return elements
+}
+
+function recallAt(found: string[], truth: string[], k: number): number {
+    const expected = truth.slice(0, k)
+    if (expected.length === 0) return 1
+    const wanted = new Set(expected)
+    let hits = 0
+    for (const element of found.slice(0, k)) {
+        if (wanted.has(element)) hits++
+    }
+    return hits / expected.length
+}
+
+/**
+ * Runs one benchmark: samples (or takes) the query vectors, computes their
+ * exact top-k with TRUTH, then measures every combination of EF,
+ * FILTER-EF, COUNT and threading for recall, latency and throughput.
+ * Progress is written to the run's key after each combination.
+ */
+class BenchmarkRunner {
+    private readonly combinations: Combination[] = []
+    // One connection per concurrency lane, open for the whole run
+    private clients: RedisClient[] = []
+
+    constructor(
+        private readonly url: string,
+        private readonly config: BenchmarkConfig,
+        private readonly run: BenchmarkRun,
+        private readonly persist = true
+    ) {
+        for (const count of config.count) {
+            for (const ef of config.ef) {
+                for (const filterEf of config.filter ? config.filterEf : [0]) {
+                    for (const threaded of config.threaded) {
+                        this.combinations.push({ ef, filterEf, count, threaded })
+                    }
+                }
+            }
+        }
+        run.totalCombinations = this.combinations.length
+    }
+
+    async execute(): Promise<void> {
+        try {
+            const queries = await this.loadQueries()
+            this.run.config.queryCount = queries.length
+            if (queries.length === 0) {
+                throw new Error("Vector set has no elements to sample queries from")
+            }
+
+            // Opened before any timing starts and kept for every combination,
+            // so connect time never shows up in latency or throughput
+            const lanes = Math.min(this.config.concurrency, queries.length)
+            const response = await RedisConnection.withDedicatedClients(this.url, lanes, async (clients) => {
+                this.clients = clients
+                const truthStart = performance.now()
+                const truth = await this.groundTruth(queries)
+                this.run.truthMs = Math.round(performance.now() - truthStart)
+                await this.save()
+
+                for (const combination of this.combinations) {
+                    this.run.results.push(await this.measure(queries, truth, combination))
+                    this.run.completedCombinations++
+                    await this.save()
+                }
+            }, { key: this.config.vectorSetName })
+            this.clients = []
+            if (!response.success) {
+                throw new Error(response.error || "Benchmark queries failed")
+            }
+
+            this.run.status = "completed"
+        } catch (error) {
+            console.error(`[BenchmarkRunner] Run ${this.run.id} failed:`, error)
+            this.run.status = "failed"
+            this.run.error = error instanceof Error ? error.message : String(error)
+        }
+
+        this.run.finishedAt = Date.now()
+        await this.save()
+        await this.archive()
+    }
+
+    private async loadQueries(): Promise<Query[]> {
+        const { queries, vectorSetName } = this.config
+        const response = await RedisConnection.withClient(this.url, async (client) => {
+            const [members, card] = await Promise.all([
+                queries.type === "sample"
+                    ? client.sendCommand(["VRANDMEMBER", vectorSetName, String(queries.count)])
+                    : null,
+                client.sendCommand(["VCARD", vectorSetName]),
+            ])
+            return { members: (members as string[] | null) || [], card: Number(card) }
+        }, { lane: "bulk", key: vectorSetName })
+        if (!response.success || !response.result) {
+            throw new Error(response.error || "Failed to sample query elements")
+        }
+        this.run.cardinality = response.result.card
+
+        if (queries.type === "vectors") {
+            return queries.vectors.map((searchVector) => ({ searchVector }))
+        }
+        return response.result.members.map((searchElement) => ({ searchElement }))
+    }
+
+    private command(query: Query, overrides: Partial<VsimRequestBody>): (string | Buffer)[] {
+        return buildVsimCommand({
+            keyName: this.config.vectorSetName,
+            ...query,
+            count: 10,
+            filter: this.config.filter,
+            ...overrides,
+        })[0]
+    }
+
+    // Exact results for the largest COUNT; smaller ones are prefixes of it
+    private async groundTruth(queries: Query[]): Promise<string[][]> {
+        const count = Math.max(...this.config.count)
+        const keyName = this.config.truthVectorSetName || this.config.vectorSetName
+        const truth: string[][] = new Array(queries.length)
+        await this.forEachQuery(queries, async (client, query, index) => {
+            const reply = await client.sendCommand(this.command(query, { keyName, count, forceLinearScan: true }))
+            truth[index] = replyElements(reply)
+        })
+        return truth
+    }
+
+    private async measure(
+        queries: Query[],
+        truth: string[][],
+        combination: Combination
+    ): Promise<BenchmarkResultRow> {
+        const { ef, filterEf, count, threaded } = combination
+        const commands = queries.map((query) =>
+            this.command(query, {
+                count,
+                searchExplorationFactor: ef,
+                filterExplorationFactor: filterEf,
+                noThread: !threaded,
+            })
+        )
+
+        for (let round = 0; round < (this.config.warmupRounds ?? 0); round++) {
+            await this.forEachQuery(queries, (client, _query, index) =>
+                client.sendCommand(commands[index]).catch(() => undefined)
+            )
+        }
+
+        const latencies: number[] = []
+        let recallSum = 0
+        let errors = 0
+        const start = performance.now()
+        await this.forEachQuery(queries, async (client, _query, index) => {
+            const sent = performance.now()
+            try {
+                const reply = await client.sendCommand(commands[index])
+                latencies.push(performance.now() - sent)
+                recallSum += recallAt(replyElements(reply), truth[index], count)
+            } catch {
+                errors++
+            }
+        })
+        const elapsed = performance.now() - start
+
+        latencies.sort((a, b) => a - b)
+        const measured = latencies.length
+        const round = (value: number, digits = 3) => Number(value.toFixed(digits))
+        return {
+            ef,
+            filterEf,
+            count,
+            threaded,
+            recall: measured > 0 ? round(recallSum / measured, 4) : 0,
+            p50Ms: round(percentile(latencies, 50)),
+            p99Ms: round(percentile(latencies, 99)),
+            meanMs: measured > 0 ? round(latencies.reduce((sum, ms) => sum + ms, 0) / measured) : 0,
+            qps: elapsed > 0 ? round((measured * 1000) / elapsed, 1) : 0,
+            errors,
+        }
+    }
+
+    // Runs `task` for every query with one lane per dedicated connection, so a
+    // lane's latency is send to reply on a socket nobody else is using.
+    // A separate truth set must live on the same node (e.g. share a hash tag).
+    private async forEachQuery(
+        queries: Query[],
+        task: (client: RedisClient, query: Query, index: number) => Promise<unknown>
+    ): Promise<void> {
+        let next = 0
+        await Promise.all(
+            this.clients.map(async (client) => {
+                while (next < queries.length) {
+                    const index = next++
+                    await task(client, queries[index], index)
+                }
+            })
+        )
+    }
+
+    private async save(): Promise<void> {
+        if (!this.persist) return
+        await RedisConnection.withClient(this.url, async (client) => {
+            await client.set(getBenchmarkRunKey(this.run.id), JSON.stringify(this.run), { EX: RUN_TTL_SECONDS })
+        })
+    }
+
+    private async archive(): Promise<void> {
+        if (!this.persist) return
+        const key = getBenchmarkHistoryKey(this.run.vectorSetName)
+        await RedisConnection.withClient(this.url, async (client) => {
+            await client.multi()
+                .lPush(key, JSON.stringify(this.run))
+                .lTrim(key, 0, BENCHMARK_HISTORY_LENGTH - 1)
+                .exec()
+        })
+    }
+}
+
+function createRun(config: BenchmarkConfig): BenchmarkRun {
+    const { queries, ...settings } = config
+    return {
+        id: randomUUID(),
+        vectorSetName: config.vectorSetName,
+        status: "running",
+        config: {
+            ...settings,
+            querySource: queries.type,
+            queryCount: queries.type === "vectors" ? queries.vectors.length : queries.count,
+        },
+        startedAt: Date.now(),
+        completedCombinations: 0,
+        totalCombinations: 0,
+        results: [],
+    }
+}
+
+/**
+ * Starts a benchmark in the background and returns its initial state;
+ * poll getBenchmarkRun for progress.
+ */
+export async function startBenchmark(url: string, config: BenchmarkConfig): Promise<BenchmarkRun> {
+    const run = createRun(config)
+    const runner = new BenchmarkRunner(url, config, run)
+    const saved = await RedisConnection.withClient(url, async (client) => {
+        await client.set(getBenchmarkRunKey(run.id), JSON.stringify(run), { EX: RUN_TTL_SECONDS })
+    })
+    if (!saved.success) {
+        throw new Error(saved.error || "Failed to save benchmark run")
+    }
+
+    console.log(`[Benchmark] Starting run ${run.id} on ${run.vectorSetName} (${run.totalCombinations} combinations)`)
+    runner.execute().catch((error) => console.error(`[Benchmark] Run ${run.id} crashed:`, error))
+    return run
+}
+
+// Runs a benchmark to completion without saving it, for other tools built on it
+export async function runBenchmark(url: string, config: BenchmarkConfig): Promise<BenchmarkRun> {
+    const run = createRun(config)
+    await new BenchmarkRunner(url, config, run, false).execute()
+    return run
+}
+
+export async function getBenchmarkRun(url: string, runId: string): Promise<BenchmarkRun | null> {
+    const response = await RedisConnection.withClient(url, async (client) => {
+        return await client.get(getBenchmarkRunKey(runId))
+    })
+    if (!response.success) {
+        throw new Error(response.error || "Failed to read benchmark run")
+    }
+    return response.result ? (JSON.parse(response.result) as BenchmarkRun) : null
+}
+
+// Finished runs for a vector set, newest first
+export async function listBenchmarkRuns(url: string, vectorSetName: string): Promise<BenchmarkRun[]> {
+    const response = await RedisConnection.withClient(url, async (client) => {
+        return await client.lRange(getBenchmarkHistoryKey(vectorSetName), 0, -1)
+    })
+    if (!response.success) {
+        throw new Error(response.error || "Failed to read benchmark history")
+    }
+    return (response.result || []).map((entry) => JSON.parse(entry) as BenchmarkRun)
+}
+
+export async function clearBenchmarkRuns(url: string, vectorSetName: string): Promise<void> {
+    const response = await RedisConnection.withClient(url, async (client) => {
+        await client.del(getBenchmarkHistoryKey(vectorSetName))
+    })
+    if (!response.success) {
+        throw new Error(response.error || "Failed to clear benchmark history")
+    }
+}
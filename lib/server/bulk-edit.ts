@@ -0,0 +1,189 @@
+import { BulkEditSpec, BulkEditState, getJobBulkEditKey } from "@/lib/types/jobs"
+import { RedisClient, RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { parseVinfo, sendPipelined, vectorToFp32Buffer } from "@/lib/redis-server/utils"
+import { invalidateVectorSet } from "@/lib/server/vsim-cache"
+import { compileFilter } from "./filter-expression"
+
+// Elements read per VRANGE page; a page's matches are changed before the next page is read
+export const BULK_EDIT_PAGE_SIZE = 500
+// Left in a vector set that a bulk delete would otherwise empty, and so remove
+const PLACEHOLDER_ELEMENT = "Placeholder (Vector)"
+
+export function describeBulkEdit(spec: BulkEditSpec): string {
+    const action = spec.action.type === "delete" ? "Delete" : "Set attributes"
+    return spec.filter?.trim() ? `${action} where ${spec.filter.trim()}` : `${action} on all elements`
+}
+
+export function describeBulkEditState(state: BulkEditState): string {
+    const failed = state.failed > 0 ? `, ${state.failed} failed` : ""
+    return `Scanned ${state.scanned}, matched ${state.matched}, changed ${state.changed}${failed}`
+}
+
+// Applies a setattr action to one element's current attributes; "" clears them
+function editAttributes(spec: BulkEditSpec, current: string | null): string {
+    if (spec.action.type !== "setattr") {
+        throw new Error("Not an attribute edit")
+    }
+    let attributes: Record<string, unknown> = {}
+    if (spec.action.mode === "merge" && current) {
+        try {
+            const parsed = JSON.parse(current)
+            if (parsed && typeof parsed === "object" && !Array.isArray(parsed)) {
+                attributes = parsed
+            }
+        } catch (_error) {
+            // Unreadable attributes are replaced
+        }
+    }
+    for (const [field, value] of Object.entries(spec.action.attributes)) {
+        if (value === null) {
+            delete attributes[field]
+        } else {
+            attributes[field] = value
+        }
+    }
+    return Object.keys(attributes).length > 0 ? JSON.stringify(attributes) : ""
+}
+
+/**
+ * Applies a bulk edit to every element of a vector set that matches its
+ * filter. The set is walked in lexicographic pages with VRANGE, so only one
+ * page is held at a time and a saved cursor is enough to resume. VSIM cannot
+ * page through a filter's matches, so the filter is evaluated here against
+ * each page's attributes (see filter-expression.ts).
+ */
+export class BulkEditRunner {
+    private readonly matches: ((attributes: string | null) => boolean) | null
+
+    private constructor(
+        private readonly url: string,
+        private readonly jobId: string,
+        private readonly vectorSetName: string,
+        private readonly spec: BulkEditSpec,
+        public state: BulkEditState
+    ) {
+        this.matches = spec.filter?.trim() ? compileFilter(spec.filter) : null
+    }
+
+    // Picks up where an earlier run of the job stopped, if there was one
+    static async load(
+        url: string,
+        jobId: string,
+        vectorSetName: string,
+        spec: BulkEditSpec
+    ): Promise<BulkEditRunner> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            return client.get(getJobBulkEditKey(jobId))
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+        const state: BulkEditState = response.result
+            ? JSON.parse(response.result)
+            : { cursor: null, scanned: 0, matched: 0, changed: 0, failed: 0, done: false }
+        return new BulkEditRunner(url, jobId, vectorSetName, spec, state)
+    }
+
+    // Reads the next page, applies the edit to its matches and saves the cursor
+    async step(): Promise<BulkEditState> {
+        const vectorSetName = this.vectorSetName
+        const response = await RedisConnection.withClient(
+            this.url,
+            async (client) => {
+                const start = this.state.cursor === null ? "-" : `(${this.state.cursor}`
+                let page: string[]
+                try {
+                    const reply = await client.sendCommand([
+                        "VRANGE", vectorSetName, start, "+", String(BULK_EDIT_PAGE_SIZE),
+                    ])
+                    page = ((reply as unknown[]) || []).map(String)
+                } catch (error) {
+                    if (/unknown command/i.test(String(error))) {
+                        throw new Error("Bulk edits need VRANGE, available from Redis 8.2")
+                    }
+                    throw error
+                }
+
+                const candidates = page.filter((element) => element !== PLACEHOLDER_ELEMENT)
+                const readAttributes =
+                    this.matches !== null ||
+                    (this.spec.action.type === "setattr" && this.spec.action.mode === "merge")
+                const attributes = readAttributes
+                    ? (await sendPipelined(
+                        client,
+                        candidates.map((element) => ["VGETATTR", vectorSetName, element])
+                    )).map((reply) => (typeof reply === "string" ? reply : null))
+                    : []
+
+                const matched = candidates
+                    .map((element, index) => ({ element, current: attributes[index] ?? null }))
+                    .filter(({ current }) => !this.matches || this.matches(current))
+                const commands = matched.map(({ element, current }) =>
+                    this.spec.action.type === "delete"
+                        ? ["VREM", vectorSetName, element]
+                        : ["VSETATTR", vectorSetName, element, editAttributes(this.spec, current)]
+                )
+
+                if (this.spec.action.type === "delete" && commands.length > 0) {
+                    await this.keepSetAlive(client, commands.length)
+                }
+                const replies = await sendPipelined(client, commands)
+
+                return {
+                    page,
+                    matched: matched.length,
+                    changed: replies.filter((reply) => reply === 1).length,
+                    failed: replies.filter((reply) => reply instanceof Error).length,
+                }
+            },
+            { key: vectorSetName, lane: "bulk" }
+        )
+        if (!response.success || !response.result) {
+            throw new Error(response.error)
+        }
+
+        const { page, matched, changed, failed } = response.result
+        if (changed > 0) {
+            invalidateVectorSet(this.url, vectorSetName)
+        }
+        this.state = {
+            cursor: page.length > 0 ? page[page.length - 1] : this.state.cursor,
+            scanned: this.state.scanned + page.length,
+            matched: this.state.matched + matched,
+            changed: this.state.changed + changed,
+            failed: this.state.failed + failed,
+            done: page.length < BULK_EDIT_PAGE_SIZE,
+        }
+        await this.save()
+        return this.state
+    }
+
+    private async save(): Promise<void> {
+        const response = await RedisConnection.withClient(this.url, async (client) => {
+            await client.set(getJobBulkEditKey(this.jobId), JSON.stringify(this.state))
+            return true
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+    }
+
+    // Adds the placeholder element before a delete that would leave the set empty
+    private async keepSetAlive(client: RedisClient, deleting: number): Promise<void> {
+        const card = Number(await client.sendCommand(["VCARD", this.vectorSetName]))
+        if (card > deleting) return
+
+        const info = parseVinfo(await client.sendCommand(["VINFO", this.vectorSetName]))
+        // A set built with REDUCE takes vectors of its input dimension
+        const dimensions =
+            Number(info?.["projection-input-dim"]) || Number(info?.["vector-dim"]) || 0
+        if (dimensions <= 0) return
+        await client.sendCommand([
+            "VADD",
+            this.vectorSetName,
+            "FP32",
+            vectorToFp32Buffer(new Array(dimensions).fill(0)),
+            PLACEHOLDER_ELEMENT,
+        ])
+    }
+}
@@ -0,0 +1,78 @@
+// Error raised by embedding calls, carrying the upstream HTTP status when known
+export class EmbeddingRequestError extends Error {
+    constructor(
+        message: string,
+        public status?: number
+    ) {
+        super(message)
+        this.name = "EmbeddingRequestError"
+    }
+}
+
+// Providers report upstream failures as "<Provider> API error: <status> - ..."
+export function getUpstreamStatus(error: unknown): number | undefined {
+    if (error instanceof EmbeddingRequestError && error.status) {
+        return error.status
+    }
+    const message = error instanceof Error ? error.message : String(error)
+    const match = message.match(/API error: (\d{3})/)
+    return match ? Number(match[1]) : undefined
+}
+
+// Rate limiting and server-side failures are worth retrying with less load
+export function isThrottleError(error: unknown): boolean {
+    const status = getUpstreamStatus(error)
+    return status !== undefined && (status === 429 || status >= 500)
+}
+
+/**
+ * Tracks how many embedding requests a job may keep in flight.
+ * The limit halves when the provider throttles (429/5xx) and grows back by one
+ * per successful request, up to the configured maximum.
+ */
+export class AdaptiveConcurrencyLimiter {
+    private currentLimit: number
+    private consecutiveThrottles: number = 0
+    private backoffUntil: number = 0
+
+    private static readonly BASE_BACKOFF_MS = 500
+    private static readonly MAX_BACKOFF_MS = 30000
+
+    constructor(private readonly maxConcurrency: number) {
+        this.maxConcurrency = Math.max(1, Math.floor(maxConcurrency))
+        this.currentLimit = this.maxConcurrency
+    }
+
+    get limit(): number {
+        return this.currentLimit
+    }
+
+    onSuccess(): void {
+        this.consecutiveThrottles = 0
+        if (this.currentLimit < this.maxConcurrency) {
+            this.currentLimit++
+        }
+    }
+
+    onThrottle(): void {
+        this.consecutiveThrottles++
+        this.currentLimit = Math.max(1, Math.floor(this.currentLimit / 2))
+
+        const backoff = Math.min(
+            AdaptiveConcurrencyLimiter.MAX_BACKOFF_MS,
+            AdaptiveConcurrencyLimiter.BASE_BACKOFF_MS *
+                2 ** (this.consecutiveThrottles - 1)
+        )
+        // Jitter so concurrent retries do not hit the provider at the same instant
+        const jittered = backoff / 2 + Math.random() * (backoff / 2)
+        this.backoffUntil = Math.max(this.backoffUntil, Date.now() + jittered)
+    }
+
+    // Resolves once any backoff window opened by a throttle has passed
+    async waitForBackoff(): Promise<void> {
+        const delay = this.backoffUntil - Date.now()
+        if (delay > 0) {
+            await new Promise((resolve) => setTimeout(resolve, delay))
+        }
+    }
+}
@@ -0,0 +1,195 @@
+import { mkdir, open, rename, rm } from "fs/promises"
+import type { FileHandle } from "fs/promises"
+import path from "path"
+import {
+    ExportFileNames,
+    exportFileNames,
+    VECTOR_EXPORT_MANIFEST_FORMAT,
+    VectorExportElement,
+    VectorExportFormat,
+    VectorExportManifest,
+} from "@/lib/imports/vectorExport"
+
+// Buffered output is written out once it grows past this many bytes
+const FLUSH_THRESHOLD_BYTES = 256 * 1024
+
+// Appends to a file written under a temporary name until it is committed
+class StagedFile {
+    private handle: FileHandle | null = null
+    private chunks: Buffer[] = []
+    private bufferedBytes = 0
+
+    constructor(readonly finalPath: string) {}
+
+    private get stagingPath(): string {
+        return `${this.finalPath}.partial`
+    }
+
+    async open(): Promise<void> {
+        this.handle = await open(this.stagingPath, "w")
+    }
+
+    async write(chunk: string | Buffer): Promise<void> {
+        const buffer = typeof chunk === "string" ? Buffer.from(chunk, "utf8") : chunk
+        this.chunks.push(buffer)
+        this.bufferedBytes += buffer.length
+        if (this.bufferedBytes >= FLUSH_THRESHOLD_BYTES) {
+            await this.flush()
+        }
+    }
+
+    async flush(): Promise<void> {
+        if (!this.handle || this.chunks.length === 0) return
+        const data = this.chunks.length === 1 ? this.chunks[0] : Buffer.concat(this.chunks)
+        this.chunks = []
+        this.bufferedBytes = 0
+        await this.handle.write(data)
+    }
+
+    async commit(): Promise<void> {
+        await this.flush()
+        await this.handle?.close()
+        this.handle = null
+        await rename(this.stagingPath, this.finalPath)
+    }
+
+    async discard(): Promise<void> {
+        this.chunks = []
+        await this.handle?.close().catch(() => {})
+        this.handle = null
+        await rm(this.stagingPath, { force: true })
+    }
+}
+
+/**
+ * Writes an export to public/exports as rows arrive, so only the rows since
+ * the last flush are held in memory. Files are written under a .partial name
+ * and only renamed into place by close(), so a failed export never leaves a
+ * truncated file behind under the real name.
+ */
+export class VectorExportWriter {
+    private readonly names: ExportFileNames
+    private readonly main: StagedFile
+    private readonly vectors: StagedFile | null
+    private readonly attributes: StagedFile | null
+    private dimension = 0
+    private _count = 0
+
+    private constructor(
+        directory: string,
+        private readonly format: VectorExportFormat,
+        filename: string
+    ) {
+        this.names = exportFileNames(filename, format)
+        this.main = new StagedFile(path.join(directory, this.names.main))
+        this.vectors = this.names.vectors
+            ? new StagedFile(path.join(directory, this.names.vectors))
+            : null
+        this.attributes = this.names.attributes
+            ? new StagedFile(path.join(directory, this.names.attributes))
+            : null
+    }
+
+    static async open(
+        filename: string,
+        format: VectorExportFormat
+    ): Promise<VectorExportWriter> {
+        const directory = path.join(process.cwd(), "public", "exports")
+        await mkdir(directory, { recursive: true })
+
+        // Sanitize filename to prevent directory traversal
+        const writer = new VectorExportWriter(directory, format, path.basename(filename))
+        try {
+            if (format === "binary") {
+                // The manifest is only written by close(), once the count is known
+                await writer.vectors!.open()
+                await writer.attributes!.open()
+            } else {
+                await writer.main.open()
+                if (format === "json") {
+                    await writer.main.write("[")
+                }
+            }
+        } catch (error) {
+            await writer.abort()
+            throw error
+        }
+
+        console.log(`[VectorExportWriter] Writing ${format} export to ${writer.names.main}`)
+        return writer
+    }
+
+    get count(): number {
+        return this._count
+    }
+
+    async append(row: VectorExportElement): Promise<void> {
+        const { element, vector, attributes } = row
+
+        switch (this.format) {
+            case "json":
+                await this.main.write((this._count > 0 ? ",\n" : "\n") + JSON.stringify(row))
+                break
+            case "ndjson":
+                await this.main.write(JSON.stringify(row) + "\n")
+                break
+            case "binary": {
+                if (this._count === 0) {
+                    this.dimension = vector.length
+                } else if (vector.length !== this.dimension) {
+                    throw new Error(
+                        `Vector for ${element} has ${vector.length} dimensions, expected ${this.dimension}`
+                    )
+                }
+                const buffer = Buffer.allocUnsafe(vector.length * 4)
+                for (let i = 0; i < vector.length; i++) {
+                    buffer.writeFloatLE(vector[i], i * 4)
+                }
+                await this.vectors!.write(buffer)
+                await this.attributes!.write(
+                    JSON.stringify(attributes ? { element, attributes } : { element }) + "\n"
+                )
+                break
+            }
+        }
+        this._count++
+    }
+
+    /**
+     * Finishes the export and moves its files into place.
+     * @returns The public URL path of the export
+     */
+    async close(): Promise<{ filePath: string; count: number }> {
+        if (this.format === "binary") {
+            await this.vectors!.commit()
+            await this.attributes!.commit()
+
+            const manifest: VectorExportManifest = {
+                format: VECTOR_EXPORT_MANIFEST_FORMAT,
+                version: 1,
+                dimension: this.dimension,
+                count: this._count,
+                vectors: this.names.vectors!,
+                attributes: this.names.attributes!,
+            }
+            await this.main.open()
+            await this.main.write(JSON.stringify(manifest))
+        } else if (this.format === "json") {
+            await this.main.write(this._count > 0 ? "\n]" : "]")
+        }
+        await this.main.commit()
+
+        const filePath = `/exports/${this.names.main}`
+        console.log(`[VectorExportWriter] Saved ${this._count} vectors to ${filePath}`)
+        return { filePath, count: this._count }
+    }
+
+    // Removes everything written so far
+    async abort(): Promise<void> {
+        await Promise.all([
+            this.main.discard(),
+            this.vectors?.discard(),
+            this.attributes?.discard(),
+        ])
+    }
+}
@@ -0,0 +1,312 @@
+/*
+ * Evaluates vector set FILTER expressions (".year > 1950 and .genre in
+ * ['drama', 'crime']") against an element's JSON attributes, the way VSIM
+ * does: selectors read top-level fields; an element whose attributes are
+ * missing, unreadable or lack a selected field does not match.
+ *
+ * Used where elements are enumerated rather than searched, so the server
+ * cannot apply the filter itself. Operands are coerced as the server does:
+ * a string used as a number is parsed strtod-style and counts as 0 unless
+ * the whole string is numeric. Constructs whose server behaviour this
+ * evaluator does not reproduce exactly (arrays outside the right-hand side
+ * of `in`, substring `in`) are rejected with FilterSyntaxError rather than
+ * guessed at, so a bulk edit never touches elements VSIM would not match.
+ */
+
+type Value = number | string | Value[]
+
+type Node =
+    | { type: "literal"; value: Value }
+    | { type: "field"; name: string }
+    | { type: "array"; items: Node[] }
+    | { type: "unary"; op: string; operand: Node }
+    | { type: "binary"; op: string; left: Node; right: Node }
+
+type Token =
+    | { kind: "number"; value: number }
+    | { kind: "string"; value: string }
+    | { kind: "field"; value: string }
+    | { kind: "op"; value: string }
+
+// Binding power of each infix operator; ** is right-associative
+const INFIX: Record<string, number> = {
+    "or": 1, "||": 1,
+    "and": 2, "&&": 2,
+    "==": 3, "!=": 3, "in": 3,
+    ">": 4, ">=": 4, "<": 4, "<=": 4,
+    "+": 5, "-": 5,
+    "*": 6, "/": 6, "%": 6,
+    "**": 7,
+}
+const PREFIX_POWER = 8
+
+const SYMBOLS = ["**", "==", "!=", ">=", "<=", "&&", "||", ">", "<", "+", "-", "*", "/", "%", "!", "(", ")", "[", "]", ","]
+
+// Raised while evaluating an element that lacks a selected field
+class MissingField extends Error {}
+
+export class FilterSyntaxError extends Error {}
+
+// Mirrors what strtod() accepts when it must consume the whole string:
+// leading whitespace, decimal or hex forms, inf and nan
+const STRTOD_DECIMAL = /^\s*[+-]?(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?$/
+const STRTOD_HEX = /^\s*([+-]?)0[xX]([0-9a-fA-F]*)(?:\.([0-9a-fA-F]*))?(?:[pP]([+-]?\d+))?$/
+const STRTOD_SPECIAL = /^\s*([+-]?)(?:(inf(?:inity)?)|nan(?:\([\w]*\))?)$/i
+// The server only converts strings shorter than its 256-byte buffer
+const MAX_NUMERIC_STRING = 255
+
+function stringToNumber(value: string): number {
+    if (Buffer.byteLength(value) > MAX_NUMERIC_STRING) return 0
+    if (STRTOD_DECIMAL.test(value)) return Number(value.trim())
+    const hex = STRTOD_HEX.exec(value)
+    if (hex && (hex[2] || hex[3])) {
+        const [, sign, whole, fraction = "", exponent = "0"] = hex
+        const mantissa = parseInt(whole + fraction || "0", 16) / 16 ** fraction.length
+        return (sign === "-" ? -1 : 1) * mantissa * 2 ** Number(exponent)
+    }
+    const special = STRTOD_SPECIAL.exec(value)
+    if (special) {
+        return special[2] ? (special[1] === "-" ? -Infinity : Infinity) : NaN
+    }
+    return 0
+}
+
+function toNumber(value: Value): number {
+    if (typeof value === "number") return value
+    if (typeof value === "string") return stringToNumber(value)
+    throw new FilterSyntaxError("Arrays can only appear on the right-hand side of 'in'")
+}
+
+function tokenize(source: string): Token[] {
+    const tokens: Token[] = []
+    let i = 0
+    while (i < source.length) {
+        const c = source[i]
+        if (/\s/.test(c)) {
+            i++
+        } else if (c === '"' || c === "'") {
+            let value = ""
+            i++
+            while (i < source.length && source[i] !== c) {
+                if (source[i] === "\\" && i + 1 < source.length) i++
+                value += source[i++]
+            }
+            if (i >= source.length) throw new FilterSyntaxError("Unterminated string")
+            i++
+            tokens.push({ kind: "string", value })
+        } else if (/[0-9]/.test(c) || (c === "." && /[0-9]/.test(source[i + 1] ?? ""))) {
+            const match = /^(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?/.exec(source.slice(i))!
+            tokens.push({ kind: "number", value: Number(match[0]) })
+            i += match[0].length
+        } else if (c === ".") {
+            const match = /^\.([A-Za-z_$][\w$]*)/.exec(source.slice(i))
+            if (!match) throw new FilterSyntaxError(`Invalid selector at ${i}`)
+            tokens.push({ kind: "field", value: match[1] })
+            i += match[0].length
+        } else if (/[A-Za-z_]/.test(c)) {
+            const word = /^[A-Za-z_]\w*/.exec(source.slice(i))![0]
+            i += word.length
+            if (word === "and" || word === "or" || word === "not" || word === "in") {
+                tokens.push({ kind: "op", value: word === "not" ? "!" : word })
+            } else if (word === "true" || word === "false") {
+                tokens.push({ kind: "number", value: word === "true" ? 1 : 0 })
+            } else {
+                throw new FilterSyntaxError(`Unknown word '${word}'`)
+            }
+        } else {
+            const symbol = SYMBOLS.find((s) => source.startsWith(s, i))
+            if (!symbol) throw new FilterSyntaxError(`Unexpected '${c}' at ${i}`)
+            tokens.push({ kind: "op", value: symbol })
+            i += symbol.length
+        }
+    }
+    return tokens
+}
+
+class Parser {
+    private position = 0
+
+    constructor(private readonly tokens: Token[]) {}
+
+    parse(): Node {
+        const node = this.expression(0)
+        if (this.position < this.tokens.length) {
+            throw new FilterSyntaxError("Unexpected input after expression")
+        }
+        return node
+    }
+
+    private peekOp(): string | null {
+        const token = this.tokens[this.position]
+        return token?.kind === "op" ? token.value : null
+    }
+
+    private expect(op: string) {
+        if (this.peekOp() !== op) throw new FilterSyntaxError(`Expected '${op}'`)
+        this.position++
+    }
+
+    private expression(minPower: number): Node {
+        let left = this.prefix()
+        for (;;) {
+            const op = this.peekOp()
+            const power = op ? INFIX[op] : undefined
+            if (!op || power === undefined || power <= minPower) break
+            this.position++
+            const right = this.expression(op === "**" ? power - 1 : power)
+            left = { type: "binary", op, left, right }
+        }
+        return left
+    }
+
+    // Array literals are only evaluated exactly as the list searched by `in`
+    static check(node: Node, allowArray = false) {
+        switch (node.type) {
+            case "array":
+                if (!allowArray) {
+                    throw new FilterSyntaxError("Arrays can only appear on the right-hand side of 'in'")
+                }
+                node.items.forEach((item) => Parser.check(item))
+                return
+            case "unary":
+                Parser.check(node.operand)
+                return
+            case "binary":
+                if (node.op === "in" && node.right.type === "literal") {
+                    throw new FilterSyntaxError("'in' is only supported with an array on the right-hand side")
+                }
+                Parser.check(node.left)
+                Parser.check(node.right, node.op === "in")
+                return
+        }
+    }
+
+    private prefix(): Node {
+        const token = this.tokens[this.position++]
+        if (!token) throw new FilterSyntaxError("Unexpected end of expression")
+
+        switch (token.kind) {
+            case "number":
+            case "string":
+                return { type: "literal", value: token.value }
+            case "field":
+                return { type: "field", name: token.value }
+        }
+
+        if (token.value === "(") {
+            const node = this.expression(0)
+            this.expect(")")
+            return node
+        }
+        if (token.value === "[") {
+            const items: Node[] = []
+            while (this.peekOp() !== "]") {
+                const item = this.expression(0)
+                if (item.type === "array") {
+                    throw new FilterSyntaxError("Nested arrays are not supported")
+                }
+                items.push(item)
+                if (this.peekOp() !== ",") break
+                this.position++
+            }
+            this.expect("]")
+            return { type: "array", items }
+        }
+        if (token.value === "!" || token.value === "-") {
+            return { type: "unary", op: token.value, operand: this.expression(PREFIX_POWER) }
+        }
+        throw new FilterSyntaxError(`Unexpected '${token.value}'`)
+    }
+}
+
+function toValue(raw: unknown): Value {
+    if (typeof raw === "number" || typeof raw === "string") return raw
+    if (typeof raw === "boolean") return raw ? 1 : 0
+    if (Array.isArray(raw)) return raw.map(toValue)
+    // Objects and null cannot be compared
+    throw new MissingField()
+}
+
+function truthy(value: Value): boolean {
+    if (typeof value === "number") return value !== 0
+    if (typeof value === "string") return value.length > 0
+    throw new FilterSyntaxError("Arrays can only appear on the right-hand side of 'in'")
+}
+
+// Strings compare as strings; any other pairing compares numerically
+function equals(a: Value, b: Value): boolean {
+    if (typeof a === "string" && typeof b === "string") return a === b
+    return toNumber(a) === toNumber(b)
+}
+
+function evaluate(node: Node, attributes: Record<string, unknown>): Value {
+    switch (node.type) {
+        case "literal":
+            return node.value
+        case "field":
+            if (!(node.name in attributes)) throw new MissingField()
+            return toValue(attributes[node.name])
+        case "array":
+            return node.items.map((item) => evaluate(item, attributes))
+        case "unary": {
+            const operand = evaluate(node.operand, attributes)
+            return node.op === "!" ? (truthy(operand) ? 0 : 1) : -toNumber(operand)
+        }
+    }
+
+    const { op } = node
+    if (op === "and" || op === "&&") {
+        return truthy(evaluate(node.left, attributes)) && truthy(evaluate(node.right, attributes)) ? 1 : 0
+    }
+    if (op === "or" || op === "||") {
+        return truthy(evaluate(node.left, attributes)) || truthy(evaluate(node.right, attributes)) ? 1 : 0
+    }
+
+    const left = evaluate(node.left, attributes)
+    const right = evaluate(node.right, attributes)
+    switch (op) {
+        case "==": return equals(left, right) ? 1 : 0
+        case "!=": return equals(left, right) ? 0 : 1
+        case "in":
+            if (Array.isArray(right)) return right.some((item) => equals(left, item)) ? 1 : 0
+            throw new FilterSyntaxError("'in' is only supported with an array on the right-hand side")
+        case ">": return toNumber(left) > toNumber(right) ? 1 : 0
+        case ">=": return toNumber(left) >= toNumber(right) ? 1 : 0
+        case "<": return toNumber(left) < toNumber(right) ? 1 : 0
+        case "<=": return toNumber(left) <= toNumber(right) ? 1 : 0
+        case "+": return toNumber(left) + toNumber(right)
+        case "-": return toNumber(left) - toNumber(right)
+        case "*": return toNumber(left) * toNumber(right)
+        case "/": return toNumber(left) / toNumber(right)
+        case "%": return toNumber(left) % toNumber(right)
+        case "**": return toNumber(left) ** toNumber(right)
+    }
+    throw new FilterSyntaxError(`Unknown operator '${op}'`)
+}
+
+/**
+ * Compiles a FILTER expression into a predicate over VGETATTR replies.
+ * Throws FilterSyntaxError for expressions that do not parse or use a
+ * construct that cannot be evaluated exactly; the predicate throws it too
+ * when an attribute holds an array outside the right-hand side of `in`.
+ */
+export function compileFilter(expression: string): (attributes: string | null) => boolean {
+    const tree = new Parser(tokenize(expression)).parse()
+    Parser.check(tree)
+    return (attributes) => {
+        if (!attributes) return false
+        let parsed: unknown
+        try {
+            parsed = JSON.parse(attributes)
+        } catch (_error) {
+            return false
+        }
+        if (!parsed || typeof parsed !== "object" || Array.isArray(parsed)) return false
+        try {
+            return truthy(evaluate(tree, parsed as Record<string, unknown>))
+        } catch (error) {
+            if (error instanceof MissingField) return false
+            throw error
+        }
+    }
+}
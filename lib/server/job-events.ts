@@ -0,0 +1,199 @@
+import { createClient } from "redis"
+import { JOB_EVENTS_CHANNEL, JobProgress, JobProgressEvent } from "@/lib/types/jobs"
+import { JobQueueService } from "./job-queue"
+
+/*
+ * Push-based job progress. JobQueueService.updateJobProgress publishes every
+ * progress write on JOB_EVENTS_CHANNEL; /api/jobs/events relays them to the
+ * browser over SSE. JobProgressReporter keeps the number of those writes per
+ * job down to a few per second.
+ */
+
+// Row-level progress is written at most this often; status changes go out at once
+export const PROGRESS_FLUSH_INTERVAL_MS = 250
+
+// Weight of the newest sample in the smoothed rows/s
+const RATE_SMOOTHING = 0.3
+
+type JobEventListener = (event: JobProgressEvent) => void
+
+interface Subscription {
+    listeners: Set<JobEventListener>
+    ready: Promise<ReturnType<typeof createClient>>
+}
+
+// One subscriber connection per Redis URL, shared by every open event stream
+const subscriptions = new Map<string, Subscription>()
+
+async function openSubscriber(url: string, listeners: Set<JobEventListener>) {
+    const subscriber = createClient({ url, socket: { connectTimeout: 5000 } })
+    subscriber.on("error", (err) => {
+        console.error("[JobEvents] Subscriber error:", err)
+    })
+    await subscriber.connect()
+    await subscriber.subscribe(JOB_EVENTS_CHANNEL, (message) => {
+        let event: JobProgressEvent
+        try {
+            event = JSON.parse(message)
+        } catch (error) {
+            console.error("[JobEvents] Ignoring malformed event:", error)
+            return
+        }
+        listeners.forEach((listener) => listener(event))
+    })
+    return subscriber
+}
+
+/**
+ * Calls `listener` with every job progress event published on this Redis
+ * server. Resolves once the subscription is active, with a function that
+ * removes the listener (closing the connection after the last one).
+ */
+export async function subscribeJobEvents(
+    url: string,
+    listener: JobEventListener
+): Promise<() => void> {
+    let subscription = subscriptions.get(url)
+    if (!subscription) {
+        const listeners = new Set<JobEventListener>()
+        const created: Subscription = { listeners, ready: openSubscriber(url, listeners) }
+        subscriptions.set(url, created)
+        // A failed connection is not kept, so the next stream retries
+        created.ready.catch(() => {
+            if (subscriptions.get(url) === created) subscriptions.delete(url)
+        })
+        subscription = created
+    }
+
+    const current = subscription
+    current.listeners.add(listener)
+    try {
+        await current.ready
+    } catch (error) {
+        current.listeners.delete(listener)
+        throw error
+    }
+
+    return () => {
+        current.listeners.delete(listener)
+        if (current.listeners.size > 0 || subscriptions.get(url) !== current) return
+        subscriptions.delete(url)
+        current.ready
+            .then((subscriber) => subscriber.quit())
+            .catch((error) => console.error("[JobEvents] Failed to close subscriber:", error))
+    }
+}
+
+/**
+ * Coalesces a job's progress updates. Row-level updates are merged and
+ * written (and so published) at most every PROGRESS_FLUSH_INTERVAL_MS;
+ * updates that change the status or report an error are written at once,
+ * together with whatever was pending. Each write carries a smoothed rows/s
+ * and an ETA.
+ */
+export class JobProgressReporter {
+    private pending: Partial<JobProgress> | null = null
+    private timer: NodeJS.Timeout | null = null
+    private lastFlushAt = 0
+    // Writes are chained so they reach Redis in order
+    private writing: Promise<void> = Promise.resolve()
+
+    private rateSampleAt = 0
+    private rateSampleCurrent = 0
+    private rowsPerSecond = 0
+    private total = 0
+
+    constructor(
+        private readonly url: string,
+        private readonly jobId: string
+    ) {}
+
+    update(progress: Partial<JobProgress>): Promise<void> {
+        this.pending = { ...this.pending, ...progress }
+
+        if (progress.status || progress.error) {
+            return this.flush()
+        }
+
+        const wait = this.lastFlushAt + PROGRESS_FLUSH_INTERVAL_MS - Date.now()
+        if (wait <= 0) {
+            return this.flush()
+        }
+        if (!this.timer) {
+            this.timer = setTimeout(() => {
+                this.timer = null
+                this.flush().catch(() => {})
+            }, wait)
+        }
+        return Promise.resolve()
+    }
+
+    // Writes anything still pending; resolves once it is in Redis
+    flush(): Promise<void> {
+        if (this.timer) {
+            clearTimeout(this.timer)
+            this.timer = null
+        }
+        const progress = this.pending
+        this.pending = null
+        this.lastFlushAt = Date.now()
+        if (!progress) {
+            return this.writing
+        }
+
+        const write = this.writing.then(async () => {
+            const written = await JobQueueService.updateJobProgress(
+                this.url,
+                this.jobId,
+                this.withRate(progress)
+            )
+            this.total = written.total
+        })
+        // A failed write is reported to its caller but does not block later ones
+        this.writing = write.catch((error) => {
+            console.error(`[JobProgressReporter] Failed to write progress for job ${this.jobId}:`, error)
+        })
+        return write
+    }
+
+    // Drops pending row-level progress, e.g. once the job's keys may be gone
+    discard(): void {
+        if (this.timer) {
+            clearTimeout(this.timer)
+            this.timer = null
+        }
+        this.pending = null
+    }
+
+    private withRate(progress: Partial<JobProgress>): Partial<JobProgress> {
+        const status = progress.status
+        if (status && status !== "processing") {
+            // Rate and ETA only mean something while rows are flowing
+            this.rateSampleAt = 0
+            return { ...progress, rowsPerSecond: 0, etaSeconds: undefined }
+        }
+        if (progress.current === undefined) {
+            return progress
+        }
+
+        const now = Date.now()
+        if (this.rateSampleAt > 0 && now > this.rateSampleAt) {
+            const rate = ((progress.current - this.rateSampleCurrent) * 1000) / (now - this.rateSampleAt)
+            this.rowsPerSecond = this.rowsPerSecond > 0
+                ? RATE_SMOOTHING * rate + (1 - RATE_SMOOTHING) * this.rowsPerSecond
+                : rate
+        }
+        this.rateSampleAt = now
+        this.rateSampleCurrent = progress.current
+
+        const total = progress.total ?? this.total
+        const remaining = total - progress.current
+        return {
+            ...progress,
+            rowsPerSecond: Math.round(this.rowsPerSecond * 10) / 10,
+            etaSeconds: this.rowsPerSecond > 0 && remaining > 0
+                ? Math.round(remaining / this.rowsPerSecond)
+                : undefined,
+        }
+    }
+}
@@ -1,14 +1,73 @@
 import {
     CSVJobMetadata,
+    getJobCheckpointKey,
     getJobStatusKey,
+    getJobWrittenKey,
     JobProgress,
+    JobQueueItem,
     CSVRow,
+    DEFAULT_JOB_BATCH_TIME_BUDGET_MS,
 } from "@/lib/types/jobs"
 import { JobQueueService } from "./job-queue"
 import { RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { sendPipelined, vectorToFp32Buffer } from "@/lib/redis-server/utils"
+import {
+    AdaptiveConcurrencyLimiter,
+    EmbeddingRequestError,
+    isThrottleError,
+} from "./concurrency-limiter"
 import { registerCompletedJob } from "@/lib/jobs/completedJobs"
-import { buildVectorElement, saveVectorData } from "@/lib/imports/importUtils"
+import { buildVectorElement } from "@/lib/imports/importUtils"
+import { resolveExportFormat } from "@/lib/imports/vectorExport"
+import { VectorExportWriter } from "./export-writer"
 import { convertToNumericIfPossible } from "@/lib/data/numbers"
+import { getEmbeddingService } from "@/lib/embeddings/service"
+import { clearImportJob, recordImportRows } from "@/lib/server/metrics"
+import { invalidateVectorSet } from "@/lib/server/vsim-cache"
+import { JobProgressReporter } from "./job-events"
+import { BulkEditRunner, describeBulkEditState } from "./bulk-edit"
+import { hostname } from "os"
+
+// A queue item resolved to the element, text and attributes it will be stored with
+interface PreparedItem {
+    index: number
+    streamId?: string
+    elementId: string
+    textToEmbed?: string
+    embedding?: number[]
+    attributes?: Record<string, string | number>
+}
+
+// A batch that has been through embedding and is waiting to be written in order
+interface EmbeddedBatch {
+    items: JobQueueItem[]
+    prepared: PreparedItem[]
+    skipped: number
+    durationMs: number
+    error?: string
+}
+
+// Retries per batch when the embedding provider answers 429/5xx
+const MAX_THROTTLE_RETRIES = 5
+// A JSON export's writer lease lapses this long after its holder stops renewing it
+const EXPORT_LEASE_TTL_MS = 60 * 1000
+// Created with the vector set so it is never empty; imports replace it
+const PLACEHOLDER_ELEMENT = "Placeholder (Vector)"
+
+/**
+ * Consumer name this process uses in job consumer groups. It must stay the
+ * same across restarts for a worker to recover the rows it had claimed.
+ */
+export function jobConsumerName(): string {
+    return process.env.JOB_WORKER_NAME || `${hostname()}-${process.pid}`
+}
+
+export interface JobProcessorOptions {
+    consumer?: string
+    // Take over rows other consumers left pending without waiting for them to
+    // go idle, when a stopped job is resumed
+    takeOver?: boolean
+}
 
 export class JobProcessor {
     private url: string
@@ -16,11 +75,35 @@ export class JobProcessor {
     private isRunning: boolean = false
     private isPaused: boolean = false
     private metadata: CSVJobMetadata | null = null
-    private _vectorElements: ReturnType<typeof buildVectorElement>[] = []
-
-    constructor(url: string, jobId: string) {
+    // Open while a JSON export is running; rows are appended as they are processed
+    private exportWriter: VectorExportWriter | null = null
+    // Set once this job has removed the placeholder element (recorded in its checkpoint)
+    private placeholderRemoved: boolean = false
+    // Rows written during this run, for the rows/s metric
+    private rowsWritten: number = 0
+    private runStartedAt: number = 0
+    private progressReporter: JobProgressReporter
+    // This processor's name in the job's consumer group
+    private consumer: string
+    // Rows this consumer left unacknowledged in an earlier run are claimed first
+    private recoveringOwn: boolean = true
+    private takingOver: boolean
+    // Stream IDs claimed by this processor and not acknowledged yet
+    private claimedIds = new Set<string>()
+    private running: Promise<void> | null = null
+
+    constructor(url: string, jobId: string, options: JobProcessorOptions = {}) {
         this.url = url
         this.jobId = jobId
+        this.consumer = options.consumer || jobConsumerName()
+        this.takingOver = options.takeOver ?? false
+        this.progressReporter = new JobProgressReporter(url, jobId)
+    }
+
+    // Set JOB_EMBEDDING_TRANSPORT=http to route job embeddings through the
+    // /api/embeddings routes instead of calling the EmbeddingService in-process
+    private useHttpEmbeddings(): boolean {
+        return process.env.JOB_EMBEDDING_TRANSPORT === "http"
     }
 
     private async getEmbedding(text: string): Promise<number[]> {
@@ -32,6 +115,48 @@ export class JobProcessor {
             throw new Error("Text to embed is undefined or empty")
         }
 
+        if (this.useHttpEmbeddings()) {
+            return this.getEmbeddingOverHttp(text)
+        }
+
+        return getEmbeddingService().getEmbedding(
+            text,
+            this.metadata.embedding,
+            false,
+            null,
+            this.url
+        )
+    }
+
+    private async getBatchEmbeddings(texts: string[]): Promise<number[][]> {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
+
+        if (this.useHttpEmbeddings()) {
+            return this.getBatchEmbeddingsOverHttp(texts)
+        }
+
+        const embeddings = await getEmbeddingService().getBatchEmbeddings(
+            texts,
+            this.metadata.embedding,
+            false,
+            null,
+            this.url
+        )
+        if (embeddings.length !== texts.length) {
+            throw new Error(
+                `Expected ${texts.length} embeddings, got ${embeddings.length}`
+            )
+        }
+        return embeddings
+    }
+
+    private async getEmbeddingOverHttp(text: string): Promise<number[]> {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
+
         const baseUrl =
             process.env.NEXT_PUBLIC_BASE_URL || "http://localhost:3000"
         const response = await fetch(`${baseUrl}/api/embeddings`, {
@@ -67,17 +192,60 @@ export class JobProcessor {
         return data.result
     }
 
+    private async getBatchEmbeddingsOverHttp(texts: string[]): Promise<number[][]> {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
+
+        const baseUrl =
+            process.env.NEXT_PUBLIC_BASE_URL || "http://localhost:3000"
+        const response = await fetch(`${baseUrl}/api/embeddings/batch`, {
+            method: "POST",
+            headers: { "Content-Type": "application/json" },
+            body: JSON.stringify({
+                texts,
+                config: this.metadata.embedding,
+            }),
+        })
+
+        if (!response.ok) {
+            // The embeddings route wraps provider errors, so keep its message for status detection
+            let message = response.statusText
+            try {
+                const errorData = await response.json()
+                message = errorData.error || message
+            } catch {
+                // Non-JSON error body
+            }
+            throw new EmbeddingRequestError(
+                `Failed to get batch embeddings: ${message}`,
+                response.status === 500 ? undefined : response.status
+            )
+        }
+
+        const data = await response.json()
+        if (!data.success) {
+            console.error("[JobProcessor] Failed to get batch embeddings:", data.error)
+            throw new Error(`Failed to get batch embeddings: ${data.error}`)
+        }
+
+        if (!Array.isArray(data.result) || data.result.length !== texts.length) {
+            console.error("[JobProcessor] Invalid batch embedding response:", data)
+            throw new Error(
+                "Invalid response from batch embedding API: expected one embedding per input"
+            )
+        }
+
+        return data.result
+    }
+
     private async updateProgress(
         progress: Partial<JobProgress>
     ): Promise<void> {
         try {
-            // Use the JobQueueService's implementation to update progress
-            // This provides a single consistent implementation and avoids duplication
-            await JobQueueService.updateJobProgress(
-                this.url,
-                this.jobId,
-                progress
-            );
+            // Row-level updates are coalesced to a few writes per second;
+            // status changes are written (and published) immediately
+            await this.progressReporter.update(progress)
 
             // If there was a status change, try to emit an event and register for client notification
             if (progress.status && this.metadata?.vectorSetName) {
@@ -94,77 +262,111 @@ export class JobProcessor {
         }
     }
 
-    private async addToRedis(
-        element: string,
-        embedding: number[],
-        attributes?: Record<string, string | number>
-    ): Promise<void> {
+    /**
+     * Writes a whole batch with one pipelined round trip, sending vectors as
+     * FP32 blobs where the server accepts them, and returns how many rows
+     * Redis rejected. The rows that
+     * were added are then marked written, so after a restart they are only
+     * acknowledged; a row written again changes nothing, as VADD with
+     * SETATTR is idempotent.
+     */
+    private async addBatchToRedis(items: PreparedItem[]): Promise<number> {
         if (!this.metadata) {
             throw new Error("Job metadata not loaded")
         }
 
         const vectorSetName = this.metadata.vectorSetName
-
-        // Check if this is the first vector being added (excluding Placeholder (Vector))
-        const countResult = await RedisConnection.withClient(
-            this.url,
-            async (client) => {
-                return await client.sendCommand(["VCARD", vectorSetName])
-            }
-        )
-
-        // Add the new vector first
-        const command = [
-            "VADD",
-            vectorSetName,
-            "VALUES",
-            String(embedding.length),
-            ...embedding.map(String),
-            element,
-        ]
-
-        // Add attributes if they exist
-        if (attributes && Object.keys(attributes).length > 0) {
-            command.push("SETATTR")
-
-            // Convert attributes to JSON string
-            const attributesJson = JSON.stringify(attributes)
-            command.push(attributesJson)
-        }
+        // Removed once a batch has added something, so the set is never left empty.
+        // The checkpoint records it instead of counting elements, which races
+        // with other workers and repeats after a restart.
+        const removePlaceholder = !this.placeholderRemoved
+        // Probed once per node; servers without FP32 take VALUES
+        const { fp32 } = await RedisConnection.getCapabilities(this.url, vectorSetName, { probe: true })
 
         const result = await RedisConnection.withClient(
             this.url,
             async (client) => {
-                await client.sendCommand(command)
-                return true
-            }
+                const commands = items.map((item) => {
+                    const embedding = item.embedding!
+                    const command: (string | Buffer)[] = [
+                        "VADD",
+                        vectorSetName,
+                        ...(fp32
+                            ? ["FP32", vectorToFp32Buffer(embedding)]
+                            : ["VALUES", String(embedding.length), ...embedding.map(String)]),
+                        item.elementId,
+                    ]
+                    if (item.attributes && Object.keys(item.attributes).length > 0) {
+                        command.push("SETATTR", JSON.stringify(item.attributes))
+                    }
+                    return command
+                })
+
+                // One rejected row (wrong dimension, bad attributes) must not
+                // fail the others, so replies are collected per command
+                const replies = await sendPipelined(client, commands)
+                const added = items.filter((_, i) => !(replies[i] instanceof Error))
+                replies.forEach((reply, i) => {
+                    if (reply instanceof Error) {
+                        console.warn(
+                            `[JobProcessor] Failed to add item ${items[i].index + 1}: ${reply.message}`
+                        )
+                    }
+                })
+
+                const followUp: (string | Buffer)[][] = []
+                const streamIds = added
+                    .map((item) => item.streamId)
+                    .filter((id): id is string => !!id)
+                if (streamIds.length > 0) {
+                    followUp.push(["SADD", getJobWrittenKey(this.jobId), ...streamIds])
+                }
+                const placeholderRemoved = removePlaceholder && added.length > 0
+                if (placeholderRemoved) {
+                    followUp.push(
+                        ["VREM", vectorSetName, PLACEHOLDER_ELEMENT],
+                        ["HSET", getJobCheckpointKey(this.jobId), "placeholderRemoved", "1"]
+                    )
+                }
+                if (followUp.length > 0) {
+                    const followUpReplies = await sendPipelined(client, followUp)
+                    const failed = followUpReplies.find((reply) => reply instanceof Error)
+                    if (failed) {
+                        // The rows are in the set; at worst they are written again after a restart
+                        console.error(`[JobProcessor] Failed to record written batch:`, failed)
+                    }
+                }
+
+                return { failed: items.length - added.length, placeholderRemoved }
+            },
+            { lane: "bulk" }
         )
+        invalidateVectorSet(this.url, vectorSetName)
 
-        if (!result.success) {
+        if (!result.success || !result.result) {
             console.error(
-                `[JobProcessor] Failed to add vector to Redis:`,
+                `[JobProcessor] Failed to add batch to Redis:`,
                 result.error
             )
-            throw new Error(`Failed to add vector to Redis: ${result.error}`)
+            throw new Error(`Failed to add batch to Redis: ${result.error}`)
         }
 
-        // If this was the second vector added (count was 1), try to remove the default vector
-        if (countResult.success && countResult.result === 1) {
-            console.log("[JobProcessor] Attempting to remove Placeholder (Vector)")
-            try {
-                await RedisConnection.withClient(
-                    this.url,
-                    async (client) => {
-                        await client.sendCommand(["VREM", vectorSetName, "Placeholder (Vector)"])
-                        console.log("[JobProcessor] Successfully removed Placeholder (Vector)")
-                        return true
-                    }
-                )
-            } catch (error) {
-                // Log but don't throw - this is a best-effort operation
-                console.error("[JobProcessor] Error removing Placeholder (Vector):", error)
-            }
+        if (result.result.placeholderRemoved) {
+            this.placeholderRemoved = true
         }
+        return result.result.failed
+    }
+
+    // Stages freshly computed embeddings before they are written; JSON exports cannot be resumed
+    private async stageEmbeddings(items: PreparedItem[]): Promise<void> {
+        if (this.metadata?.exportType === "json") return
+        await JobQueueService.stageEmbeddings(
+            this.url,
+            this.jobId,
+            items
+                .filter((item) => item.streamId && item.embedding)
+                .map((item) => ({ streamId: item.streamId!, embedding: item.embedding! }))
+        )
     }
 
     private processTemplate(template: string, rowData: CSVRow): string {
@@ -185,14 +387,194 @@ export class JobProcessor {
             throw new Error("Job metadata not loaded")
         }
 
-        const vectorElement = buildVectorElement(elementId, embedding, attributes)
+        const writer = await this.getExportWriter()
+        await writer.append(buildVectorElement(elementId, embedding, attributes))
+    }
+
+    private async getExportWriter(): Promise<VectorExportWriter> {
+        if (!this.metadata?.outputFilename) {
+            throw new Error("Output filename is required for JSON export")
+        }
+        if (!this.exportWriter) {
+            this.exportWriter = await VectorExportWriter.open(
+                this.metadata.outputFilename,
+                resolveExportFormat(this.metadata.outputFilename, this.metadata.exportFormat)
+            )
+        }
+        return this.exportWriter
+    }
+
+    // Resolves a queue item to its element id, text to embed (or pre-computed vector) and attributes
+    private prepareItem(item: JobQueueItem): PreparedItem | { skipReason: string } {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
+
+        let elementId: string
+        let textToEmbed: string | undefined
+        let embedding: number[] | undefined
+
+        // Embedded by an earlier run of this job
+        if (item.stagedEmbedding) {
+            embedding = item.stagedEmbedding
+        }
+
+        // Handle pre-computed vectors from JSON or image files
+        if (!embedding && (this.metadata.fileType === 'json' || this.metadata.fileType === 'image' || this.metadata.fileType === 'images')) {
+            // Check if we have a pre-computed vector
+            if ((item.rowData as any)._vector) {
+                embedding = (item.rowData as any)._vector
+            }
+        }
+
+        // Get the element identifier - either from template or column
+        if (this.metadata.elementTemplate) {
+            elementId = this.processTemplate(
+                this.metadata.elementTemplate,
+                item.rowData
+            )
+        } else {
+            // Get the element identifier from the configured column
+            const elementColumn =
+                this.metadata.elementColumn || "id" // Default to "id" for JSON files
+            elementId = String(item.rowData[elementColumn]) // Ensure string output for element ID
+        }
+
+        if (!elementId) {
+            return { skipReason: "Missing element identifier" }
+        }
+
+        // For files without pre-computed vectors
+        if (!embedding) {
+            // Get the text to embed - either from template or column
+            if (this.metadata.textTemplate) {
+                textToEmbed = this.processTemplate(
+                    this.metadata.textTemplate,
+                    item.rowData
+                )
+            } else {
+                // Get the text to embed from the configured column
+                const textColumn =
+                    this.metadata.textColumn || "text" // Default to "text" for JSON files
+                textToEmbed = String(item.rowData[textColumn]) // Ensure string output for embedding
+            }
+
+            if (!textToEmbed) {
+                return { skipReason: "Missing text to embed" }
+            }
+        }
+
+        // Extract attributes if attribute columns are configured
+        const attributes: Record<string, string | number> = {}
+        if (
+            this.metadata.attributeColumns &&
+            this.metadata.attributeColumns.length > 0
+        ) {
+            this.metadata.attributeColumns.forEach((column: string) => {
+                const value = item.rowData[column]
+                if (value !== undefined) {
+                    // Replace spaces with hyphens in attribute names for query compatibility
+                    const attributeName = column.replace(/\s+/g, '-').toLowerCase() // Also convert to lowercase for consistency
+                    // For attributes, we want to preserve numeric types
+                    attributes[attributeName] = typeof value === 'number'
+                        ? value
+                        : convertToNumericIfPossible(String(value))
+                }
+            })
+        }
+
+        return {
+            index: item.index,
+            streamId: item.streamId,
+            elementId,
+            textToEmbed,
+            embedding,
+            attributes: Object.keys(attributes).length > 0 ? attributes : undefined,
+        }
+    }
+
+    private async finishJob(message: string = "Processing completed"): Promise<void> {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
+
+        // If this was a JSON export job, finish the file the rows were streamed to
+        if (this.metadata.exportType === 'json' && this.metadata.outputFilename) {
+            try {
+                const writer = await this.getExportWriter()
+                const result = await writer.close()
+                this.exportWriter = null
+                console.log(`[JobProcessor] Successfully saved ${result.count} vectors to ${result.filePath}`)
+
+                // Update the progress with the file location
+                await this.updateProgress({
+                    status: "completed",
+                    message: `Export completed. File saved to ${result.filePath}`,
+                })
+            } catch (error) {
+                console.error(`[JobProcessor] Failed to save vectors to JSON:`, error)
+                await this.updateProgress({
+                    status: "failed",
+                    error: error instanceof Error ? error.message : String(error),
+                    message: `Failed to save vectors to JSON: ${error instanceof Error ? error.message : String(error)}`,
+                })
+                throw error
+            }
+        } else {
+            await this.updateProgress({
+                status: "completed",
+                message,
+            })
+        }
+
+        // Create an import log entry before cleaning up the job; bulk edits import nothing
+        if (!this.metadata.bulkEdit) {
+            await this.createImportLogEntry()
+        }
 
-        // Store the vector element in memory until we're ready to save
-        if (!this._vectorElements) {
-            this._vectorElements = []
+        // Notify about the import completing
+        if (this.metadata?.vectorSetName) {
+            // Register the completed job for client polling
+            registerCompletedJob(this.jobId, this.metadata.vectorSetName)
         }
-        this._vectorElements.push(vectorElement)
 
+        // Clean up the job data from Redis
+        await JobQueueService.cleanupJob(this.url, this.jobId)
+    }
+
+    // Waits while paused; returns false if the job was cancelled in the meantime
+    private async waitWhilePaused(): Promise<boolean> {
+        // Check if job was cancelled while paused
+        const progress = await JobQueueService.getJobProgress(
+            this.url,
+            this.jobId
+        )
+        if (!progress || progress.status === "cancelled" || progress.status === "failed") {
+            return false
+        }
+
+        // Resumed through Redis, e.g. by another process that has no handle on
+        // this processor (external workers, several web servers)
+        if (progress.status === "processing") {
+            this.isPaused = false
+            return true
+        }
+
+        await new Promise((resolve) => setTimeout(resolve, 1000))
+        return true
+    }
+
+    private async cleanupOrphanedStatus(): Promise<void> {
+        console.log(
+            `[JobProcessor] Job ${this.jobId} metadata no longer exists but status does, cleaning up orphaned status`
+        )
+        await RedisConnection.withClient(
+            this.url,
+            async (client) => {
+                const statusKey = getJobStatusKey(this.jobId)
+                await client.del(statusKey)
+            }
+        )
     }
 
     public async start(): Promise<void> {
@@ -200,8 +582,15 @@ export class JobProcessor {
             return
         }
 
+        this.running = this.run()
+        return this.running
+    }
+
+    private async run(): Promise<void> {
         this.isRunning = true
         this.isPaused = false
+        this.rowsWritten = 0
+        this.runStartedAt = performance.now()
         this.metadata = await JobQueueService.getJobMetadata(
             this.url,
             this.jobId
@@ -211,273 +600,619 @@ export class JobProcessor {
             console.error(
                 `[JobProcessor] No metadata found for job ${this.jobId}`
             )
+            this.isRunning = false
             throw new Error("Job metadata not found")
         }
 
+        // A JSON export is written, and a bulk edit run, by a single process
+        if (this.metadata.exportType === "json" || this.metadata.bulkEdit) {
+            if (!(await this.renewExportLease())) {
+                console.log(
+                    `[JobProcessor] Job ${this.jobId} is being run by another worker`
+                )
+                this.isRunning = false
+                return
+            }
+        }
+        if (this.metadata.exportType === "json") {
+            // Rows written by an earlier run went to a file that was discarded with it
+            if ((await JobQueueService.ackQueueItems(this.url, this.jobId, [])) > 0) {
+                await this.updateProgress({
+                    status: "failed",
+                    error: "Export was interrupted",
+                    message: "Export was interrupted and cannot be resumed; start it again",
+                })
+                this.isRunning = false
+                return
+            }
+        }
+
+        const checkpoint = await JobQueueService.getJobCheckpoint(this.url, this.jobId)
+        this.placeholderRemoved = checkpoint?.placeholderRemoved ?? false
+
         await this.updateProgress({
             status: "processing",
-            message: "Processing started",
+            message: checkpoint && checkpoint.watermark > 0
+                ? `Processing resumed from row ${checkpoint.watermark + 1}`
+                : "Processing started",
         })
 
         try {
-            while (this.isRunning) {
-                // Check if job is paused
-                if (this.isPaused) {
-
-                    // Check if job was cancelled while paused
-                    const progress = await JobQueueService.getJobProgress(
-                        this.url,
-                        this.jobId
-                    )
-                    if (!progress || progress.status === "cancelled") {
-                        this.isRunning = false
-                        break
-                    }
+            if (this.metadata.bulkEdit) {
+                await this.processBulkEdit()
+            } else if ((this.metadata.batchSize || 1) > 1 || (this.metadata.concurrency || 1) > 1) {
+                await this.processBatches()
+            } else {
+                await this.processItems()
+            }
+        } catch (error) {
+            const errorMessage =
+                error instanceof Error ? error.message : String(error)
+            console.error(`[JobProcessor] Job processing error:`, error)
+            await this.updateProgress({
+                status: "failed",
+                error: errorMessage,
+                message: `Job failed: ${errorMessage}`,
+            })
+        } finally {
+            // An export that did not finish leaves no file behind
+            if (this.exportWriter) {
+                await this.exportWriter.abort().catch((error) =>
+                    console.error(`[JobProcessor] Failed to discard partial export:`, error)
+                )
+                this.exportWriter = null
+            }
+            // Status changes were written as they happened; a late row count
+            // must not recreate the status key of a job that was removed
+            this.progressReporter.discard()
+            clearImportJob(this.jobId)
+            console.log(`[JobProcessor] Job ${this.jobId} finished`)
+            this.isRunning = false
+        }
+    }
 
-                    await new Promise((resolve) => setTimeout(resolve, 1000))
-                    continue
-                }
+    private async renewExportLease(): Promise<boolean> {
+        return JobQueueService.acquireExportLease(
+            this.url,
+            this.jobId,
+            this.consumer,
+            EXPORT_LEASE_TTL_MS
+        )
+    }
 
-                const item = await JobQueueService.getNextQueueItem(
-                    this.url,
-                    this.jobId
-                )
-                if (!item) {
-                    // If this was a JSON export job, save the collected vectors
-                    if (this.metadata.exportType === 'json' && this.metadata.outputFilename) {
-                        try {
-                            console.log(`[JobProcessor] Starting JSON export of ${this._vectorElements.length} vectors to ${this.metadata.outputFilename}`)
-                            const result = await saveVectorData(this.metadata.outputFilename, this._vectorElements)
-                            console.log(`[JobProcessor] Successfully saved vectors to ${result.filePath}`)
-
-                            // Update the progress with the file location
-                            await this.updateProgress({
-                                status: "completed",
-                                message: `Export completed. File saved to ${result.filePath}`,
-                            })
-                        } catch (error) {
-                            console.error(`[JobProcessor] Failed to save vectors to JSON:`, error)
-                            await this.updateProgress({
-                                status: "failed",
-                                error: error instanceof Error ? error.message : String(error),
-                                message: `Failed to save vectors to JSON: ${error instanceof Error ? error.message : String(error)}`,
-                            })
-                            throw error
-                        }
-                    } else {
-                        await this.updateProgress({
-                            status: "completed",
-                            message: "Processing completed",
-                        })
-                    }
+    // Claims up to `count` rows from the job's stream for this processor
+    private async claimItems(count: number): Promise<JobQueueItem[]> {
+        if (this.metadata?.exportType === "json" && !(await this.renewExportLease())) {
+            console.warn(`[JobProcessor] Lost the export lease for job ${this.jobId}, stopping`)
+            this.isRunning = false
+            return []
+        }
 
-                    // Create an import log entry before cleaning up the job
-                    await this.createImportLogEntry()
+        const { items, source } = await JobQueueService.claimQueueItems(
+            this.url,
+            this.jobId,
+            this.consumer,
+            count,
+            this.recoveringOwn,
+            this.takingOver ? 0 : undefined
+        )
+        if (source !== "recovered") {
+            this.recoveringOwn = false
+        }
+        if (source === "new" || source === "none") {
+            this.takingOver = false
+        }
 
-                    // Notify about the import completing
-                    if (this.metadata?.vectorSetName) {
-                        // Register the completed job for client polling
-                        registerCompletedJob(this.jobId, this.metadata.vectorSetName)
-                    }
+        // A slow batch of our own can look idle and be handed back to us;
+        // it is already being worked on
+        const claimed = items.filter((item) => !this.claimedIds.has(item.streamId!))
+        claimed.forEach((item) => this.claimedIds.add(item.streamId!))
+        if (claimed.length > 0 && source !== "new") {
+            console.log(
+                `[JobProcessor] ${source === "recovered" ? "Recovered" : "Took over"} ${claimed.length} unacknowledged rows of job ${this.jobId}`
+            )
+            return this.applyRowCheckpoints(claimed)
+        }
+        return claimed
+    }
 
-                    // Clean up the job data from Redis
-                    await JobQueueService.cleanupJob(this.url, this.jobId)
+    /**
+     * Rows left by an earlier run: those it had already written are only
+     * acknowledged, the others get back the embeddings it had staged.
+     */
+    private async applyRowCheckpoints(items: JobQueueItem[]): Promise<JobQueueItem[]> {
+        if (this.metadata?.exportType === "json") {
+            return items
+        }
 
-                    break
+        const { written, staged } = await JobQueueService.getRowCheckpoints(
+            this.url,
+            this.jobId,
+            items.map((item) => item.streamId!)
+        )
+
+        const done = items.filter((item) => written.has(item.streamId!))
+        if (done.length > 0) {
+            await this.updateProgress({
+                current: await this.ackItems(done),
+                message: `Skipped ${done.length} rows written before the job was interrupted`,
+            })
+        }
+
+        const remaining = items.filter((item) => !written.has(item.streamId!))
+        remaining.forEach((item) => {
+            item.stagedEmbedding = staged.get(item.streamId!)
+        })
+        if (staged.size > 0) {
+            console.log(
+                `[JobProcessor] Reusing ${staged.size} staged embeddings of job ${this.jobId}`
+            )
+        }
+        return remaining
+    }
+
+    // Acknowledges finished rows; returns the job's processed row count
+    private async ackItems(items: JobQueueItem[]): Promise<number> {
+        const processed = await JobQueueService.ackQueueItems(this.url, this.jobId, items)
+        items.forEach((item) => item.streamId && this.claimedIds.delete(item.streamId))
+        return processed
+    }
+
+    /**
+     * Called when no row could be claimed. Keeps the loop going while rows
+     * may still arrive or are held by other workers (they are taken over if
+     * those workers died). Otherwise the job is done: the first worker to
+     * get here finishes it, and false is returned to end the loop.
+     */
+    private async waitForQueuedRows(ingestActive: boolean): Promise<boolean> {
+        if (!this.isRunning) {
+            return false
+        }
+
+        // A streaming upload may still be enqueueing rows
+        if (ingestActive) {
+            await new Promise((resolve) => setTimeout(resolve, 250))
+            return true
+        }
+
+        if (await JobQueueService.hasQueuedRows(this.url, this.jobId)) {
+            await new Promise((resolve) => setTimeout(resolve, 1000))
+            return true
+        }
+
+        if (await JobQueueService.claimJobFinish(this.url, this.jobId, this.consumer)) {
+            await this.finishJob()
+        }
+        this.isRunning = false
+        return false
+    }
+
+    /**
+     * Stops this processor without changing the job's status, e.g. when the
+     * worker process shuts down. Rows it had claimed but not finished stay
+     * pending, and are recovered by this consumer after a restart or taken
+     * over by another worker.
+     */
+    public async shutdown(): Promise<void> {
+        this.isRunning = false
+        await this.running?.catch(() => {})
+    }
+
+    // True until the processor's loop has ended
+    public get active(): boolean {
+        return this.isRunning
+    }
+
+    private recordRowsWritten(rows: number): void {
+        this.rowsWritten += rows
+        const elapsedSeconds = (performance.now() - this.runStartedAt) / 1000
+        recordImportRows(
+            this.jobId,
+            rows,
+            elapsedSeconds > 0 ? this.rowsWritten / elapsedSeconds : 0
+        )
+    }
+
+    // Bulk edits page through the vector set instead of reading queued rows
+    private async processBulkEdit(): Promise<void> {
+        if (!this.metadata?.bulkEdit) {
+            throw new Error("Job is not a bulk edit")
+        }
+
+        const runner = await BulkEditRunner.load(
+            this.url,
+            this.jobId,
+            this.metadata.vectorSetName,
+            this.metadata.bulkEdit
+        )
+        const total = this.metadata.total
+
+        while (this.isRunning && !runner.state.done) {
+            const control = await JobQueueService.getJobControlState(
+                this.url,
+                this.jobId
+            )
+            if (!control.statusExists) {
+                this.isRunning = false
+                break
+            }
+            if (!control.metadataExists) {
+                await this.cleanupOrphanedStatus()
+                this.isRunning = false
+                break
+            }
+            if (
+                !control.progress ||
+                control.progress.status === "cancelled" ||
+                control.progress.status === "failed"
+            ) {
+                this.isRunning = false
+                break
+            }
+            if (control.progress.status === "paused") {
+                if (!(await this.waitWhilePaused())) {
+                    this.isRunning = false
                 }
+                continue
+            }
+            if (!(await this.renewExportLease())) {
+                console.warn(`[JobProcessor] Lost the lease for bulk edit ${this.jobId}, stopping`)
+                this.isRunning = false
+                break
+            }
 
-                // Check if job status exists and if the job itself still exists
-                const statusExists = await RedisConnection.withClient(
-                    this.url,
-                    async (client) => {
-                        const statusKey = getJobStatusKey(this.jobId)
-                        return await client.exists(statusKey)
-                    }
-                )
+            const state = await runner.step()
+            // Elements added since the job started can take the scan past its total
+            await this.updateProgress({
+                current: state.scanned,
+                total: Math.max(total, state.scanned),
+                message: describeBulkEditState(state),
+            })
+        }
+
+        if (this.isRunning && runner.state.done) {
+            await this.finishJob(`Bulk edit completed. ${describeBulkEditState(runner.state)}`)
+            this.isRunning = false
+        }
+    }
 
-                if (!statusExists) {
+    // Row-by-row processing, used when the job has no batch size configured
+    private async processItems(): Promise<void> {
+        while (this.isRunning && this.metadata) {
+            // Check if job is paused
+            if (this.isPaused) {
+                if (!(await this.waitWhilePaused())) {
                     this.isRunning = false
                     break
                 }
+                continue
+            }
 
-                // Check if job metadata still exists
-                const jobMetadata = await JobQueueService.getJobMetadata(
-                    this.url,
-                    this.jobId
-                )
+            // Check that the job still exists and was not cancelled or paused
+            // before claiming a row, so a claimed row is always worked on
+            const control = await JobQueueService.getJobControlState(
+                this.url,
+                this.jobId
+            )
+            if (!control.statusExists) {
+                this.isRunning = false
+                break
+            }
+            if (!control.metadataExists) {
+                await this.cleanupOrphanedStatus()
+                this.isRunning = false
+                break
+            }
+            if (
+                !control.progress ||
+                control.progress.status === "cancelled" ||
+                control.progress.status === "failed"
+            ) {
+                this.isRunning = false
+                break
+            }
+            if (control.progress.status === "paused") {
+                this.isPaused = true
+                continue
+            }
 
-                // If status exists but job metadata doesn't, clean up the orphaned status key
-                if (!jobMetadata) {
-                    console.log(
-                        `[JobProcessor] Job ${this.jobId} metadata no longer exists but status does, cleaning up orphaned status`
-                    )
-                    await RedisConnection.withClient(
-                        this.url,
-                        async (client) => {
-                            const statusKey = getJobStatusKey(this.jobId)
-                            await client.del(statusKey)
-                        }
-                    )
-                    this.isRunning = false
+            const [item] = await this.claimItems(1)
+            if (!item) {
+                if (!(await this.waitForQueuedRows(control.ingestActive))) {
                     break
                 }
+                continue
+            }
+
+            try {
+                const prepared = this.prepareItem(item)
+
+                if ("skipReason" in prepared) {
+                    console.warn(
+                        `[JobProcessor] Skipping item ${item.index + 1
+                        }: ${prepared.skipReason}`
+                    )
+                    await this.updateProgress({
+                        current: await this.ackItems([item]),
+                        message: `Skipped item ${item.index + 1
+                            }: ${prepared.skipReason}`,
+                    })
+                    continue
+                }
+
+                if (!prepared.embedding) {
+                    prepared.embedding = await this.getEmbedding(prepared.textToEmbed!)
+                    await this.stageEmbeddings([prepared])
+                }
+
+                // Choose between Redis and JSON export
+                if (this.metadata.exportType === 'json') {
+                    console.log(`[JobProcessor] Exporting to JSON: ${prepared.elementId}`)
+                    await this.processToJson(prepared.elementId, prepared.embedding, prepared.attributes)
+                } else {
+                    console.log(`[JobProcessor] Adding to Redis: ${prepared.elementId}`)
+                    if ((await this.addBatchToRedis([prepared])) > 0) {
+                        throw new Error("Failed to add vector to Redis")
+                    }
+                }
+                this.recordRowsWritten(1)
 
-                // Check if job was cancelled or paused
-                const progress = await JobQueueService.getJobProgress(
-                    this.url,
-                    this.jobId
+                // Update progress
+                await this.updateProgress({
+                    current: await this.ackItems([item]),
+                    message: `Processed item ${item.index + 1}`,
+                })
+            } catch (error) {
+                const errorMessage =
+                    error instanceof Error ? error.message : String(error)
+                console.error(
+                    `[JobProcessor] Error processing item ${item.index + 1
+                    }:`,
+                    error
                 )
-                if (!progress) {
-                    this.isRunning = false
-                    break
+                // Failed rows are reported, not retried
+                await this.updateProgress({
+                    current: await this.ackItems([item]),
+                    message: `Error processing item ${item.index + 1
+                        }: ${errorMessage}`,
+                })
+                // Continue with next item after error
+                await new Promise((resolve) => setTimeout(resolve, 1000))
+            }
+        }
+    }
+
+    // Batched processing: control state is checked, rows are embedded and
+    // written once per batch rather than once per row. Up to `concurrency`
+    // batches are embedded at the same time, while writes and progress updates
+    // are applied strictly in queue order. The batch shrinks when a step
+    // overruns the time budget so pause/cancel stay responsive.
+    private async processBatches(): Promise<void> {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
+
+        const maxBatchSize = Math.max(1, this.metadata.batchSize || 1)
+        const timeBudgetMs =
+            this.metadata.batchTimeBudgetMs || DEFAULT_JOB_BATCH_TIME_BUDGET_MS
+        const concurrency = Math.max(1, this.metadata.concurrency || 1)
+        const limiter = new AdaptiveConcurrencyLimiter(concurrency)
+        let batchSize = maxBatchSize
+
+        // Embedded batches waiting for their turn to be written, keyed by sequence
+        const inFlight = new Map<number, Promise<void>>()
+        const completed = new Map<number, EmbeddedBatch>()
+        // Stop pulling rows while this many batches are embedded but not yet written
+        const maxPendingBatches = concurrency * 2
+        let nextSeq = 0
+        let nextWriteSeq = 0
+
+        const flush = async () => {
+            while (completed.has(nextWriteSeq)) {
+                const batch = completed.get(nextWriteSeq)!
+                completed.delete(nextWriteSeq)
+                nextWriteSeq++
+
+                await this.writeBatch(batch)
+
+                if (batch.durationMs > timeBudgetMs && batchSize > 1) {
+                    batchSize = Math.max(1, Math.floor(batchSize / 2))
+                } else if (batch.durationMs < timeBudgetMs / 2 && batchSize < maxBatchSize) {
+                    batchSize = Math.min(maxBatchSize, batchSize * 2)
                 }
+            }
+        }
 
-                if (progress.status === "cancelled") {
+        const drain = async () => {
+            await Promise.all(Array.from(inFlight.values()))
+            await flush()
+        }
+
+        while (this.isRunning) {
+            await flush()
+
+            if (this.isPaused) {
+                // Finish what was already pulled from the queue before idling
+                await drain()
+                if (!(await this.waitWhilePaused())) {
                     this.isRunning = false
                     break
-                } else if (progress.status === "paused") {
-                    this.isPaused = true
+                }
+                continue
+            }
+
+            // Backpressure: wait for a slot before pulling more rows
+            if (
+                inFlight.size > 0 &&
+                (inFlight.size >= limiter.limit ||
+                    inFlight.size + completed.size >= maxPendingBatches)
+            ) {
+                await Promise.race(Array.from(inFlight.values()))
+                continue
+            }
+
+            const control = await JobQueueService.getJobControlState(
+                this.url,
+                this.jobId
+            )
+            if (!control.statusExists) {
+                this.isRunning = false
+                break
+            }
+            if (!control.metadataExists) {
+                await this.cleanupOrphanedStatus()
+                this.isRunning = false
+                break
+            }
+            if (
+                !control.progress ||
+                control.progress.status === "cancelled" ||
+                control.progress.status === "failed"
+            ) {
+                this.isRunning = false
+                break
+            }
+            if (control.progress.status === "paused") {
+                this.isPaused = true
+                continue
+            }
+
+            const items = await this.claimItems(batchSize)
+            if (items.length === 0) {
+                // Our own batches are written (and acknowledged) before deciding
+                // whether the job is done
+                if (inFlight.size > 0) {
+                    await Promise.race(Array.from(inFlight.values()))
                     continue
                 }
+                await flush()
+                if (!(await this.waitForQueuedRows(control.ingestActive))) {
+                    break
+                }
+                continue
+            }
 
-                try {
-                    let elementId: string
-                    let textToEmbed: string
-                    let embedding: number[] | undefined
+            const seq = nextSeq++
+            inFlight.set(
+                seq,
+                this.embedBatch(items, limiter)
+                    .then((batch) => {
+                        completed.set(seq, batch)
+                    })
+                    .finally(() => {
+                        inFlight.delete(seq)
+                    })
+            )
+        }
 
-                    // Handle pre-computed vectors from JSON or image files
-                    if (this.metadata.fileType === 'json' || this.metadata.fileType === 'image' || this.metadata.fileType === 'images') {
-                        // Check if we have a pre-computed vector
-                        if ((item.rowData as any)._vector) {
-                            embedding = (item.rowData as any)._vector
-                        }
-                    }
+        // Cancelled or removed: let outstanding requests settle without writing them
+        await Promise.allSettled(Array.from(inFlight.values()))
+    }
 
-                    // Get the element identifier - either from template or column
-                    if (this.metadata.elementTemplate) {
-                        elementId = this.processTemplate(
-                            this.metadata.elementTemplate,
-                            item.rowData
-                        )
-                    } else {
-                        // Get the element identifier from the configured column
-                        const elementColumn =
-                            this.metadata.elementColumn || "id" // Default to "id" for JSON files
-                        elementId = String(item.rowData[elementColumn]) // Ensure string output for element ID
-                    }
+    // Prepares and embeds one batch. Never rejects; failures are reported on the result
+    private async embedBatch(
+        items: JobQueueItem[],
+        limiter: AdaptiveConcurrencyLimiter
+    ): Promise<EmbeddedBatch> {
+        const startTime = performance.now()
+        const prepared: PreparedItem[] = []
+        let skipped = 0
+
+        try {
+            for (const item of items) {
+                const result = this.prepareItem(item)
+                if ("skipReason" in result) {
+                    console.warn(
+                        `[JobProcessor] Skipping item ${item.index + 1}: ${result.skipReason}`
+                    )
+                    skipped++
+                    continue
+                }
+                prepared.push(result)
+            }
 
-                    if (!elementId) {
+            // Embed every row without a pre-computed vector in one request
+            const pending = prepared.filter((item) => !item.embedding)
+            if (pending.length > 0) {
+                const texts = pending.map((item) => item.textToEmbed!)
+                let embeddings: number[][] | null = null
+
+                for (let attempt = 0; embeddings === null; attempt++) {
+                    await limiter.waitForBackoff()
+                    try {
+                        embeddings = await this.getBatchEmbeddings(texts)
+                        limiter.onSuccess()
+                    } catch (error) {
+                        if (!isThrottleError(error) || attempt >= MAX_THROTTLE_RETRIES) {
+                            throw error
+                        }
+                        limiter.onThrottle()
                         console.warn(
-                            `[JobProcessor] Skipping item ${item.index + 1
-                            }: Element identifier not found`
+                            `[JobProcessor] Embedding provider throttled (attempt ${attempt + 1}), concurrency now ${limiter.limit}`
                         )
-                        await this.updateProgress({
-                            current: item.index + 1,
-                            message: `Skipped item ${item.index + 1
-                                }: Missing element identifier`,
-                        })
-                        continue
                     }
+                }
 
-                    // For files without pre-computed vectors
-                    if (!embedding) {
-                        // Get the text to embed - either from template or column
-                        if (this.metadata.textTemplate) {
-                            textToEmbed = this.processTemplate(
-                                this.metadata.textTemplate,
-                                item.rowData
-                            )
-                        } else {
-                            // Get the text to embed from the configured column
-                            const textColumn =
-                                this.metadata.textColumn || "text" // Default to "text" for JSON files
-                            textToEmbed = String(item.rowData[textColumn]) // Ensure string output for embedding
-                        }
+                pending.forEach((item, i) => {
+                    item.embedding = embeddings![i]
+                })
+                await this.stageEmbeddings(pending)
+            }
 
-                        if (!textToEmbed) {
-                            console.warn(
-                                `[JobProcessor] Skipping item ${item.index + 1
-                                }: Text to embed not found`
-                            )
-                            await this.updateProgress({
-                                current: item.index + 1,
-                                message: `Skipped item ${item.index + 1
-                                    }: Missing text to embed`,
-                            })
-                            continue
-                        }
+            return { items, prepared, skipped, durationMs: performance.now() - startTime }
+        } catch (error) {
+            return {
+                items,
+                prepared: [],
+                skipped,
+                durationMs: performance.now() - startTime,
+                error: error instanceof Error ? error.message : String(error),
+            }
+        }
+    }
 
-                        embedding = await this.getEmbedding(textToEmbed)
-                    }
+    private async writeBatch(batch: EmbeddedBatch): Promise<void> {
+        if (!this.metadata) {
+            throw new Error("Job metadata not loaded")
+        }
 
-                    // Extract attributes if attribute columns are configured
-                    const attributes: Record<string, string | number> = {}
-                    if (
-                        this.metadata?.attributeColumns &&
-                        this.metadata.attributeColumns.length > 0
-                    ) {
-                        this.metadata.attributeColumns.forEach((column: string) => {
-                            const value = item.rowData[column]
-                            if (value !== undefined) {
-                                // Replace spaces with hyphens in attribute names for query compatibility
-                                const attributeName = column.replace(/\s+/g, '-').toLowerCase() // Also convert to lowercase for consistency
-                                // For attributes, we want to preserve numeric types
-                                attributes[attributeName] = typeof value === 'number' 
-                                    ? value 
-                                    : convertToNumericIfPossible(String(value))
-                            }
-                        })
-                        console.log(
-                            `[JobProcessor] Extracted attributes with normalized names:`,
-                            attributes
-                        )
-                    }
+        const first = batch.items[0].index + 1
+        const last = batch.items[batch.items.length - 1].index + 1
 
-                    // Choose between Redis and JSON export
-                    if (this.metadata.exportType === 'json') {
-                        console.log(`[JobProcessor] Exporting to JSON: ${elementId}`)
-                        await this.processToJson(elementId, embedding, Object.keys(attributes).length > 0 ? attributes : undefined)
-                    } else {
-                        console.log(`[JobProcessor] Adding to Redis: ${elementId}`)
-                        await this.addToRedis(elementId, embedding, Object.keys(attributes).length > 0 ? attributes : undefined)
-                    }
+        try {
+            if (batch.error) {
+                throw new Error(batch.error)
+            }
 
-                    // Update progress
-                    await this.updateProgress({
-                        current: item.index + 1,
-                        message: `Processed item ${item.index + 1}`,
-                    })
-                } catch (error) {
-                    const errorMessage =
-                        error instanceof Error ? error.message : String(error)
-                    console.error(
-                        `[JobProcessor] Error processing item ${item.index + 1
-                        }:`,
-                        error
-                    )
-                    await this.updateProgress({
-                        current: item.index + 1,
-                        message: `Error processing item ${item.index + 1
-                            }: ${errorMessage}`,
-                    })
-                    // Continue with next item after error
-                    await new Promise((resolve) => setTimeout(resolve, 1000))
+            let failed = 0
+            if (batch.prepared.length > 0) {
+                if (this.metadata.exportType === 'json') {
+                    for (const item of batch.prepared) {
+                        await this.processToJson(item.elementId, item.embedding!, item.attributes)
+                    }
+                } else {
+                    failed = await this.addBatchToRedis(batch.prepared)
                 }
             }
+
+            const processed = batch.prepared.length - failed
+            this.recordRowsWritten(processed)
+            await this.updateProgress({
+                current: await this.ackItems(batch.items),
+                message: `Processed items ${first}-${last} (${processed} added${batch.skipped ? `, ${batch.skipped} skipped` : ""}${failed ? `, ${failed} failed` : ""})`,
+            })
         } catch (error) {
             const errorMessage =
                 error instanceof Error ? error.message : String(error)
-            console.error(`[JobProcessor] Job processing error:`, error)
+            console.error(
+                `[JobProcessor] Error processing items ${first}-${last}:`,
+                errorMessage
+            )
+            // Failed rows are reported, not retried
             await this.updateProgress({
-                status: "failed",
-                error: errorMessage,
-                message: `Job failed: ${errorMessage}`,
+                current: await this.ackItems(batch.items),
+                message: `Error processing items ${first}-${last}: ${errorMessage}`,
             })
-        } finally {
-            // Clear the vector elements array
-            this._vectorElements = []
-            console.log(`[JobProcessor] Job ${this.jobId} finished`)
-            this.isRunning = false
         }
     }
 
@@ -2,17 +2,103 @@ import { ImportJobConfig } from "@/app/api/jobs"
 import { EmbeddingConfig } from "@/lib/embeddings/types/embeddingModels"
 
 import {
+    BulkEditSpec,
     CSVJobMetadata,
     CSVRow,
+    DEFAULT_JOB_BATCH_SIZE,
+    DEFAULT_JOB_BATCH_TIME_BUDGET_MS,
+    DEFAULT_JOB_CONCURRENCY,
+    JOB_CONSUMER_GROUP,
+    JOB_EVENTS_CHANNEL,
+    JOBS_ACTIVE_KEY,
+    JobCheckpoint,
+    JobControlState,
     JobProgress,
+    JobProgressEvent,
     JobQueueItem,
+    getJobBulkEditKey,
+    getJobCheckpointKey,
+    getJobExportLeaseKey,
+    getJobFinishKey,
+    getJobIngestKey,
     getJobMetadataKey,
     getJobQueueKey,
+    getJobStagedKey,
     getJobStatusKey,
+    getJobStreamKey,
+    getJobWrittenKey,
 } from "@/lib/types/jobs"
 import { parse } from "csv-parse/sync"
 import { v4 as uuidv4 } from "uuid"
 import { RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { fp32BufferToVector, vectorToFp32Buffer } from "@/lib/redis-server/utils"
+import { parseCSVStream, parseJSONStream } from "@/lib/imports/streamParsers"
+import { describeBulkEdit } from "./bulk-edit"
+import { compileFilter } from "./filter-expression"
+
+// Streaming imports push rows to the queue in chunks of this size
+const STREAM_CHUNK_SIZE = 500
+// Parsing pauses while the queue holds more rows than this, keeping Redis memory bounded
+const STREAM_QUEUE_HIGH_WATER = 20000
+// The ingest marker expires if the uploading process dies mid-stream; while the
+// upload is being read it is refreshed on a timer, however slowly the client sends
+const STREAM_INGEST_TTL_SECONDS = 60
+const STREAM_INGEST_REFRESH_MS = (STREAM_INGEST_TTL_SECONDS * 1000) / 3
+// Rows a worker has held this long without acknowledging them are taken over
+// by other workers; the worker is assumed to have died
+const JOB_CLAIM_IDLE_MS = Number(process.env.JOB_CLAIM_IDLE_MS) || 5 * 60 * 1000
+
+// Where the rows returned by claimQueueItems came from
+export type ClaimSource = "recovered" | "reclaimed" | "new" | "none"
+
+type StreamEntry = { id: string; message: Record<string, string> }
+
+// Converts one object from a JSON import into a queue record
+function jsonItemToRecord(item: any, index: number): CSVRow {
+    // If the item has a vector property, store it for later use
+    const vector = item.vector || item.embedding
+    const record: CSVRow = {
+        id: item.id || String(index),
+        text: item.text || '',
+        ...item // Include all other properties as attributes
+    }
+
+    if (vector) {
+        // Store the vector directly in the record for later use
+        ; (record as any)._vector = vector
+    }
+
+    return record
+}
+
+// Select appropriate columns based on options or defaults
+function resolveColumns(
+    options: ImportJobConfig,
+    availableColumns: string[]
+): { elementColumn: string; textColumn: string } {
+    const elementColumn =
+        options?.elementColumn ||
+        (availableColumns.includes("title")
+            ? "title"
+            : availableColumns[0] || "title")
+
+    const textColumn =
+        options?.textColumn ||
+        (availableColumns.includes("plot_synopsis")
+            ? "plot_synopsis"
+            : availableColumns.length > 1
+                ? availableColumns[1]
+                : "plot_synopsis")
+
+    return { elementColumn, textColumn }
+}
+
+// JSON imports default to every field except id, text and vectors as attributes
+function defaultJsonAttributeColumns(availableColumns: string[]): string[] {
+    return availableColumns.filter(col =>
+        col !== 'id' && col !== 'text' && col !== 'vector' && col !== 'embedding' && !col.startsWith('_')
+    )
+}
 
 export class JobQueueService {
     public static async updateJobProgress(
@@ -30,8 +116,11 @@ export class JobQueueService {
                 timestamp: Date.now(),
             }
 
-            // Get current status
-            const currentStatus = await client.hGetAll(statusKey)
+            // Get current status, and the vector set name for the progress event
+            const [currentStatus, metadataData] = await Promise.all([
+                client.hGetAll(statusKey),
+                client.hGet(getJobMetadataKey(jobId), "data"),
+            ])
 
             // If we have existing data, parse it
             if (currentStatus?.data) {
@@ -48,6 +137,11 @@ export class JobQueueService {
                 }
             }
 
+            // Streaming imports keep the growing row count in its own field
+            if (currentStatus?.streamedTotal) {
+                currentProgress.total = Number(currentStatus.streamedTotal)
+            }
+
             // Update with new values
             const updatedProgress: JobProgress = {
                 ...currentProgress,
@@ -55,8 +149,20 @@ export class JobQueueService {
                 timestamp: Date.now(),
             }
 
-            // Store the updated progress
-            await client.hSet(statusKey, { data: JSON.stringify(updatedProgress) })
+            // Store the updated progress and push it to /api/jobs/events subscribers
+            let vectorSetName: string | undefined
+            try {
+                vectorSetName = metadataData
+                    ? (JSON.parse(metadataData) as CSVJobMetadata).vectorSetName
+                    : undefined
+            } catch {
+                // Metadata is unreadable; publish without the vector set name
+            }
+            const event: JobProgressEvent = { ...updatedProgress, jobId, vectorSetName }
+            await Promise.all([
+                client.hSet(statusKey, { data: JSON.stringify(updatedProgress) }),
+                client.publish(JOB_EVENTS_CHANNEL, JSON.stringify(event)),
+            ])
             return updatedProgress;
         })
 
@@ -122,31 +228,14 @@ export class JobQueueService {
             const dataArray = Array.isArray(jsonData) ? jsonData : [jsonData]
 
             // Convert JSON objects to records
-            records = dataArray.map((item, index) => {
-                // If the item has a vector property, store it for later use
-                const vector = item.vector || item.embedding
-                const record: CSVRow = {
-                    id: item.id || String(index),
-                    text: item.text || '',
-                    ...item // Include all other properties as attributes
-                }
-
-                if (vector) {
-                    // Store the vector directly in the record for later use
-                    ; (record as any)._vector = vector
-                }
-
-                return record
-            })
+            records = dataArray.map(jsonItemToRecord)
 
             // Get all unique keys from the first record for columns
             availableColumns = records.length > 0 ? Object.keys(records[0]) : []
 
             // Update attribute columns to include all fields except id, text, and vector
             if (!options.attributeColumns || options.attributeColumns.length === 0) {
-                options.attributeColumns = availableColumns.filter(col =>
-                    col !== 'id' && col !== 'text' && col !== 'vector' && col !== 'embedding' && !col.startsWith('_')
-                )
+                options.attributeColumns = defaultJsonAttributeColumns(availableColumns)
             }
         }
         else if (fileType === "image" || fileType === "images") {
@@ -189,20 +278,7 @@ export class JobQueueService {
             }
         }
 
-        // Select appropriate columns based on options or defaults
-        const elementColumn =
-            options?.elementColumn ||
-            (availableColumns.includes("title")
-                ? "title"
-                : availableColumns[0] || "title")
-
-        const textColumn =
-            options?.textColumn ||
-            (availableColumns.includes("plot_synopsis")
-                ? "plot_synopsis"
-                : availableColumns.length > 1
-                    ? availableColumns[1]
-                    : "plot_synopsis")
+        const { elementColumn, textColumn } = resolveColumns(options, availableColumns)
 
         const response = await RedisConnection.withClient(
             url,
@@ -225,6 +301,12 @@ export class JobQueueService {
                     fileType,
                     exportType,
                     outputFilename: options?.outputFilename,
+                    exportFormat: options?.exportFormat,
+                    batchSize: options?.batchSize ?? DEFAULT_JOB_BATCH_SIZE,
+                    batchTimeBudgetMs:
+                        options?.batchTimeBudgetMs ??
+                        DEFAULT_JOB_BATCH_TIME_BUDGET_MS,
+                    concurrency: options?.concurrency ?? DEFAULT_JOB_CONCURRENCY,
                 }
                 await client.hSet(getJobMetadataKey(jobId), {
                     data: JSON.stringify(metadata),
@@ -241,19 +323,26 @@ export class JobQueueService {
                     data: JSON.stringify(initialProgress),
                 })
 
-                // Add records to job queue
-                const queueKey = getJobQueueKey(jobId)
-                for (let i = 0; i < records.length; i++) {
-                    const item: JobQueueItem = {
-                        jobId,
-                        rowData: records[i],
-                        index: i,
-                    }
-                    await client.rPush(queueKey, JSON.stringify(item))
+                // Add records to the job's stream in pipelined chunks, then
+                // register the job so workers in any process pick it up
+                const streamKey = getJobStreamKey(jobId)
+                await client.xGroupCreate(streamKey, JOB_CONSUMER_GROUP, "0", { MKSTREAM: true })
+                for (let start = 0; start < records.length; start += STREAM_CHUNK_SIZE) {
+                    const chunk = records.slice(start, start + STREAM_CHUNK_SIZE)
+                    await Promise.all(chunk.map((rowData, offset) => {
+                        const item: JobQueueItem = {
+                            jobId,
+                            rowData,
+                            index: start + offset,
+                        }
+                        return client.xAdd(streamKey, "*", { item: JSON.stringify(item) })
+                    }))
                 }
+                await client.sAdd(JOBS_ACTIVE_KEY, jobId)
 
                 return jobId
-            }
+            },
+            { lane: "bulk" }
         )
 
         if (!response.success) {
@@ -266,6 +355,344 @@ export class JobQueueService {
         return response.result as string
     }
 
+    /**
+     * Creates a job that deletes or re-attributes every element matching a
+     * filter. It has no rows to queue: the processor pages through the set
+     * itself, and the set's size at creation is the progress total.
+     */
+    public static async createBulkEditJob(
+        url: string,
+        vectorSetName: string,
+        spec: BulkEditSpec
+    ): Promise<string> {
+        // Reject a filter that does not parse before anything is written
+        if (spec.filter?.trim()) {
+            compileFilter(spec.filter)
+        }
+        if (spec.action.type === "setattr" && (!spec.action.attributes || typeof spec.action.attributes !== "object")) {
+            throw new Error("Attributes to set must be an object")
+        }
+
+        const capabilities = await RedisConnection.getCapabilities(url, vectorSetName, { probe: true })
+        // Unprobed servers are left to fail on the first page instead
+        if (capabilities.probed && !capabilities.vrange) {
+            throw new Error("Bulk edits need VRANGE, available from Redis 8.2")
+        }
+
+        const jobId = uuidv4()
+        const response = await RedisConnection.withClient(url, async (client) => {
+            const total = Number(await client.sendCommand(["VCARD", vectorSetName]))
+            if (!total) {
+                throw new Error(`Vector set "${vectorSetName}" not found`)
+            }
+
+            const metadata: CSVJobMetadata = {
+                jobId,
+                filename: describeBulkEdit(spec),
+                vectorSetName,
+                embedding: { provider: "none" },
+                total,
+                bulkEdit: spec,
+            }
+            const initialProgress: JobProgress = {
+                current: 0,
+                total,
+                status: "pending",
+                message: "Job created",
+            }
+            await client
+                .multi()
+                .hSet(getJobMetadataKey(jobId), { data: JSON.stringify(metadata) })
+                .hSet(getJobStatusKey(jobId), { data: JSON.stringify(initialProgress) })
+                .sAdd(JOBS_ACTIVE_KEY, jobId)
+                .exec()
+            return jobId
+        })
+
+        if (!response.success) {
+            console.error(`[JobQueue] Failed to create bulk edit job ${jobId}:`, response.error)
+            throw new Error(response.error)
+        }
+        return response.result as string
+    }
+
+    /**
+     * Creates a job whose rows are uploaded afterwards with ingestStreamingJob,
+     * so the caller has the job ID (to show, pause or cancel it) before the
+     * upload starts. Columns are resolved from the first record of the upload.
+     */
+    public static async createStreamingJob(
+        url: string,
+        fileName: string,
+        vectorSetName: string,
+        embeddingConfig: EmbeddingConfig,
+        options: ImportJobConfig
+    ): Promise<string> {
+        const jobId = uuidv4()
+
+        // Set default options
+        const fileType = options?.fileType || "csv"
+        const exportType = options?.exportType || "redis"
+
+        if (fileType !== "csv" && fileType !== "json") {
+            throw new Error(`Streaming import is not supported for ${fileType} files`)
+        }
+
+        // Validate output filename for JSON export
+        if (exportType === "json" && !options?.outputFilename) {
+            throw new Error("Output filename is required for JSON export")
+        }
+
+        const metadata: CSVJobMetadata = {
+            jobId,
+            filename: fileName,
+            vectorSetName,
+            embedding: embeddingConfig,
+            elementColumn: options?.elementColumn,
+            textColumn: options?.textColumn,
+            elementTemplate: options?.elementTemplate,
+            textTemplate: options?.textTemplate,
+            attributeColumns: options?.attributeColumns || [],
+            total: 0,
+            delimiter: options?.delimiter || ",",
+            hasHeader: options?.hasHeader !== undefined ? options.hasHeader : true,
+            skipRows: options?.skipRows || 0,
+            fileType,
+            exportType,
+            outputFilename: options?.outputFilename,
+            exportFormat: options?.exportFormat,
+            batchSize: options?.batchSize ?? DEFAULT_JOB_BATCH_SIZE,
+            batchTimeBudgetMs:
+                options?.batchTimeBudgetMs ??
+                DEFAULT_JOB_BATCH_TIME_BUDGET_MS,
+            concurrency: options?.concurrency ?? DEFAULT_JOB_CONCURRENCY,
+            streaming: true,
+        }
+
+        const created = await RedisConnection.withClient(url, async (client) => {
+            const initialProgress: JobProgress = {
+                current: 0,
+                total: 0,
+                status: "pending",
+                message: "Job created, waiting for upload",
+            }
+            await client
+                .multi()
+                .hSet(getJobMetadataKey(jobId), { data: JSON.stringify(metadata) })
+                .hSet(getJobStatusKey(jobId), {
+                    data: JSON.stringify(initialProgress),
+                    streamedTotal: "0",
+                })
+                .xGroupCreate(getJobStreamKey(jobId), JOB_CONSUMER_GROUP, "0", { MKSTREAM: true })
+                .exec()
+            return true
+        })
+        if (!created.success) {
+            console.error(
+                `[JobQueue] Failed to create job ${jobId}:`,
+                created.error
+            )
+            throw new Error(created.error)
+        }
+
+        return jobId
+    }
+
+    /**
+     * Reads the upload of a job made by createStreamingJob without holding
+     * the file in memory. Rows are parsed incrementally and pushed to the
+     * queue in pipelined chunks. onIngestStarted is called once the columns
+     * are known so processing can start while the upload is still being
+     * parsed. Failures end up in the job's status as well as being thrown.
+     * Resolves to the number of rows enqueued.
+     */
+    public static async ingestStreamingJob(
+        url: string,
+        jobId: string,
+        stream: ReadableStream<Uint8Array>,
+        onIngestStarted: (jobId: string) => void
+    ): Promise<number> {
+        const statusKey = getJobStatusKey(jobId)
+        const streamKey = getJobStreamKey(jobId)
+        const ingestKey = getJobIngestKey(jobId)
+
+        const pending = await JobQueueService.getJobMetadata(url, jobId)
+        if (!pending?.streaming) {
+            throw new Error("Job not found or not waiting for an upload")
+        }
+
+        // One upload per job
+        const claimed = await RedisConnection.withClient(url, async (client) => {
+            if ((await client.hGet(statusKey, "streamedTotal")) !== "0") {
+                return false
+            }
+            return (await client.set(ingestKey, "1", { NX: true, EX: STREAM_INGEST_TTL_SECONDS })) === "OK"
+        })
+        if (!claimed.success) {
+            throw new Error(claimed.error)
+        }
+        if (!claimed.result) {
+            throw new Error("The upload for this job has already been received")
+        }
+
+        let total = 0
+        let index = 0
+        let chunk: string[] = []
+
+        const flushChunk = async () => {
+            if (chunk.length === 0) return
+            const items = chunk
+            chunk = []
+
+            // Wait for the workers to drain the stream below the high-water mark
+            // (acknowledged rows are deleted, so its length is what is left to do).
+            // Each check takes its own short lease so the wait never pins a pooled connection
+            while (true) {
+                const check = await RedisConnection.withClient(url, async (client) => {
+                    if ((await client.xLen(streamKey)) <= STREAM_QUEUE_HIGH_WATER) {
+                        return true
+                    }
+                    if (!(await client.exists(statusKey))) {
+                        throw new Error("Job was removed while the upload was in progress")
+                    }
+                    return false
+                })
+                if (!check.success) {
+                    throw new Error(check.error)
+                }
+                if (check.result) break
+                await new Promise((resolve) => setTimeout(resolve, 250))
+            }
+
+            const response = await RedisConnection.withClient(url, async (client) => {
+                total += items.length
+                const multi = client.multi()
+                for (const item of items) {
+                    multi.xAdd(streamKey, "*", { item })
+                }
+                await multi
+                    .hSet(statusKey, "streamedTotal", String(total))
+                    .exec()
+                return true
+            }, { lane: "bulk" })
+            if (!response.success) {
+                throw new Error(response.error)
+            }
+        }
+
+        // Keep the marker alive for as long as this process is reading the upload,
+        // including while the parser waits on a slow client between chunks.
+        // Only a dead process stops the refresh and lets the marker expire
+        const refresh = setInterval(() => {
+            RedisConnection.withClient(url, async (client) => {
+                await client.expire(ingestKey, STREAM_INGEST_TTL_SECONDS)
+            }).then((response) => {
+                if (!response.success) {
+                    console.warn(`[JobQueue] Could not refresh the upload marker for job ${jobId}:`, response.error)
+                }
+            })
+        }, STREAM_INGEST_REFRESH_MS)
+
+        try {
+            const { delimiter, hasHeader, skipRows, fileType } = pending
+            const records: AsyncIterator<CSVRow> = fileType === "csv"
+                ? parseCSVStream(stream, { delimiter: delimiter || ",", hasHeader: hasHeader ?? true, skipRows: skipRows || 0 })
+                : (async function* () {
+                    let index = 0
+                    for await (const item of parseJSONStream(stream)) {
+                        yield jsonItemToRecord(item, index++)
+                    }
+                })()
+
+            // The first record determines the available columns
+            const first = await records.next()
+            const availableColumns = first.done ? [] : Object.keys(first.value)
+
+            const attributeColumns =
+                fileType === "json" && (!pending.attributeColumns || pending.attributeColumns.length === 0)
+                    ? defaultJsonAttributeColumns(availableColumns)
+                    : pending.attributeColumns || []
+            const { elementColumn, textColumn } = resolveColumns(
+                { elementColumn: pending.elementColumn, textColumn: pending.textColumn },
+                availableColumns
+            )
+            const metadata: CSVJobMetadata = { ...pending, elementColumn, textColumn, attributeColumns }
+
+            const started = await RedisConnection.withClient(url, async (client) => {
+                await client
+                    .multi()
+                    .hSet(getJobMetadataKey(jobId), { data: JSON.stringify(metadata) })
+                    .sAdd(JOBS_ACTIVE_KEY, jobId)
+                    .exec()
+                return true
+            })
+            if (!started.success) {
+                throw new Error(started.error)
+            }
+            await JobQueueService.updateJobProgress(url, jobId, {
+                message: "Reading upload",
+            })
+
+            onIngestStarted(jobId)
+
+            let next = first
+            while (!next.done) {
+                const item: JobQueueItem = {
+                    jobId,
+                    rowData: next.value,
+                    index: index++,
+                }
+                chunk.push(JSON.stringify(item))
+                if (chunk.length >= STREAM_CHUNK_SIZE) {
+                    await flushChunk()
+                }
+                next = await records.next()
+            }
+            await flushChunk()
+
+            // Record the final row count, then mark the upload as fully enqueued
+            await RedisConnection.withClient(url, async (client) => {
+                await client.hSet(getJobMetadataKey(jobId), {
+                    data: JSON.stringify({ ...metadata, total }),
+                })
+                await client.del(ingestKey)
+            })
+        } catch (error) {
+            const errorMessage =
+                error instanceof Error ? error.message : String(error)
+            console.error(`[JobQueue] Streaming import for job ${jobId} failed:`, error)
+            await RedisConnection.withClient(url, async (client) => {
+                await client.del(ingestKey)
+            })
+            const statusStillExists = await JobQueueService.getJobProgress(url, jobId)
+            if (statusStillExists) {
+                await JobQueueService.updateJobProgress(url, jobId, {
+                    status: "failed",
+                    error: errorMessage,
+                    message: `Failed to read upload: ${errorMessage}`,
+                })
+            }
+            throw error
+        } finally {
+            clearInterval(refresh)
+        }
+
+        return total
+    }
+
+    public static async isIngestActive(
+        url: string,
+        jobId: string
+    ): Promise<boolean> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            return (await client.exists(getJobIngestKey(jobId))) > 0
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+        return response.result === true
+    }
+
     public static async getJobProgress(
         url: string,
         jobId: string
@@ -281,14 +708,18 @@ export class JobQueueService {
 
                 // Handle the case where data might already be an object
                 try {
-                    if (
+                    const progress = (
                         typeof status.data === "object" &&
                         status.data !== null
-                    ) {
-                        return status.data as JobProgress
-                    } else {
-                        return JSON.parse(status.data) as JobProgress
+                    )
+                        ? status.data as JobProgress
+                        : JSON.parse(status.data) as JobProgress
+
+                    // Streaming imports keep the growing row count in its own field
+                    if (status.streamedTotal) {
+                        progress.total = Number(status.streamedTotal)
                     }
+                    return progress
                 } catch (error) {
                     console.error(
                         `[JobQueue] Error parsing job progress for ${jobId}:`,
@@ -356,33 +787,383 @@ export class JobQueueService {
         return response.result as CSVJobMetadata | null
     }
 
-    public static async getNextQueueItem(
+    /**
+     * Claims up to `count` rows of the job for `consumer`, in order of preference:
+     * - With `recoverOwn`, rows this consumer read but never acknowledged,
+     *   e.g. before the process restarted.
+     * - Rows another consumer has held for longer than `takeOverIdleMs`
+     *   (JOB_CLAIM_IDLE_MS unless a stopped job is being resumed).
+     * - Rows no consumer has read yet.
+     * Claimed rows stay pending until ackQueueItems is called for them.
+     */
+    public static async claimQueueItems(
+        url: string,
+        jobId: string,
+        consumer: string,
+        count: number,
+        recoverOwn: boolean = false,
+        takeOverIdleMs: number = JOB_CLAIM_IDLE_MS
+    ): Promise<{ items: JobQueueItem[]; source: ClaimSource }> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            const key = getJobStreamKey(jobId)
+            let entries: StreamEntry[] = []
+            let source: ClaimSource = "none"
+
+            if (recoverOwn) {
+                const own = await client.xReadGroup(
+                    JOB_CONSUMER_GROUP,
+                    consumer,
+                    { key, id: "0" },
+                    { COUNT: count }
+                )
+                entries = own?.[0]?.messages ?? []
+                source = "recovered"
+            }
+
+            if (entries.length === 0) {
+                const claimed = await client.xAutoClaim(
+                    key,
+                    JOB_CONSUMER_GROUP,
+                    consumer,
+                    takeOverIdleMs,
+                    "0-0",
+                    { COUNT: count }
+                )
+                // Entries deleted while pending come back as null
+                entries = claimed.messages.filter((entry): entry is StreamEntry => entry !== null)
+                source = "reclaimed"
+            }
+
+            if (entries.length === 0) {
+                const fresh = await client.xReadGroup(
+                    JOB_CONSUMER_GROUP,
+                    consumer,
+                    { key, id: ">" },
+                    { COUNT: count }
+                )
+                entries = fresh?.[0]?.messages ?? []
+                source = entries.length > 0 ? "new" : "none"
+            }
+
+            const items = entries.map((entry) => ({
+                ...(JSON.parse(entry.message.item) as JobQueueItem),
+                streamId: entry.id,
+            }))
+            return { items, source }
+        }, { lane: "bulk" })
+        if (!response.success || !response.result) {
+            console.error(
+                `[JobQueue] Failed to claim queue items for job ${jobId}:`,
+                response.error
+            )
+            throw new Error(response.error)
+        }
+        return response.result
+    }
+
+    /**
+     * Marks claimed rows as done: they are acknowledged and deleted from the
+     * stream, so no worker processes them again, and counted towards the
+     * job's progress. Their staged embeddings and written markers are dropped
+     * and the checkpoint watermark moves up to the oldest row still queued.
+     * Returns the number of rows done so far across workers.
+     */
+    public static async ackQueueItems(
+        url: string,
+        jobId: string,
+        items: JobQueueItem[]
+    ): Promise<number> {
+        const ids = items.map((item) => item.streamId).filter((id): id is string => !!id)
+        const response = await RedisConnection.withClient(url, async (client) => {
+            const key = getJobStreamKey(jobId)
+            if (ids.length === 0) {
+                return Number((await client.hGet(getJobStatusKey(jobId), "processed")) || 0)
+            }
+            // Only rows this call acknowledged are counted: a row acknowledged
+            // twice (a retried batch, or a worker that took it over) counts once
+            const acknowledged = await client.xAck(key, JOB_CONSUMER_GROUP, ids)
+            const [, processed, , , oldest] = await client
+                .multi()
+                .xDel(key, ids)
+                .hIncrBy(getJobStatusKey(jobId), "processed", acknowledged)
+                .hDel(getJobStagedKey(jobId), ids)
+                .sRem(getJobWrittenKey(jobId), ids)
+                .xRange(key, "-", "+", { COUNT: 1 })
+                .exec()
+
+            // Rows are queued in order, so the oldest one left bounds what is done
+            const first = (oldest as unknown as StreamEntry[])[0]
+            const watermark = first
+                ? (JSON.parse(first.message.item) as JobQueueItem).index
+                : Number(processed)
+            await client.hSet(getJobCheckpointKey(jobId), {
+                watermark: String(watermark),
+                updatedAt: String(Date.now()),
+            })
+            return Number(processed)
+        }, { lane: "bulk" })
+        if (!response.success) {
+            console.error(
+                `[JobQueue] Failed to acknowledge queue items for job ${jobId}:`,
+                response.error
+            )
+            throw new Error(response.error)
+        }
+        return response.result ?? 0
+    }
+
+    // Saves embeddings of claimed rows so a run that stops before writing them does not pay for them again
+    public static async stageEmbeddings(
+        url: string,
+        jobId: string,
+        rows: { streamId: string; embedding: number[] }[]
+    ): Promise<void> {
+        if (rows.length === 0) return
+        const args: (string | Buffer)[] = []
+        rows.forEach((row) => args.push(row.streamId, vectorToFp32Buffer(row.embedding)))
+        const response = await RedisConnection.withClient(url, async (client) => {
+            await client.sendCommand(["HSET", getJobStagedKey(jobId), ...args])
+            return true
+        }, { lane: "bulk" })
+        if (!response.success) {
+            // The rows are still written; a restart would only embed them again
+            console.error(
+                `[JobQueue] Failed to stage embeddings for job ${jobId}:`,
+                response.error
+            )
+        }
+    }
+
+    /**
+     * For rows recovered from an earlier run: which were already added to
+     * the set (only their acknowledgement was lost), and the staged
+     * embeddings of the others.
+     */
+    public static async getRowCheckpoints(
+        url: string,
+        jobId: string,
+        streamIds: string[]
+    ): Promise<{ written: Set<string>; staged: Map<string, number[]> }> {
+        const written = new Set<string>()
+        const staged = new Map<string, number[]>()
+        if (streamIds.length === 0) {
+            return { written, staged }
+        }
+
+        const response = await RedisConnection.withClient(url, async (client) => {
+            const [isWritten, embeddings] = await Promise.all([
+                client.smIsMember(getJobWrittenKey(jobId), streamIds),
+                client.sendCommand(
+                    ["HMGET", getJobStagedKey(jobId), ...streamIds],
+                    { returnBuffers: true }
+                ) as Promise<(Buffer | null)[]>,
+            ])
+            streamIds.forEach((id, i) => {
+                if (isWritten[i]) {
+                    written.add(id)
+                } else if (embeddings[i] && embeddings[i]!.length > 0) {
+                    staged.set(id, fp32BufferToVector(embeddings[i]!))
+                }
+            })
+            return true
+        }, { lane: "bulk" })
+        if (!response.success) {
+            // Without the markers the rows are simply embedded and written again
+            console.error(
+                `[JobQueue] Failed to read row checkpoints for job ${jobId}:`,
+                response.error
+            )
+        }
+        return { written, staged }
+    }
+
+    public static async getJobCheckpoint(
         url: string,
         jobId: string
-    ): Promise<JobQueueItem | null> {
+    ): Promise<JobCheckpoint | null> {
         const response = await RedisConnection.withClient(url, async (client) => {
-            const queueKey = getJobQueueKey(jobId)
-            const item = await client.lPop(queueKey)
-            return item ? (JSON.parse(item) as JobQueueItem) : null
+            return client.hGetAll(getJobCheckpointKey(jobId))
         })
         if (!response.success) {
+            throw new Error(response.error)
+        }
+        const fields = response.result
+        if (!fields || Object.keys(fields).length === 0) {
+            return null
+        }
+        return {
+            watermark: Number(fields.watermark || 0),
+            placeholderRemoved: fields.placeholderRemoved === "1",
+            updatedAt: fields.updatedAt ? Number(fields.updatedAt) : undefined,
+        }
+    }
+
+    /**
+     * Restarts a job that failed or whose processors went away (e.g. the
+     * server restarted). Rows that were done stay done; the rest are picked
+     * up from the checkpoint, reusing staged embeddings. Bulk edits carry on
+     * from their own saved state.
+     */
+    public static async resumeInterruptedJob(
+        url: string,
+        jobId: string
+    ): Promise<JobCheckpoint> {
+        const metadata = await JobQueueService.getJobMetadata(url, jobId)
+        if (!metadata) {
+            throw new Error("Job not found")
+        }
+        if (metadata.exportType === "json") {
+            throw new Error("An interrupted export cannot be resumed; start it again")
+        }
+
+        const checkpoint = (await JobQueueService.getJobCheckpoint(url, jobId)) ?? {
+            watermark: 0,
+            placeholderRemoved: false,
+        }
+        const response = await RedisConnection.withClient(url, async (client) => {
+            await client
+                .multi()
+                .del(getJobFinishKey(jobId))
+                .sAdd(JOBS_ACTIVE_KEY, jobId)
+                .exec()
+            return true
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+
+        await JobQueueService.updateJobProgress(url, jobId, {
+            status: "processing",
+            error: undefined,
+            message: metadata.bulkEdit ? "Job resumed" : `Resuming from row ${checkpoint.watermark + 1}`,
+        })
+        return checkpoint
+    }
+
+    // True while the job's stream still holds rows that are unread or unacknowledged
+    public static async hasQueuedRows(url: string, jobId: string): Promise<boolean> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            return (await client.xLen(getJobStreamKey(jobId))) > 0
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+        return response.result === true
+    }
+
+    // Only the first worker to call this for a job gets to finish it
+    public static async claimJobFinish(
+        url: string,
+        jobId: string,
+        consumer: string
+    ): Promise<boolean> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            return (await client.set(getJobFinishKey(jobId), consumer, { NX: true, EX: 3600 })) === "OK"
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+        return response.result === true
+    }
+
+    /**
+     * Takes or renews the lease on writing a job's JSON export (or running
+     * its bulk edit), which lives in one process. Returns false while another
+     * consumer holds it.
+     */
+    public static async acquireExportLease(
+        url: string,
+        jobId: string,
+        consumer: string,
+        ttlMs: number
+    ): Promise<boolean> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            const key = getJobExportLeaseKey(jobId)
+            if ((await client.set(key, consumer, { NX: true, PX: ttlMs })) === "OK") {
+                return true
+            }
+            if ((await client.get(key)) === consumer) {
+                await client.pExpire(key, ttlMs)
+                return true
+            }
+            return false
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+        return response.result === true
+    }
+
+    // Jobs registered for workers, until cleanupJob removes them
+    public static async listActiveJobs(url: string): Promise<string[]> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            return client.sMembers(JOBS_ACTIVE_KEY)
+        })
+        if (!response.success) {
+            throw new Error(response.error)
+        }
+        return response.result || []
+    }
+
+    // Reads status existence, metadata existence and progress in one round trip
+    public static async getJobControlState(
+        url: string,
+        jobId: string
+    ): Promise<JobControlState> {
+        const response = await RedisConnection.withClient(url, async (client) => {
+            const [statusExists, metadataExists, statusData, ingestActive] = await client
+                .multi()
+                .exists(getJobStatusKey(jobId))
+                .exists(getJobMetadataKey(jobId))
+                .hGet(getJobStatusKey(jobId), "data")
+                .exists(getJobIngestKey(jobId))
+                .exec()
+
+            let progress: JobProgress | null = null
+            if (typeof statusData === "string") {
+                try {
+                    progress = JSON.parse(statusData) as JobProgress
+                } catch (error) {
+                    console.error(
+                        `[JobQueue] Error parsing job progress for ${jobId}:`,
+                        error
+                    )
+                }
+            }
+
+            return {
+                statusExists: Number(statusExists) > 0,
+                metadataExists: Number(metadataExists) > 0,
+                progress,
+                ingestActive: Number(ingestActive) > 0,
+            }
+        })
+        if (!response.success || !response.result) {
             console.error(
-                `[JobQueue] Failed to get next queue item for job ${jobId}:`,
+                `[JobQueue] Failed to get control state for job ${jobId}:`,
                 response.error
             )
             throw new Error(response.error)
         }
-        return response.result as JobQueueItem | null
+        return response.result
     }
 
     public static async cleanupJob(url: string, jobId: string): Promise<void> {
         const result = await RedisConnection.withClient(url, async (client) => {
             const keys = [
                 getJobQueueKey(jobId),
+                getJobStreamKey(jobId),
                 getJobStatusKey(jobId),
                 getJobMetadataKey(jobId),
+                getJobIngestKey(jobId),
+                getJobFinishKey(jobId),
+                getJobExportLeaseKey(jobId),
+                getJobBulkEditKey(jobId),
+                getJobCheckpointKey(jobId),
+                getJobStagedKey(jobId),
+                getJobWrittenKey(jobId),
             ]
-            await client.del(keys)
+            await client.multi().del(keys).sRem(JOBS_ACTIVE_KEY, jobId).exec()
             return true
         })
         if (!result.success) {
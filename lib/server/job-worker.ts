@@ -0,0 +1,93 @@
+import { JobQueueService } from "./job-queue"
+import { JobProcessor, jobConsumerName } from "./job-processor"
+
+// How often the worker looks for jobs it is not working on yet
+const JOB_WORKER_POLL_INTERVAL_MS = 2000
+
+export interface JobWorkerOptions {
+    // Consumer name in the jobs' consumer groups; keep it stable across restarts
+    consumer?: string
+    // Jobs worked on at the same time by this worker
+    maxJobs?: number
+}
+
+/**
+ * Runs import jobs from the shared job registry. Every worker, in any
+ * process, joins the consumer group of each pending or processing job, so
+ * rows of one job are spread over all workers. Paused jobs keep their
+ * processor (it idles until resumed); finished, cancelled and removed jobs
+ * drop out on their own.
+ */
+export class JobWorker {
+    private readonly consumer: string
+    private readonly maxJobs: number
+    private readonly processors = new Map<string, JobProcessor>()
+    private timer: NodeJS.Timeout | null = null
+    private stopped = false
+
+    constructor(
+        private readonly url: string,
+        options: JobWorkerOptions = {}
+    ) {
+        this.consumer = options.consumer || jobConsumerName()
+        this.maxJobs = Math.max(1, options.maxJobs ?? 4)
+    }
+
+    start(): void {
+        if (this.timer || this.stopped) return
+        console.log(`[JobWorker] ${this.consumer} watching for jobs`)
+        const tick = async () => {
+            try {
+                await this.poll()
+            } catch (error) {
+                console.error("[JobWorker] Failed to look for jobs:", error)
+            }
+            if (!this.stopped) {
+                this.timer = setTimeout(tick, JOB_WORKER_POLL_INTERVAL_MS)
+            }
+        }
+        this.timer = setTimeout(tick, 0)
+    }
+
+    private async poll(): Promise<void> {
+        for (const [jobId, processor] of this.processors) {
+            if (!processor.active) this.processors.delete(jobId)
+        }
+
+        const jobIds = await JobQueueService.listActiveJobs(this.url)
+        for (const jobId of jobIds) {
+            if (this.stopped || this.processors.size >= this.maxJobs) break
+            if (this.processors.has(jobId)) continue
+
+            const progress = await JobQueueService.getJobProgress(this.url, jobId)
+            if (!progress || (progress.status !== "pending" && progress.status !== "processing")) {
+                continue
+            }
+
+            const processor = new JobProcessor(this.url, jobId, { consumer: this.consumer })
+            this.processors.set(jobId, processor)
+            console.log(`[JobWorker] ${this.consumer} joining job ${jobId}`)
+            processor
+                .start()
+                .catch((error) => console.error(`[JobWorker] Job ${jobId} failed:`, error))
+                .finally(() => {
+                    if (this.processors.get(jobId) === processor) this.processors.delete(jobId)
+                })
+        }
+    }
+
+    /**
+     * Stops looking for jobs and lets each processor finish the batch it is
+     * writing. Claimed rows that were not finished stay pending for the
+     * next worker (or this one, after a restart).
+     */
+    async shutdown(): Promise<void> {
+        this.stopped = true
+        if (this.timer) {
+            clearTimeout(this.timer)
+            this.timer = null
+        }
+        await Promise.all(Array.from(this.processors.values()).map((processor) => processor.shutdown()))
+        this.processors.clear()
+    }
+}
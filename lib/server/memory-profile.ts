@@ -0,0 +1,471 @@
+import { randomUUID } from "crypto"
+import { buildVaddCommand } from "@/app/api/redis/command/vadd/command"
+import { RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { parseVinfo } from "@/lib/redis-server/utils"
+import { runBenchmark } from "@/lib/server/benchmark"
+import {
+    DEFAULT_HNSW_M,
+    estimateHNSWMemoryUsagePerNode,
+    estimateVectorSetMemoryUsage,
+    parseQuantization,
+    projectionMatrixBytes,
+    QuantizationType,
+} from "@/lib/storage/vectorSetMemory"
+import {
+    getWhatIfHistoryKey,
+    getWhatIfRunKey,
+    getWhatIfShadowKey,
+    MemoryMeasurement,
+    QuantizationFlag,
+    WHATIF_HISTORY_LENGTH,
+    WHATIF_MAX_QUERIES,
+    WHATIF_MAX_SAMPLE,
+    WHATIF_MAX_VARIANTS,
+    WhatIfConfig,
+    WhatIfRun,
+    WhatIfVariant,
+    WhatIfVariantResult,
+} from "@/lib/types/memory"
+
+// A run's live state is kept this long; finished runs also go to the history list
+const RUN_TTL_SECONDS = 24 * 60 * 60
+
+// VEMB / VADD commands pipelined per round trip while copying the sample
+const COPY_BATCH_SIZE = 500
+
+// Shadow sets expire this long after their last renewal, so a run whose
+// process dies leaves nothing behind; a live run renews them on a timer
+const SHADOW_TTL_MS = 5 * 60 * 1000
+const SHADOW_RENEW_MS = SHADOW_TTL_MS / 3
+
+const QUANTIZATIONS: QuantizationFlag[] = ["NOQUANT", "Q8", "BIN"]
+
+function quantizationFlag(quantType: string): QuantizationFlag {
+    switch (parseQuantization(quantType)) {
+        case QuantizationType.FP32:
+            return "NOQUANT"
+        case QuantizationType.BIN:
+            return "BIN"
+        default:
+            return "Q8"
+    }
+}
+
+function variantLabel(variant: WhatIfVariant): string {
+    return variant.reduce ? `${variant.quantization} REDUCE ${variant.reduce}` : variant.quantization
+}
+
+function toMeasurement(
+    vectorSetName: string,
+    info: Record<string, string | number>,
+    memoryBytes: number
+): MemoryMeasurement {
+    const size = Number(info["size"]) || 0
+    const dimensions = Number(info["vector-dim"]) || 0
+    const inputDimensions = Number(info["projection-input-dim"]) || dimensions
+    const quantType = String(info["quant-type"] ?? "int8")
+    const hnswM = Number(info["hnsw-m"]) || DEFAULT_HNSW_M
+    const estimatedBytes = estimateVectorSetMemoryUsage(
+        size,
+        inputDimensions,
+        dimensions,
+        parseQuantization(quantType),
+        inputDimensions > dimensions,
+        hnswM
+    )
+
+    return {
+        vectorSetName,
+        measuredAt: Date.now(),
+        size,
+        dimensions,
+        inputDimensions,
+        quantization: quantizationFlag(quantType),
+        hnswM,
+        memoryBytes,
+        bytesPerVector: size > 0 ? Math.round(memoryBytes / size) : 0,
+        estimatedBytes,
+        estimatedBytesPerVector: size > 0 ? Math.round(estimatedBytes / size) : 0,
+        modelError: memoryBytes > 0 ? Number(((estimatedBytes - memoryBytes) / memoryBytes).toFixed(4)) : 0,
+        info,
+    }
+}
+
+/**
+ * MEMORY USAGE and VINFO of a live set, next to what the model in
+ * lib/storage/vectorSetMemory predicts for the same size and settings.
+ * Returns null when the key is not a vector set.
+ */
+export async function measureVectorSet(url: string, vectorSetName: string): Promise<MemoryMeasurement | null> {
+    const response = await RedisConnection.withClient(url, async (client) => {
+        const [info, usage] = await Promise.all([
+            client.sendCommand(["VINFO", vectorSetName]),
+            client.sendCommand(["MEMORY", "USAGE", vectorSetName]),
+        ])
+        return { info: parseVinfo(info), memoryBytes: Number(usage) || 0 }
+    }, { key: vectorSetName })
+    if (!response.success || !response.result) {
+        throw new Error(response.error || `Failed to measure ${vectorSetName}`)
+    }
+
+    const { info, memoryBytes } = response.result
+    return info ? toMeasurement(vectorSetName, info, memoryBytes) : null
+}
+
+function boundedInteger(value: unknown, fallback: number, min: number, max: number): number | null {
+    if (value === undefined) return fallback
+    const n = Number(value)
+    return Number.isInteger(n) && n >= min && n <= max ? n : null
+}
+
+export function validateWhatIfConfig(body: any): { isValid: boolean; error?: string; value?: WhatIfConfig } {
+    if (!body || typeof body.vectorSetName !== "string" || !body.vectorSetName) {
+        return { isValid: false, error: "vectorSetName is required" }
+    }
+
+    const sampleSize = boundedInteger(body.sampleSize, 2000, 1, WHATIF_MAX_SAMPLE)
+    if (sampleSize === null) {
+        return { isValid: false, error: `sampleSize must be between 1 and ${WHATIF_MAX_SAMPLE}` }
+    }
+    const queryCount = boundedInteger(body.queryCount, 100, 1, WHATIF_MAX_QUERIES)
+    if (queryCount === null) {
+        return { isValid: false, error: `queryCount must be between 1 and ${WHATIF_MAX_QUERIES}` }
+    }
+    const count = boundedInteger(body.count, 10, 1, 1000)
+    const concurrency = boundedInteger(body.concurrency, 8, 1, 64)
+    if (count === null || concurrency === null) {
+        return { isValid: false, error: "count and concurrency must be positive integers" }
+    }
+
+    const ef = Array.isArray(body.ef) && body.ef.length > 0 ? body.ef.map(Number) : [0]
+    if (ef.some((n: number) => !Number.isInteger(n) || n < 0)) {
+        return { isValid: false, error: "ef must be a list of non-negative integers" }
+    }
+
+    if (!Array.isArray(body.variants) || body.variants.length === 0) {
+        return { isValid: false, error: "At least one variant is required" }
+    }
+    const variants: WhatIfVariant[] = []
+    for (const item of body.variants) {
+        if (!QUANTIZATIONS.includes(item?.quantization)) {
+            return { isValid: false, error: `Quantization must be one of ${QUANTIZATIONS.join(", ")}` }
+        }
+        const reduce = item.reduce === undefined || item.reduce === null || item.reduce === 0
+            ? undefined
+            : Number(item.reduce)
+        if (reduce !== undefined && (!Number.isInteger(reduce) || reduce < 1)) {
+            return { isValid: false, error: "REDUCE dimensions must be positive integers" }
+        }
+        variants.push({ quantization: item.quantization, reduce })
+    }
+
+    // The unquantized, unreduced copy is the recall reference, so it always runs first
+    const unique = new Map<string, WhatIfVariant>([["NOQUANT", { quantization: "NOQUANT" }]])
+    variants.forEach((variant) => unique.set(variantLabel(variant), variant))
+    if (unique.size > WHATIF_MAX_VARIANTS) {
+        return { isValid: false, error: `At most ${WHATIF_MAX_VARIANTS} variants are supported` }
+    }
+
+    return {
+        isValid: true,
+        value: {
+            vectorSetName: body.vectorSetName,
+            sampleSize,
+            queryCount,
+            variants: Array.from(unique.values()),
+            count,
+            ef: Array.from(new Set<number>(ef)),
+            concurrency,
+        },
+    }
+}
+
+/**
+ * Samples elements of a live set and copies them into one shadow set per
+ * variant (quantization and REDUCE). Each shadow is measured with MEMORY
+ * USAGE and benchmarked for recall against the NOQUANT copy, using held-out
+ * sampled elements as queries. Shadows are deleted when the run ends
+ * and carry a TTL that the run keeps renewing, in case it never does.
+ */
+class WhatIfRunner {
+    private readonly shadowKeys: string[] = []
+
+    constructor(
+        private readonly url: string,
+        private readonly run: WhatIfRun
+    ) {}
+
+    async execute(): Promise<void> {
+        const { config } = this.run
+        const renew = setInterval(() => this.renewShadows(), SHADOW_RENEW_MS)
+        try {
+            const source = await measureVectorSet(this.url, config.vectorSetName)
+            if (!source) {
+                throw new Error(`Vector set ${config.vectorSetName} not found`)
+            }
+            this.run.source = source
+            await this.save()
+
+            const sample = await this.sample(config.sampleSize + config.queryCount)
+            // Hold queries out of the copies, so no query finds itself
+            const queries = Math.min(config.queryCount, Math.floor(sample.elements.length / 2))
+            if (queries === 0) {
+                throw new Error("Vector set has too few elements to sample")
+            }
+            const queryVectors = sample.vectors.slice(0, queries)
+            const elements = sample.elements.slice(queries)
+            const vectors = sample.vectors.slice(queries)
+
+            const referenceKey = getWhatIfShadowKey(this.run.id, "NOQUANT")
+            for (const variant of config.variants) {
+                this.run.variants.push(
+                    await this.evaluate(variant, elements, vectors, queryVectors, referenceKey, source)
+                )
+                this.run.completedVariants++
+                await this.save()
+            }
+
+            this.run.status = "completed"
+        } catch (error) {
+            console.error(`[WhatIfRunner] Run ${this.run.id} failed:`, error)
+            this.run.status = "failed"
+            this.run.error = error instanceof Error ? error.message : String(error)
+        } finally {
+            clearInterval(renew)
+            await this.dropShadows()
+        }
+
+        this.run.finishedAt = Date.now()
+        await this.save()
+        await this.archive()
+    }
+
+    // Distinct random elements of the source with their vectors
+    private async sample(count: number): Promise<{ elements: string[]; vectors: number[][] }> {
+        const { vectorSetName } = this.run.config
+        const response = await RedisConnection.withClient(this.url, async (client) => {
+            const members = ((await client.sendCommand([
+                "VRANDMEMBER", vectorSetName, String(count),
+            ])) as string[] | null) || []
+
+            const elements: string[] = []
+            const vectors: number[][] = []
+            for (let i = 0; i < members.length; i += COPY_BATCH_SIZE) {
+                const batch = members.slice(i, i + COPY_BATCH_SIZE)
+                const replies = await Promise.all(
+                    batch.map((element) => client.sendCommand(["VEMB", vectorSetName, element]))
+                )
+                replies.forEach((reply, index) => {
+                    // Elements removed since VRANDMEMBER reply null
+                    if (!Array.isArray(reply)) return
+                    elements.push(batch[index])
+                    vectors.push((reply as unknown[]).map((value) => parseFloat(String(value))))
+                })
+            }
+            return { elements, vectors }
+        }, { lane: "bulk", key: vectorSetName })
+        if (!response.success || !response.result) {
+            throw new Error(response.error || "Failed to sample the vector set")
+        }
+        return response.result
+    }
+
+    private async evaluate(
+        variant: WhatIfVariant,
+        elements: string[],
+        vectors: number[][],
+        queryVectors: number[][],
+        referenceKey: string,
+        source: MemoryMeasurement
+    ): Promise<WhatIfVariantResult> {
+        const label = variantLabel(variant)
+        const key = getWhatIfShadowKey(this.run.id, label)
+        const inputDim = vectors[0].length
+        const dimensions = variant.reduce && variant.reduce < inputDim ? variant.reduce : inputDim
+        const projectionBytes = projectionMatrixBytes(inputDim, dimensions)
+        const estimatedBytesPerVector = estimateHNSWMemoryUsagePerNode(
+            dimensions,
+            parseQuantization(variant.quantization),
+            source.hnswM
+        )
+        const result: WhatIfVariantResult = {
+            label,
+            quantization: variant.quantization,
+            reduce: variant.reduce,
+            dimensions,
+            elements: 0,
+            buildMs: 0,
+            memoryBytes: 0,
+            projectionBytes,
+            bytesPerVector: 0,
+            estimatedBytesPerVector,
+            projectedBytes: 0,
+            benchmark: [],
+        }
+
+        if (variant.reduce && variant.reduce >= inputDim) {
+            result.error = `REDUCE ${variant.reduce} is not below the stored ${inputDim} dimensions`
+            return result
+        }
+
+        try {
+            const buildStart = performance.now()
+            await this.copy(key, variant, elements, vectors, source.hnswM)
+            result.buildMs = Math.round(performance.now() - buildStart)
+
+            const measured = await measureVectorSet(this.url, key)
+            if (!measured) {
+                throw new Error(`Shadow set ${key} was not created`)
+            }
+            result.elements = measured.size
+            result.memoryBytes = measured.memoryBytes
+            result.bytesPerVector = measured.size > 0
+                ? Math.round((measured.memoryBytes - projectionBytes) / measured.size)
+                : 0
+            result.projectedBytes = result.bytesPerVector * source.size + projectionBytes
+
+            const benchmark = await runBenchmark(this.url, {
+                vectorSetName: key,
+                truthVectorSetName: referenceKey,
+                queries: { type: "vectors", vectors: queryVectors },
+                ef: this.run.config.ef,
+                filterEf: [0],
+                count: [this.run.config.count],
+                threaded: [true],
+                concurrency: this.run.config.concurrency,
+                warmupRounds: 1,
+            })
+            result.benchmark = benchmark.results
+            if (benchmark.status === "failed") {
+                result.error = benchmark.error
+            }
+        } catch (error) {
+            console.error(`[WhatIfRunner] Variant ${label} failed:`, error)
+            result.error = error instanceof Error ? error.message : String(error)
+        }
+        return result
+    }
+
+    private async copy(
+        key: string,
+        variant: WhatIfVariant,
+        elements: string[],
+        vectors: number[][],
+        hnswM: number
+    ): Promise<void> {
+        this.shadowKeys.push(key)
+        const response = await RedisConnection.withClient(this.url, async (client) => {
+            for (let i = 0; i < elements.length; i += COPY_BATCH_SIZE) {
+                await Promise.all(
+                    elements.slice(i, i + COPY_BATCH_SIZE).map((element, j) => {
+                        const command = buildVaddCommand({
+                            keyName: key,
+                            element,
+                            vector: vectors[i + j],
+                            reduceDimensions: variant.reduce,
+                            quantization: variant.quantization,
+                        })
+                        if (hnswM !== DEFAULT_HNSW_M) {
+                            command.push("M", String(hnswM))
+                        }
+                        return client.sendCommand(command)
+                    })
+                )
+                // The key exists once the first batch is in
+                if (i === 0) {
+                    await client.pExpire(key, SHADOW_TTL_MS)
+                }
+            }
+        }, { lane: "bulk", key })
+        if (!response.success) {
+            throw new Error(response.error || `Failed to build ${key}`)
+        }
+    }
+
+    private async renewShadows(): Promise<void> {
+        if (this.shadowKeys.length === 0) return
+        const response = await RedisConnection.withClient(this.url, async (client) => {
+            await Promise.all(this.shadowKeys.map((key) => client.pExpire(key, SHADOW_TTL_MS)))
+        }, { key: this.shadowKeys[0] })
+        if (!response.success) {
+            console.error(`[WhatIfRunner] Could not renew shadow sets of run ${this.run.id}:`, response.error)
+        }
+    }
+
+    private async dropShadows(): Promise<void> {
+        if (this.shadowKeys.length === 0) return
+        const response = await RedisConnection.withClient(this.url, async (client) => {
+            await client.del(this.shadowKeys)
+        }, { key: this.shadowKeys[0] })
+        if (!response.success) {
+            console.error(`[WhatIfRunner] Could not delete shadow sets of run ${this.run.id}:`, response.error)
+        }
+    }
+
+    private async save(): Promise<void> {
+        await RedisConnection.withClient(this.url, async (client) => {
+            await client.set(getWhatIfRunKey(this.run.id), JSON.stringify(this.run), { EX: RUN_TTL_SECONDS })
+        })
+    }
+
+    private async archive(): Promise<void> {
+        const key = getWhatIfHistoryKey(this.run.vectorSetName)
+        await RedisConnection.withClient(this.url, async (client) => {
+            await client.multi()
+                .lPush(key, JSON.stringify(this.run))
+                .lTrim(key, 0, WHATIF_HISTORY_LENGTH - 1)
+                .exec()
+        })
+    }
+}
+
+/**
+ * Starts a what-if run in the background and returns its initial state;
+ * poll getWhatIfRun for progress.
+ */
+export async function startWhatIf(url: string, config: WhatIfConfig): Promise<WhatIfRun> {
+    const run: WhatIfRun = {
+        id: randomUUID(),
+        vectorSetName: config.vectorSetName,
+        status: "running",
+        config,
+        startedAt: Date.now(),
+        completedVariants: 0,
+        totalVariants: config.variants.length,
+        variants: [],
+    }
+
+    const saved = await RedisConnection.withClient(url, async (client) => {
+        await client.set(getWhatIfRunKey(run.id), JSON.stringify(run), { EX: RUN_TTL_SECONDS })
+    })
+    if (!saved.success) {
+        throw new Error(saved.error || "Failed to save what-if run")
+    }
+
+    console.log(`[MemoryProfile] Starting what-if ${run.id} on ${run.vectorSetName} (${run.totalVariants} variants)`)
+    new WhatIfRunner(url, run).execute().catch((error) =>
+        console.error(`[MemoryProfile] What-if ${run.id} crashed:`, error)
+    )
+    return run
+}
+
+export async function getWhatIfRun(url: string, runId: string): Promise<WhatIfRun | null> {
+    const response = await RedisConnection.withClient(url, async (client) => {
+        return await client.get(getWhatIfRunKey(runId))
+    })
+    if (!response.success) {
+        throw new Error(response.error || "Failed to read what-if run")
+    }
+    return response.result ? (JSON.parse(response.result) as WhatIfRun) : null
+}
+
+// Finished runs for a vector set, newest first
+export async function listWhatIfRuns(url: string, vectorSetName: string): Promise<WhatIfRun[]> {
+    const response = await RedisConnection.withClient(url, async (client) => {
+        return await client.lRange(getWhatIfHistoryKey(vectorSetName), 0, -1)
+    })
+    if (!response.success) {
+        throw new Error(response.error || "Failed to read what-if history")
+    }
+    return (response.result || []).map((entry) => JSON.parse(entry) as WhatIfRun)
+}
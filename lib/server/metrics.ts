@@ -0,0 +1,257 @@
+import { RedisConnection, RedisOperationResult } from "@/lib/redis-server/RedisConnection"
+
+/*
+ * In-process metrics for the server, rendered in Prometheus text format by
+ * /api/metrics. Latencies are kept as summaries over a sliding window of
+ * recent observations so p50/p95/p99 reflect current behaviour.
+ */
+
+type Labels = Record<string, string>
+
+const WINDOW_SIZE = 1024
+const QUANTILES = [0.5, 0.95, 0.99]
+
+class Summary {
+    private window: number[] = []
+    private next = 0
+    count = 0
+    sum = 0
+
+    observe(value: number): void {
+        this.count++
+        this.sum += value
+        if (this.window.length < WINDOW_SIZE) {
+            this.window.push(value)
+        } else {
+            this.window[this.next] = value
+            this.next = (this.next + 1) % WINDOW_SIZE
+        }
+    }
+
+    quantiles(): [number, number][] {
+        const sorted = [...this.window].sort((a, b) => a - b)
+        return QUANTILES.map((q) => [
+            q,
+            sorted.length > 0
+                ? sorted[Math.min(sorted.length - 1, Math.floor(q * sorted.length))]
+                : NaN,
+        ])
+    }
+}
+
+interface MetricFamily<T> {
+    help: string
+    series: Map<string, { labels: Labels; value: T }>
+}
+
+function seriesKey(labels: Labels): string {
+    return Object.keys(labels)
+        .sort()
+        .map((key) => `${key}=${labels[key]}`)
+        .join(",")
+}
+
+function formatLabels(labels: Labels): string {
+    const entries = Object.entries(labels)
+    if (entries.length === 0) return ""
+    return `{${entries
+        .map(([key, value]) => `${key}="${value.replace(/\\/g, "\\\\").replace(/"/g, '\\"').replace(/\n/g, "\\n")}"`)
+        .join(",")}}`
+}
+
+class MetricsRegistry {
+    private summaries = new Map<string, MetricFamily<Summary>>()
+    private counters = new Map<string, MetricFamily<number>>()
+    private gauges = new Map<string, MetricFamily<number>>()
+
+    private family<T>(
+        store: Map<string, MetricFamily<T>>,
+        name: string,
+        help: string
+    ): MetricFamily<T> {
+        let family = store.get(name)
+        if (!family) {
+            family = { help, series: new Map() }
+            store.set(name, family)
+        }
+        return family
+    }
+
+    observe(name: string, help: string, labels: Labels, value: number): void {
+        const family = this.family(this.summaries, name, help)
+        const key = seriesKey(labels)
+        let entry = family.series.get(key)
+        if (!entry) {
+            entry = { labels, value: new Summary() }
+            family.series.set(key, entry)
+        }
+        entry.value.observe(value)
+    }
+
+    increment(name: string, help: string, labels: Labels, by: number = 1): void {
+        const family = this.family(this.counters, name, help)
+        const key = seriesKey(labels)
+        const entry = family.series.get(key)
+        family.series.set(key, { labels, value: (entry?.value ?? 0) + by })
+    }
+
+    setGauge(name: string, help: string, labels: Labels, value: number): void {
+        this.family(this.gauges, name, help).series.set(seriesKey(labels), { labels, value })
+    }
+
+    removeGauge(name: string, labels: Labels): void {
+        this.gauges.get(name)?.series.delete(seriesKey(labels))
+    }
+
+    getCounter(name: string, labels: Labels): number {
+        return this.counters.get(name)?.series.get(seriesKey(labels))?.value ?? 0
+    }
+
+    render(): string {
+        const lines: string[] = []
+
+        this.summaries.forEach((family, name) => {
+            lines.push(`# HELP ${name} ${family.help}`, `# TYPE ${name} summary`)
+            family.series.forEach(({ labels, value }) => {
+                value.quantiles().forEach(([q, v]) => {
+                    lines.push(`${name}${formatLabels({ ...labels, quantile: String(q) })} ${v}`)
+                })
+                lines.push(`${name}_sum${formatLabels(labels)} ${value.sum}`)
+                lines.push(`${name}_count${formatLabels(labels)} ${value.count}`)
+            })
+        })
+
+        this.counters.forEach((family, name) => {
+            lines.push(`# HELP ${name} ${family.help}`, `# TYPE ${name} counter`)
+            family.series.forEach(({ labels, value }) => {
+                lines.push(`${name}${formatLabels(labels)} ${value}`)
+            })
+        })
+
+        this.gauges.forEach((family, name) => {
+            lines.push(`# HELP ${name} ${family.help}`, `# TYPE ${name} gauge`)
+            family.series.forEach(({ labels, value }) => {
+                lines.push(`${name}${formatLabels(labels)} ${value}`)
+            })
+        })
+
+        return lines.join("\n") + "\n"
+    }
+}
+
+export const metrics = new MetricsRegistry()
+
+const COMMAND_PHASE_METRIC = "vectorsets_command_phase_seconds"
+const COMMAND_PHASE_HELP =
+    "Time spent per Redis command route, split by phase (queue_wait, connect, redis, parse, serialize)"
+
+export type CommandPhase = "queue_wait" | "connect" | "redis" | "parse" | "serialize"
+
+/**
+ * Times one request to a Redis command route, phase by phase:
+ *
+ *   const timer = new CommandTimer("VSIM")
+ *   const redisResult = await RedisConnection.withClient(...)
+ *   timer.recordRedis(redisResult)
+ *   ...parse the reply...
+ *   timer.mark("parse")
+ *   return timer.serialize(() => formatResponse(...))
+ */
+export class CommandTimer {
+    private last = performance.now()
+
+    constructor(private readonly command: string) {}
+
+    private record(phase: CommandPhase, ms: number): void {
+        metrics.observe(
+            COMMAND_PHASE_METRIC,
+            COMMAND_PHASE_HELP,
+            { command: this.command, phase },
+            ms / 1000
+        )
+    }
+
+    // Records the pool wait, connect and round-trip times reported by withClient
+    recordRedis(result: RedisOperationResult<unknown>): void {
+        if (result.timings) {
+            this.record("queue_wait", result.timings.queueWaitMs)
+            this.record("connect", result.timings.connectMs)
+            this.record("redis", result.timings.redisMs)
+        }
+        this.last = performance.now()
+    }
+
+    // Records the time since the previous mark under the given phase
+    mark(phase: CommandPhase): void {
+        const now = performance.now()
+        this.record(phase, now - this.last)
+        this.last = now
+    }
+
+    // Builds the response (which stringifies the body) and records it as serialize time
+    serialize<T>(build: () => T): T {
+        this.last = performance.now()
+        const response = build()
+        this.mark("serialize")
+        return response
+    }
+}
+
+export function recordEmbeddingRequest(provider: string, ms: number, inputs: number): void {
+    metrics.observe(
+        "vectorsets_embedding_provider_seconds",
+        "Latency of embedding provider calls",
+        { provider },
+        ms / 1000
+    )
+    metrics.increment(
+        "vectorsets_embedding_inputs_total",
+        "Inputs sent to embedding providers",
+        { provider },
+        inputs
+    )
+}
+
+export function recordEmbeddingCacheLookup(hit: boolean): void {
+    metrics.increment(
+        "vectorsets_embedding_cache_lookups_total",
+        "Embedding cache lookups by result",
+        { result: hit ? "hit" : "miss" }
+    )
+}
+
+export function recordImportRows(jobId: string, rows: number, rowsPerSecond: number): void {
+    metrics.increment("vectorsets_import_rows_total", "Rows written to Redis by import jobs", {}, rows)
+    metrics.setGauge(
+        "vectorsets_import_rows_per_second",
+        "Recent write rate of each running import job",
+        { job_id: jobId },
+        rowsPerSecond
+    )
+}
+
+export function clearImportJob(jobId: string): void {
+    metrics.removeGauge("vectorsets_import_rows_per_second", { job_id: jobId })
+}
+
+// Refreshes point-in-time gauges, then renders everything
+export function renderMetrics(): string {
+    const hits = metrics.getCounter("vectorsets_embedding_cache_lookups_total", { result: "hit" })
+    const misses = metrics.getCounter("vectorsets_embedding_cache_lookups_total", { result: "miss" })
+    metrics.setGauge(
+        "vectorsets_embedding_cache_hit_ratio",
+        "Share of embedding cache lookups that were hits since start",
+        {},
+        hits + misses > 0 ? hits / (hits + misses) : 0
+    )
+
+    for (const pool of RedisConnection.getPoolStats()) {
+        const labels = { url: pool.url, lane: pool.lane }
+        metrics.setGauge("vectorsets_redis_pool_connections", "Open pooled Redis connections", labels, pool.size)
+        metrics.setGauge("vectorsets_redis_pool_active", "Pooled Redis connections currently leased", labels, pool.active)
+        metrics.setGauge("vectorsets_redis_pool_waiting", "Callers waiting for a pooled Redis connection", labels, pool.waiting)
+        metrics.setGauge("vectorsets_redis_pool_wait_seconds_max", "Longest wait for a pooled Redis connection", labels, pool.maxWaitMs / 1000)
+    }
+
+    return metrics.render()
+}
@@ -0,0 +1,163 @@
+import { buildVsimCommand } from "@/app/api/redis/command/vsim/command"
+import { RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { VsimFanoutResult, VsimRequestBody } from "@/lib/redis-server/api"
+import { nodeLabel } from "@/lib/redis-server/cluster"
+import { parseVinfo } from "@/lib/redis-server/utils"
+
+/*
+ * A logical vector set may be split over several keys, so that on a cluster
+ * its shards land on different slots (and so nodes). The convention is a
+ * hash tag after the set's name: docs{0}, docs{1}, ... The plain key (docs)
+ * is included too when it exists. Each shard is an ordinary vector set.
+ */
+
+export interface ShardInfo {
+    key: string
+    node: string
+    card: number | null
+    info: Record<string, string | number> | null
+    executionTimeMs?: number
+    error?: string
+}
+
+export interface ShardedSetInfo {
+    keys: string[]
+    nodes: number
+    totalCard: number
+    dimensions: number | null // null when the shards disagree or none answered
+    shards: ShardInfo[]
+}
+
+export type ShardTiming = VsimFanoutResult["shards"][number]
+
+export type FanoutVsimRequest = Omit<VsimRequestBody, "keyName" | "returnCommandOnly" | "withEmbeddings"> & {
+    keys: string[]
+}
+
+// [element, score, key, attributes?]
+export type FanoutVsimResultItem = VsimFanoutResult["results"][number]
+
+function escapeGlob(value: string): string {
+    return value.replace(/[*?[\]\\]/g, (c) => `\\${c}`)
+}
+
+// The keys making up a logical set, found on every primary
+export async function resolveShardKeys(url: string, name: string): Promise<string[]> {
+    const pattern = `${escapeGlob(name)}{*}`
+    const responses = await RedisConnection.withEachPrimary(url, async (client) => {
+        let cursor = "0"
+        const keys: string[] = []
+        do {
+            const [nextCursor, batch] = (await client.sendCommand([
+                "SCAN", cursor, "MATCH", pattern, "COUNT", "1000", "TYPE", "vectorset",
+            ])) as [string, string[]]
+            keys.push(...batch)
+            cursor = nextCursor
+        } while (cursor !== "0")
+        return keys
+    })
+    const plain = await RedisConnection.withClient(
+        url,
+        async (client) => Number(await client.sendCommand(["EXISTS", name])) === 1,
+        { key: name }
+    )
+
+    const keys = new Set<string>()
+    if (plain.success && plain.result) keys.add(name)
+    responses.forEach((response) => response.result?.forEach((key) => keys.add(key)))
+    return Array.from(keys).sort()
+}
+
+// VINFO and VCARD of every shard, each on the node that owns it, summed up
+export async function describeShards(url: string, keys: string[]): Promise<ShardedSetInfo> {
+    const shards = await Promise.all(
+        keys.map(async (key): Promise<ShardInfo> => {
+            const node = nodeLabel(await RedisConnection.urlForKey(url, key))
+            const response = await RedisConnection.withClient(url, async (client) => {
+                const [info, card] = await Promise.all([
+                    client.sendCommand(["VINFO", key]),
+                    client.sendCommand(["VCARD", key]),
+                ])
+                return { info: parseVinfo(info), card: Number(card) }
+            }, { key })
+            return response.success && response.result
+                ? { key, node, ...response.result, executionTimeMs: response.executionTimeMs }
+                : { key, node, card: null, info: null, error: response.error }
+        })
+    )
+
+    const dimensions = new Set(
+        shards.filter((shard) => shard.info).map((shard) => Number(shard.info!["vector-dim"]))
+    )
+    return {
+        keys,
+        nodes: new Set(shards.map((shard) => shard.node)).size,
+        totalCard: shards.reduce((sum, shard) => sum + (shard.card ?? 0), 0),
+        dimensions: dimensions.size === 1 ? Array.from(dimensions)[0] : null,
+        shards,
+    }
+}
+
+// The query element's vector, from whichever shard holds it
+async function findElementVector(url: string, keys: string[], element: string): Promise<number[] | null> {
+    const replies = await Promise.all(
+        keys.map((key) =>
+            RedisConnection.withClient(url, (client) => client.sendCommand(["VEMB", key, element]), { key })
+        )
+    )
+    const found = replies.find((reply) => reply.success && Array.isArray(reply.result))
+    return found ? (found.result as unknown[]).map((value) => parseFloat(String(value))) : null
+}
+
+/**
+ * Runs one VSIM against every shard in parallel, each with the full COUNT,
+ * and merges the replies into the global top COUNT by score. A search by
+ * element first looks the element's vector up, since only one shard has it.
+ */
+export async function fanoutVsim(url: string, request: FanoutVsimRequest): Promise<VsimFanoutResult> {
+    const { keys, searchElement, ...search } = request
+    let searchVector = request.searchVector
+    if (!searchVector && searchElement) {
+        searchVector = (await findElementVector(url, keys, searchElement)) ?? undefined
+        if (!searchVector) {
+            throw new Error(`Element ${searchElement} was not found in any shard`)
+        }
+    }
+
+    const perShard = await Promise.all(
+        keys.map(async (key) => {
+            const command = buildVsimCommand({ ...search, keyName: key, searchVector })[0]
+            const response = await RedisConnection.withClient(url, (client) => client.sendCommand(command), { key })
+            const node = nodeLabel(await RedisConnection.urlForKey(url, key))
+
+            const items: FanoutVsimResultItem[] = []
+            if (response.success && Array.isArray(response.result)) {
+                const reply = response.result as unknown[]
+                const stride = request.withAttribs ? 3 : 2
+                for (let i = 0; i + 1 < reply.length; i += stride) {
+                    const attributes = request.withAttribs ? reply[i + 2] : null
+                    items.push([
+                        String(reply[i]),
+                        parseFloat(String(reply[i + 1])),
+                        key,
+                        attributes == null ? null : String(attributes),
+                    ])
+                }
+            }
+            const timing: ShardTiming = {
+                key,
+                node,
+                results: items.length,
+                executionTimeMs: response.executionTimeMs,
+                error: response.success ? undefined : response.error,
+            }
+            return { items, timing }
+        })
+    )
+
+    const results = perShard
+        .flatMap((shard) => shard.items)
+        .sort((a, b) => b[1] - a[1])
+        .slice(0, request.count)
+    return { results, shards: perShard.map((shard) => shard.timing) }
+}
@@ -0,0 +1,25 @@
+/**
+ * Deduplicates concurrent calls: while a call for a key is in flight, later
+ * callers with the same key share its promise instead of starting their own.
+ * Nothing is kept once the call settles.
+ */
+export class SingleFlight<T> {
+    private inFlight = new Map<string, Promise<T>>()
+
+    run(key: string, fn: () => Promise<T>): Promise<T> {
+        const existing = this.inFlight.get(key)
+        if (existing) {
+            return existing
+        }
+
+        const promise = fn().finally(() => {
+            this.inFlight.delete(key)
+        })
+        this.inFlight.set(key, promise)
+        return promise
+    }
+
+    get size(): number {
+        return this.inFlight.size
+    }
+}
@@ -0,0 +1,375 @@
+import { createClient } from "redis"
+import { RedisClient, RedisConnection } from "@/lib/redis-server/RedisConnection"
+import { parseVinfo } from "@/lib/redis-server/utils"
+import { CAPABILITY_PROBE_PREFIX } from "@/lib/redis-server/capabilities"
+import { WHATIF_SHADOW_PREFIX } from "@/lib/types/memory"
+import { VectorSetCatalogEntry, VectorSetMetadata } from "@/lib/types/vectors"
+
+/*
+ * Server-side catalog of the vector sets behind a Redis URL, with their
+ * VINFO and metadata. The keyspace is scanned once; after that:
+ *   - writes made through this server mark the set dirty (via
+ *     invalidateVectorSet) and only that set is re-read;
+ *   - keyevent notifications, when the server has them enabled, do the
+ *     same for writes made elsewhere;
+ *   - a background rescan runs when the catalog is older than
+ *     CATALOG_MAX_AGE_MS (much longer while notifications are flowing).
+ * Requests are answered from memory; only the very first one waits for the
+ * scan.
+ */
+
+const CONFIG_KEY = "vector-set-browser:config"
+
+const CATALOG_MAX_AGE_MS = readMs("VECTORSET_CATALOG_MAX_AGE_MS", 30000)
+const CATALOG_MAX_AGE_WITH_NOTIFICATIONS_MS = readMs("VECTORSET_CATALOG_NOTIFIED_MAX_AGE_MS", 10 * 60 * 1000)
+// A catalog nobody has asked for in this long is dropped and its subscribers closed
+const CATALOG_IDLE_MS = readMs("VECTORSET_CATALOG_IDLE_MS", 30 * 60 * 1000)
+// How long to wait before checking for notifications again after they were
+// unavailable or the subscribe failed
+const NOTIFICATIONS_RETRY_MS = 60000
+
+// Key events that can add, change or remove a vector set
+const WATCHED_EVENTS = [
+    "vadd", "vrem", "vsetattr", "del", "unlink", "expired", "evicted",
+    "rename_from", "rename_to", "move_from", "move_to", "copy_to", "restore",
+]
+
+// Temporary sets made by the memory what-if and the capability probe are not listed
+function isListed(key: string): boolean {
+    return !key.startsWith(WHATIF_SHADOW_PREFIX) && !key.startsWith(CAPABILITY_PROBE_PREFIX)
+}
+
+function readMs(name: string, fallback: number): number {
+    const value = Number(process.env[name])
+    return Number.isFinite(value) && value >= 0 ? value : fallback
+}
+
+function metadataField(name: string): string {
+    return `vset:${name}:metadata`
+}
+
+function dbIndex(url: string): number {
+    try {
+        const db = Number(new URL(url).pathname.slice(1))
+        return Number.isInteger(db) && db >= 0 ? db : 0
+    } catch (_error) {
+        return 0
+    }
+}
+
+function parseMetadata(name: string, stored: string | null | undefined): VectorSetMetadata | null {
+    if (!stored) return null
+    try {
+        return JSON.parse(stored) as VectorSetMetadata
+    } catch (error) {
+        console.error(`[VectorSetCatalog] Ignoring unreadable metadata for ${name}:`, error)
+        return null
+    }
+}
+
+// VINFO for each key on one client; keys that are gone or not vector sets come back null
+async function readInfo(client: RedisClient, keys: string[]) {
+    return Promise.all(
+        keys.map((key) =>
+            client.sendCommand(["VINFO", key]).then(parseVinfo, () => null)
+        )
+    )
+}
+
+class VectorSetCatalog {
+    private entries = new Map<string, VectorSetCatalogEntry>()
+    private dirty = new Set<string>()
+    private loadedAt = 0
+    private scanning: Promise<void> | null = null
+    private refreshing: Promise<void> | null = null
+    private subscribers: ReturnType<typeof createClient>[] = []
+    private notifications: "off" | "starting" | "on" = "off"
+    private notificationsRetryAt = 0
+    private closed = false
+    public lastUsed = Date.now()
+
+    constructor(private readonly url: string) {}
+
+    async list(): Promise<VectorSetCatalogEntry[]> {
+        await this.ensureFresh()
+        return Array.from(this.entries.values()).sort((a, b) => a.name.localeCompare(b.name))
+    }
+
+    // Entries for the given sets; sets not seen yet are looked up directly
+    async get(names: string[]): Promise<(VectorSetCatalogEntry | null)[]> {
+        await this.ensureFresh()
+        const unknown = names.filter((name) => !this.entries.has(name))
+        if (unknown.length > 0) {
+            unknown.forEach((name) => this.dirty.add(name))
+            await this.refreshDirty()
+        }
+        return names.map((name) => this.entries.get(name) ?? null)
+    }
+
+    markDirty(name: string): void {
+        this.dirty.add(name)
+    }
+
+    setMetadata(name: string, metadata: VectorSetMetadata | null): void {
+        const entry = this.entries.get(name)
+        if (entry) entry.metadata = metadata
+    }
+
+    // Forces the next request to wait for a full rescan
+    reset(): void {
+        this.loadedAt = 0
+    }
+
+    // Stops watching key events; the catalog is no longer reachable afterwards
+    close(): Promise<void> {
+        this.closed = true
+        return this.closeSubscribers()
+    }
+
+    private async closeSubscribers(): Promise<void> {
+        const subscribers = this.subscribers.splice(0)
+        await Promise.all(
+            subscribers.map((subscriber) =>
+                subscriber.isOpen ? subscriber.quit().catch(() => subscriber.disconnect().catch(() => {})) : undefined
+            )
+        )
+    }
+
+    private async ensureFresh(): Promise<void> {
+        this.lastUsed = Date.now()
+        this.startNotifications()
+
+        if (this.loadedAt === 0) {
+            await this.rescan()
+        } else {
+            const maxAge = this.notifications === "on"
+                ? CATALOG_MAX_AGE_WITH_NOTIFICATIONS_MS
+                : CATALOG_MAX_AGE_MS
+            if (Date.now() - this.loadedAt > maxAge) {
+                // Served from the current entries while the rescan runs
+                this.rescan().catch((error) => console.error("[VectorSetCatalog] Rescan failed:", error))
+            }
+        }
+        await this.refreshDirty()
+    }
+
+    // SCAN ... TYPE vectorset on every primary, reading VINFO on the same connection
+    private rescan(): Promise<void> {
+        if (this.scanning) return this.scanning
+
+        const startedAt = Date.now()
+        this.scanning = (async () => {
+            const responses = await RedisConnection.withEachPrimary(this.url, async (client) => {
+                let cursor = "0"
+                const found: { name: string; info: Record<string, string | number> | null }[] = []
+                do {
+                    const [nextCursor, batch] = (await client.sendCommand([
+                        "SCAN", cursor, "COUNT", "1000", "TYPE", "vectorset",
+                    ])) as [string, string[]]
+                    const keys = batch.filter(isListed)
+                    const infos = await readInfo(client, keys)
+                    keys.forEach((name, index) => found.push({ name, info: infos[index] }))
+                    cursor = nextCursor
+                } while (cursor !== "0")
+                return found
+            }, { lane: "bulk" })
+
+            const failed = responses.find((response) => !response.success)
+            if (failed) {
+                throw new Error(failed.error || `Failed to scan ${failed.node}`)
+            }
+
+            const found = responses.flatMap((response) => response.result || [])
+            const metadata = await this.readMetadata(found.map(({ name }) => name))
+            const entries = new Map<string, VectorSetCatalogEntry>()
+            found.forEach(({ name, info }, index) => {
+                if (info) entries.set(name, this.toEntry(name, info, metadata[index]))
+            })
+
+            this.entries = entries
+            this.loadedAt = startedAt
+            console.log(`[VectorSetCatalog] Scanned ${entries.size} vector sets in ${Date.now() - startedAt}ms`)
+        })().finally(() => {
+            this.scanning = null
+        })
+        return this.scanning
+    }
+
+    // Re-reads every set marked dirty; marks made meanwhile are picked up by the next loop
+    private refreshDirty(): Promise<void> {
+        if (this.refreshing) return this.refreshing.then(() => this.refreshDirty())
+        if (this.dirty.size === 0) return Promise.resolve()
+
+        const names = Array.from(this.dirty)
+        this.dirty.clear()
+        this.refreshing = (async () => {
+            const [infos, metadata] = await Promise.all([
+                Promise.all(
+                    names.map(async (name) => {
+                        const response = await RedisConnection.withClient(
+                            this.url,
+                            async (client) => (await readInfo(client, [name]))[0],
+                            { key: name }
+                        )
+                        if (!response.success) {
+                            // Try again on the next request
+                            this.dirty.add(name)
+                            return undefined
+                        }
+                        return response.result ?? null
+                    })
+                ),
+                this.readMetadata(names),
+            ])
+
+            names.forEach((name, index) => {
+                const info = infos[index]
+                if (info === undefined) return
+                if (info === null) {
+                    this.entries.delete(name)
+                } else {
+                    this.entries.set(name, this.toEntry(name, info, metadata[index]))
+                }
+            })
+        })().finally(() => {
+            this.refreshing = null
+        })
+        return this.refreshing
+    }
+
+    private async readMetadata(names: string[]): Promise<(VectorSetMetadata | null)[]> {
+        if (names.length === 0) return []
+        const response = await RedisConnection.withClient(
+            this.url,
+            (client) => client.hmGet(CONFIG_KEY, names.map(metadataField)),
+            { key: CONFIG_KEY }
+        )
+        if (!response.success || !response.result) {
+            // Keep what we had rather than dropping metadata on a transient error
+            return names.map((name) => this.entries.get(name)?.metadata ?? null)
+        }
+        return response.result.map((stored, index) => parseMetadata(names[index], stored))
+    }
+
+    private toEntry(
+        name: string,
+        info: Record<string, string | number>,
+        metadata: VectorSetMetadata | null
+    ): VectorSetCatalogEntry {
+        return {
+            name,
+            dimensions: Number(info["vector-dim"]) || 0,
+            size: Number(info["size"]) || 0,
+            info,
+            metadata,
+            updatedAt: Date.now(),
+        }
+    }
+
+    /**
+     * Subscribes to key events on every primary when the server publishes
+     * them (notify-keyspace-events with E and g or A). The setting is never
+     * changed from here; without it the catalog relies on the rescan.
+     */
+    private startNotifications(): void {
+        if (this.notifications !== "off" || this.closed || Date.now() < this.notificationsRetryAt) return
+        this.notifications = "starting"
+
+        const start = async () => {
+            const config = await RedisConnection.withClient(this.url, (client) =>
+                client.sendCommand(["CONFIG", "GET", "notify-keyspace-events"])
+            )
+            const reply = config.success ? (config.result as unknown) : null
+            const flags = Array.isArray(reply) ? String(reply[1] ?? "") : String((reply as any)?.["notify-keyspace-events"] ?? "")
+            if (!flags.includes("E") || !(flags.includes("g") || flags.includes("A"))) {
+                console.log("[VectorSetCatalog] Key event notifications are off; refreshing by rescan")
+                // Checked again later in case they are turned on
+                this.notifications = "off"
+                this.notificationsRetryAt = Date.now() + NOTIFICATIONS_RETRY_MS
+                return
+            }
+
+            const db = dbIndex(this.url)
+            const channels = WATCHED_EVENTS.map((event) => `__keyevent@${db}__:${event}`)
+            const topology = await RedisConnection.getTopology(this.url)
+            const urls = topology ? topology.primaries.map((node) => node.url) : [this.url]
+
+            for (const nodeUrl of urls) {
+                const subscriber = createClient({ url: nodeUrl, socket: { connectTimeout: 5000 } })
+                // Tracked before connecting so a failed start can close it
+                this.subscribers.push(subscriber)
+                subscriber.on("error", (err) => {
+                    console.error("[VectorSetCatalog] Subscriber error:", err)
+                })
+                // Events may have been missed while disconnected
+                subscriber.on("ready", () => {
+                    if (this.notifications === "on") this.loadedAt = 1
+                })
+                await subscriber.connect()
+                await subscriber.subscribe(channels, (key, channel) => {
+                    const event = channel.slice(channel.lastIndexOf(":") + 1)
+                    if (!isListed(key)) return
+                    // Deletes of unrelated keys are by far the most common event
+                    if (event === "vadd" || event === "rename_to" || event === "move_to" ||
+                        event === "copy_to" || event === "restore" || this.entries.has(key)) {
+                        this.dirty.add(key)
+                    }
+                })
+            }
+            if (this.closed) {
+                await this.closeSubscribers()
+                return
+            }
+            this.notifications = "on"
+            console.log(`[VectorSetCatalog] Watching key events on ${urls.length} node(s)`)
+        }
+
+        start().catch(async (error) => {
+            console.error("[VectorSetCatalog] Could not subscribe to key events:", error)
+            await this.closeSubscribers()
+            // A later request tries again
+            this.notifications = "off"
+            this.notificationsRetryAt = Date.now() + NOTIFICATIONS_RETRY_MS
+        })
+    }
+}
+
+const catalogs = new Map<string, VectorSetCatalog>()
+let idleSweep: ReturnType<typeof setInterval> | null = null
+
+function dropIdleCatalogs(): void {
+    const now = Date.now()
+    for (const [url, catalog] of Array.from(catalogs.entries())) {
+        if (now - catalog.lastUsed > CATALOG_IDLE_MS) {
+            catalogs.delete(url)
+            catalog.close().catch((error) => console.error("[VectorSetCatalog] Error closing subscribers:", error))
+        }
+    }
+    if (catalogs.size === 0 && idleSweep) {
+        clearInterval(idleSweep)
+        idleSweep = null
+    }
+}
+
+export function getVectorSetCatalog(url: string): VectorSetCatalog {
+    let catalog = catalogs.get(url)
+    if (!catalog) {
+        catalog = new VectorSetCatalog(url)
+        catalogs.set(url, catalog)
+    }
+    if (!idleSweep) {
+        idleSweep = setInterval(dropIdleCatalogs, Math.max(CATALOG_IDLE_MS / 4, 1000))
+        idleSweep.unref?.()
+    }
+    catalog.lastUsed = Date.now()
+    return catalog
+}
+
+// Called for every write to a set made through this server
+export function markVectorSetChanged(url: string, name: string): void {
+    catalogs.get(url)?.markDirty(name)
+}
+
+export function setCatalogMetadata(url: string, name: string, metadata: VectorSetMetadata | null): void {
+    catalogs.get(url)?.setMetadata(name, metadata)
+}
@@ -0,0 +1,150 @@
+import { createHash } from "crypto"
+import { MemoryLRU } from "@/lib/embeddings/cache/memory-cache"
+import { SingleFlight } from "./single-flight"
+import { markVectorSetChanged } from "./vectorset-catalog"
+
+/*
+ * Short-lived cache of VSIM results, plus single-flight for identical
+ * concurrent searches. An entry is only served while:
+ *   - it is younger than VSIM_CACHE_TTL_MS (default 5s, 0 disables caching),
+ *   - no write to the set has gone through this server since it was stored,
+ *   - the set's VCARD still matches (catches writes from other clients).
+ * The cache is bounded by the estimated size of its entries rather than
+ * their number, since a result with embeddings can be thousands of times
+ * larger than one without. A result bigger than a quarter of the budget is
+ * not cached at all.
+ */
+
+const TTL_MS = process.env.VSIM_CACHE_TTL_MS !== undefined
+    ? Math.max(0, Number(process.env.VSIM_CACHE_TTL_MS) || 0)
+    : 5000
+const MAX_BYTES = process.env.VSIM_CACHE_MAX_BYTES !== undefined
+    ? Math.max(0, Number(process.env.VSIM_CACHE_MAX_BYTES) || 0)
+    : 32 * 1024 * 1024
+const MAX_ENTRY_BYTES = MAX_BYTES / 4
+
+export interface VsimCacheEntry<T> {
+    value: T
+    card: number
+    generation: number
+    storedAt: number
+    bytes: number
+}
+
+// Bumped on every write to a set made through this server
+const generations = new Map<string, number>()
+const entries = new MemoryLRU<VsimCacheEntry<unknown>>(MAX_BYTES, (entry) => entry.bytes)
+const inFlight = new SingleFlight<unknown>()
+
+// Rough in-memory size of a search outcome: 8 bytes per number, 2 per string
+// character, plus a little per array and object
+function estimateBytes(value: unknown): number {
+    if (typeof value === "number" || typeof value === "boolean") return 8
+    if (typeof value === "string") return 16 + value.length * 2
+    if (value instanceof Buffer) return 16 + value.length
+    if (Array.isArray(value)) {
+        let bytes = 16
+        for (const item of value) bytes += estimateBytes(item)
+        return bytes
+    }
+    if (value && typeof value === "object") {
+        let bytes = 16
+        for (const [key, item] of Object.entries(value)) bytes += key.length * 2 + estimateBytes(item)
+        return bytes
+    }
+    return 8
+}
+
+function setKey(redisUrl: string, keyName: string): string {
+    return `${redisUrl}|${keyName}`
+}
+
+function currentGeneration(redisUrl: string, keyName: string): number {
+    return generations.get(setKey(redisUrl, keyName)) ?? 0
+}
+
+// Call after VADD/VREM/VSETATTR/DEL on a set so cached searches are not served
+// (and the set's catalog entry is re-read)
+export function invalidateVectorSet(redisUrl: string, keyName: string): void {
+    const key = setKey(redisUrl, keyName)
+    generations.set(key, (generations.get(key) ?? 0) + 1)
+    markVectorSetChanged(redisUrl, keyName)
+}
+
+/**
+ * Cache key for one search: the built command and every flag that changes
+ * the response shape. Buffers (FP32 query vectors) are hashed as raw bytes.
+ */
+export function vsimRequestKey(
+    redisUrl: string,
+    keyName: string,
+    command: (string | Buffer)[],
+    options: Record<string, unknown>
+): string {
+    const hash = createHash("sha256")
+    for (const arg of command) {
+        hash.update(arg instanceof Buffer ? arg : String(arg))
+        hash.update("\0")
+    }
+    hash.update(JSON.stringify(options))
+    return `${setKey(redisUrl, keyName)}|${hash.digest("hex")}`
+}
+
+// Returns a cached entry that is still fresh; the caller confirms the VCARD
+export function getCachedVsim<T>(
+    redisUrl: string,
+    keyName: string,
+    requestKey: string
+): VsimCacheEntry<T> | null {
+    if (TTL_MS === 0) return null
+
+    const entry = entries.get(requestKey) as VsimCacheEntry<T> | undefined
+    if (!entry) return null
+
+    if (
+        Date.now() - entry.storedAt > TTL_MS ||
+        entry.generation !== currentGeneration(redisUrl, keyName)
+    ) {
+        entries.delete(requestKey)
+        return null
+    }
+    return entry
+}
+
+export function dropCachedVsim(requestKey: string): void {
+    entries.delete(requestKey)
+}
+
+/**
+ * Runs a search once for all concurrent identical callers. `search` reports
+ * the set's VCARD alongside its outcome; outcomes with a null card (failures)
+ * are shared with the waiting callers but never cached.
+ */
+export async function runVsimOnce<T>(
+    redisUrl: string,
+    keyName: string,
+    requestKey: string,
+    search: () => Promise<{ value: T; card: number | null }>
+): Promise<T> {
+    const generation = currentGeneration(redisUrl, keyName)
+
+    const result = (await inFlight.run(`${requestKey}|${generation}`, search)) as {
+        value: T
+        card: number | null
+    }
+
+    // Skip caching if the set was written to while this search ran
+    if (result.card !== null && TTL_MS > 0 && generation === currentGeneration(redisUrl, keyName)) {
+        const bytes = estimateBytes(result.value)
+        if (bytes <= MAX_ENTRY_BYTES) {
+            entries.set(requestKey, {
+                value: result.value,
+                card: result.card,
+                generation,
+                storedAt: Date.now(),
+                bytes,
+            })
+        }
+    }
+    return result.value
+}
@@ -4,6 +4,7 @@ export interface UserSettingsResponse<T = any> {
 
 // Configuration constants
 export const WITHATTRIBS_SETTING_KEY = 'vsim-use-withattribs'
+export const PROGRESSIVE_SEARCH_SETTING_KEY = 'vsim-progressive'
 
 export const userSettings = {
     get<T = any>(key: string): T | null {
@@ -55,4 +56,13 @@ export const userSettings = {
     setUseWithAttribs(value: boolean): void {
         this.set(WITHATTRIBS_SETTING_KEY, value)
     },
+
+    // Progressive search returns [element, score] first and loads the rest per visible row
+    getProgressiveSearch(): boolean {
+        return this.get<boolean>(PROGRESSIVE_SEARCH_SETTING_KEY) ?? true
+    },
+
+    setProgressiveSearch(value: boolean): void {
+        this.set(PROGRESSIVE_SEARCH_SETTING_KEY, value)
+    },
 }
@@ -1,19 +1,34 @@
 // HNSW parameters (kept constant as in C version)
 const P = 0.25
-const M = 16
-const M0 = 32
+export const DEFAULT_HNSW_M = 16
 const MAX_THREADS = 128
 const MAX_LEVELS = 16
 
-enum QuantizationType {
+export enum QuantizationType {
     FP32 = 0, // 4 bytes/dim, NOQUANT
     Q8 = 1, // 1 byte/dim + small overhead (Default)
     BIN = 2, // 1 bit/dim
 }
 
-function estimateHNSWMemoryUsagePerNode(
+// VADD flag or VINFO quant-type ("f32", "int8", "bin") to the model's type
+export function parseQuantization(value: string): QuantizationType {
+    switch (value.toLowerCase()) {
+        case "noquant":
+        case "f32":
+        case "fp32":
+            return QuantizationType.FP32
+        case "bin":
+            return QuantizationType.BIN
+        default:
+            return QuantizationType.Q8
+    }
+}
+
+// M is the number of links per node on upper layers; layer 0 has 2 * M
+export function estimateHNSWMemoryUsagePerNode(
     storeDim: number,
-    quantType: QuantizationType
+    quantType: QuantizationType,
+    m: number = DEFAULT_HNSW_M
 ): number {
     // 1) Node struct base overhead
     const nodeStructOverhead =
@@ -26,7 +41,7 @@ function estimateHNSWMemoryUsagePerNode(
     // 2) Average number of levels and pointers
     const avgLevels = 1.0 + P / (1.0 - P)
     const effectiveUpperLayers = Math.max(avgLevels - 1.0, 0.0)
-    const avgPointers = M0 + effectiveUpperLayers * M
+    const avgPointers = 2 * m + effectiveUpperLayers * m
     const pointerBytes = avgPointers * 8.0
 
     // 3) Vector storage based on quantization
@@ -53,23 +68,28 @@ export function estimateVectorSetMemoryUsage(
     originalDim: number,
     storeDim: number = originalDim,
     quantType: QuantizationType = QuantizationType.Q8,
-    useProjection: boolean = false
+    useProjection: boolean = false,
+    m: number = DEFAULT_HNSW_M
 ): number {
     // 1) Per-node usage
-    const perNode = estimateHNSWMemoryUsagePerNode(storeDim, quantType)
+    const perNode = estimateHNSWMemoryUsagePerNode(storeDim, quantType, m)
 
     // 2) Total for all N nodes
     let total = perNode * vectorCount
 
     // 3) If we keep the projection matrix in memory, add it
-    if (useProjection && storeDim < originalDim) {
-        const matrixBytes = originalDim * storeDim * 4
-        total += matrixBytes
+    if (useProjection) {
+        total += projectionMatrixBytes(originalDim, storeDim)
     }
 
     return total
 }
 
+// The REDUCE projection matrix, stored once per set as FP32
+export function projectionMatrixBytes(originalDim: number, storeDim: number): number {
+    return storeDim < originalDim ? originalDim * storeDim * 4 : 0
+}
+
 export function formatBytes(bytes: number): string {
     if (bytes === 0) return "0 B"
     const k = 1024
@@ -0,0 +1,64 @@
+// Recall/latency benchmark of VSIM search settings against TRUTH (linear scan)
+
+export type BenchmarkStatus = "running" | "completed" | "failed"
+
+// Where query vectors come from
+export type BenchmarkQuerySource =
+    | { type: "sample"; count: number } // VRANDMEMBER elements, searched with ELE
+    | { type: "vectors"; vectors: number[][] } // Held-out vectors, searched with FP32
+
+export interface BenchmarkConfig {
+    vectorSetName: string
+    queries: BenchmarkQuerySource
+    // Each combination of the lists below is measured; 0 means the server default
+    ef: number[]
+    filterEf: number[]
+    count: number[]
+    threaded: boolean[] // false adds NOTHREAD
+    filter?: string
+    // Queries in flight at once
+    concurrency: number
+    // Untimed passes over the queries before measuring each combination
+    warmupRounds?: number
+    // Set holding the exact results, e.g. an unquantized copy; the set itself by default
+    truthVectorSetName?: string
+}
+
+export interface BenchmarkResultRow {
+    ef: number
+    filterEf: number
+    count: number
+    threaded: boolean
+    recall: number // Mean recall@count against the TRUTH results
+    p50Ms: number
+    p99Ms: number
+    meanMs: number
+    qps: number
+    errors: number
+}
+
+export interface BenchmarkRun {
+    id: string
+    vectorSetName: string
+    status: BenchmarkStatus
+    config: Omit<BenchmarkConfig, "queries"> & { queryCount: number; querySource: BenchmarkQuerySource["type"] }
+    startedAt: number
+    finishedAt?: number
+    // Set count when the run started, to tell runs before and after a re-import apart
+    cardinality?: number
+    truthMs?: number // Time spent computing the exact results
+    completedCombinations: number
+    totalCombinations: number
+    results: BenchmarkResultRow[]
+    error?: string
+}
+
+// Caps keeping one run from monopolising the server
+export const BENCHMARK_MAX_QUERIES = 1000
+export const BENCHMARK_MAX_COMBINATIONS = 64
+export const BENCHMARK_MAX_CONCURRENCY = 64
+// Runs kept per vector set
+export const BENCHMARK_HISTORY_LENGTH = 20
+
+export const getBenchmarkHistoryKey = (vectorSetName: string) => `benchmark:${vectorSetName}:runs`
+export const getBenchmarkRunKey = (runId: string) => `benchmark:run:${runId}`
@@ -1,4 +1,5 @@
 import { EmbeddingConfig } from "@/lib/embeddings/types/embeddingModels"
+import type { VectorExportFormat } from "@/lib/imports/vectorExport"
 
 export type JobStatus =
     | "pending"
@@ -15,6 +16,14 @@ export interface JobProgress {
     message?: string
     error?: string
     timestamp?: number
+    rowsPerSecond?: number // Recent processing rate, while the job is running
+    etaSeconds?: number // Estimated time left at that rate
+}
+
+// Published on JOB_EVENTS_CHANNEL each time a job's progress is written
+export interface JobProgressEvent extends JobProgress {
+    jobId: string
+    vectorSetName?: string
 }
 
 export interface CSVJobMetadata {
@@ -34,6 +43,33 @@ export interface CSVJobMetadata {
     fileType?: string
     exportType?: 'redis' | 'json'
     outputFilename?: string
+    exportFormat?: VectorExportFormat // File layout for JSON exports (defaults from outputFilename)
+    batchSize?: number // Rows pulled, embedded and written per step (1 = row-by-row)
+    batchTimeBudgetMs?: number // Target wall time per batch; the batch shrinks when it is exceeded
+    concurrency?: number // Maximum embedding requests kept in flight at once
+    streaming?: boolean // Rows are enqueued while the upload is still being parsed
+    bulkEdit?: BulkEditSpec // Set for jobs that edit existing elements instead of importing rows
+}
+
+// "merge" overlays the given fields on each element's attributes (null removes
+// a field); "replace" overwrites them, and {} clears them
+export type BulkEditAction =
+    | { type: "delete" }
+    | { type: "setattr"; attributes: Record<string, unknown>; mode: "merge" | "replace" }
+
+export interface BulkEditSpec {
+    action: BulkEditAction
+    filter?: string // FILTER expression, as for VSIM; every element when empty
+}
+
+// How far a bulk edit has got; saved after every page so a restarted job resumes there
+export interface BulkEditState {
+    cursor: string | null // Last element scanned
+    scanned: number
+    matched: number
+    changed: number
+    failed: number
+    done: boolean
 }
 
 export interface CSVRow {
@@ -44,9 +80,54 @@ export interface JobQueueItem {
     jobId: string
     rowData: CSVRow
     index: number
+    streamId?: string // Entry ID in the job's row stream, set when the item is claimed
+    stagedEmbedding?: number[] // Embedded by an earlier run that stopped before writing the row
+}
+
+// Where an import has got to, kept while the job exists so it can be resumed
+export interface JobCheckpoint {
+    watermark: number // Every row before this index is done
+    placeholderRemoved: boolean
+    updatedAt?: number
 }
 
+// Snapshot of the keys that control whether a job should keep running
+export interface JobControlState {
+    statusExists: boolean
+    metadataExists: boolean
+    progress: JobProgress | null
+    ingestActive: boolean
+}
+
+// Defaults for batched ingestion
+export const DEFAULT_JOB_BATCH_SIZE = 64
+export const DEFAULT_JOB_BATCH_TIME_BUDGET_MS = 5000
+export const DEFAULT_JOB_CONCURRENCY = 4
+
 // Redis key helpers
+// Legacy list queue; only deleted now, rows live in the job's stream
 export const getJobQueueKey = (jobId: string) => `job:${jobId}:queue`
+// Stream of queued rows, shared by all workers through JOB_CONSUMER_GROUP
+export const getJobStreamKey = (jobId: string) => `job:${jobId}:rows`
+// Set by the one worker that gets to finish the job
+export const getJobFinishKey = (jobId: string) => `job:${jobId}:finished`
+// Held by the worker writing a JSON export or running a bulk edit, which cannot be shared
+export const getJobExportLeaseKey = (jobId: string) => `job:${jobId}:export-lease`
+// BulkEditState of a bulk edit job
+export const getJobBulkEditKey = (jobId: string) => `job:${jobId}:bulk-edit`
+// JobCheckpoint fields of an import job
+export const getJobCheckpointKey = (jobId: string) => `job:${jobId}:checkpoint`
+// Embeddings of claimed rows by stream ID, written before the rows are added to the set
+export const getJobStagedKey = (jobId: string) => `job:${jobId}:staged`
+// Stream IDs of rows added to the set but not acknowledged yet; each batch adds
+// its rows in the same pipeline as its VADDs
+export const getJobWrittenKey = (jobId: string) => `job:${jobId}:written`
+// Set of job IDs that workers should look at
+export const JOBS_ACTIVE_KEY = "jobs:active"
+export const JOB_CONSUMER_GROUP = "job-workers"
 export const getJobStatusKey = (jobId: string) => `job:${jobId}:status`
 export const getJobMetadataKey = (jobId: string) => `job:${jobId}:metadata`
+// Present (with a short TTL) while a streaming upload is still enqueueing rows
+export const getJobIngestKey = (jobId: string) => `job:${jobId}:ingest`
+// Pub/sub channel carrying JobProgressEvent messages for every job
+export const JOB_EVENTS_CHANNEL = "job:events"
@@ -0,0 +1,81 @@
+import { BenchmarkResultRow, BenchmarkStatus } from "@/lib/types/benchmark"
+
+// Measured memory of live vector sets, and what-if builds of sampled copies
+
+export type QuantizationFlag = "NOQUANT" | "Q8" | "BIN"
+
+export interface MemoryMeasurement {
+    vectorSetName: string
+    measuredAt: number
+    size: number
+    dimensions: number // Stored dimensions, after REDUCE
+    inputDimensions: number // Dimensions of the vectors added
+    quantization: QuantizationFlag
+    hnswM: number
+    memoryBytes: number // MEMORY USAGE
+    bytesPerVector: number
+    // The same set as priced by lib/storage/vectorSetMemory
+    estimatedBytes: number
+    estimatedBytesPerVector: number
+    modelError: number // (estimated - measured) / measured
+    info: Record<string, string | number>
+}
+
+export interface WhatIfVariant {
+    quantization: QuantizationFlag
+    reduce?: number // Target dimensions for REDUCE; none keeps the source's
+}
+
+export interface WhatIfConfig {
+    vectorSetName: string
+    sampleSize: number // Elements copied into every shadow set
+    queryCount: number // Further sampled elements, held out and used as queries
+    variants: WhatIfVariant[]
+    count: number
+    ef: number[]
+    concurrency: number
+}
+
+export interface WhatIfVariantResult {
+    label: string // e.g. "Q8", "BIN REDUCE 256"
+    quantization: QuantizationFlag
+    reduce?: number
+    dimensions: number
+    elements: number
+    buildMs: number
+    memoryBytes: number
+    projectionBytes: number // REDUCE matrix, paid once per set
+    bytesPerVector: number // Excludes the projection matrix
+    estimatedBytesPerVector: number
+    projectedBytes: number // bytesPerVector at the source set's size, plus the matrix
+    // Recall against an unquantized, unreduced copy of the same sample
+    benchmark: BenchmarkResultRow[]
+    error?: string
+}
+
+export interface WhatIfRun {
+    id: string
+    vectorSetName: string
+    status: BenchmarkStatus
+    config: WhatIfConfig
+    startedAt: number
+    finishedAt?: number
+    source?: MemoryMeasurement
+    completedVariants: number
+    totalVariants: number
+    variants: WhatIfVariantResult[]
+    error?: string
+}
+
+export const WHATIF_MAX_SAMPLE = 10000
+export const WHATIF_MAX_QUERIES = 500
+export const WHATIF_MAX_VARIANTS = 12
+// Runs kept per vector set
+export const WHATIF_HISTORY_LENGTH = 20
+
+// Shadow sets of one run share a hash tag, so on a cluster they live on one node
+export const WHATIF_SHADOW_PREFIX = "memory-whatif:shadow:"
+export const getWhatIfShadowKey = (runId: string, label: string) =>
+    `${WHATIF_SHADOW_PREFIX}{${runId}}:${label.replace(/\s+/g, "-")}`
+export const getWhatIfHistoryKey = (vectorSetName: string) => `memory-whatif:${vectorSetName}:runs`
+export const getWhatIfRunKey = (runId: string) => `memory-whatif:run:${runId}`
@@ -19,6 +19,16 @@ export interface VectorSetMetadata {
     redisConfig?: VectorSetAdvancedConfig
 }
 
+// One vector set as served by /api/vectorset/catalog
+export interface VectorSetCatalogEntry {
+    name: string
+    dimensions: number
+    size: number
+    info: Record<string, string | number> // Full VINFO reply
+    metadata: VectorSetMetadata | null
+    updatedAt: number // When the entry was last read from Redis
+}
+
 // New interface for search options that combines VectorSetAdvancedConfig parameters with search state
 export interface VectorSetSearchOptions {
     searchType: SearchType
@@ -0,0 +1,38 @@
+import { HeatmapOptions, rasterizeHeatmap } from "./raster"
+
+/*
+ * Rasterizes heatmaps off the main thread. The pixels are put on an
+ * OffscreenCanvas and handed back as an ImageBitmap, which the page can
+ * blit with drawImage and keep as a cached thumbnail.
+ */
+
+export interface HeatmapWorkerRequest {
+    id: number
+    vector: Float32Array
+    options: HeatmapOptions
+}
+
+export type HeatmapWorkerResponse =
+    | { id: number; bitmap: ImageBitmap }
+    | { id: number; error: string }
+
+const ctx = self as unknown as {
+    onmessage: ((event: MessageEvent<HeatmapWorkerRequest>) => void) | null
+    postMessage: (message: HeatmapWorkerResponse, transfer?: Transferable[]) => void
+}
+
+ctx.onmessage = (event) => {
+    const { id, vector, options } = event.data
+    try {
+        const size = Math.max(1, Math.round(options.size))
+        const canvas = new OffscreenCanvas(size, size)
+        const context = canvas.getContext("2d")
+        if (!context) throw new Error("OffscreenCanvas 2D context unavailable")
+
+        context.putImageData(new ImageData(rasterizeHeatmap(vector, options), size, size), 0, 0)
+        const bitmap = canvas.transferToImageBitmap()
+        ctx.postMessage({ id, bitmap }, [bitmap])
+    } catch (error) {
+        ctx.postMessage({ id, error: error instanceof Error ? error.message : String(error) })
+    }
+}
@@ -0,0 +1,176 @@
+/*
+ * Pixel-level heatmap rasterizer shared by the main thread and
+ * heatmap.worker.ts. Colours are written straight into an RGBA buffer
+ * instead of issuing a fillRect/strokeRect pair per dimension.
+ */
+
+export type HeatmapColorScheme = "thermal" | "viridis" | "classic"
+export type HeatmapScalingMode = "relative" | "absolute"
+
+export interface HeatmapOptions {
+    size: number
+    scalingMode: HeatmapScalingMode
+    colorScheme: HeatmapColorScheme
+}
+
+export interface HeatmapLayout {
+    cols: number
+    rows: number
+    cellSize: number
+    offsetX: number
+    offsetY: number
+}
+
+// Square-ish grid with square cells, centred in a size × size canvas
+export function heatmapLayout(length: number, size: number): HeatmapLayout {
+    const cols = Math.max(1, Math.ceil(Math.sqrt(length)))
+    const rows = Math.max(1, Math.ceil(length / cols))
+    const cellSize = Math.min(size / cols, size / rows)
+    return {
+        cols,
+        rows,
+        cellSize,
+        offsetX: (size - cols * cellSize) / 2,
+        offsetY: (size - rows * cellSize) / 2,
+    }
+}
+
+// Colour for a normalized value in [0, 1]
+export function heatmapColor(value: number, colorScheme: HeatmapColorScheme): [number, number, number] {
+    const t = Math.max(0, Math.min(1, value))
+
+    switch (colorScheme) {
+        case "thermal":
+            // Black -> Purple -> Red -> Orange -> Yellow -> White
+            if (t < 0.2) {
+                const s = t / 0.2
+                return [Math.round(s * 64), 0, Math.round(s * 128)]
+            } else if (t < 0.4) {
+                const s = (t - 0.2) / 0.2
+                return [Math.round(64 + s * (255 - 64)), 0, Math.round(128 * (1 - s))]
+            } else if (t < 0.6) {
+                const s = (t - 0.4) / 0.2
+                return [255, Math.round(s * 165), 0]
+            } else if (t < 0.8) {
+                const s = (t - 0.6) / 0.2
+                return [255, Math.round(165 + s * (255 - 165)), 0]
+            } else {
+                const s = (t - 0.8) / 0.2
+                return [255, 255, Math.round(s * 255)]
+            }
+
+        case "viridis":
+            // Inspired by matplotlib's viridis: Dark Purple -> Blue -> Green -> Yellow
+            if (t < 0.25) {
+                const s = t / 0.25
+                return [Math.round(s * 68), Math.round(s * 1), Math.round(84 + s * (140 - 84))]
+            } else if (t < 0.5) {
+                const s = (t - 0.25) / 0.25
+                return [Math.round(68 + s * (53 - 68)), Math.round(1 + s * (95 - 1)), Math.round(140 + s * (169 - 140))]
+            } else if (t < 0.75) {
+                const s = (t - 0.5) / 0.25
+                return [Math.round(53 + s * (35 - 53)), Math.round(95 + s * (140 - 95)), Math.round(169 + s * (69 - 169))]
+            } else {
+                const s = (t - 0.75) / 0.25
+                return [Math.round(35 + s * (253 - 35)), Math.round(140 + s * (231 - 140)), Math.round(69 + s * (37 - 69))]
+            }
+
+        case "classic":
+        default:
+            // Blue -> White -> Red
+            if (t < 0.5) {
+                const s = t / 0.5
+                return [
+                    Math.round(100 + s * (255 - 100)),
+                    Math.round(149 + s * (255 - 149)),
+                    Math.round(237 + s * (255 - 237)),
+                ]
+            } else {
+                const s = (t - 0.5) / 0.5
+                return [255, Math.round(255 - s * (255 - 20)), Math.round(255 - s * (255 - 60))]
+            }
+    }
+}
+
+// 256-entry RGB lookup table per scheme, built on first use
+const palettes = new Map<HeatmapColorScheme, Uint8Array>()
+
+function palette(colorScheme: HeatmapColorScheme): Uint8Array {
+    let table = palettes.get(colorScheme)
+    if (!table) {
+        table = new Uint8Array(256 * 3)
+        for (let i = 0; i < 256; i++) {
+            table.set(heatmapColor(i / 255, colorScheme), i * 3)
+        }
+        palettes.set(colorScheme, table)
+    }
+    return table
+}
+
+export function heatmapRange(vector: ArrayLike<number>, scalingMode: HeatmapScalingMode) {
+    if (scalingMode === "absolute") {
+        return { min: -1, max: 1 }
+    }
+    let min = Infinity
+    let max = -Infinity
+    for (let i = 0; i < vector.length; i++) {
+        if (vector[i] < min) min = vector[i]
+        if (vector[i] > max) max = vector[i]
+    }
+    return { min, max }
+}
+
+/**
+ * Renders the heatmap into a size × size RGBA buffer, ready for ImageData.
+ * Cells get a faint dark outline, like the canvas-2D version, when they
+ * are large enough for it to be visible.
+ */
+export function rasterizeHeatmap(vector: ArrayLike<number>, options: HeatmapOptions) {
+    const { scalingMode, colorScheme } = options
+    const size = Math.max(0, Math.round(options.size))
+    const pixels = new Uint8ClampedArray(size * size * 4)
+    const length = vector.length
+    if (length === 0 || size <= 0) return pixels
+
+    const { cols, cellSize, offsetX, offsetY } = heatmapLayout(length, size)
+    const { min, max } = heatmapRange(vector, scalingMode)
+    const range = max - min
+    const table = palette(colorScheme)
+
+    // Palette index per dimension
+    const shades = new Uint8Array(length)
+    for (let i = 0; i < length; i++) {
+        let t: number
+        if (range === 0) {
+            t = 0.5 // All values are the same
+        } else if (scalingMode === "absolute") {
+            t = (vector[i] + 1) / 2
+        } else {
+            t = (vector[i] - min) / range
+        }
+        shades[i] = Math.round(Math.max(0, Math.min(1, t)) * 255)
+    }
+
+    const outline = cellSize >= 3
+    for (let py = 0; py < size; py++) {
+        const cy = (py + 0.5 - offsetY) / cellSize
+        const row = Math.floor(cy)
+        const edgeY = outline && cy - row < 1 / cellSize
+        let p = py * size * 4
+        for (let px = 0; px < size; px++, p += 4) {
+            const cx = (px + 0.5 - offsetX) / cellSize
+            const col = Math.floor(cx)
+            const index = row * cols + col
+            if (cx < 0 || col >= cols || cy < 0 || index >= length) continue
+
+            const c = shades[index] * 3
+            // Matches a 10% black stroke over the cell's top and left edge
+            const shade = edgeY || (outline && cx - col < 1 / cellSize) ? 0.9 : 1
+            pixels[p] = table[c] * shade
+            pixels[p + 1] = table[c + 1] * shade
+            pixels[p + 2] = table[c + 2] * shade
+            pixels[p + 3] = 255
+        }
+    }
+    return pixels
+}
@@ -0,0 +1,135 @@
+import { HeatmapOptions, rasterizeHeatmap } from "./raster"
+import type { HeatmapWorkerRequest, HeatmapWorkerResponse } from "./heatmap.worker"
+
+/*
+ * Draws heatmaps onto canvases and keeps the finished thumbnails. Small
+ * heatmaps are rasterized inline (cheaper than a worker round trip);
+ * larger ones go to a shared worker that renders on an OffscreenCanvas.
+ */
+
+type Thumbnail = ImageBitmap | ImageData
+
+// Below this many pixels, posting to the worker costs more than rasterizing inline
+const WORKER_MIN_PIXELS = 128 * 128
+
+// Keyed by vector identity, so thumbnails are dropped along with their vectors
+const thumbnails = new WeakMap<ArrayLike<number>, Map<string, Thumbnail | Promise<Thumbnail>>>()
+
+const pending = new Map<number, { resolve: (bitmap: ImageBitmap) => void; reject: (error: Error) => void }>()
+let nextRequestId = 1
+let worker: Worker | null | undefined
+
+function getWorker(): Worker | null {
+    if (worker !== undefined) return worker
+    if (
+        typeof Worker === "undefined" ||
+        typeof OffscreenCanvas === "undefined" ||
+        typeof createImageBitmap === "undefined"
+    ) {
+        worker = null
+        return worker
+    }
+
+    try {
+        const created = new Worker(new URL("./heatmap.worker.ts", import.meta.url))
+        created.onmessage = (event: MessageEvent<HeatmapWorkerResponse>) => {
+            const message = event.data
+            const request = pending.get(message.id)
+            if (!request) return
+            pending.delete(message.id)
+            if ("bitmap" in message) {
+                request.resolve(message.bitmap)
+            } else {
+                request.reject(new Error(message.error))
+            }
+        }
+        created.onerror = (event) => {
+            console.error("[Heatmap] Worker failed, rendering on the main thread:", event)
+            created.terminate()
+            worker = null
+            pending.forEach((request) => request.reject(new Error("Heatmap worker failed")))
+            pending.clear()
+        }
+        worker = created
+    } catch (error) {
+        console.error("[Heatmap] Could not start worker:", error)
+        worker = null
+    }
+    return worker
+}
+
+function rasterizeInline(vector: ArrayLike<number>, options: HeatmapOptions): ImageData {
+    const size = Math.max(1, Math.round(options.size))
+    return new ImageData(rasterizeHeatmap(vector, options), size, size)
+}
+
+function rasterizeInWorker(target: Worker, vector: ArrayLike<number>, options: HeatmapOptions): Promise<Thumbnail> {
+    return new Promise<ImageBitmap>((resolve, reject) => {
+        const id = nextRequestId++
+        pending.set(id, { resolve, reject })
+        // Copy, so the caller's vector is never detached by the transfer
+        const copy = Float32Array.from(vector)
+        const request: HeatmapWorkerRequest = { id, vector: copy, options }
+        target.postMessage(request, [copy.buffer])
+    }).catch((error) => {
+        console.warn("[Heatmap] Falling back to inline rendering:", error)
+        return rasterizeInline(vector, options)
+    })
+}
+
+function paint(canvas: HTMLCanvasElement, thumbnail: Thumbnail) {
+    const context = canvas.getContext("2d")
+    if (!context) return
+    context.clearRect(0, 0, canvas.width, canvas.height)
+    if (thumbnail instanceof ImageData) {
+        context.putImageData(thumbnail, 0, 0)
+    } else {
+        context.drawImage(thumbnail, 0, 0)
+    }
+}
+
+/**
+ * Sizes the canvas and draws the vector's heatmap, from the thumbnail
+ * cache when this vector was already drawn with the same options.
+ * Returns a function that stops a pending draw from landing on the canvas.
+ */
+export function drawHeatmap(
+    canvas: HTMLCanvasElement,
+    vector: ArrayLike<number>,
+    options: HeatmapOptions
+): () => void {
+    const size = Math.max(1, Math.round(options.size))
+    canvas.width = size
+    canvas.height = size
+
+    const key = `${size}|${options.scalingMode}|${options.colorScheme}`
+    let entries = thumbnails.get(vector)
+    if (!entries) {
+        entries = new Map()
+        thumbnails.set(vector, entries)
+    }
+
+    let entry = entries.get(key)
+    if (!entry) {
+        const target = size * size >= WORKER_MIN_PIXELS ? getWorker() : null
+        entry = target ? rasterizeInWorker(target, vector, options) : rasterizeInline(vector, options)
+        entries.set(key, entry)
+        if (entry instanceof Promise) {
+            const cacheEntries = entries
+            entry.then((thumbnail) => cacheEntries.set(key, thumbnail))
+        }
+    }
+
+    if (!(entry instanceof Promise)) {
+        paint(canvas, entry)
+        return () => {}
+    }
+
+    let active = true
+    entry.then((thumbnail) => {
+        if (active) paint(canvas, thumbnail)
+    })
+    return () => {
+        active = false
+    }
+}
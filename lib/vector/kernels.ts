@@ -0,0 +1,225 @@
+/**
+ * Float32Array kernels behind the vector math in vectorUtils.ts.
+ *
+ * Results are written into caller-provided (or reused) buffers rather than
+ * built with map/reduce, and the hot loops are unrolled by four with
+ * independent accumulators so the JIT can keep them in registers. Inputs
+ * may be plain arrays or typed arrays.
+ */
+
+export type VectorLike = ArrayLike<number>;
+export type FloatBuffer = Float32Array | Float64Array;
+
+// Dimensions processed per pass over the inputs when accumulating many
+// vectors, so the output slice stays in L1 while every input is added in.
+const BLOCK_SIZE = 512;
+
+/**
+ * Dot product of a and b over their common length
+ */
+export function dot(a: VectorLike, b: VectorLike): number {
+  const n = Math.min(a.length, b.length);
+  let s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  let i = 0;
+  for (; i + 3 < n; i += 4) {
+    s0 += a[i] * b[i];
+    s1 += a[i + 1] * b[i + 1];
+    s2 += a[i + 2] * b[i + 2];
+    s3 += a[i + 3] * b[i + 3];
+  }
+  for (; i < n; i++) {
+    s0 += a[i] * b[i];
+  }
+  return s0 + s1 + s2 + s3;
+}
+
+/**
+ * Squared Euclidean norm of a
+ */
+export function sumOfSquares(a: VectorLike): number {
+  return dot(a, a);
+}
+
+/**
+ * Cosine similarity computed in a single pass (dot product and both
+ * norms together). Returns 0 when either vector is all zeros.
+ */
+export function cosine(a: VectorLike, b: VectorLike): number {
+  const n = Math.min(a.length, b.length);
+  let ab0 = 0, ab1 = 0, aa0 = 0, aa1 = 0, bb0 = 0, bb1 = 0;
+  let i = 0;
+  for (; i + 1 < n; i += 2) {
+    const x0 = a[i], y0 = b[i], x1 = a[i + 1], y1 = b[i + 1];
+    ab0 += x0 * y0;
+    ab1 += x1 * y1;
+    aa0 += x0 * x0;
+    aa1 += x1 * x1;
+    bb0 += y0 * y0;
+    bb1 += y1 * y1;
+  }
+  for (; i < n; i++) {
+    ab0 += a[i] * b[i];
+    aa0 += a[i] * a[i];
+    bb0 += b[i] * b[i];
+  }
+  const denominator = Math.sqrt((aa0 + aa1) * (bb0 + bb1));
+  return denominator === 0 ? 0 : (ab0 + ab1) / denominator;
+}
+
+/**
+ * out[i] += alpha * x[i], in place
+ */
+export function axpy(out: FloatBuffer, x: VectorLike, alpha: number, start = 0, end = out.length): void {
+  let i = start;
+  for (; i + 3 < end; i += 4) {
+    out[i] += alpha * x[i];
+    out[i + 1] += alpha * x[i + 1];
+    out[i + 2] += alpha * x[i + 2];
+    out[i + 3] += alpha * x[i + 3];
+  }
+  for (; i < end; i++) {
+    out[i] += alpha * x[i];
+  }
+}
+
+/**
+ * out[i] *= alpha, in place
+ */
+export function scaleInPlace<T extends FloatBuffer>(out: T, alpha: number): T {
+  for (let i = 0; i < out.length; i++) {
+    out[i] *= alpha;
+  }
+  return out;
+}
+
+/**
+ * Scales out to unit length in place. A zero vector is left unchanged.
+ */
+export function normalizeInPlace<T extends FloatBuffer>(out: T): T {
+  const magnitude = Math.sqrt(sumOfSquares(out));
+  return magnitude === 0 ? out : scaleInPlace(out, 1 / magnitude);
+}
+
+/**
+ * Writes sum(weights[k] * vectors[k]) into out, optionally scaled to unit
+ * length. The sum is built one block of dimensions at a time, and the
+ * squared norm of each block is taken while it is still in cache, so
+ * normalizing costs a single extra scaling pass.
+ */
+export function combineInto(
+  out: Float32Array,
+  vectors: ArrayLike<VectorLike>,
+  weights: ArrayLike<number>,
+  normalize = false
+): Float32Array {
+  const dimension = out.length;
+  let squares = 0;
+
+  out.fill(0);
+  for (let blockStart = 0; blockStart < dimension; blockStart += BLOCK_SIZE) {
+    const blockEnd = Math.min(dimension, blockStart + BLOCK_SIZE);
+    for (let k = 0; k < vectors.length; k++) {
+      const weight = k < weights.length ? weights[k] : 0;
+      if (weight !== 0) {
+        axpy(out, vectors[k], weight, blockStart, blockEnd);
+      }
+    }
+    if (normalize) {
+      for (let i = blockStart; i < blockEnd; i++) {
+        squares += out[i] * out[i];
+      }
+    }
+  }
+
+  if (normalize && squares > 0) {
+    scaleInPlace(out, 1 / Math.sqrt(squares));
+  }
+  return out;
+}
+
+/**
+ * Writes the component-wise maximum of weights[k] * vectors[k] into out
+ */
+export function componentMaxInto(
+  out: Float32Array,
+  vectors: ArrayLike<VectorLike>,
+  weights: ArrayLike<number>
+): Float32Array {
+  if (vectors.length === 0) {
+    return out.fill(0);
+  }
+
+  const first = vectors[0];
+  const firstWeight = weights[0];
+  for (let i = 0; i < out.length; i++) {
+    out[i] = first[i] * firstWeight;
+  }
+  for (let k = 1; k < vectors.length; k++) {
+    const vector = vectors[k];
+    const weight = weights[k];
+    for (let i = 0; i < out.length; i++) {
+      const value = vector[i] * weight;
+      if (value > out[i]) out[i] = value;
+    }
+  }
+  return out;
+}
+
+// Basis buffers reused between calls, so repeated recombination (e.g. while
+// a weight slider is dragged) does not allocate a vector per input each time.
+// Kept in double precision: with float32 the residual of a repeated input
+// would not fall below the 1e-10 cut-off and it would be kept.
+let basisPool: Float64Array[] = [];
+
+function basisBuffer(index: number, dimension: number): Float64Array {
+  let buffer = basisPool[index];
+  if (!buffer || buffer.length !== dimension) {
+    buffer = new Float64Array(dimension);
+    basisPool[index] = buffer;
+  }
+  return buffer;
+}
+
+/**
+ * Modified Gram–Schmidt: each vector, in order, has its projection onto the
+ * vectors kept so far removed, and is kept when what remains is not
+ * (numerically) zero. The first vector is kept as is, not normalized.
+ * Kept vectors are then combined with weights[0], weights[1], ... in the
+ * order they were kept. Writes the combination into out and returns how
+ * many vectors were kept.
+ */
+export function orthogonalCombineInto(
+  out: Float32Array,
+  vectors: ArrayLike<VectorLike>,
+  weights: ArrayLike<number>
+): number {
+  const dimension = out.length;
+  if (basisPool.length > vectors.length) {
+    basisPool = basisPool.slice(0, vectors.length);
+  }
+
+  // Squared norms of the kept vectors, so each projection needs one dot product
+  const basisSquares: number[] = [];
+  let kept = 0;
+
+  for (let k = 0; k < vectors.length; k++) {
+    const current = basisBuffer(kept, dimension);
+    current.set(vectors[k] as ArrayLike<number>);
+
+    for (let j = 0; j < kept; j++) {
+      if (basisSquares[j] === 0) continue;
+      const previous = basisPool[j];
+      const projection = dot(current, previous) / basisSquares[j];
+      axpy(current, previous, -projection);
+    }
+
+    const squares = sumOfSquares(current);
+    if (k === 0 || Math.sqrt(squares) > 1e-10) {
+      basisSquares.push(squares);
+      kept++;
+    }
+  }
+
+  combineInto(out, basisPool.slice(0, kept), weights);
+  return kept;
+}
@@ -0,0 +1,113 @@
+import { PCA } from "ml-pca"
+import { UMAP } from "umap-js"
+
+/*
+ * Dimensionality reduction shared by projection.worker.ts and the
+ * main-thread fallback in service.ts.
+ */
+
+export type ProjectionMethod = "umap" | "pca"
+
+export interface ProjectionParams {
+    method: ProjectionMethod
+    components: 2 | 3
+    nEpochs?: number
+    nNeighbors?: number
+    minDist?: number
+}
+
+export class ProjectionCancelledError extends Error {
+    constructor() {
+        super("Projection cancelled")
+        this.name = "ProjectionCancelledError"
+    }
+}
+
+// Views a flat [count × dims] buffer as rows, the shape umap-js and ml-pca expect
+export function toRows(data: Float32Array, count: number, dims: number): number[][] {
+    const rows: number[][] = new Array(count)
+    for (let i = 0; i < count; i++) {
+        rows[i] = Array.from(data.subarray(i * dims, (i + 1) * dims))
+    }
+    return rows
+}
+
+export function flattenRows(rows: number[][], width: number): Float32Array {
+    const flat = new Float32Array(rows.length * width)
+    rows.forEach((row, i) => {
+        for (let c = 0; c < width; c++) flat[i * width + c] = row[c] ?? 0
+    })
+    return flat
+}
+
+function projectPCA(rows: number[][], components: number): number[][] {
+    if (rows.length < 2) {
+        return rows.map(() => new Array(components).fill(0))
+    }
+    // NIPALS extracts only the leading components, which scales far better
+    // than a full SVD for many high-dimensional vectors
+    const pca = rows.length > 50
+        ? new PCA(rows, { method: "NIPALS", nCompNIPALS: components })
+        : new PCA(rows)
+    const projected = pca.predict(rows, { nComponents: components }).to2DArray()
+    return projected.map((row) => {
+        const out = row.slice(0, components)
+        while (out.length < components) out.push(0)
+        return out
+    })
+}
+
+/**
+ * Projects rows to `components` dimensions. UMAP runs epoch by epoch via
+ * fitAsync (its neighbour graph comes from approximate NN-descent rather
+ * than a dense distance matrix), reporting progress and stopping early
+ * when isCancelled() turns true.
+ */
+export async function computeProjection(
+    rows: number[][],
+    params: ProjectionParams,
+    onProgress: (fraction: number) => void,
+    isCancelled: () => boolean
+): Promise<number[][]> {
+    const { components } = params
+    if (rows.length === 0) return []
+
+    // Already within the target dimensionality
+    if (rows[0].length <= components) {
+        return rows.map((row) => {
+            const out = row.slice(0, components)
+            while (out.length < components) out.push(0)
+            return out
+        })
+    }
+
+    if (params.method === "pca" || rows.length < 3) {
+        const result = projectPCA(rows, components)
+        onProgress(1)
+        return result
+    }
+
+    const nEpochs = params.nEpochs ?? 200
+    const umap = new UMAP({
+        nComponents: components,
+        nEpochs,
+        nNeighbors: Math.min(params.nNeighbors ?? 15, rows.length - 1),
+        minDist: params.minDist ?? 0.1,
+    })
+
+    let lastReported = 0
+    const embedding = await umap.fitAsync(rows, (epoch) => {
+        if (isCancelled()) return false
+        if (epoch - lastReported >= 5) {
+            lastReported = epoch
+            onProgress(epoch / nEpochs)
+        }
+        return true
+    })
+
+    if (isCancelled()) {
+        throw new ProjectionCancelledError()
+    }
+    onProgress(1)
+    return embedding
+}
@@ -0,0 +1,68 @@
+import {
+    ProjectionCancelledError,
+    ProjectionParams,
+    computeProjection,
+    flattenRows,
+    toRows,
+} from "./compute"
+
+/*
+ * Runs projections off the main thread. Vectors arrive as one transferred
+ * Float32Array; UMAP yields between epochs, so "cancel" messages are seen
+ * while a job is running.
+ */
+
+export type ProjectionWorkerRequest =
+    | {
+          type: "project"
+          id: number
+          data: Float32Array
+          count: number
+          dims: number
+          params: ProjectionParams
+      }
+    | { type: "cancel"; id: number }
+
+export type ProjectionWorkerResponse =
+    | { type: "progress"; id: number; progress: number }
+    | { type: "result"; id: number; coordinates: Float32Array; components: number }
+    | { type: "error"; id: number; error: string; cancelled: boolean }
+
+const ctx = self as unknown as {
+    onmessage: ((event: MessageEvent<ProjectionWorkerRequest>) => void) | null
+    postMessage: (message: ProjectionWorkerResponse, transfer?: Transferable[]) => void
+}
+
+const cancelled = new Set<number>()
+
+ctx.onmessage = async (event) => {
+    const message = event.data
+    if (message.type === "cancel") {
+        cancelled.add(message.id)
+        return
+    }
+
+    const { id, data, count, dims, params } = message
+    try {
+        const result = await computeProjection(
+            toRows(data, count, dims),
+            params,
+            (progress) => ctx.postMessage({ type: "progress", id, progress }),
+            () => cancelled.has(id)
+        )
+        const coordinates = flattenRows(result, params.components)
+        ctx.postMessage(
+            { type: "result", id, coordinates, components: params.components },
+            [coordinates.buffer]
+        )
+    } catch (error) {
+        ctx.postMessage({
+            type: "error",
+            id,
+            error: error instanceof Error ? error.message : String(error),
+            cancelled: error instanceof ProjectionCancelledError,
+        })
+    } finally {
+        cancelled.delete(id)
+    }
+}
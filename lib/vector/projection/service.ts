@@ -0,0 +1,193 @@
+import {
+    ProjectionCancelledError,
+    ProjectionParams,
+    computeProjection,
+    toRows,
+} from "./compute"
+import type {
+    ProjectionWorkerRequest,
+    ProjectionWorkerResponse,
+} from "./projection.worker"
+
+export { ProjectionCancelledError } from "./compute"
+export type { ProjectionMethod, ProjectionParams } from "./compute"
+
+/*
+ * Client-side entry point for UMAP/PCA projections. Jobs run in a shared
+ * worker (or inline when Workers are unavailable), report progress, can be
+ * cancelled, and their results are kept per cache key so revisiting a view
+ * over the same sample does not recompute.
+ */
+
+export interface ProjectionJob {
+    promise: Promise<number[][]>
+    cancel: () => void
+}
+
+export interface ProjectionOptions {
+    // Identifies the vector set and sample; omit to skip the result cache
+    cacheKey?: string
+    onProgress?: (fraction: number) => void
+}
+
+const CACHE_LIMIT = 32
+
+// Least recently used first
+const resultCache = new Map<string, number[][]>()
+
+interface PendingJob {
+    resolve: (rows: number[][]) => void
+    reject: (error: Error) => void
+    onProgress?: (fraction: number) => void
+}
+
+const pending = new Map<number, PendingJob>()
+let nextJobId = 1
+let worker: Worker | null | undefined
+
+function rejectAll(error: Error) {
+    pending.forEach((job) => job.reject(error))
+    pending.clear()
+}
+
+function getWorker(): Worker | null {
+    if (worker !== undefined) return worker
+    if (typeof Worker === "undefined") {
+        worker = null
+        return worker
+    }
+
+    try {
+        const created = new Worker(new URL("./projection.worker.ts", import.meta.url))
+        created.onmessage = (event: MessageEvent<ProjectionWorkerResponse>) => {
+            const message = event.data
+            const job = pending.get(message.id)
+            if (!job) return
+
+            if (message.type === "progress") {
+                job.onProgress?.(message.progress)
+            } else if (message.type === "result") {
+                pending.delete(message.id)
+                const rows: number[][] = []
+                for (let i = 0; i < message.coordinates.length; i += message.components) {
+                    rows.push(Array.from(message.coordinates.subarray(i, i + message.components)))
+                }
+                job.resolve(rows)
+            } else {
+                pending.delete(message.id)
+                job.reject(message.cancelled ? new ProjectionCancelledError() : new Error(message.error))
+            }
+        }
+        created.onerror = (event) => {
+            console.error("[Projection] Worker failed, falling back to the main thread:", event)
+            created.terminate()
+            worker = null
+            rejectAll(new Error("Projection worker failed"))
+        }
+        worker = created
+    } catch (error) {
+        console.error("[Projection] Could not start worker:", error)
+        worker = null
+    }
+    return worker
+}
+
+function cacheGet(key: string): number[][] | undefined {
+    const rows = resultCache.get(key)
+    if (rows) {
+        resultCache.delete(key)
+        resultCache.set(key, rows)
+    }
+    return rows
+}
+
+function cacheSet(key: string, rows: number[][]) {
+    resultCache.delete(key)
+    resultCache.set(key, rows)
+    while (resultCache.size > CACHE_LIMIT) {
+        const oldest = resultCache.keys().next().value
+        if (oldest === undefined) break
+        resultCache.delete(oldest)
+    }
+}
+
+// FNV-1a over the sample's element names, so the key stays short for large samples
+export function projectionCacheKey(
+    scope: string,
+    params: ProjectionParams,
+    elements: string[]
+): string {
+    let hash = 0x811c9dc5
+    for (const element of elements) {
+        for (let i = 0; i < element.length; i++) {
+            hash ^= element.charCodeAt(i)
+            hash = Math.imul(hash, 0x01000193)
+        }
+        // Separator, so ["ab", "c"] and ["a", "bc"] differ
+        hash ^= 0xff
+        hash = Math.imul(hash, 0x01000193)
+    }
+    return [
+        scope,
+        params.method,
+        params.components,
+        params.nEpochs ?? "",
+        params.nNeighbors ?? "",
+        params.minDist ?? "",
+        elements.length,
+        (hash >>> 0).toString(16),
+    ].join("|")
+}
+
+export function runProjection(
+    vectors: ArrayLike<number>[],
+    params: ProjectionParams,
+    options: ProjectionOptions = {}
+): ProjectionJob {
+    const { cacheKey, onProgress } = options
+
+    if (cacheKey) {
+        const cached = cacheGet(cacheKey)
+        if (cached) {
+            onProgress?.(1)
+            return { promise: Promise.resolve(cached), cancel: () => {} }
+        }
+    }
+
+    const count = vectors.length
+    const dims = count > 0 ? vectors[0].length : 0
+    const data = new Float32Array(count * dims)
+    vectors.forEach((vector, i) => data.set(vector, i * dims))
+
+    const id = nextJobId++
+    let cancelled = false
+    const target = getWorker()
+
+    const promise = new Promise<number[][]>((resolve, reject) => {
+        if (target) {
+            pending.set(id, { resolve, reject, onProgress })
+            const request: ProjectionWorkerRequest = { type: "project", id, data, count, dims, params }
+            target.postMessage(request, [data.buffer])
+            return
+        }
+
+        computeProjection(toRows(data, count, dims), params, onProgress ?? (() => {}), () => cancelled)
+            .then(resolve, reject)
+    }).then((rows) => {
+        // A finished result is still worth caching even if the caller gave up on it
+        if (cacheKey) cacheSet(cacheKey, rows)
+        if (cancelled) throw new ProjectionCancelledError()
+        return rows
+    })
+
+    const cancel = () => {
+        if (cancelled) return
+        cancelled = true
+        if (target && pending.has(id)) {
+            const request: ProjectionWorkerRequest = { type: "cancel", id }
+            target.postMessage(request)
+        }
+    }
+
+    return { promise, cancel }
+}
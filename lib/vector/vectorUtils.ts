@@ -1,7 +1,21 @@
 /**
  * Utility functions for vector math operations
+ *
+ * These are number[] wrappers over the Float32Array kernels in kernels.ts;
+ * use the kernels directly to combine into a reused buffer.
  */
 
+import {
+  axpy,
+  combineInto,
+  componentMaxInto,
+  cosine,
+  dot,
+  normalizeInPlace,
+  orthogonalCombineInto,
+  scaleInPlace,
+} from "./kernels";
+
 /**
  * Enum for vector combination methods
  */
@@ -24,7 +38,9 @@ export function addVectors(vec1: number[], vec2: number[]): number[] {
     throw new Error("Vectors must have the same dimension");
   }
   
-  return vec1.map((val, i) => val + vec2[i]);
+  const result = Float32Array.from(vec1);
+  axpy(result, vec2, 1);
+  return Array.from(result);
 }
 
 /**
@@ -34,7 +50,7 @@ export function addVectors(vec1: number[], vec2: number[]): number[] {
  * @returns Vector with each element multiplied by the scalar
  */
 export function multiplyVectorByScalar(vec: number[], scalar: number): number[] {
-  return vec.map(val => val * scalar);
+  return Array.from(scaleInPlace(Float32Array.from(vec), scalar));
 }
 
 /**
@@ -48,7 +64,7 @@ export function dotProduct(vec1: number[], vec2: number[]): number {
     throw new Error("Vectors must have the same dimension");
   }
   
-  return vec1.reduce((sum, val, i) => sum + val * vec2[i], 0);
+  return dot(vec1, vec2);
 }
 
 /**
@@ -62,15 +78,8 @@ export function cosineSimilarity(vec1: number[], vec2: number[]): number {
     throw new Error("Vectors must have the same dimension");
   }
   
-  const dot = dotProduct(vec1, vec2);
-  const mag1 = Math.sqrt(vec1.reduce((sum, val) => sum + val * val, 0));
-  const mag2 = Math.sqrt(vec2.reduce((sum, val) => sum + val * val, 0));
-  
-  if (mag1 === 0 || mag2 === 0) {
-    return 0; // Avoid division by zero
-  }
-  
-  return dot / (mag1 * mag2);
+  // Returns 0 when either magnitude is zero
+  return cosine(vec1, vec2);
 }
 
 /**
@@ -152,17 +161,7 @@ export function combineVectors(vectors: number[][], weights: number[]): number[]
     }
   }
   
-  // Initialize result vector with zeros
-  const result = new Array(dimension).fill(0);
-  
-  // Apply weighted sum
-  for (let i = 0; i < filteredVectors.length; i++) {
-    for (let j = 0; j < dimension; j++) {
-      result[j] += filteredVectors[i][j] * filteredWeights[i];
-    }
-  }
-  
-  return result;
+  return Array.from(combineInto(new Float32Array(dimension), filteredVectors, filteredWeights));
 }
 
 /**
@@ -199,7 +198,7 @@ export function weightedAverage(vectors: number[][], weights: number[]): number[
   }
   
   // Divide by sum of weights
-  return combined.map(val => val / weightSum);
+  return Array.from(scaleInPlace(Float32Array.from(combined), 1 / weightSum));
 }
 
 /**
@@ -212,41 +211,9 @@ export function orthogonalizeCombine(vectors: number[][], weights: number[]): nu
   if (vectors.length === 0) return [];
   if (vectors.length === 1) return multiplyVectorByScalar(vectors[0], weights[0]);
   
-  const dimension = vectors[0].length;
-  const orthogonalVectors: number[][] = [vectors[0]]; // First vector stays the same
-  
-  // Generate orthogonal versions of subsequent vectors
-  for (let i = 1; i < vectors.length; i++) {
-    const currentVector = [...vectors[i]];
-    
-    // Project out components in the direction of previous vectors
-    for (let j = 0; j < i; j++) {
-      const prevVector = orthogonalVectors[j];
-      const scalarProj = dotProduct(currentVector, prevVector) / dotProduct(prevVector, prevVector);
-      
-      // Subtract the projection
-      for (let k = 0; k < dimension; k++) {
-        currentVector[k] -= scalarProj * prevVector[k];
-      }
-    }
-    
-    // Only add if the vector isn't too close to zero
-    const magnitude = Math.sqrt(dotProduct(currentVector, currentVector));
-    if (magnitude > 1e-10) {
-      orthogonalVectors.push(currentVector);
-    }
-  }
-  
-  // Apply weights and combine
-  const result = new Array(dimension).fill(0);
-  for (let i = 0; i < orthogonalVectors.length; i++) {
-    const weight = i < weights.length ? weights[i] : 0;
-    for (let j = 0; j < dimension; j++) {
-      result[j] += orthogonalVectors[i][j] * weight;
-    }
-  }
-  
-  return result;
+  const result = new Float32Array(vectors[0].length);
+  orthogonalCombineInto(result, vectors, weights);
+  return Array.from(result);
 }
 
 /**
@@ -259,22 +226,8 @@ export function componentWiseMax(vectors: number[][], weights: number[]): number
   if (vectors.length === 0) return [];
   if (vectors.length === 1) return multiplyVectorByScalar(vectors[0], weights[0]);
   
-  const dimension = vectors[0].length;
-  
-  // Initialize result with first weighted vector
-  const result = multiplyVectorByScalar(vectors[0], weights[0]);
-  
-  // Compare with remaining weighted vectors
-  for (let i = 1; i < vectors.length; i++) {
-    const weightedVector = multiplyVectorByScalar(vectors[i], weights[i]);
-    
-    for (let j = 0; j < dimension; j++) {
-      // Take the max value for each component
-      result[j] = Math.max(result[j], weightedVector[j]);
-    }
-  }
-  
-  return result;
+  const result = new Float32Array(vectors[0].length);
+  return Array.from(componentMaxInto(result, vectors, weights));
 }
 
 /**
@@ -289,10 +242,33 @@ export function combineAndNormalizeVectors(
   weights: number[],
   method: VectorCombinationMethod = VectorCombinationMethod.LINEAR
 ): number[] {
-  // First combine the vectors using the specified method
+  // A weighted average is a positive multiple of the linear sum, so both
+  // normalize to the same vector: combine and normalize in one kernel call
+  if (
+    vectors.length > 1 &&
+    (method === VectorCombinationMethod.LINEAR || method === VectorCombinationMethod.WEIGHTED_AVERAGE)
+  ) {
+    if (vectors.length !== weights.length) {
+      throw new Error("Number of vectors must match number of weights");
+    }
+    // Zero-weight vectors are skipped, as in combineVectors
+    const weighted = vectors.filter((_, i) => weights[i] !== 0);
+    const dimension = (weighted[0] ?? vectors[0]).length;
+    for (let i = 1; i < weighted.length; i++) {
+      if (weighted[i].length !== dimension) {
+        throw new Error(`Vector at index ${i} has different dimension (${weighted[i].length}) than first vector (${dimension})`);
+      }
+    }
+    return Array.from(combineInto(
+      new Float32Array(dimension),
+      weighted,
+      weights.filter((w) => w !== 0),
+      true
+    ));
+  }
+
+  // Otherwise combine the vectors using the specified method, then normalize to unit length
   const combined = combineVectorsWithMethod(vectors, weights, method);
-  
-  // Then normalize to unit length
   return normalizeVector(combined);
 }
 
@@ -302,14 +278,8 @@ export function combineAndNormalizeVectors(
  * @returns Normalized vector
  */
 export function normalizeVector(vec: number[]): number[] {
-  const magnitude = Math.sqrt(vec.reduce((sum, val) => sum + val * val, 0));
-  
-  // Avoid division by zero
-  if (magnitude === 0) {
-    return [...vec];
-  }
-  
-  return vec.map(val => val / magnitude);
+  // A zero vector is returned unchanged (as a copy)
+  return Array.from(normalizeInPlace(Float32Array.from(vec)));
 }
 
 /**
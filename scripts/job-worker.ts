@@ -0,0 +1,42 @@
+/*
+ * Import job worker, run separately from the web server:
+ *
+ *   npm run build
+ *   REDIS_URL=redis://localhost:6379 npm run worker
+ *
+ * It is loaded by instrumentation.ts when the built app starts with
+ * JOB_WORKER=1, so it runs on the app's own dependencies.
+ *
+ * Any number of workers (and web servers) can run against the same Redis;
+ * they share the rows of every job. Set JOB_WORKER_NAME to a name that is
+ * stable across restarts (e.g. the pod name) so a restarted worker picks
+ * its unfinished rows back up; JOB_WORKER_MAX_JOBS limits how many jobs it
+ * works on at once.
+ */
+import { JobWorker } from "@/lib/server/job-worker"
+import { RedisConnection } from "@/lib/redis-server/RedisConnection"
+
+const url = process.env.REDIS_URL
+if (!url) {
+    console.error("[job-worker] REDIS_URL is required")
+    process.exit(1)
+}
+
+const worker = new JobWorker(url, {
+    consumer: process.env.JOB_WORKER_NAME,
+    maxJobs: Number(process.env.JOB_WORKER_MAX_JOBS) || undefined,
+})
+worker.start()
+
+let shuttingDown = false
+async function shutdown(signal: string) {
+    if (shuttingDown) return
+    shuttingDown = true
+    console.log(`[job-worker] ${signal} received, finishing current batches`)
+    await worker.shutdown()
+    await RedisConnection.closeAllConnections()
+    process.exit(0)
+}
+
+process.on("SIGINT", () => shutdown("SIGINT"))
+process.on("SIGTERM", () => shutdown("SIGTERM"))